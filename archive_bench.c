@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/persistence.c"
+#include "src/archive.c"
+
+#define DEFAULT_TASKS 1000000
+#define ARCHIVE_PATH "archive_bench.archive"
+#define SMALL_ARCHIVE_PATH "archive_bench_small.archive"
+#define COLD_LOOKUPS 2000
+#define WARM_LOOKUPS 1000000
+
+static double elapsed_us(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+}
+
+static long page_faults(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt + usage.ru_majflt;
+}
+
+// Drop the file from the page cache so the first queries really go to disk
+static void evict(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+static TaskManager *build(int count)
+{
+    TaskManager *manager = create_task_manager();
+    char description[64];
+
+    srand(5);
+    for (int id = 1; id <= count && manager; id++)
+    {
+        snprintf(description, sizeof(description), "Archived task %d, batch %d", id, rand() % 500);
+        add_task(manager, id, description, 1 + rand() % LOWEST_PRIORITY);
+        Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+        set_task_completion(manager, id, rand() % 4 != 0);
+        if (id % 10 == 0)
+            add_subtask(manager, id, "closing note", 3);
+    }
+    return manager;
+}
+
+static double time_open(const char *path, TaskArchive **archive)
+{
+    struct timespec start, end;
+    evict(path);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    *archive = open_archive(path);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return elapsed_us(start, end);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+
+    TaskManager *manager = build(count);
+    if (!manager)
+        return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool written = write_archive(manager, ARCHIVE_PATH, false);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Wrote archive of %d tasks in %.2f ms\n", count, elapsed_us(start, end) / 1e3);
+
+    // Opening does not depend on size: compare with an archive of a hundredth of the tasks
+    TaskManager *small = build(count / 100 > 0 ? count / 100 : 1);
+    written = small && write_archive(small, SMALL_ARCHIVE_PATH, false) && written;
+    free_task_manager(small);
+    if (!written)
+        return 1;
+
+    TaskArchive *archive;
+    double small_open = time_open(SMALL_ARCHIVE_PATH, &archive);
+    close_archive(archive);
+    double open_us = time_open(ARCHIVE_PATH, &archive);
+    if (!archive)
+        return 1;
+    printf("open: %.1f us for %llu tasks (%d tasks: %.1f us)\n", open_us,
+           (unsigned long long)archive_task_count(archive), count / 100, small_open);
+
+    // Cold lookups: every page comes from disk the first time it is touched
+    long faults = page_faults();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int found = 0;
+    for (int i = 0; i < COLD_LOOKUPS; i++)
+        found += archive_find_task(archive, 1 + rand() % count) != NULL;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("cold find: %d/%d found, %.2f us/lookup, %.1f page faults/lookup\n", found, COLD_LOOKUPS,
+           elapsed_us(start, end) / COLD_LOOKUPS, (double)(page_faults() - faults) / COLD_LOOKUPS);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    found = 0;
+    for (int i = 0; i < WARM_LOOKUPS; i++)
+        found += archive_find_task(archive, 1 + rand() % count) != NULL;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("warm find: %d/%d found, %.0f ns/lookup\n", found, WARM_LOOKUPS,
+           elapsed_us(start, end) * 1e3 / WARM_LOOKUPS);
+
+    // Every record matches the manager it came from
+    bool same = archive_task_count(archive) == (uint64_t)count;
+    for (int id = 1; same && id <= count; id += 1 + count / 10000)
+    {
+        const TaskRecord *record = archive_find_task(archive, id);
+        Task *task = find_task(manager, id);
+        const SubTaskRecord *subtask = record ? archive_subtask(archive, record, 0) : NULL;
+        same = record && record->id == id && record->priority == task->priority &&
+               strcmp(archive_text(archive, record->description), task->description) == 0 &&
+               (id % 10 != 0 || (subtask && strcmp(archive_text(archive, subtask->description), "closing note") == 0));
+    }
+
+    // Range queries: agenda pages and one day, checked for order
+    const TaskRecord *page[50];
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int agenda = archive_agenda(archive, false, HIGHEST_PRIORITY, LOWEST_PRIORITY, page, 50);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int i = 1; same && i < agenda; i++)
+        same = archive_key(ARCHIVE_BY_PRIORITY, page[i - 1]) < archive_key(ARCHIVE_BY_PRIORITY, page[i]) &&
+               !(page[i]->flags & SNAPSHOT_COMPLETE);
+    printf("agenda page: %d tasks in %.1f us\n", agenda, elapsed_us(start, end));
+
+    Task *sample = find_task(manager, count / 2);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int day = archive_day(archive, sample->month, sample->date, page, 50);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int i = 0; same && i < day; i++)
+        same = page[i]->month == (uint8_t)sample->month && page[i]->date == (uint8_t)sample->date;
+    printf("day %02d/%02d: %d tasks in %.1f us\n", sample->month + 1, sample->date, day, elapsed_us(start, end));
+
+    printf("Archive matches manager: %s\n", same ? "yes" : "NO");
+
+    close_archive(archive);
+    free_task_manager(manager);
+    remove(ARCHIVE_PATH);
+    remove(SMALL_ARCHIVE_PATH);
+    return same ? 0 : 1;
+}
@@ -1,10 +1,83 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include "avl_api.h"
 
 // ---------------- AVL Value List Functions ----------------
 
+#define INDEX_EMPTY 0
+#define INDEX_REMOVED ((size_t)-1)
+
+static size_t hash_value_pointer(void *data, size_t index_capacity)
+{
+    uint64_t h = (uint64_t)(uintptr_t)data >> 4;
+    h *= 11400714819323198485ull; // Fibonacci hashing
+    return (size_t)(h >> 32) & (index_capacity - 1);
+}
+
+static void index_put(AVLValueList *list, size_t slot)
+{
+    size_t mask = list->index_capacity - 1;
+    size_t i = hash_value_pointer(list->values[slot], list->index_capacity);
+
+    while (list->index[i] != INDEX_EMPTY && list->index[i] != INDEX_REMOVED)
+        i = (i + 1) & mask;
+
+    if (list->index[i] == INDEX_EMPTY)
+        list->index_used++;
+    list->index[i] = slot + 1;
+}
+
+// Rebuilds the pointer index from scratch; sized for twice the used slots
+static bool rebuild_value_index(AVLValueList *list)
+{
+    size_t index_capacity = 32;
+    while (index_capacity < list->capacity * 2)
+        index_capacity <<= 1;
+
+    size_t *index = (size_t *)calloc(index_capacity, sizeof(size_t));
+    if (!index)
+    {
+        printf("Failed to build AVLValueList index.\n");
+        return false;
+    }
+
+    free(list->index);
+    list->index = index;
+    list->index_capacity = index_capacity;
+    list->index_used = 0;
+
+    for (size_t i = 0; i < list->used; i++)
+    {
+        if (list->values[i])
+            index_put(list, i);
+    }
+    return true;
+}
+
+bool init_value_list(AVLValueList *list, int capacity)
+{
+    if (capacity <= 0)
+        capacity = 2;
+    // Empty before allocating, so release_value_list is safe after a failure
+    list->size = 0;
+    list->used = 0;
+    list->capacity = 0;
+    list->index = NULL;
+    list->index_capacity = 0;
+    list->index_used = 0;
+    list->values = (void **)malloc(sizeof(void *) * capacity); // Use provided capacity
+    if (!list->values)
+    {
+        printf("Memory allocation failed for AVLValueList values.\n");
+        return false;
+    }
+    list->capacity = capacity;
+    return true;
+}
+
 AVLValueList *create_value_list(int capacity)
 {
     AVLValueList *list = (AVLValueList *)malloc(sizeof(AVLValueList));
@@ -13,31 +86,58 @@ AVLValueList *create_value_list(int capacity)
         printf("Memory allocation failed for AVLValueList.\n");
         return NULL;
     }
-    list->values = (void **)malloc(sizeof(void *) * capacity); // Use provided capacity
-    list->size = 0;
-    list->capacity = capacity;
+    if (!init_value_list(list, capacity))
+    {
+        free(list);
+        return NULL;
+    }
     return list;
 }
 
 bool add_value_to_list(AVLValueList *list, void *data)
 {
-    if (!list)
+    if (!list || !data)
         return false;
 
-    if (list->size >= list->capacity)
+    if (list->used >= list->capacity)
     {
-        size_t new_capacity = list->capacity * 2;
-        void **new_values = (void **)realloc(list->values, sizeof(void *) * new_capacity);
-        if (!new_values)
+        // Reuse holes before growing when at least half the slots are dead
+        if (list->used - list->size >= list->used / 2 && list->used - list->size > 0)
         {
-            printf("Failed to expand AVLValueList.\n");
-            return false;
+            compact_value_list(list);
         }
-        list->values = new_values;
-        list->capacity = new_capacity;
+        else
+        {
+            size_t new_capacity = list->capacity * 2;
+            void **new_values = (void **)realloc(list->values, sizeof(void *) * new_capacity);
+            if (!new_values)
+            {
+                printf("Failed to expand AVLValueList.\n");
+                return false;
+            }
+            list->values = new_values;
+            list->capacity = new_capacity;
+
+            if (list->index && !rebuild_value_index(list))
+                return false;
+        }
+    }
+
+    size_t slot = list->used++;
+    list->values[slot] = data;
+    list->size++;
+
+    if (list->index && (list->index_used + 1) * 4 <= list->index_capacity * 3)
+        index_put(list, slot);
+    else if (list->index)
+    {
+        // Too many removed markers; a rebuild drops them and indexes the new slot
+        if (!rebuild_value_index(list))
+            return false;
     }
+    else if (list->used > AVL_VALUE_INDEX_THRESHOLD && !rebuild_value_index(list))
+        return false;
 
-    list->values[list->size++] = data;
     return true;
 }
 
@@ -50,40 +150,140 @@ AVLValueList *copy_value_list(AVLValueList *source)
     if (!copy)
         return NULL;
 
-    for (size_t i = 0; i < source->size; i++)
+    for (size_t i = 0; i < source->used; i++)
     {
-        copy->values[i] = source->values[i]; // Shallow copy (just copying pointers)
+        if (source->values[i])
+            copy->values[copy->used++] = source->values[i]; // Shallow copy (just copying pointers)
     }
-    copy->size = source->size;
+    copy->size = copy->used;
+
+    if (copy->used > AVL_VALUE_INDEX_THRESHOLD)
+        rebuild_value_index(copy);
 
     return copy;
 }
 
+// Squeezes out removed slots while keeping the live values in order
+void compact_value_list(AVLValueList *list)
+{
+    if (!list || list->used == list->size)
+        return;
+
+    size_t out = 0;
+    for (size_t i = 0; i < list->used; i++)
+    {
+        if (list->values[i])
+            list->values[out++] = list->values[i];
+    }
+    list->used = out;
+
+    if (list->index)
+        rebuild_value_index(list);
+}
+
+// Removes one occurrence of the data pointer in O(1) expected time
 bool remove_value_from_list(AVLValueList *list, void *data)
 {
-    if (!list || list->size == 0)
+    if (!list || list->size == 0 || !data)
         return false;
 
-    for (size_t i = 0; i < list->size; i++)
+    size_t slot = list->used;
+
+    if (list->index)
     {
-        if (*(int *)list->values[i] == *(int *)data) // Compare actual int values
+        size_t mask = list->index_capacity - 1;
+        size_t i = hash_value_pointer(data, list->index_capacity);
+
+        while (list->index[i] != INDEX_EMPTY)
         {
-            for (size_t j = i; j < list->size - 1; j++)
+            if (list->index[i] != INDEX_REMOVED && list->values[list->index[i] - 1] == data)
             {
-                list->values[j] = list->values[j + 1];
+                slot = list->index[i] - 1;
+                list->index[i] = INDEX_REMOVED;
+                break;
             }
-            list->size--;
-            return true;
+            i = (i + 1) & mask;
         }
     }
-    return false;
+    else
+    {
+        for (size_t i = 0; i < list->used; i++)
+        {
+            if (list->values[i] == data)
+            {
+                slot = i;
+                break;
+            }
+        }
+    }
+
+    if (slot == list->used)
+        return false;
+
+    list->values[slot] = NULL;
+    list->size--;
+
+    if (list->size == 0)
+    {
+        // Nothing left to keep in order; start over without touching the index
+        list->used = 0;
+        if (list->index)
+        {
+            memset(list->index, 0, sizeof(size_t) * list->index_capacity);
+            list->index_used = 0;
+        }
+    }
+    else if (slot == list->used - 1)
+    {
+        while (list->used > 0 && list->values[list->used - 1] == NULL)
+            list->used--;
+    }
+    else if (list->used - list->size > list->used / 2)
+    {
+        compact_value_list(list);
+    }
+
+    return true;
 }
 
-void free_value_list(AVLValueList *list)
+size_t next_value_slot(AVLValueList *list, size_t slot)
+{
+    while (slot < list->used && list->values[slot] == NULL)
+        slot++;
+    return slot;
+}
+
+void *first_value_in_list(AVLValueList *list)
+{
+    if (!list || list->size == 0)
+        return NULL;
+    return list->values[next_value_slot(list, 0)];
+}
+
+void *last_value_in_list(AVLValueList *list)
+{
+    // Trailing holes are trimmed on removal, so the last used slot is live
+    if (!list || list->size == 0)
+        return NULL;
+    return list->values[list->used - 1];
+}
+
+void release_value_list(AVLValueList *list)
 {
     if (!list)
         return;
+    free(list->index);
     free(list->values);
+    list->index = NULL;
+    list->values = NULL;
+    list->size = list->used = list->capacity = 0;
+}
+
+void free_value_list(AVLValueList *list)
+{
+    if (!list)
+        return;
+    release_value_list(list);
     free(list);
 }
 
@@ -101,11 +301,30 @@ AVL *create_avl(int (*cmp)(void *, void *), void *(*copy_key)(void *, size_t), v
     tree->cmp = cmp;
     tree->copy_key = copy_key;
     tree->free_key = free_key;
+    tree->key_size = sizeof(int); // Copying trees have always assumed int keys
+    tree->inline_keys = false;
     tree->size = 0;
     tree->capacity = capacity;
     return tree;
 }
 
+AVL *create_avl_inline(int (*cmp)(void *, void *), size_t key_size, int capacity)
+{
+    if (key_size == 0 || key_size > AVL_INLINE_KEY_BYTES)
+    {
+        printf("Inline AVL keys must be 1-%d bytes.\n", AVL_INLINE_KEY_BYTES);
+        return NULL;
+    }
+
+    AVL *tree = create_avl(cmp, NULL, NULL, capacity);
+    if (!tree)
+        return NULL;
+
+    tree->key_size = key_size;
+    tree->inline_keys = true;
+    return tree;
+}
+
 AVLNode *create_avl_node(AVL *tree, void *key, void *data)
 {
     AVLNode *node = (AVLNode *)malloc(sizeof(AVLNode));
@@ -115,18 +334,42 @@ AVLNode *create_avl_node(AVL *tree, void *key, void *data)
         return NULL;
     }
 
-    node->key = tree->copy_key(key, sizeof(*(int *)key)); // Assuming key is an int
-    node->list = create_value_list(2);
-    if (!node->list || !add_value_to_list(node->list, data))
+    if (tree->inline_keys)
+    {
+        node->key_storage.as_int = 0;
+        memcpy(node->key_storage.bytes, key, tree->key_size);
+        node->key = &node->key_storage;
+    }
+    else
+    {
+        node->key = tree->copy_key(key, tree->key_size);
+    }
+
+    node->list = &node->value_store;
+    if (!init_value_list(node->list, 2) || !add_value_to_list(node->list, data))
     {
+        release_value_list(node->list);
+        if (!tree->inline_keys)
+            tree->free_key(node->key);
         free(node);
         return NULL;
     }
+
     node->height = 1;
     node->left = node->right = NULL;
+    node->parent = NULL;
     return node;
 }
 
+// Frees a node that has already been unlinked from the tree
+static void release_avl_node(AVL *tree, AVLNode *node)
+{
+    release_value_list(node->list);
+    if (!tree->inline_keys && tree->free_key)
+        tree->free_key(node->key);
+    free(node);
+}
+
 bool is_avl_empty(AVL *tree)
 {
     return tree->root == NULL;
@@ -142,7 +385,7 @@ bool is_avl_full(AVL *tree)
     return tree->size >= tree->capacity;
 }
 
-int max(int a, int b)
+int avl_max(int a, int b)
 {
     return (a > b) ? a : b;
 }
@@ -194,14 +437,14 @@ AVLNode *find_avl(AVL *tree, AVLNode *node, void *key)
 
 // ---------------- AVL Tree Balancing ----------------
 
-int get_height(AVLNode *node)
+int get_avl_height(AVLNode *node)
 {
     return node ? node->height : 0;
 }
 
 int get_balance_factor(AVLNode *node)
 {
-    return node ? get_height(node->left) - get_height(node->right) : 0;
+    return node ? get_avl_height(node->left) - get_avl_height(node->right) : 0;
 }
 
 // Rotate Left with Parent Updates
@@ -218,8 +461,8 @@ AVLNode *rotate_left(AVLNode *x)
     if (T2)
         T2->parent = x;
 
-    x->height = 1 + max(get_height(x->left), get_height(x->right));
-    y->height = 1 + max(get_height(y->left), get_height(y->right));
+    x->height = 1 + avl_max(get_avl_height(x->left), get_avl_height(x->right));
+    y->height = 1 + avl_max(get_avl_height(y->left), get_avl_height(y->right));
 
     return y;
 }
@@ -238,8 +481,8 @@ AVLNode *rotate_right(AVLNode *y)
     if (T2)
         T2->parent = y;
 
-    y->height = 1 + max(get_height(y->left), get_height(y->right));
-    x->height = 1 + max(get_height(x->left), get_height(x->right));
+    y->height = 1 + avl_max(get_avl_height(y->left), get_avl_height(y->right));
+    x->height = 1 + avl_max(get_avl_height(x->left), get_avl_height(x->right));
 
     return x;
 }
@@ -247,7 +490,7 @@ AVLNode *rotate_right(AVLNode *y)
 // Balance AVL Node
 AVLNode *balance_avl(AVLNode *node)
 {
-    node->height = 1 + max(get_height(node->left), get_height(node->right));
+    node->height = 1 + avl_max(get_avl_height(node->left), get_avl_height(node->right));
 
     int balance = get_balance_factor(node);
 
@@ -287,11 +530,13 @@ bool insert_into_avl(AVLNode **node, AVL *tree, void *key, void *data)
     {
         if (!insert_into_avl(&(*node)->left, tree, key, data))
             return false;
+        (*node)->left->parent = *node;
     }
     else if (to_right(tree, key, (*node)->key))
     {
         if (!insert_into_avl(&(*node)->right, tree, key, data))
             return false;
+        (*node)->right->parent = *node;
     }
     else
     {
@@ -302,6 +547,23 @@ bool insert_into_avl(AVLNode **node, AVL *tree, void *key, void *data)
     return true;
 }
 
+// Unlinks the leftmost node of a subtree, rebalancing on the way back up
+static AVLNode *detach_min(AVLNode **node)
+{
+    if ((*node)->left == NULL)
+    {
+        AVLNode *min = *node;
+        *node = min->right;
+        if (*node)
+            (*node)->parent = min->parent;
+        return min;
+    }
+
+    AVLNode *min = detach_min(&(*node)->left);
+    *node = balance_avl(*node);
+    return min;
+}
+
 bool delete_from_avl(AVLNode **node, AVL *tree, void *key, void *value)
 {
     if (!(*node))
@@ -310,11 +572,17 @@ bool delete_from_avl(AVLNode **node, AVL *tree, void *key, void *value)
     // Traverse the AVL tree to find the node
     if (to_left(tree, key, (*node)->key))
     {
-        return delete_from_avl(&((*node)->left), tree, key, value);
+        if (!delete_from_avl(&((*node)->left), tree, key, value))
+            return false;
+        if ((*node)->left)
+            (*node)->left->parent = *node;
     }
     else if (to_right(tree, key, (*node)->key))
     {
-        return delete_from_avl(&((*node)->right), tree, key, value);
+        if (!delete_from_avl(&((*node)->right), tree, key, value))
+            return false;
+        if ((*node)->right)
+            (*node)->right->parent = *node;
     }
     else
     {
@@ -325,40 +593,31 @@ bool delete_from_avl(AVLNode **node, AVL *tree, void *key, void *value)
         // If the dynamic array is empty, we need to remove the AVL node itself
         if ((*node)->list->size == 0)
         {
-            // Case 1: No children
-            if (!(*node)->left && !(*node)->right)
-            {
-                free_value_list((*node)->list);
-                tree->free_key((*node)->key);
-                free(*node);
-                *node = NULL;
-            }
-            // Case 2: One child
-            else if (!(*node)->left || !(*node)->right)
+            AVLNode *target = *node;
+
+            // Case 1 & 2: No children or one child, splice the child in
+            if (!target->left || !target->right)
             {
-                AVLNode *temp = (*node)->left ? (*node)->left : (*node)->right;
-                free_value_list((*node)->list);
-                tree->free_key((*node)->key);
-                **node = *temp;
-                free(temp);
+                *node = target->left ? target->left : target->right;
+                if (*node)
+                    (*node)->parent = target->parent;
             }
-            // Case 3: Two children
+            // Case 3: Two children, move the successor node into place.
+            // Nodes are relinked rather than copied, so no key or value list is duplicated.
             else
             {
-                AVLNode *successor = (*node)->right;
-                while (successor->left != NULL)
-                    successor = successor->left;
-
-                // Copy successor's key and value list
-                tree->free_key((*node)->key);
-                (*node)->key = tree->copy_key(successor->key, sizeof(*(int *)successor->key));
-
-                free_value_list((*node)->list);
-                (*node)->list = copy_value_list(successor->list); // Use copy_value_list here
-
-                // Recursively delete the successor node
-                delete_from_avl(&((*node)->right), tree, successor->key, successor->list->values[0]);
+                AVLNode *successor = detach_min(&target->right);
+
+                successor->left = target->left;
+                successor->right = target->right;
+                successor->parent = target->parent;
+                successor->left->parent = successor;
+                if (successor->right)
+                    successor->right->parent = successor;
+                *node = successor;
             }
+
+            release_avl_node(tree, target);
             tree->size--;
         }
     }
@@ -382,18 +641,18 @@ bool remove_from_avl(AVL *tree, void *key, void *value)
 
 // ---------------- AVL Tree Traversal and Cleanup ----------------
 
-void inorder_traversal(AVLNode *node)
+void avl_inorder_traversal(AVLNode *node)
 {
     if (!node)
         return;
-    inorder_traversal(node->left);
+    avl_inorder_traversal(node->left);
     printf("%d ", *(int *)node->key);
-    inorder_traversal(node->right);
+    avl_inorder_traversal(node->right);
 }
 
 void traverse_tree(AVL *tree)
 {
-    inorder_traversal(tree->root);
+    avl_inorder_traversal(tree->root);
 }
 
 void free_avl(AVLNode *node, void (*free_key)(void *))
@@ -402,7 +661,8 @@ void free_avl(AVLNode *node, void (*free_key)(void *))
         return;
     free_avl(node->left, free_key);
     free_avl(node->right, free_key);
-    free_value_list(node->list);
-    free_key(node->key);
+    release_value_list(node->list);
+    if (free_key && node->key != (void *)&node->key_storage)
+        free_key(node->key);
     free(node);
 }
@@ -7,14 +7,26 @@
 
 #define MAX_TREE_SIZE 1000
 
+// Lists up to this many slots are searched linearly; larger ones get a pointer index
+#define AVL_VALUE_INDEX_THRESHOLD 16
+
 // --- Structure to Hold Multiple Values Per Key ---
+// Removed values leave a NULL hole so the remaining values keep their insertion
+// order; holes are squeezed out once they make up half of the used slots.
 typedef struct AVLValueList 
 {
-    void **values;  // Dynamic array of values
-    size_t size;    // Number of values
+    void **values;  // Dynamic array of values (NULL = removed slot)
+    size_t size;    // Number of live values
+    size_t used;    // Number of slots handed out, including removed ones
     size_t capacity;// Capacity of the array
+    size_t *index;  // Open-addressed value pointer -> slot + 1 (NULL while the list is small)
+    size_t index_capacity;
+    size_t index_used; // Index entries that are live or removed markers
 } AVLValueList;
 
+// Largest key that an inline-key tree can store inside the node itself
+#define AVL_INLINE_KEY_BYTES 8
+
 // --- Generic AVL Tree Node ---
 typedef struct AVLNode 
 {
@@ -23,6 +35,14 @@ typedef struct AVLNode
     struct AVLNode *left, *right;
     struct AVLNode *parent;
     int height;
+    union
+    {
+        long long as_int;
+        double as_double;
+        void *as_pointer;
+        unsigned char bytes[AVL_INLINE_KEY_BYTES];
+    } key_storage;             // Key bytes for inline-key trees (key points here)
+    AVLValueList value_store;  // Backing store for list, allocated with the node
 } AVLNode;
 
 // --- AVL Tree Structure ---
@@ -32,24 +52,34 @@ typedef struct AVL
     int (*cmp)(void *, void *);        // Function pointer for comparing keys
     void *(*copy_key)(void *, size_t); // Function to copy keys
     void (*free_key)(void *);          // Function to free keys
+    size_t key_size;                   // Bytes handed to copy_key or stored inline
+    bool inline_keys;                  // Keys live in node->key_storage, no copy/free calls
     int size;
     int capacity;
 } AVL;
 
 // --- AVLValueList Functions ---
 AVLValueList *create_value_list(int capacity);
+bool init_value_list(AVLValueList *list, int capacity);
+void release_value_list(AVLValueList *list); // Frees the contents, not the list itself
 void free_value_list(AVLValueList *list);
 bool add_value_to_list(AVLValueList *list, void *data); // Added function
 bool remove_value_from_list(AVLValueList *list, void *data); // Added function
+void compact_value_list(AVLValueList *list);
+void *first_value_in_list(AVLValueList *list);
+void *last_value_in_list(AVLValueList *list);
+size_t next_value_slot(AVLValueList *list, size_t slot); // Next live slot >= slot, or list->used
 
 // --- AVL Tree Utility Functions ---
 AVL *create_avl(int (*cmp)(void *, void *), 
     void *(*copy_key)(void *, size_t), void (*free_key)(void *), int capacity);
+// Scalar keys up to AVL_INLINE_KEY_BYTES are copied into the node, saving a malloc per node
+AVL *create_avl_inline(int (*cmp)(void *, void *), size_t key_size, int capacity);
 AVLNode *create_avl_node(AVL *tree, void *key, void *data);
 bool is_avl_empty(AVL *tree);
 int get_avl_size(AVL *tree);
 bool is_avl_full(AVL *tree);
-int max(int a, int b);
+int avl_max(int a, int b);
 
 // Determines if new_key should go to the left of current_key
 bool to_left(AVL *tree, void *new_key, void *current_key);
@@ -70,15 +100,15 @@ bool add_to_avl(AVL *tree, void *key, void *data);
 bool remove_from_avl(AVL *tree, void *key, void *value); // Updated
 
 // --- AVL Tree Balancing Functions ---
-int get_height(AVLNode *node);
+int get_avl_height(AVLNode *node);
 int get_balance_factor(AVLNode *node);
 AVLNode *rotate_right(AVLNode *y);
 AVLNode *rotate_left(AVLNode *x);
 AVLNode *balance_avl(AVLNode *node);
 
 // --- AVL Tree Traversal ---
-void inorder_traversal(AVLNode *node);
+void avl_inorder_traversal(AVLNode *node);
 void traverse_tree(AVL *tree);
-void free_avl(AVLNode *node, void (*free_key)(void *));
+void free_avl(AVLNode *node, void (*free_key)(void *)); // free_key may be NULL for inline keys
 
 #endif
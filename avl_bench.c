@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Count every allocation made by the AVL code compiled into this file
+static size_t allocation_count = 0;
+
+static void *counted_malloc(size_t size)
+{
+    allocation_count++;
+    return malloc(size);
+}
+
+static void *counted_calloc(size_t count, size_t size)
+{
+    allocation_count++;
+    return calloc(count, size);
+}
+
+static void *counted_realloc(void *ptr, size_t size)
+{
+    allocation_count++;
+    return realloc(ptr, size);
+}
+
+#define malloc counted_malloc
+#define calloc counted_calloc
+#define realloc counted_realloc
+#include "avl_api.h"
+#include "avl_api.c"
+#undef malloc
+#undef calloc
+#undef realloc
+
+#define DEFAULT_KEYS 200000
+
+int compare_ints(void *a, void *b)
+{
+    int x = *(int *)a, y = *(int *)b;
+    return (x > y) - (x < y);
+}
+
+void *copy_int_key(void *key, size_t size)
+{
+    int *new_key = (int *)counted_malloc(size);
+    if (new_key)
+        *new_key = *(int *)key;
+    return new_key;
+}
+
+void free_int_key(void *key)
+{
+    free(key);
+}
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void shuffle(int *keys, int count)
+{
+    for (int i = count - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        int temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+}
+
+// values[k] is the payload stored under key k, so it survives shuffling the keys
+static int *values;
+
+static void run(const char *label, AVL *tree, int *keys, int count)
+{
+    struct timespec start, end;
+
+    allocation_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        add_to_avl(tree, &keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-12s insert: %8.2f ms, %.2f allocations/op\n", label,
+           elapsed_ms(start, end), (double)allocation_count / count);
+
+    // Delete in a different order so plenty of two-child deletions happen
+    shuffle(keys, count);
+    allocation_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        remove_from_avl(tree, &keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-12s delete: %8.2f ms, %.2f allocations/op (tree size now %d)\n", label,
+           elapsed_ms(start, end), (double)allocation_count / count, get_avl_size(tree));
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYS;
+    int *keys = (int *)malloc(sizeof(int) * count);
+    values = (int *)malloc(sizeof(int) * count);
+    if (!keys || !values)
+        return 1;
+
+    srand(42);
+    for (int i = 0; i < count; i++)
+        keys[i] = values[i] = i;
+    shuffle(keys, count);
+
+    AVL *copying = create_avl(compare_ints, copy_int_key, free_int_key, count);
+    run("copy keys", copying, keys, count);
+    free_avl(copying->root, free_int_key);
+    free(copying);
+
+#ifdef AVL_INLINE_KEY_BYTES
+    shuffle(keys, count);
+    AVL *inlined = create_avl_inline(compare_ints, sizeof(int), count);
+    run("inline keys", inlined, keys, count);
+    free_avl(inlined->root, NULL);
+    free(inlined);
+#endif
+
+    free(keys);
+    free(values);
+    return 0;
+}
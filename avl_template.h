@@ -0,0 +1,503 @@
+#ifndef AVL_TEMPLATE_H
+#define AVL_TEMPLATE_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "avl_api.h"
+
+// --- Compile-Time Specialised AVL Tree ---
+//
+// AVL_DEFINE(name, key_t, cmp_expr) generates a tree type `name` whose keys are
+// stored by value and compared with cmp_expr, an expression over the two keys
+// `a` and `b` that yields <0, 0 or >0. The comparison is inlined and evaluated
+// once per level. Each node keeps an AVLValueList, like the generic AVL, and
+// counts the keys in its subtree, so a key's rank and the key at a rank are
+// both found in O(log n).
+//
+//     AVL_DEFINE(priority_avl, int, (a > b) - (a < b))
+//
+//     priority_avl tree;
+//     priority_avl_init(&tree);
+//     priority_avl_insert(&tree, 3, task);
+//     for (priority_avl_node *n = priority_avl_first(&tree); n; n = priority_avl_next(n)) ...
+
+#define AVL_DEFINE(name, key_t, cmp_expr)                                                     \
+                                                                                              \
+    typedef struct name##_node                                                                \
+    {                                                                                         \
+        key_t key;                                                                            \
+        AVLValueList list; /* Values stored under this key, in insertion order */            \
+        struct name##_node *left, *right;                                                     \
+        struct name##_node *parent;                                                           \
+        int height;                                                                           \
+        int count; /* Keys in this subtree, for rank and select */                            \
+    } name##_node;                                                                            \
+                                                                                              \
+    typedef struct name                                                                       \
+    {                                                                                         \
+        name##_node *root;                                                                    \
+        int size; /* Number of distinct keys */                                               \
+        unsigned long version; /* Bumped by every change, so cached views know */             \
+    } name;                                                                                   \
+                                                                                              \
+    static inline int name##_compare(key_t a, key_t b)                                        \
+    {                                                                                         \
+        return (cmp_expr);                                                                    \
+    }                                                                                         \
+                                                                                              \
+    static inline void name##_init(name *tree)                                                \
+    {                                                                                         \
+        tree->root = NULL;                                                                    \
+        tree->size = 0;                                                                       \
+        tree->version = 0;                                                                    \
+    }                                                                                         \
+                                                                                              \
+    static inline int name##_height(name##_node *node)                                        \
+    {                                                                                         \
+        return node ? node->height : 0;                                                       \
+    }                                                                                         \
+                                                                                              \
+    static inline int name##_count(name##_node *node)                                         \
+    {                                                                                         \
+        return node ? node->count : 0;                                                        \
+    }                                                                                         \
+                                                                                              \
+    static inline void name##_update(name##_node *node)                                       \
+    {                                                                                         \
+        int hl = name##_height(node->left), hr = name##_height(node->right);                  \
+        node->height = 1 + (hl > hr ? hl : hr);                                               \
+        node->count = 1 + name##_count(node->left) + name##_count(node->right);               \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_rotate_left(name##_node *x)                             \
+    {                                                                                         \
+        name##_node *y = x->right;                                                            \
+        x->right = y->left;                                                                   \
+        if (y->left)                                                                          \
+            y->left->parent = x;                                                              \
+        y->left = x;                                                                          \
+        y->parent = x->parent;                                                                \
+        x->parent = y;                                                                        \
+        name##_update(x);                                                                     \
+        name##_update(y);                                                                     \
+        return y;                                                                             \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_rotate_right(name##_node *y)                            \
+    {                                                                                         \
+        name##_node *x = y->left;                                                             \
+        y->left = x->right;                                                                   \
+        if (x->right)                                                                         \
+            x->right->parent = y;                                                             \
+        x->right = y;                                                                         \
+        x->parent = y->parent;                                                                \
+        y->parent = x;                                                                        \
+        name##_update(y);                                                                     \
+        name##_update(x);                                                                     \
+        return x;                                                                             \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_balance(name##_node *node)                              \
+    {                                                                                         \
+        name##_update(node);                                                                  \
+        int balance = name##_height(node->left) - name##_height(node->right);                 \
+        if (balance > 1)                                                                      \
+        {                                                                                     \
+            if (name##_height(node->left->left) < name##_height(node->left->right))           \
+                node->left = name##_rotate_left(node->left);                                  \
+            return name##_rotate_right(node);                                                 \
+        }                                                                                     \
+        if (balance < -1)                                                                     \
+        {                                                                                     \
+            if (name##_height(node->right->right) < name##_height(node->right->left))         \
+                node->right = name##_rotate_right(node->right);                               \
+            return name##_rotate_left(node);                                                  \
+        }                                                                                     \
+        return node;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_find(name *tree, key_t key)                             \
+    {                                                                                         \
+        name##_node *node = tree->root;                                                       \
+        while (node)                                                                          \
+        {                                                                                     \
+            int c = name##_compare(key, node->key);                                           \
+            if (c == 0)                                                                       \
+                return node;                                                                  \
+            node = c < 0 ? node->left : node->right;                                          \
+        }                                                                                     \
+        return NULL;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    /* First node whose key is >= key, or NULL */                                             \
+    static inline name##_node *name##_lower_bound(name *tree, key_t key)                      \
+    {                                                                                         \
+        name##_node *node = tree->root, *best = NULL;                                         \
+        while (node)                                                                          \
+        {                                                                                     \
+            if (name##_compare(node->key, key) >= 0)                                          \
+            {                                                                                 \
+                best = node;                                                                  \
+                node = node->left;                                                            \
+            }                                                                                 \
+            else                                                                              \
+            {                                                                                 \
+                node = node->right;                                                           \
+            }                                                                                 \
+        }                                                                                     \
+        return best;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_first(name *tree)                                       \
+    {                                                                                         \
+        name##_node *node = tree->root;                                                       \
+        while (node && node->left)                                                            \
+            node = node->left;                                                                \
+        return node;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_last(name *tree)                                        \
+    {                                                                                         \
+        name##_node *node = tree->root;                                                       \
+        while (node && node->right)                                                           \
+            node = node->right;                                                               \
+        return node;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    /* Node holding the rank-th smallest key (from 0), or NULL; O(log n) */                   \
+    static inline name##_node *name##_select(name *tree, int rank)                            \
+    {                                                                                         \
+        name##_node *node = tree->root;                                                       \
+        while (node)                                                                          \
+        {                                                                                     \
+            int left = name##_count(node->left);                                              \
+            if (rank == left)                                                                 \
+                return node;                                                                  \
+            if (rank < left)                                                                  \
+            {                                                                                 \
+                node = node->left;                                                            \
+            }                                                                                 \
+            else                                                                              \
+            {                                                                                 \
+                rank -= left + 1;                                                             \
+                node = node->right;                                                           \
+            }                                                                                 \
+        }                                                                                     \
+        return NULL;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    /* Number of keys below key, which is the rank key has or would have */                   \
+    static inline int name##_rank(name *tree, key_t key)                                      \
+    {                                                                                         \
+        name##_node *node = tree->root;                                                       \
+        int rank = 0;                                                                         \
+        while (node)                                                                          \
+        {                                                                                     \
+            if (name##_compare(node->key, key) < 0)                                           \
+            {                                                                                 \
+                rank += name##_count(node->left) + 1;                                         \
+                node = node->right;                                                           \
+            }                                                                                 \
+            else                                                                              \
+            {                                                                                 \
+                node = node->left;                                                            \
+            }                                                                                 \
+        }                                                                                     \
+        return rank;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_next(name##_node *node)                                 \
+    {                                                                                         \
+        if (node->right)                                                                      \
+        {                                                                                     \
+            node = node->right;                                                               \
+            while (node->left)                                                                \
+                node = node->left;                                                            \
+            return node;                                                                      \
+        }                                                                                     \
+        while (node->parent && node == node->parent->right)                                   \
+            node = node->parent;                                                              \
+        return node->parent;                                                                  \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_prev(name##_node *node)                                 \
+    {                                                                                         \
+        if (node->left)                                                                       \
+        {                                                                                     \
+            node = node->left;                                                                \
+            while (node->right)                                                               \
+                node = node->right;                                                           \
+            return node;                                                                      \
+        }                                                                                     \
+        while (node->parent && node == node->parent->left)                                    \
+            node = node->parent;                                                              \
+        return node->parent;                                                                  \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_insert_at(name *tree, name##_node *node, key_t key,     \
+                                                void *value, bool *ok)                        \
+    {                                                                                         \
+        if (!node)                                                                            \
+        {                                                                                     \
+            node = (name##_node *)malloc(sizeof(name##_node));                                \
+            if (!node || !init_value_list(&node->list, 2) || !add_value_to_list(&node->list, value)) \
+            {                                                                                 \
+                if (node)                                                                     \
+                    release_value_list(&node->list);                                          \
+                free(node);                                                                   \
+                *ok = false;                                                                  \
+                return NULL;                                                                  \
+            }                                                                                 \
+            node->key = key;                                                                  \
+            node->left = node->right = node->parent = NULL;                                   \
+            node->height = 1;                                                                 \
+            node->count = 1;                                                                  \
+            tree->size++;                                                                     \
+            *ok = true;                                                                       \
+            return node;                                                                      \
+        }                                                                                     \
+        int c = name##_compare(key, node->key);                                               \
+        if (c == 0)                                                                           \
+        {                                                                                     \
+            *ok = add_value_to_list(&node->list, value);                                      \
+            return node;                                                                      \
+        }                                                                                     \
+        if (c < 0)                                                                            \
+        {                                                                                     \
+            name##_node *child = name##_insert_at(tree, node->left, key, value, ok);          \
+            if (!child)                                                                       \
+                return node;                                                                  \
+            node->left = child;                                                               \
+            child->parent = node;                                                             \
+        }                                                                                     \
+        else                                                                                  \
+        {                                                                                     \
+            name##_node *child = name##_insert_at(tree, node->right, key, value, ok);         \
+            if (!child)                                                                       \
+                return node;                                                                  \
+            node->right = child;                                                              \
+            child->parent = node;                                                             \
+        }                                                                                     \
+        return name##_balance(node);                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline bool name##_insert(name *tree, key_t key, void *value)                      \
+    {                                                                                         \
+        bool ok = false;                                                                      \
+        name##_node *root = name##_insert_at(tree, tree->root, key, value, &ok);              \
+        if (root)                                                                             \
+        {                                                                                     \
+            tree->root = root;                                                                \
+            root->parent = NULL;                                                              \
+        }                                                                                     \
+        tree->version++;                                                                      \
+        return ok;                                                                            \
+    }                                                                                         \
+                                                                                              \
+    /* Unlinks the leftmost node of a subtree, rebalancing on the way back up */              \
+    static inline name##_node *name##_detach_min(name##_node **node)                          \
+    {                                                                                         \
+        if (!(*node)->left)                                                                   \
+        {                                                                                     \
+            name##_node *min = *node;                                                         \
+            *node = min->right;                                                               \
+            if (*node)                                                                        \
+                (*node)->parent = min->parent;                                                \
+            return min;                                                                       \
+        }                                                                                     \
+        name##_node *min = name##_detach_min(&(*node)->left);                                 \
+        *node = name##_balance(*node);                                                        \
+        return min;                                                                           \
+    }                                                                                         \
+                                                                                              \
+    static inline bool name##_remove_at(name *tree, name##_node **node, key_t key, void *value) \
+    {                                                                                         \
+        if (!*node)                                                                           \
+            return false;                                                                     \
+        int c = name##_compare(key, (*node)->key);                                            \
+        if (c < 0)                                                                            \
+        {                                                                                     \
+            if (!name##_remove_at(tree, &(*node)->left, key, value))                          \
+                return false;                                                                 \
+        }                                                                                     \
+        else if (c > 0)                                                                       \
+        {                                                                                     \
+            if (!name##_remove_at(tree, &(*node)->right, key, value))                         \
+                return false;                                                                 \
+        }                                                                                     \
+        else                                                                                  \
+        {                                                                                     \
+            if (!remove_value_from_list(&(*node)->list, value))                               \
+                return false;                                                                 \
+            if ((*node)->list.size > 0)                                                       \
+                return true;                                                                  \
+                                                                                              \
+            name##_node *target = *node;                                                      \
+            if (!target->left || !target->right)                                              \
+            {                                                                                 \
+                *node = target->left ? target->left : target->right;                          \
+                if (*node)                                                                    \
+                    (*node)->parent = target->parent;                                         \
+            }                                                                                 \
+            else                                                                              \
+            {                                                                                 \
+                name##_node *successor = name##_detach_min(&target->right);                   \
+                successor->left = target->left;                                               \
+                successor->right = target->right;                                             \
+                successor->parent = target->parent;                                           \
+                successor->left->parent = successor;                                          \
+                if (successor->right)                                                         \
+                    successor->right->parent = successor;                                     \
+                *node = successor;                                                            \
+            }                                                                                 \
+            release_value_list(&target->list);                                                \
+            free(target);                                                                     \
+            tree->size--;                                                                     \
+        }                                                                                     \
+        if (*node)                                                                            \
+        {                                                                                     \
+            name##_node *parent = (*node)->parent;                                            \
+            *node = name##_balance(*node);                                                    \
+            (*node)->parent = parent;                                                         \
+        }                                                                                     \
+        return true;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    static inline bool name##_remove(name *tree, key_t key, void *value)                      \
+    {                                                                                         \
+        tree->version++;                                                                      \
+        return name##_remove_at(tree, &tree->root, key, value);                               \
+    }                                                                                         \
+                                                                                              \
+    static inline void name##_free_nodes(name##_node *node)                                   \
+    {                                                                                         \
+        while (node)                                                                          \
+        {                                                                                     \
+            name##_free_nodes(node->left);                                                    \
+            name##_node *right = node->right;                                                 \
+            release_value_list(&node->list);                                                  \
+            free(node);                                                                       \
+            node = right;                                                                     \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static inline void name##_free(name *tree)                                                \
+    {                                                                                         \
+        name##_free_nodes(tree->root);                                                        \
+        tree->root = NULL;                                                                    \
+        tree->size = 0;                                                                       \
+        tree->version++;                                                                      \
+    }                                                                                         \
+                                                                                              \
+    static inline name##_node *name##_build_range(name *tree, const key_t *keys,              \
+                                                  void *const *values, int low, int high,     \
+                                                  name##_node *parent, bool *ok)              \
+    {                                                                                         \
+        if (low > high || !*ok)                                                               \
+            return NULL;                                                                      \
+        int middle = low + (high - low) / 2;                                                  \
+        name##_node *node = (name##_node *)malloc(sizeof(name##_node));                       \
+        if (!node || !init_value_list(&node->list, 2) ||                                      \
+            !add_value_to_list(&node->list, values[middle]))                                  \
+        {                                                                                     \
+            if (node)                                                                         \
+                release_value_list(&node->list);                                              \
+            free(node);                                                                       \
+            *ok = false;                                                                      \
+            return NULL;                                                                      \
+        }                                                                                     \
+        node->key = keys[middle];                                                             \
+        node->parent = parent;                                                                \
+        node->left = name##_build_range(tree, keys, values, low, middle - 1, node, ok);       \
+        node->right = name##_build_range(tree, keys, values, middle + 1, high, node, ok);     \
+        name##_update(node);                                                                  \
+        tree->size++;                                                                         \
+        return node;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    /* Builds a balanced tree in O(n) from strictly ascending keys; the tree must be empty */ \
+    static inline bool name##_build_sorted(name *tree, const key_t *keys, void *const *values, \
+                                           int count)                                         \
+    {                                                                                         \
+        if (tree->root)                                                                       \
+            return false;                                                                     \
+        bool ok = true;                                                                       \
+        tree->root = name##_build_range(tree, keys, values, 0, count - 1, NULL, &ok);         \
+        tree->version++;                                                                      \
+        if (!ok)                                                                              \
+            name##_free(tree);                                                                \
+        return ok;                                                                            \
+    }                                                                                         \
+                                                                                              \
+    /* Joins left, node and right, whose keys ascend in that order, into one tree */          \
+    static inline name##_node *name##_join(name##_node *left, name##_node *node,              \
+                                           name##_node *right)                                \
+    {                                                                                         \
+        int hl = name##_height(left), hr = name##_height(right);                              \
+        if (hl > hr + 1)                                                                      \
+        {                                                                                     \
+            left->right = name##_join(left->right, node, right);                              \
+            left->right->parent = left;                                                       \
+            return name##_balance(left);                                                      \
+        }                                                                                     \
+        if (hr > hl + 1)                                                                      \
+        {                                                                                     \
+            right->left = name##_join(left, node, right->left);                               \
+            right->left->parent = right;                                                      \
+            return name##_balance(right);                                                     \
+        }                                                                                     \
+        node->left = left;                                                                    \
+        node->right = right;                                                                  \
+        if (left)                                                                             \
+            left->parent = node;                                                              \
+        if (right)                                                                            \
+            right->parent = node;                                                             \
+        name##_update(node);                                                                  \
+        return node;                                                                          \
+    }                                                                                         \
+                                                                                              \
+    /* Splits keys[low..high] around the node's key and merges each side into its subtree */  \
+    static inline name##_node *name##_merge_at(name *tree, name##_node *node, const key_t *keys, \
+                                               void *const *values, int low, int high, bool *ok) \
+    {                                                                                         \
+        if (low > high)                                                                       \
+            return node;                                                                      \
+        if (!node)                                                                            \
+            return name##_build_range(tree, keys, values, low, high, NULL, ok);               \
+        int first = low, last = high + 1;                                                     \
+        while (first < last)                                                                  \
+        {                                                                                     \
+            int middle = first + (last - first) / 2;                                          \
+            if (name##_compare(keys[middle], node->key) < 0)                                  \
+                first = middle + 1;                                                           \
+            else                                                                              \
+                last = middle;                                                                \
+        }                                                                                     \
+        int after = first;                                                                    \
+        if (first <= high && name##_compare(keys[first], node->key) == 0)                     \
+        {                                                                                     \
+            if (!add_value_to_list(&node->list, values[first]))                               \
+                *ok = false;                                                                  \
+            after++;                                                                          \
+        }                                                                                     \
+        name##_node *left = name##_merge_at(tree, node->left, keys, values, low, first - 1, ok); \
+        name##_node *right = name##_merge_at(tree, node->right, keys, values, after, high, ok); \
+        return name##_join(left, node, right);                                                \
+    }                                                                                         \
+                                                                                              \
+    /* Adds strictly ascending keys to a tree that may already hold others, in                \
+       O(k log(n/k + 1)) for k keys into n. A key already present gains the value. On         \
+       failure the keys merged so far stay and the tree stays ordered, though it may          \
+       no longer be balanced. */                                                              \
+    static inline bool name##_merge_sorted(name *tree, const key_t *keys, void *const *values, \
+                                           int count)                                         \
+    {                                                                                         \
+        bool ok = true;                                                                       \
+        tree->root = name##_merge_at(tree, tree->root, keys, values, 0, count - 1, &ok);      \
+        if (tree->root)                                                                       \
+            tree->root->parent = NULL;                                                        \
+        tree->version++;                                                                      \
+        return ok;                                                                            \
+    }
+
+#endif // AVL_TEMPLATE_H
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include "avl_api.h"
+#include "avl_api.c"
+#include "avl_template.h"
+
+#define DEFAULT_KEYS 1000000
+
+AVL_DEFINE(int_avl, int, (a > b) - (a < b))
+
+int compare_ints(void *a, void *b)
+{
+    int x = *(int *)a, y = *(int *)b;
+    return (x > y) - (x < y);
+}
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void shuffle(int *keys, int count)
+{
+    for (int i = count - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        int temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+}
+
+// Order, parent links, heights, counts and balance of a subtree; returns its node count or -1
+static int check_subtree(int_avl_node *node, int_avl_node *parent, long low, long high)
+{
+    if (!node)
+        return 0;
+    if (node->parent != parent || node->key <= low || node->key >= high)
+        return -1;
+    int left = check_subtree(node->left, node, low, node->key);
+    int right = check_subtree(node->right, node, node->key, high);
+    int hl = int_avl_height(node->left), hr = int_avl_height(node->right);
+    if (left < 0 || right < 0 || hl - hr > 1 || hr - hl > 1 || node->height != 1 + (hl > hr ? hl : hr) ||
+        node->count != left + right + 1)
+        return -1;
+    return node->count;
+}
+
+// Sorted batches merged into a tree of even keys, against inserting them one at a time
+static void merge_batches(int count, int *values)
+{
+    int batch_size = count / 64 > 0 ? count / 64 : 1;
+    int *batch = (int *)malloc(sizeof(int) * batch_size);
+    void **batch_values = (void **)malloc(sizeof(void *) * batch_size);
+    if (!batch || !batch_values)
+        return;
+
+    const char *names[] = {"spread", "clustered"};
+    for (int clustered = 0; clustered < 2; clustered++)
+    {
+        int_avl merged, inserted;
+        int_avl_init(&merged);
+        int_avl_init(&inserted);
+        for (int key = 0; key < count; key += 2)
+        {
+            int_avl_insert(&merged, key, &values[key]);
+            int_avl_insert(&inserted, key, &values[key]);
+        }
+
+        // Odd keys: every (count / batch_size)th one, or one run from the middle
+        int stride = clustered ? 1 : count / batch_size / 2 * 2 + 1;
+        int first = clustered ? count / 2 + 1 : 1;
+        int taken = 0;
+        for (int key = first; taken < batch_size && key < count; key += clustered ? 2 : stride)
+        {
+            batch[taken] = key;
+            batch_values[taken++] = &values[key];
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool ok = int_avl_merge_sorted(&merged, batch, batch_values, taken);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double merge_ms = elapsed_ms(start, end);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < taken; i++)
+            int_avl_insert(&inserted, batch[i], batch_values[i]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double insert_ms = elapsed_ms(start, end);
+
+        ok = ok && check_subtree(merged.root, NULL, -1, (long)count + 1) == merged.size &&
+             merged.size == inserted.size;
+        printf("%-16s %d keys into %d: merge %.2f ms, one by one %.2f ms, tree %s\n", names[clustered], taken,
+               (count + 1) / 2, merge_ms, insert_ms, ok ? "valid" : "INVALID");
+        int_avl_free(&merged);
+        int_avl_free(&inserted);
+    }
+    free(batch);
+    free(batch_values);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYS;
+    int *keys = (int *)malloc(sizeof(int) * count);
+    int *values = (int *)malloc(sizeof(int) * count);
+    if (!keys || !values)
+        return 1;
+
+    srand(7);
+    for (int i = 0; i < count; i++)
+        keys[i] = values[i] = i;
+    shuffle(keys, count);
+
+    struct timespec start, end;
+    long found = 0;
+
+    // --- Function-pointer AVL (inline keys, cmp through tree->cmp) ---
+    AVL *generic = create_avl_inline(compare_ints, sizeof(int), count);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        add_to_avl(generic, &keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double generic_insert = elapsed_ms(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        found += find_avl(generic, generic->root, &values[i]) != NULL;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double generic_find = elapsed_ms(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        remove_from_avl(generic, &keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double generic_remove = elapsed_ms(start, end);
+
+    free_avl(generic->root, NULL);
+    free(generic);
+
+    // --- Macro-generated AVL ---
+    int_avl tree;
+    int_avl_init(&tree);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        int_avl_insert(&tree, keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double template_insert = elapsed_ms(start, end);
+
+    int ordered = 1, previous = -1, visited = 0;
+    for (int_avl_node *node = int_avl_first(&tree); node; node = int_avl_next(node), visited++)
+    {
+        if (node->key <= previous)
+            ordered = 0;
+        previous = node->key;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        found += int_avl_find(&tree, values[i]) != NULL;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double template_find = elapsed_ms(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        int_avl_remove(&tree, keys[i], &values[keys[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double template_remove = elapsed_ms(start, end);
+
+    printf("%d keys, %ld found, in-order walk %s (%d nodes), %d left after removal\n",
+           count, found, ordered ? "sorted" : "UNSORTED", visited, tree.size);
+    printf("%-16s %10s %10s %10s\n", "", "insert ms", "find ms", "remove ms");
+    printf("%-16s %10.2f %10.2f %10.2f\n", "function ptr", generic_insert, generic_find, generic_remove);
+    printf("%-16s %10.2f %10.2f %10.2f\n", "AVL_DEFINE", template_insert, template_find, template_remove);
+
+    int_avl_free(&tree);
+    merge_batches(count, values);
+    free(keys);
+    free(values);
+    return 0;
+}
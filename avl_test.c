@@ -30,9 +30,11 @@ int main() {
 
     // Insert elements
     int keys[] = {10, 20, 5, 6, 15, 30, 25};
+    int *values[7];
     for (int i = 0; i < 7; i++) {
         int *value = (int *)malloc(sizeof(int));
         *value = keys[i] * 10; // Just an example value
+        values[i] = value;
         if (!add_to_avl(tree, &keys[i], value)) {
             printf("Failed to insert key %d into AVL tree.\n", keys[i]);
         }
@@ -43,13 +45,13 @@ int main() {
     traverse_tree(tree);
     printf("\n");
 
-    // Remove a value (remove key 20)
+    // Remove a value (remove key 20); values are matched by pointer
     int key_to_remove = 20;
-    int value_to_remove = 200;
-    if (remove_from_avl(tree, &key_to_remove, &value_to_remove)) {
-        printf("Removed value %d from key %d.\n", value_to_remove, key_to_remove);
+    int *value_to_remove = values[1];
+    if (remove_from_avl(tree, &key_to_remove, value_to_remove)) {
+        printf("Removed value %d from key %d.\n", *value_to_remove, key_to_remove);
     } else {
-        printf("Failed to remove value %d from key %d.\n", value_to_remove, key_to_remove);
+        printf("Failed to remove value %d from key %d.\n", *value_to_remove, key_to_remove);
     }
 
     // Display in-order traversal after deletion
@@ -57,9 +59,37 @@ int main() {
     traverse_tree(tree);
     printf("\n");
 
+    // Many values under one key: removal goes through the value index
+    int shared_key = 15;
+    int shared_values[100];
+    for (int i = 0; i < 100; i++) {
+        shared_values[i] = i;
+        add_to_avl(tree, &shared_key, &shared_values[i]);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        remove_from_avl(tree, &shared_key, &shared_values[i]);
+    }
+
+    AVLNode *shared = find_avl(tree, tree->root, &shared_key);
+    int expected = 1, in_order = 1;
+    for (size_t slot = next_value_slot(shared->list, 0); slot < shared->list->used;
+         slot = next_value_slot(shared->list, slot + 1)) {
+        int *value = (int *)shared->list->values[slot];
+        if (value == values[4])
+            continue;
+        if (*value != expected)
+            in_order = 0;
+        expected += (expected % 3 == 2) ? 2 : 1;
+    }
+    printf("Key %d holds %zu values, insertion order kept: %s\n",
+           shared_key, shared->list->size, in_order ? "yes" : "no");
+
     // Cleanup memory
     free_avl(tree->root, free_int_key);
     free(tree);
+    for (int i = 0; i < 7; i++) {
+        free(values[i]);
+    }
 
     return 0;
 }
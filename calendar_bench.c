@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_APPOINTMENTS 1000000
+#define TASKS_PER_APPOINTMENT 10     // One task for every ten appointments
+#define CALENDAR_YEAR 26             // 2026
+#define REPEATS 5
+
+// What a month view needs: the items of each day, in the order they were added
+typedef struct MonthView {
+    int days;
+    uint32_t task_count[CALENDAR_DAYS];
+    uint32_t appointment_count[CALENDAR_DAYS];
+    Task **tasks[CALENDAR_DAYS];
+    Appointment **appointments[CALENDAR_DAYS];
+} MonthView;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// The old way: walk both lists and gather the month's items into per-day scratch arrays
+static void build_from_lists(const Calendar *calendar, MonthsInAYear month, MonthView *view, Task **task_scratch,
+                             Appointment **appointment_scratch, int scratch_per_day)
+{
+    view->days = days_in_month(CALENDAR_BASE_YEAR + calendar->year, month);
+    for (int day = 0; day < view->days; day++)
+    {
+        view->task_count[day] = view->appointment_count[day] = 0;
+        view->tasks[day] = task_scratch + (size_t)day * scratch_per_day;
+        view->appointments[day] = appointment_scratch + (size_t)day * scratch_per_day;
+    }
+
+    for (Node *node = calendar->tasks->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        if (task->month == month && task->date > 0 && task->date <= view->days)
+            view->tasks[task->date - 1][view->task_count[task->date - 1]++] = task;
+    }
+    for (Node *node = calendar->appointments->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        int day = appointment->date - 1;
+        if (appointment->month == month && day >= 0 && day < view->days)
+            view->appointments[day][view->appointment_count[day]++] = appointment;
+    }
+}
+
+// The index: one bucket read per day
+static void build_from_index(const Calendar *calendar, MonthsInAYear month, MonthView *view)
+{
+    const CalendarDay *days[CALENDAR_DAYS];
+    view->days = calendar_month_view(calendar->days, CALENDAR_BASE_YEAR + calendar->year, month, days);
+    for (int day = 0; day < view->days; day++)
+    {
+        view->task_count[day] = days[day] ? days[day]->task_count : 0;
+        view->appointment_count[day] = days[day] ? days[day]->appointment_count : 0;
+        view->tasks[day] = days[day] ? days[day]->tasks : NULL;
+        view->appointments[day] = days[day] ? days[day]->appointments : NULL;
+    }
+}
+
+static bool same_view(const MonthView *a, const MonthView *b)
+{
+    if (a->days != b->days)
+        return false;
+    for (int day = 0; day < a->days; day++)
+    {
+        // An empty day may have no bucket to compare
+        if (a->task_count[day] != b->task_count[day] || a->appointment_count[day] != b->appointment_count[day] ||
+            (a->task_count[day] && memcmp(a->tasks[day], b->tasks[day], sizeof(Task *) * a->task_count[day])) ||
+            (a->appointment_count[day] &&
+             memcmp(a->appointments[day], b->appointments[day], sizeof(Appointment *) * a->appointment_count[day])))
+            return false;
+    }
+    return true;
+}
+
+static bool day_holds(const Calendar *calendar, MonthsInAYear month, int date, const void *item)
+{
+    const CalendarDay *day = calendar_day(calendar->days, CALENDAR_BASE_YEAR + calendar->year, month, date);
+    for (uint32_t i = 0; day && i < day->task_count; i++)
+        if (day->tasks[i] == item)
+            return true;
+    for (uint32_t i = 0; day && i < day->appointment_count; i++)
+        if (day->appointments[i] == item)
+            return true;
+    return false;
+}
+
+// Moving and deleting items through the manager keeps the day index in step
+static bool refiles(TaskManager *manager, Calendar *calendar)
+{
+    Task *task = find_task(manager, 1);
+    Appointment *appointment = find_appointment(manager, 1);
+    MonthsInAYear task_month = task->month, appointment_month = appointment->month;
+    int task_date = task->date, appointment_date = appointment->date;
+    uint64_t tasks = calendar->days->tasks, appointments = calendar->days->appointments;
+
+    bool ok = reschedule_task_in_calendar(manager, calendar, 1, (MonthsInAYear)((task_month + 1) % 12), 3,
+                                          task->time) &&
+              reschedule_appointment_in_calendar(manager, calendar, 1, (MonthsInAYear)((appointment_month + 1) % 12),
+                                                 3, appointment->time) &&
+              !day_holds(calendar, task_month, task_date, task) && day_holds(calendar, task->month, 3, task) &&
+              !day_holds(calendar, appointment_month, appointment_date, appointment) &&
+              day_holds(calendar, appointment->month, 3, appointment) && calendar->days->tasks == tasks &&
+              calendar->days->appointments == appointments;
+
+    // A refused date leaves the item where it was
+    ok = ok && !reschedule_task_in_calendar(manager, calendar, 1, task->month, 40, task->time) &&
+         day_holds(calendar, task->month, 3, task) &&
+         !reschedule_appointment_in_calendar(manager, calendar, 1, appointment->month, 40, appointment->time) &&
+         appointment->date == 3 && day_holds(calendar, appointment->month, 3, appointment);
+
+    ok = ok && remove_task_from_calendar(manager, calendar, 1) && delete_task(manager, 1) &&
+         remove_appointment_from_calendar(manager, calendar, 1) && delete_appointment(manager, 1) &&
+         calendar->days->tasks == tasks - 1 && calendar->days->appointments == appointments - 1 &&
+         !remove_task_from_calendar(manager, calendar, 2 * (int)tasks + 1);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_APPOINTMENTS;
+    int task_count = count / TASKS_PER_APPOINTMENT;
+    struct timespec start, end;
+
+    TaskManager *manager = create_task_manager();
+    if (!manager)
+        return 1;
+
+    srand(40);
+    for (int id = 1; id <= count; id++)
+    {
+        MonthsInAYear month = (MonthsInAYear)(rand() % 12);
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        add_appointment(manager, id, (char)(1 + rand() % days_in_month(2026, month)), time, month, rand() % 2,
+                        NONE);
+    }
+    for (int id = 1; id <= task_count; id++)
+    {
+        MonthsInAYear month = (MonthsInAYear)(rand() % 12);
+        Time time = {0, 9};
+        add_task(manager, id, "Follow up", 1 + rand() % LOWEST_PRIORITY);
+        set_task_schedule(manager, id, month, (char)(1 + rand() % days_in_month(2026, month)), time);
+    }
+
+    Calendar calendar = {0};
+    calendar.year = CALENDAR_YEAR;
+    bool filed = true;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int id = 1; id <= count; id++)
+        filed = add_appointment_to_calendar(manager, &calendar, id) && filed;
+    for (int id = 1; id <= task_count; id++)
+        filed = add_task_to_calendar(manager, &calendar, id) && filed;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d appointments and %d tasks filed in %.1f ms (%.0f ns/item, list and index)\n", count, task_count,
+           elapsed_ms(start, end), elapsed_ms(start, end) * 1e6 / (count + task_count));
+
+    // Enough scratch per day for the busiest day of any month
+    int scratch_per_day = 0;
+    for (int month = 0; month < CALENDAR_MONTHS; month++)
+    {
+        for (int date = 1; date <= CALENDAR_DAYS; date++)
+        {
+            const CalendarDay *day = calendar_day(calendar.days, CALENDAR_BASE_YEAR + CALENDAR_YEAR,
+                                                  (MonthsInAYear)month, date);
+            if (day && (int)day->appointment_count > scratch_per_day)
+                scratch_per_day = day->appointment_count;
+            if (day && (int)day->task_count > scratch_per_day)
+                scratch_per_day = day->task_count;
+        }
+    }
+    Task **task_scratch = (Task **)malloc(sizeof(Task *) * CALENDAR_DAYS * (scratch_per_day + 1));
+    Appointment **appointment_scratch =
+        (Appointment **)malloc(sizeof(Appointment *) * CALENDAR_DAYS * (scratch_per_day + 1));
+    if (!task_scratch || !appointment_scratch)
+        return 1;
+
+    MonthView walked, indexed;
+    bool same = filed && calendar.days->appointments == (uint64_t)count && calendar.days->tasks == (uint64_t)task_count;
+    double walk_total = 0, index_total = 0;
+    for (int month = 0; month < CALENDAR_MONTHS; month++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            build_from_lists(&calendar, (MonthsInAYear)month, &walked, task_scratch, appointment_scratch,
+                             scratch_per_day + 1);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        walk_total += elapsed_ms(start, end) / REPEATS;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS * 1000; r++)
+            build_from_index(&calendar, (MonthsInAYear)month, &indexed);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        index_total += elapsed_ms(start, end) / (REPEATS * 1000);
+
+        same = same && same_view(&walked, &indexed);
+    }
+    printf("month view: list walk %.2f ms, day index %.3f us (%.0fx)\n", walk_total / CALENDAR_MONTHS,
+           index_total * 1e3 / CALENDAR_MONTHS, walk_total / index_total);
+
+    printf("Month views match: %s\n", same ? "yes" : "NO");
+    bool moved = refiles(manager, &calendar);
+    printf("Rescheduled and deleted items refiled: %s\n", moved ? "yes" : "NO");
+    same = same && moved;
+    free(task_scratch);
+    free(appointment_scratch);
+    free_calendar(&calendar);
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
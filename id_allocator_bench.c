@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#include "src/id_allocator.c"
+
+#define ID_PATH "id_allocator_bench.ids"
+#define LEGACY_PATH "id_allocator_bench.legacy"
+#define LEGACY_IDS 2000
+#define IDS_PER_THREAD 1000000
+#define MAX_THREADS 8
+#define CRASH_ROUNDS 20
+
+typedef struct Worker {
+    IdAllocator *allocator;
+    int *ids;
+    int count;
+} Worker;
+
+static double elapsed_ns(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// What the old save_last_used_id did: rewrite and sync the file for every id
+static double legacy_ns_per_id(void)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int id = 1; id <= LEGACY_IDS; id++)
+    {
+        int fd = open(LEGACY_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || write(fd, &id, sizeof(id)) != (ssize_t)sizeof(id) || fsync(fd) != 0)
+            return -1;
+        close(fd);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    remove(LEGACY_PATH);
+    return elapsed_ns(start, end) / LEGACY_IDS;
+}
+
+static void *allocate_ids(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    for (int i = 0; i < worker->count; i++)
+        worker->ids[i] = allocate_id(worker->allocator);
+    return NULL;
+}
+
+static int compare_ids(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Every thread gets its own ids; checked by sorting all of them
+static bool run_threads(int threads)
+{
+    remove(ID_PATH);
+    IdAllocator *allocator = open_id_allocator(ID_PATH);
+    int total = threads * IDS_PER_THREAD;
+    int *ids = (int *)malloc(sizeof(int) * total);
+    if (!allocator || !ids)
+        return false;
+
+    pthread_t thread[MAX_THREADS];
+    Worker worker[MAX_THREADS];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < threads; t++)
+    {
+        worker[t] = (Worker){allocator, ids + t * IDS_PER_THREAD, IDS_PER_THREAD};
+        pthread_create(&thread[t], NULL, allocate_ids, &worker[t]);
+    }
+    for (int t = 0; t < threads; t++)
+        pthread_join(thread[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    qsort(ids, total, sizeof(int), compare_ids);
+    bool unique = ids[0] == ID_FIRST;
+    for (int i = 1; unique && i < total; i++)
+        unique = ids[i] == ids[i - 1] + 1;
+
+    printf("%d thread(s): %d ids, %.1f ns/id, %llu syncs, unique and dense: %s\n", threads, total,
+           elapsed_ns(start, end) / total, (unsigned long long)allocator->syncs, unique ? "yes" : "NO");
+
+    // A clean close leaves no gap
+    close_id_allocator(allocator);
+    allocator = open_id_allocator(ID_PATH);
+    int next = allocate_id(allocator);
+    bool resumed = next == ids[total - 1] + 1;
+    if (!resumed)
+        printf("Reopened at %d, expected %d\n", next, ids[total - 1] + 1);
+
+    close_id_allocator(allocator);
+    free(ids);
+    return unique && resumed;
+}
+
+// A child allocates until it is killed, reporting each id through a pipe;
+// after reopening, ids must continue above everything it handed out
+static bool crash_round(int round)
+{
+    int pipes[2];
+    if (pipe(pipes) != 0)
+        return false;
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(pipes[0]);
+        IdAllocator *allocator = open_id_allocator(ID_PATH);
+        for (;;)
+        {
+            int id = allocate_id(allocator);
+            if (write(pipes[1], &id, sizeof(id)) != (ssize_t)sizeof(id))
+                _exit(1);
+        }
+    }
+    close(pipes[1]);
+
+    int id, highest = 0, seen = 0;
+    while (seen < 20000 + round * 1000 && read(pipes[0], &id, sizeof(id)) == (ssize_t)sizeof(id))
+    {
+        highest = id > highest ? id : highest;
+        seen++;
+    }
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    // Ids that were already in the pipe were handed out too
+    while (read(pipes[0], &id, sizeof(id)) == (ssize_t)sizeof(id))
+        highest = id > highest ? id : highest;
+    close(pipes[0]);
+
+    IdAllocator *allocator = open_id_allocator(ID_PATH);
+    int next = allocate_id(allocator);
+    close_id_allocator(allocator);
+    if (next <= highest)
+        printf("Crash round %d: reopened at %d but %d was already handed out\n", round, next, highest);
+    return next > highest;
+}
+
+int main(void)
+{
+    double legacy = legacy_ns_per_id();
+    printf("file write + fsync per id: %.0f ns/id\n", legacy);
+
+    bool ok = true;
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+        ok = run_threads(threads) && ok;
+
+    remove(ID_PATH);
+    bool crash_safe = true;
+    for (int round = 0; round < CRASH_ROUNDS; round++)
+        crash_safe = crash_round(round) && crash_safe;
+    printf("No id reused after %d crashes: %s\n", CRASH_ROUNDS, crash_safe ? "yes" : "NO");
+
+    remove(ID_PATH);
+    return ok && crash_safe ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/import_export.c"
+
+#define DEFAULT_TASKS 200000
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static TaskManager *build(int count)
+{
+    TaskManager *manager = create_task_manager();
+    char description[96];
+
+    srand(11);
+    for (int id = 1; id <= count && manager; id++)
+    {
+        // Every few rows carries text that needs quoting or escaping
+        if (id % 7 == 0)
+            snprintf(description, sizeof(description), "Call \"Sam\", re: invoice %d; then\nfile it", id);
+        else
+            snprintf(description, sizeof(description), "Task %d: follow up on item %d", id, rand() % 1000);
+
+        Task *task = add_task(manager, id, description, 1 + rand() % LOWEST_PRIORITY);
+        Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+        if (id % 3 == 0)
+            set_task_completion(manager, id, true);
+
+        if (id % 10 == 0)
+        {
+            add_subtask(manager, id, "check details, twice", 2);
+            add_subtask(manager, id, "sign off", 4);
+        }
+        if (id % 50 == 0)
+        {
+            Appointment *appointment = add_appointment(manager, id, task->date, due, task->month, true, BI_WEEKLY);
+            add_appointment_note(manager, appointment->id, "Bring the signed form; room 4");
+            link_task_to_appointment(manager, id, id);
+        }
+    }
+    return manager;
+}
+
+static bool same_task(Task *a, Task *b)
+{
+    return a && b && a->id == b->id && a->priority == b->priority && a->is_complete == b->is_complete &&
+           a->month == b->month && a->date == b->date && a->time.hour == b->time.hour &&
+           a->time.minutes == b->time.minutes && strcmp(a->description, b->description) == 0 &&
+           (a->subtasks ? list_size(a->subtasks) : 0) == (b->subtasks ? list_size(b->subtasks) : 0) &&
+           (a->appointment ? a->appointment->id : -1) == (b->appointment ? b->appointment->id : -1);
+}
+
+// The agenda index holds every task once, in key order, and is still balanced
+static bool agenda_sound(TaskManager *manager)
+{
+    int seen = 0, height_bound = 2;
+    uint64_t previous = 0;
+    for (task_order_index_node *node = task_order_index_first(&manager->agenda_index); node;
+         node = task_order_index_next(node), seen++)
+    {
+        if ((seen > 0 && node->key <= previous) || node->key != task_order_key((Task *)node->list.values[0]))
+            return false;
+        previous = node->key;
+    }
+    for (int n = 1; n < seen; n = n * 3 / 2 + 1)
+        height_bound++;          // An AVL tree is under 1.44 log2(n + 2) high
+    return seen == list_size(manager->task_list) &&
+           task_order_index_height(manager->agenda_index.root) <= height_bound;
+}
+
+// A task may name an appointment further on in the file, or one that is not there
+static bool links_resolve(void)
+{
+    const char *path = "import_export_bench_links.csv";
+    FILE *file = fopen(path, "w");
+    if (!file)
+        return false;
+    fputs("kind,id,priority,complete,reminder,recurrence,month,date,hour,minute,link,description,note\n"
+          "task,1,2,0,0,0,3,4,9,30,900,Linked ahead,\n"
+          "task,2,2,0,0,0,3,4,9,30,901,Linked to nothing,\n"
+          "appointment,900,0,0,0,0,3,4,9,30,,,Room 2\n",
+          file);
+    fclose(file);
+
+    TaskManager *manager = create_task_manager();
+    ImportStats stats;
+    bool ok = manager && import_from_file(manager, path, FORMAT_CSV, &stats) && stats.unlinked == 1 &&
+              find_task(manager, 1)->appointment == find_appointment(manager, 900) &&
+              !find_task(manager, 2)->appointment;
+    free_task_manager(manager);
+    remove(path);
+    return ok;
+}
+
+static bool run(TaskManager *source, const char *label, const char *path, ExchangeFormat format)
+{
+    struct timespec start, end;
+    struct stat info;
+    long items = list_size(source->task_list) + list_size(source->appointment_list);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool exported = export_to_file(source, path, format);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double export_ms = elapsed_ms(start, end);
+    double megabytes = stat(path, &info) == 0 ? info.st_size / 1e6 : 0;
+
+    TaskManager *target = create_task_manager();
+    ImportStats stats;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool imported = import_from_file(target, path, format, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double import_ms = elapsed_ms(start, end);
+
+    bool same = exported && imported && stats.rejected == 0 &&
+                list_size(target->task_list) == list_size(source->task_list) &&
+                list_size(target->appointment_list) == list_size(source->appointment_list);
+    for (Node *node = source->task_list->head; same && node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        same = same_task(task, find_task(target, task->id));
+    }
+    same = same && agenda_sound(target);
+
+    // Moving the items into a manager that already has as many of its own
+    int count = list_size(source->task_list), offset = 2 * count;
+    TaskManager *busy = create_task_manager();
+    for (int id = 1; busy && id <= count; id++)
+        add_task(busy, offset + id, "Already here", 1 + id % LOWEST_PRIORITY);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool merged = busy && import_from_file(busy, path, format, &stats);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double merge_ms = elapsed_ms(start, end);
+    same = same && merged && stats.rejected == 0 && list_size(busy->task_list) == 2 * count && agenda_sound(busy);
+
+    printf("%-6s %7.1f MB  export %8.2f ms (%8.0f items/sec)  import %8.2f ms (%8.0f rows/sec)  "
+           "into a full one %8.2f ms  round trip %s\n",
+           label, megabytes, export_ms, items / (export_ms / 1e3), import_ms, stats.rows / (import_ms / 1e3), merge_ms,
+           same ? "ok" : "FAILED");
+
+    free_task_manager(busy);
+    free_task_manager(target);
+    remove(path);
+    return same;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    TaskManager *source = build(count);
+    if (!source)
+        return 1;
+
+    printf("%d tasks, %d appointments\n", list_size(source->task_list), list_size(source->appointment_list));
+    bool ok = run(source, "csv", "import_export_bench.csv", FORMAT_CSV);
+    ok = run(source, "jsonl", "import_export_bench.jsonl", FORMAT_JSONL) && ok;
+    ok = run(source, "ics", "import_export_bench.ics", FORMAT_ICALENDAR) && ok;
+    bool linked = links_resolve();
+    printf("Forward and missing links: %s\n", linked ? "ok" : "FAILED");
+    ok = ok && linked;
+
+    free_task_manager(source);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "persistence.h"   // TaskRecord, SubTaskRecord and the string heap format
+
+// --- Read-Only Task Archive --- //
+//
+// A browse-only copy of a TaskManager's tasks that is used straight from a
+// read-only mapping. Nothing is deserialised: records, indexes and strings are
+// addressed by file offset, so opening is O(1) whatever the size and a query
+// only faults in the pages it touches.
+//
+// [ArchiveHeader][TaskRecord x task_count][SubTaskRecord x subtask_count]
+// [index: ID][index: priority order][index: date order][string heap]
+//
+// Each index is a static B-tree over (key, record) entries sorted by key. The
+// leaf level holds every entry; each level above holds the first key of every
+// ARCHIVE_FANOUT entries of the level below, up to a root of at most
+// ARCHIVE_FANOUT keys. Levels start on a page boundary, so a lookup reads one
+// page per level. Records are stored in priority order, so browsing the
+// agenda reads the record section front to back.
+
+#define ARCHIVE_MAGIC 0x41444F54u // "TODA"
+#define ARCHIVE_VERSION 2
+#define ARCHIVE_FANOUT 256
+#define ARCHIVE_MAX_LEVELS 8
+#define ARCHIVE_PAGE 4096
+
+typedef enum ArchiveOrder {
+    ARCHIVE_BY_ID,
+    ARCHIVE_BY_PRIORITY,  // task_order_key: (completion, priority, due time, id)
+    ARCHIVE_BY_DATE,      // archive_date_key: (month, date, hour, minute, id)
+    ARCHIVE_ORDERS
+} ArchiveOrder;
+
+typedef struct ArchiveEntry {
+    uint64_t key;
+    uint64_t record;      // Index into the TaskRecord section
+} ArchiveEntry;
+
+typedef struct ArchiveIndex {
+    uint32_t levels;                          // Level 0 is the leaf level
+    uint32_t padding;
+    uint64_t offset[ARCHIVE_MAX_LEVELS];      // File offset of each level
+    uint64_t count[ARCHIVE_MAX_LEVELS];       // Entries (leaf) or keys (above) per level
+} ArchiveIndex;
+
+typedef struct ArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t file_size;
+    uint64_t task_count;
+    uint64_t subtask_count;
+    uint64_t tasks_offset;
+    uint64_t subtasks_offset;
+    uint64_t heap_offset;
+    uint64_t heap_size;
+    ArchiveIndex index[ARCHIVE_ORDERS];
+} ArchiveHeader;
+
+typedef struct TaskArchive {
+    const char *base;     // Read-only mapping of the whole file
+    size_t size;
+    const ArchiveHeader *header;
+    const TaskRecord *tasks;
+    const SubTaskRecord *subtasks;
+    const char *heap;
+} TaskArchive;
+
+// --- Writing --- //
+
+// Writes the manager's tasks (only completed ones if completed_only) as an archive
+bool write_archive(TaskManager *manager, const char *filename, bool completed_only);
+
+// --- Browsing --- //
+
+// Maps the file and checks its header; no record is read
+TaskArchive *open_archive(const char *filename);
+void close_archive(TaskArchive *archive);
+
+uint64_t archive_task_count(const TaskArchive *archive);
+
+// Record with the given id, or NULL. Reads one page per index level.
+const TaskRecord *archive_find_task(const TaskArchive *archive, int id);
+
+// Text of a record's description, note or subtask, or NULL for none
+const char *archive_text(const TaskArchive *archive, uint64_t offset);
+
+// Subtask i of a task record, or NULL
+const SubTaskRecord *archive_subtask(const TaskArchive *archive, const TaskRecord *task, uint32_t i);
+
+// Key of a record in the given order; pass key + 1 as low to continue a scan after it
+uint64_t archive_key(ArchiveOrder order, const TaskRecord *record);
+uint64_t archive_date_key(MonthsInAYear month, char date, Time time, int id);
+
+// Records with low <= key < high in the given order, at most max_results of them
+int archive_range(const TaskArchive *archive, ArchiveOrder order, uint64_t low, uint64_t high,
+                  const TaskRecord **out, int max_results);
+
+// Same selection as get_agenda(), over tasks with the given completion state
+int archive_agenda(const TaskArchive *archive, bool is_complete, unsigned int min_priority,
+                   unsigned int max_priority, const TaskRecord **out, int max_results);
+
+// Tasks due on one day, by time
+int archive_day(const TaskArchive *archive, MonthsInAYear month, char date,
+                const TaskRecord **out, int max_results);
+
+#endif // ARCHIVE_H
@@ -0,0 +1,49 @@
+#ifndef BACKGROUND_JOBS_H
+#define BACKGROUND_JOBS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "worker_pool.h"     // Where the jobs run
+#include "task_manager.h"
+#include "wal.h"             // Private copies of the logged state, sync waits
+#include "import_export.h"
+#include "archive.h"
+#include "recurrence.h"
+
+// --- Background Jobs --- //
+//
+// The application's long operations as worker pool jobs. None of them touches
+// the live TaskManager, which belongs to the UI thread: exports and archive
+// rebuilds read a private manager loaded from the snapshot and its logs
+// (wal_load_private), the way compaction does, and recurrence expansion works
+// on a copy of the rules taken when the job is submitted.
+//
+// done runs on the thread that drains the pool, with the job's outcome. For an
+// expansion, result is a RecurrenceExpansion that is freed when done returns;
+// the other jobs pass NULL.
+
+typedef void (*BackgroundDone)(bool ok, void *result, void *context);
+
+typedef struct RecurrenceExpansion {
+    int64_t start;
+    int64_t end;
+    const Occurrence *occurrences;
+    uint32_t count;
+} RecurrenceExpansion;
+
+// Waits for the log to make everything up to sequence durable
+bool background_sync(WorkerPool *pool, Wal *wal, uint64_t sequence, BackgroundDone done, void *context);
+
+// Writes the logged state of the snapshot at snapshot_path to filename
+bool background_export(WorkerPool *pool, const char *snapshot_path, const char *filename, ExchangeFormat format,
+                       BackgroundDone done, void *context);
+
+// Rebuilds the read-only archive and its sorted indexes from the logged state
+bool background_archive(WorkerPool *pool, const char *snapshot_path, const char *filename, bool completed_only,
+                        BackgroundDone done, void *context);
+
+// Expands [start, end) from a copy of engine's rules
+bool background_expand(WorkerPool *pool, const RecurrenceEngine *engine, int64_t start, int64_t end,
+                       BackgroundDone done, void *context);
+
+#endif // BACKGROUND_JOBS_H
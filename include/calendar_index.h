@@ -0,0 +1,74 @@
+#ifndef CALENDAR_INDEX_H
+#define CALENDAR_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "to_do_app.h"
+
+// --- Calendar Day Index --- //
+//
+// Tasks and appointments filed by (year, month, day). Each year is a block of
+// 12 x 31 day buckets found by its offset from the first year held, and each
+// bucket keeps two packed arrays of handles, so filing an item is an append
+// and a month view reads 28-31 buckets without looking at any other day.
+//
+// Handles are borrowed: the index never frees a Task or Appointment, and an
+// item has to be taken out again before it is deleted or rescheduled (the
+// manager's remove_*_from_calendar and reschedule_*_in_calendar do this for a
+// Calendar). Tasks and appointments carry no year of their own, so the caller
+// says which year an item is filed under.
+
+#define CALENDAR_BASE_YEAR 2000     // Calendar.year counts from here
+#define CALENDAR_MONTHS 12
+#define CALENDAR_DAYS 31
+#define CALENDAR_INITIAL_BUCKET 4
+
+typedef struct CalendarDay {
+    uint32_t task_count;
+    uint32_t task_capacity;
+    uint32_t appointment_count;
+    uint32_t appointment_capacity;
+    Task **tasks;                   // In the order they were filed
+    Appointment **appointments;
+} CalendarDay;
+
+typedef struct CalendarYear {
+    CalendarDay days[CALENDAR_MONTHS][CALENDAR_DAYS];
+} CalendarYear;
+
+typedef struct CalendarIndex {
+    int first_year;
+    uint32_t year_count;
+    CalendarYear **years;           // years[y - first_year], NULL for a year with nothing filed
+    uint64_t tasks;                 // Handles held across every bucket
+    uint64_t appointments;
+} CalendarIndex;
+
+// --- Index Lifecycle --- //
+void calendar_index_init(CalendarIndex *index);
+void calendar_index_free(CalendarIndex *index);
+
+// --- Filing --- //
+// Items are filed under their own month and date; an unscheduled item (date 0)
+// is refused.
+
+bool calendar_index_add_task(CalendarIndex *index, int year, Task *task);
+bool calendar_index_add_appointment(CalendarIndex *index, int year, Appointment *appointment);
+
+// Take an item out of the bucket it was filed in; false if it is not there
+bool calendar_index_remove_task(CalendarIndex *index, int year, const Task *task);
+bool calendar_index_remove_appointment(CalendarIndex *index, int year, const Appointment *appointment);
+
+// --- Lookup --- //
+
+// The bucket for one day, or NULL when nothing was ever filed in that year
+const CalendarDay *calendar_day(const CalendarIndex *index, int year, MonthsInAYear month, int date);
+
+int days_in_month(int year, MonthsInAYear month);
+
+// Fills days[0 .. n-1] with the buckets of every day of the month (NULL for
+// a year with nothing filed) and returns n, the number of days in the month
+int calendar_month_view(const CalendarIndex *index, int year, MonthsInAYear month,
+                        const CalendarDay *days[CALENDAR_DAYS]);
+
+#endif // CALENDAR_INDEX_H
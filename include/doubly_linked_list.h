@@ -14,6 +14,9 @@ typedef struct Data
     void* value;
 }Data;
 
+// Pass as capacity to create_list for a list with no size limit
+#define UNBOUNDED_LIST_CAPACITY 0
+
 typedef struct DoublyLinkedList
 {
     Node *head;
@@ -44,6 +47,11 @@ Node *insert_before(DoublyLinkedList *list, Node* next_node, struct Data *data);
 
 Node *delete_by_value(DoublyLinkedList *list, void *target_value);
 
+// O(1) operations on a node the caller already holds
+Node *unlink_node(DoublyLinkedList *list, Node *node); // Detaches without freeing
+Node *relink_after(DoublyLinkedList *list, Node *previous_node, Node *node); // NULL previous = front
+void delete_node(DoublyLinkedList *list, Node *node); // Unlinks, then frees node and data
+
 Node *search_list(DoublyLinkedList *list, void *target_value);
 
 void traverse_forward(DoublyLinkedList *list);
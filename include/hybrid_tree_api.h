@@ -9,13 +9,6 @@ typedef struct HashMapWithTree HashMapWithTree; // Forward declaration
 struct DynamicArray;    // Forward declaration
 // Forward declaration of HashMapWithTree
 
-// Define Red-Black tree colors using enum for better readability
-typedef enum
-{
-    RED,
-    BLACK
-} Color;
-
 // Define direction constants for clarity
 typedef enum
 {
@@ -23,12 +16,11 @@ typedef enum
     RIGHT = 1
 } Direction;
 
-// Hybrid Node structure combining AVL and Red-Black properties
+// Hybrid Node structure: an AVL node that also counts accesses
 typedef struct HybridNode
 {
     void *key;
-    Color color;      // Used for Red-Black balancing
-    int height;       // Used for AVL balancing
+    int height;       // Used for AVL balancing; 0 for a leaf
     int access_count; // Tracks frequent access for AVL optimizations
     void *value;
     struct HybridNode *parent;
@@ -46,6 +38,13 @@ typedef struct HybridTree
 // At the top of hybrid_tree_api.h
 typedef struct DynamicArray DynamicArray;
 
+// A key and its value, as bulk construction takes them
+typedef struct HybridEntry
+{
+    int key;
+    void *value;
+} HybridEntry;
+
 // Core Functions
 HybridTree *create_hybrid_tree();
 void destroy_hybrid_tree(struct HybridTree *tree);
@@ -53,23 +52,22 @@ int void_ptr_to_int(void *ptr);
 void *int_to_void_ptr(int key);
 
 // Insertion and Deletion
-HybridNode *insert_hybrid(HybridTree *tree, HybridNode *node, int key, void *value, Direction dir, bool *fixup_ok);
-HybridNode *delete_hybrid(HybridTree *tree, HybridNode *node, int key, Direction dir, bool *fixup_ok);
+HybridNode *insert_hybrid(HybridTree *tree, HybridNode *node, int key, void *value);
+HybridNode *delete_hybrid(HybridTree *tree, HybridNode *node, int key);
 void insert_hybrid_public(HybridTree *tree, int key, void *value, bool *inserted);
 void delete_from_hybrid_tree(HybridTree *tree, int key);
 void range_query(HybridNode *node, int low, int high, DynamicArray *result);
 
+// Bulk Construction: builds a height-balanced tree into an empty tree in O(n),
+// from entries whose keys are strictly ascending. False if memory runs out,
+// in which case the tree is left empty.
+bool build_hybrid_tree_sorted(HybridTree *tree, const HybridEntry *entries, int count);
+
 // Searching and Access Count Management
 // hybrid_tree_api.h
 HybridNode *search_hybrid(HybridTree *tree, void *key);
 void increment_access_count(HybridNode *node);
 
-HybridNode *rb_insert_fixup(HybridTree *tree, HybridNode *node, Direction dir);
-HybridNode *rb_delete_fixup(HybridTree *tree, HybridNode *node, bool dir, bool *ok);
-HybridNode *rotate(HybridTree *tree, HybridNode *node, Direction dir);
-HybridNode *double_rotate(HybridTree *tree, HybridNode *node, Direction dir);
-void color_flip(HybridNode *node);
-
 // AVL Balancing Functions
 int max(int a, int b);
 void update_height(HybridNode *node);
@@ -82,8 +80,61 @@ HybridNode *rebalance_if_needed(HybridTree *tree, HybridNode *node);
 // Utility Functions
 void free_hybrid_tree(HybridNode *node, void (*free_key)(void *));
 void print_hybrid_tree(HybridNode *root, int level);
+void print_tree(HybridNode *root, int space);  // Sideways diagram on stdout, via HybridDiagram
 void inorder_traversal(HybridNode *node);
 
+// --- Tree Diagram --- //
+//
+// A subtree drawn one line per node, produced a line at a time into a buffer
+// the diagram reuses, for a caller to page through or print. The layout is
+// the tree turned on its side, as print_tree prints it: right subtree above,
+// left below, indented by depth. A subtree below depth_limit levels becomes
+// one summary line with its key range, so a diagram is at most
+// 2^(depth_limit + 1) - 1 lines however big the tree. The walk keeps its own
+// stack of depth_limit + 1 frames and never recurses.
+
+#define HYBRID_DIAGRAM_MAX_DEPTH 64
+#define HYBRID_DIAGRAM_LINE 512         // Bytes per line, terminator included
+#define HYBRID_DIAGRAM_INDENT 5         // Columns per level
+
+typedef struct HybridDiagramFrame
+{
+    const HybridNode *node;
+    int depth;
+} HybridDiagramFrame;
+
+typedef struct HybridDiagram
+{
+    const HybridNode *root;         // Top of the subtree drawn, at depth 0
+    const HybridNode *focus;        // Node whose line is marked focused, or NULL
+    int depth_limit;                // Deepest level drawn node by node
+    int indent;                     // Columns before depth 0
+
+    HybridDiagramFrame stack[HYBRID_DIAGRAM_MAX_DEPTH + 1];
+    int count;
+    const HybridNode *pending;      // Next subtree to descend into
+    int pending_depth;
+
+    // The current line
+    char line[HYBRID_DIAGRAM_LINE];
+    int length;
+    int depth;
+    bool focused;
+    bool collapsed;                 // Summarises a subtree below depth_limit
+    int lines;                      // Lines produced so far
+} HybridDiagram;
+
+// Diagram of root's subtree
+void hybrid_diagram_init(HybridDiagram *diagram, const HybridNode *root, int depth_limit);
+
+// Diagram around key in tree: from up to above ancestors of its node down to
+// below levels under it. If key is absent, the diagram is drawn around where
+// the search for it stopped, and false is returned. O(height) to set up.
+bool hybrid_diagram_around(HybridDiagram *diagram, const HybridTree *tree, int key, int above, int below);
+
+// Produces the next line into diagram->line; false once the diagram is done
+bool hybrid_diagram_next(HybridDiagram *diagram);
+
 // Successor and Predecessor
 HybridNode *find_successor(HybridNode *node);
 HybridNode *find_predecessor(HybridNode *node);
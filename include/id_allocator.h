@@ -0,0 +1,54 @@
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// --- Block-Reserving ID Allocator --- //
+//
+// The file holds a high-water mark: every id below it may already have been
+// handed out. Before an id is returned, a mark above it is on disk, so a
+// crash can waste the rest of a block but never hand the same id out twice.
+// Marks move ID_BLOCK_SIZE ids at a time, which costs one fdatasync per block.
+// Every other allocation is a single atomic increment.
+//
+// The mark is kept in two slots that are written alternately, each with a
+// sequence number and a checksum. A torn write can only damage the slot being
+// written, and loading takes the valid slot with the higher sequence.
+
+#define ID_BLOCK_SIZE 4096
+#define ID_FIRST 1
+#define ID_ALLOCATOR_MAGIC 0x49444D4Bu // "IDMK"
+
+typedef struct IdMark {
+    uint64_t mark;
+    uint32_t sequence;
+    uint32_t checksum;    // Over mark and sequence, seeded with ID_ALLOCATOR_MAGIC
+} IdMark;
+
+typedef struct IdAllocator {
+    _Atomic int64_t next;          // Next id to hand out
+    _Atomic int64_t reserved_end;  // Ids below this are covered by the mark on disk
+    pthread_mutex_t lock;          // Held while the mark is moved
+    int fd;
+    int slot;                      // Slot the next mark goes to
+    uint32_t sequence;             // Sequence of the last mark written
+    uint64_t syncs;
+    bool failed;
+} IdAllocator;
+
+// Opens (or creates) the mark file; ids continue above the stored mark
+IdAllocator *open_id_allocator(const char *filename);
+
+// Stores the exact next id, so a clean shutdown leaves no gap, and frees the allocator
+bool close_id_allocator(IdAllocator *allocator);
+
+// Returns a never-before-used id, or -1 if the mark cannot be persisted or ids ran out
+int allocate_id(IdAllocator *allocator);
+
+// Makes sure every future id is above id, e.g. after importing items with their own ids
+bool reserve_ids_through(IdAllocator *allocator, int id);
+
+#endif // ID_ALLOCATOR_H
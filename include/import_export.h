@@ -0,0 +1,64 @@
+#ifndef IMPORT_EXPORT_H
+#define IMPORT_EXPORT_H
+
+#include <stdbool.h>
+#include "task_manager.h"
+
+// --- Exchange Formats --- //
+//
+// CSV: a header row, then one row per item. kind is task, subtask, appointment
+// or note. Subtask rows follow their task and note rows their appointment;
+// both carry the parent id in the id column.
+//
+//   kind,id,priority,complete,reminder,recurrence,month,date,hour,minute,link,description,note
+//
+// JSONL: one object per line. Tasks nest their subtasks and appointments
+// their notes:
+//
+//   {"kind":"task","id":7,"priority":2,...,"link":3,"description":"...",
+//    "note":"...","subtasks":[{"priority":1,"description":"..."}]}
+//
+// iCalendar: tasks are VTODOs and appointments VEVENTs with UID task-<id> or
+// appointment-<id>. Items carry no year, so dates are written in ICAL_YEAR.
+// Subtasks use the X-TODO-SUBTASK property and reminders a display VALARM.
+//
+// Both directions stream in EXCHANGE_CHUNK_SIZE chunks. Import parses on the
+// calling thread and hands batches of built items over a bounded queue to an
+// inserter thread that bulk-attaches them, so memory outside the manager stays
+// at IMPORT_QUEUE_DEPTH batches however large the file is. A task linked to an
+// appointment further on waits in a table of at most IMPORT_MAX_DEFERRED_LINKS
+// entries, which is checked each time a batch brings appointments.
+
+#define EXCHANGE_CHUNK_SIZE (64 * 1024)
+#define EXCHANGE_MAX_LINE (1 << 20) // Longer lines (or CSV records) are rejected
+#define IMPORT_BATCH_SIZE 4096
+#define IMPORT_QUEUE_DEPTH 4
+#define IMPORT_MAX_DEFERRED_LINKS 16384 // Links to appointments not yet seen, held at once
+#define ICAL_YEAR 2000
+
+typedef enum ExchangeFormat {
+    FORMAT_CSV,
+    FORMAT_JSONL,
+    FORMAT_ICALENDAR
+} ExchangeFormat;
+
+typedef struct ImportStats {
+    long rows;          // Records read: CSV rows, JSON lines or calendar components
+    long tasks;
+    long appointments;
+    long rejected;      // Malformed records and items the manager refused
+    long unlinked;      // Links left out: the appointment never came, or too many were waiting
+} ImportStats;
+
+// Picks a format from the extension (.csv, .jsonl/.json, .ics); CSV otherwise
+ExchangeFormat exchange_format_from_filename(const char *filename);
+
+// Writes every task and appointment; appointments come first so task links resolve on import
+bool export_to_file(TaskManager *manager, const char *filename, ExchangeFormat format);
+
+// Adds every item in the file to the manager. Items whose id is already taken are
+// rejected and counted. stats may be NULL. Nothing is logged item by item: once
+// anything was added, bulk_load_finished runs, which checkpoints an open Wal.
+bool import_from_file(TaskManager *manager, const char *filename, ExchangeFormat format, ImportStats *stats);
+
+#endif // IMPORT_EXPORT_H
@@ -2,8 +2,78 @@
 #define PERSISTENCE_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include "task_manager.h"  // Assuming this contains TaskManager, Task, etc.
 
+// --- Snapshot File Format --- //
+//
+// [SnapshotHeader][TaskRecord x task_count][SubTaskRecord x subtask_count]
+// [AppointmentRecord x appointment_count][uint64_t note offsets x note_count][string heap]
+//
+// Sections are fixed-size records laid out back to back (all 8-byte multiples).
+// Text lives in the string heap as a uint32_t length, the bytes and a NUL, and
+// records refer to it by heap offset. Loading maps the file read-only and points
+// descriptions straight into the heap, so no string is copied.
+
+#define SNAPSHOT_MAGIC 0x534F4454u // "TDOS"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_NO_STRING UINT64_MAX
+
+// Record flags
+#define SNAPSHOT_COMPLETE 0x01
+#define SNAPSHOT_REMINDER 0x02
+#define SNAPSHOT_LINKED 0x04 // Task record: appointment_id is valid
+#define SNAPSHOT_ARMED 0x08  // Task record: reminder_at is valid
+
+typedef struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t task_count;
+    uint64_t subtask_count;
+    uint64_t appointment_count;
+    uint64_t note_count;
+    uint64_t heap_size;
+    uint64_t log_sequence;    // Last write-ahead log record folded into this snapshot
+} SnapshotHeader;
+
+typedef struct TaskRecord {
+    int32_t id;
+    uint32_t priority;
+    uint8_t flags;
+    uint8_t recurrence_type;
+    uint8_t date;
+    uint8_t month;
+    uint8_t hour;
+    uint8_t minutes;
+    uint16_t padding;
+    int32_t appointment_id;
+    uint32_t subtask_count;   // Subtasks follow each other in the subtask section
+    uint64_t first_subtask;
+    uint64_t description;     // Heap offset
+    uint64_t note;            // Heap offset or SNAPSHOT_NO_STRING
+    int64_t reminder_at;      // Armed reminder's fire time in minute stamps
+} TaskRecord;
+
+typedef struct SubTaskRecord {
+    int32_t task_id;
+    uint32_t priority;
+    uint64_t description;
+} SubTaskRecord;
+
+typedef struct AppointmentRecord {
+    int32_t id;
+    uint8_t flags;
+    uint8_t recurrence_type;
+    uint8_t date;
+    uint8_t month;
+    uint8_t hour;
+    uint8_t minutes;
+    uint16_t padding;
+    uint32_t note_count;      // Entries in the note offset section
+    uint64_t first_note;
+} AppointmentRecord;
+
 // --- Core Persistence Functions --- //
 
 // Save all tasks, appointments, and relevant data to a binary file
@@ -12,18 +82,18 @@ bool save_tasks_to_file(TaskManager *manager, const char *filename);
 // Load tasks and appointments from a binary file into the TaskManager
 bool load_tasks_from_file(TaskManager *manager, const char *filename);
 
-// Save the last used task/appointment ID to ensure no duplicates
-bool save_last_used_id(const char *filename, int last_id);
-
-// Load the last used ID from file
-int load_last_used_id(const char *filename);
+// IDs are handed out by the block-reserving allocator in id_allocator.h
 
 // --- Utility Functions for Serialization --- //
 
-// Helper to serialize a task into the file
+// Fills every field of a TaskRecord except the subtask and string offsets
+void fill_task_record(TaskRecord *record, Task *task);
+
+// Helper to serialize a task into the file: a uint32_t length followed by a
+// TaskRecord whose string offsets are relative to the end of the record
 bool serialize_task(FILE *file, Task *task);
 
-// Helper to deserialize a task from the file
+// Helper to deserialize a task from the file (strings are heap-allocated)
 Task *deserialize_task(FILE *file);
 
 #endif // PERSISTENCE_H
@@ -0,0 +1,126 @@
+#ifndef RECURRENCE_H
+#define RECURRENCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "to_do_app.h"
+#include "calendar_index.h"  // CALENDAR_BASE_YEAR, days_in_month
+
+// --- Lazy Recurrence Expansion --- //
+//
+// Recurring tasks and appointments are kept as rules (an anchor time and a
+// RecurrenceType), never as materialised instances. Expanding a window computes
+// each item's first occurrence at or after the window start directly from its
+// anchor, then merges all items through a min-heap keyed by next occurrence,
+// so a window costs O(n + k log n) for k occurrences and only the window's
+// occurrences are ever stored.
+//
+// Times are minute stamps: minutes since 00:00 on 1 January of
+// CALENDAR_BASE_YEAR. HOURLY, DAILY, WEEKLY and BI_WEEKLY (every two weeks)
+// are fixed steps. MONTHLY and YEARLY keep the anchor's day of the month and
+// fall back to the last day of shorter months. NONE occurs once, at the anchor.
+//
+// Expanded windows are cached. Any change to the rules bumps the generation and
+// invalidates every cached window.
+
+#define RECURRENCE_CACHE_WINDOWS 4
+#define RECURRENCE_INITIAL_ITEMS 1024
+
+#define MINUTES_PER_HOUR 60
+#define MINUTES_PER_DAY (24 * MINUTES_PER_HOUR)
+
+typedef enum RecurringKind {
+    RECURRING_TASK,
+    RECURRING_APPOINTMENT
+} RecurringKind;
+
+typedef struct RecurringItem {
+    int64_t anchor;              // Minute stamp of the first occurrence
+    int32_t id;
+    int16_t year;                // The anchor split out, for MONTHLY and YEARLY
+    uint8_t month;
+    uint8_t date;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t kind;                // RecurringKind
+    uint8_t rule;                // RecurrenceType
+} RecurringItem;
+
+typedef struct Occurrence {
+    int64_t stamp;
+    int32_t id;
+    uint8_t kind;                // RecurringKind
+} Occurrence;
+
+// One item's position in a merge: its next occurrence is number n from the anchor
+typedef struct RecurrenceCursor {
+    int64_t next;
+    uint32_t item;
+    uint32_t n;
+} RecurrenceCursor;
+
+typedef struct RecurrenceWindow {
+    int64_t start;
+    int64_t end;
+    uint64_t generation;         // Engine generation it was expanded at
+    uint64_t last_used;
+    Occurrence *occurrences;
+    uint32_t count;
+    uint32_t capacity;
+} RecurrenceWindow;
+
+typedef struct RecurrenceEngine {
+    RecurringItem *items;
+    uint32_t count;
+    uint32_t capacity;
+    RecurrenceCursor *heap;      // Reused by every merge
+    uint32_t heap_capacity;
+    uint64_t generation;
+    uint64_t clock;              // Ticks on every cache lookup, for LRU eviction
+    RecurrenceWindow cache[RECURRENCE_CACHE_WINDOWS];
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+} RecurrenceEngine;
+
+// --- Minute Stamps --- //
+int64_t recurrence_stamp(int year, MonthsInAYear month, int date, Time time);
+void recurrence_split(int64_t stamp, int *year, MonthsInAYear *month, int *date, Time *time);
+
+// --- Engine Lifecycle --- //
+void recurrence_engine_init(RecurrenceEngine *engine);
+void recurrence_engine_free(RecurrenceEngine *engine);
+
+// Copies the rules into a new engine with an empty cache, so the copy can be
+// expanded on another thread while the original stays in use
+bool recurrence_engine_copy(RecurrenceEngine *copy, const RecurrenceEngine *engine);
+
+// --- Rules --- //
+// Items are anchored at their month, date and time in the given year, since
+// tasks and appointments carry no year of their own. Unscheduled items (date 0)
+// are refused.
+
+bool recurrence_add_task(RecurrenceEngine *engine, int year, const Task *task);
+bool recurrence_add_appointment(RecurrenceEngine *engine, int year, const Appointment *appointment);
+bool recurrence_add(RecurrenceEngine *engine, RecurringKind kind, int id, RecurrenceType rule, int year,
+                    MonthsInAYear month, int date, Time time);
+
+// Drops an item's rule; O(n) in the number of rules. False if it is not there.
+bool recurrence_remove(RecurrenceEngine *engine, RecurringKind kind, int id);
+
+// --- Expansion --- //
+
+// Occurrences with start <= stamp < end in stamp order (ties in the order the
+// rules were added). Fills at most max_results entries and returns the count;
+// the merge stops as soon as out is full.
+int recurrence_expand(RecurrenceEngine *engine, int64_t start, int64_t end, Occurrence *out, int max_results);
+
+// The whole window from the cache, expanding it on a miss. The array stays
+// valid until the rules change or RECURRENCE_CACHE_WINDOWS other windows have
+// been expanded. NULL only when memory runs out.
+const Occurrence *recurrence_window(RecurrenceEngine *engine, int64_t start, int64_t end, uint32_t *count);
+
+// Bytes held by rules, the merge heap and cached windows
+size_t recurrence_memory(const RecurrenceEngine *engine);
+
+#endif // RECURRENCE_H
@@ -0,0 +1,84 @@
+#ifndef REMINDER_WHEEL_H
+#define REMINDER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Hierarchical Timing Wheel --- //
+//
+// Pending reminders keyed by fire time in minute stamps (see recurrence.h).
+// Level 0 has one slot per minute of the current 64-minute block; each level
+// above covers 64 times the span of the one below, so four levels reach 2^24
+// minutes (about 32 years) ahead and anything further waits on an overflow
+// list. Each slot is an intrusive doubly linked list, so arming and cancelling
+// are O(1). Advancing one minute fires the current level 0 slot; crossing a
+// block boundary first cascades the matching slot of the level above down.
+//
+// Occupancy bits per level let advance skip empty stretches: with nothing in
+// the lower levels it jumps straight to the next boundary that can matter.
+//
+// Timers come from a pooled free list. A fired or cancelled timer goes back
+// to the pool before its callback runs, so callbacks may arm and cancel.
+
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+#define WHEEL_OVERFLOW WHEEL_LEVELS      // Level of a timer on the overflow list
+#define WHEEL_POOL_CHUNK 4096
+
+typedef struct ReminderTimer {
+    int64_t fire_at;
+    struct ReminderTimer *prev;
+    struct ReminderTimer *next;          // Also links the pool's free list
+    int32_t id;
+    uint8_t level;
+    uint8_t slot;
+} ReminderTimer;
+
+typedef struct ReminderChunk {
+    struct ReminderChunk *next;
+    ReminderTimer timers[WHEEL_POOL_CHUNK];
+} ReminderChunk;
+
+typedef struct ReminderWheel {
+    int64_t now;                         // Last minute processed
+    ReminderTimer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t occupied[WHEEL_LEVELS];     // Bit s set while slots[level][s] is non-empty
+    ReminderTimer *overflow;
+    ReminderChunk *chunks;
+    ReminderTimer *free_timers;
+    uint64_t count;                      // Armed timers
+    uint64_t cascaded;                   // Timers moved down a level, for benchmarks
+} ReminderWheel;
+
+// Called once per due timer, in fire time order across minutes
+typedef void (*ReminderFire)(int id, int64_t fire_at, void *context);
+
+// --- Wheel Lifecycle --- //
+void reminder_wheel_init(ReminderWheel *wheel, int64_t now);
+void reminder_wheel_free(ReminderWheel *wheel);
+
+// --- Timers --- //
+
+// A fire time at or before now fires on the next advance. NULL when memory runs out.
+ReminderTimer *reminder_wheel_arm(ReminderWheel *wheel, int id, int64_t fire_at);
+void reminder_wheel_cancel(ReminderWheel *wheel, ReminderTimer *timer);
+
+// Moves an armed timer to a new fire time, keeping the handle
+void reminder_wheel_reschedule(ReminderWheel *wheel, ReminderTimer *timer, int64_t fire_at);
+
+// --- Time --- //
+
+// Processes every minute up to and including now, firing what is due.
+// Returns the number of timers fired.
+uint64_t reminder_wheel_advance(ReminderWheel *wheel, int64_t now, ReminderFire fire, void *context);
+
+// The first minute after now at which advance may fire or cascade anything, so
+// a caller can sleep until then; INT64_MAX with nothing armed
+int64_t reminder_wheel_next(const ReminderWheel *wheel);
+
+// Bytes held by the timer pool
+size_t reminder_wheel_memory(const ReminderWheel *wheel);
+
+#endif // REMINDER_WHEEL_H
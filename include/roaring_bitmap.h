@@ -0,0 +1,68 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Compressed Bitmap (Roaring Layout) --- //
+//
+// A set of 32-bit values split by their high 16 bits into containers. Each
+// container holds the low 16 bits of its values either as a sorted array,
+// while it has at most ROARING_ARRAY_MAX of them, or as a 65536-bit bitmap.
+// Sparse sets therefore cost two bytes per value and dense sets one bit, and
+// an intersection only visits containers whose high bits occur in every set.
+//
+// A container turns into a bitmap when it passes ROARING_ARRAY_MAX values and
+// back into an array only below ROARING_ARRAY_MIN, so adding and removing
+// around the boundary does not convert it back and forth.
+
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_ARRAY_MIN 2048
+#define ROARING_BITMAP_WORDS 1024    // 65536 bits
+#define ROARING_INITIAL_ARRAY 4
+
+typedef struct RoaringContainer {
+    uint32_t cardinality;
+    uint32_t capacity;               // Array slots allocated; unused for a bitmap
+    uint16_t *values;                // Sorted low bits, or NULL when bits is used
+    uint64_t *bits;
+} RoaringContainer;
+
+typedef struct RoaringBitmap {
+    uint32_t count;                  // Containers in use
+    uint32_t capacity;
+    uint16_t *keys;                  // Sorted high bits, one per container
+    RoaringContainer *containers;
+    uint64_t cardinality;
+} RoaringBitmap;
+
+// --- Lifecycle --- //
+void roaring_init(RoaringBitmap *set);
+void roaring_free(RoaringBitmap *set);
+
+// --- Updates --- //
+
+// False only when memory runs out; adding a present value is a no-op
+bool roaring_add(RoaringBitmap *set, uint32_t value);
+
+// True if the value was present
+bool roaring_remove(RoaringBitmap *set, uint32_t value);
+
+// --- Queries --- //
+bool roaring_contains(const RoaringBitmap *set, uint32_t value);
+
+static inline uint64_t roaring_cardinality(const RoaringBitmap *set)
+{
+    return set ? set->cardinality : 0;
+}
+
+// Values present in every one of the sets, ascending. Fills at most
+// max_results entries and returns the count.
+int roaring_intersect(const RoaringBitmap *const *sets, int count, uint32_t *out, int max_results);
+uint64_t roaring_intersect_count(const RoaringBitmap *const *sets, int count);
+
+// Bytes held by the containers and key arrays
+size_t roaring_memory(const RoaringBitmap *set);
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,79 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "to_do_app.h"       // NoteBlob
+
+// --- Interned String Arena --- //
+//
+// Task, subtask and note text is stored once per distinct string: recurring
+// tasks that share a description share one copy. Each string carries a
+// reference count and is found again by its hash, so interning a string that
+// is already present costs one lookup and no allocation.
+//
+// Small strings are carved out of ARENA_CHUNK_SIZE chunks in slots rounded to
+// ARENA_SLOT_ALIGN bytes; a released slot goes on a free list for its size and
+// is reused by the next string of that size. Strings that do not fit a small
+// slot get their own allocation. Interned text is shared and must not be
+// written through.
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_SLOT_ALIGN 8
+#define ARENA_MAX_SLOT 256
+#define ARENA_SIZE_CLASSES (ARENA_MAX_SLOT / ARENA_SLOT_ALIGN)
+#define ARENA_INITIAL_SLOTS 1024
+
+typedef struct InternedString {
+    uint32_t references;
+    uint32_t length;
+    char text[];
+} InternedString;
+
+typedef struct ArenaSlot {
+    InternedString *string;  // NULL for an empty slot, ARENA_TOMBSTONE once removed
+    uint32_t hash;
+} ArenaSlot;
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t used;
+    char data[];
+} ArenaChunk;
+
+typedef struct StringArena {
+    ArenaSlot *slots;        // Open addressing, linear probing
+    size_t capacity;         // Always a power of two
+    size_t count;
+    size_t tombstones;
+    ArenaChunk *chunks;      // Newest first; only the head is bump-allocated from
+    void *free_slots[ARENA_SIZE_CLASSES];
+    size_t bytes;            // Bytes held in chunks and large strings
+    size_t interned;         // intern_string calls that returned a live string
+} StringArena;
+
+// --- Arena Lifecycle --- //
+StringArena *create_string_arena();
+void free_string_arena(StringArena *arena);
+
+// --- Interning --- //
+
+// Shared copy of text with one more reference, or NULL if it could not be stored
+char *intern_string(StringArena *arena, const char *text);
+
+// Drops one reference; false if text was not interned in this arena
+bool release_interned(StringArena *arena, const char *text);
+
+// --- Note Blobs --- //
+//
+// All of an appointment's notes in one allocation, stored back to back and
+// NUL-terminated. Walk them with note_blob_first / note_blob_next.
+
+// Appends a copy of text, growing the blob; false leaves *blob unchanged
+bool note_blob_append(NoteBlob **blob, const char *text);
+uint32_t note_blob_count(const NoteBlob *blob);
+const char *note_blob_first(const NoteBlob *blob);
+const char *note_blob_next(const NoteBlob *blob, const char *note);
+
+#endif // STRING_ARENA_H
@@ -0,0 +1,65 @@
+#ifndef TASK_FILTER_H
+#define TASK_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "task_store.h"
+
+// --- Selection Bitmaps over the Task Store --- //
+//
+// A selection holds one bit per store slot (bit i of word i / 64 is slot i);
+// bits past the last slot are always clear. Predicates over the byte columns
+// each fill a selection, and selections combine with AND / OR / AND NOT, so a
+// view builds its compound filter out of single-column scans or asks for the
+// whole TaskFilter in one fused pass.
+//
+// Every byte predicate has the same shape, (column & mask) - low <= span in
+// unsigned bytes: an equality test is span 0, a range is [low, low + span] and
+// mask 0 turns a term off. On x86-64 the kernels test 32 slots per AVX2
+// instruction when the CPU has it and fall back to scalar code otherwise.
+
+typedef enum TaskColumn {
+    TASK_COLUMN_PRIORITY,
+    TASK_COLUMN_FLAGS,
+    TASK_COLUMN_MONTH,
+    TASK_COLUMN_DATE,
+    TASK_COLUMN_HOUR,
+    TASK_COLUMN_MINUTE,
+    TASK_COLUMN_RECURRENCE
+} TaskColumn;
+
+// Words needed for a selection over rows slots
+static inline size_t selection_words(uint32_t rows)
+{
+    return ((size_t)rows + 63) / 64;
+}
+
+// --- Predicates --- //
+// Each writes selection_words(store->count) words to out
+
+// Slots with low <= column <= high
+void task_select_range(const TaskStore *store, TaskColumn column, uint8_t low, uint8_t high, uint64_t *out);
+
+// Slots with (column & mask) == want, e.g. TASK_COLUMN_FLAGS and TASK_STORE_COMPLETE
+void task_select_masked(const TaskStore *store, TaskColumn column, uint8_t mask, uint8_t want, uint64_t *out);
+
+// Slots that pass the whole filter, in one pass over the columns
+void task_select(const TaskStore *store, const TaskFilter *filter, uint64_t *out);
+
+// --- Combining Selections --- //
+// out may be the same array as either input
+
+void selection_and(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+void selection_or(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+void selection_and_not(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words);
+
+uint32_t selection_count(const uint64_t *bits, size_t words);
+
+// Slots of the set bits in order; fills at most max_results entries and returns the count
+int selection_slots(const uint64_t *bits, size_t words, uint32_t *out, int max_results);
+
+// True when the AVX2 kernels are in use on this CPU
+bool task_filter_simd();
+
+#endif // TASK_FILTER_H
@@ -0,0 +1,60 @@
+#ifndef TASK_INDEX_H
+#define TASK_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../avl_template.h"
+#include "to_do_app.h"
+
+// --- Composite Task Order Key --- //
+//
+// One 64-bit key orders tasks by (completion, priority, month, date, hour, minute, id).
+// Incomplete tasks therefore form one contiguous range at the front of the index,
+// ordered by priority and then due time, and the id keeps every key unique.
+//
+//   bit 56      is_complete
+//   bits 52-55  priority
+//   bits 48-51  month
+//   bits 43-47  date
+//   bits 38-42  hour
+//   bits 32-37  minute
+//   bits 0-31   id
+
+#define TASK_ORDER_ID_BITS 32
+#define TASK_ORDER_MINUTE_SHIFT 32
+#define TASK_ORDER_HOUR_SHIFT 38
+#define TASK_ORDER_DATE_SHIFT 43
+#define TASK_ORDER_MONTH_SHIFT 48
+#define TASK_ORDER_PRIORITY_SHIFT 52
+#define TASK_ORDER_COMPLETE_SHIFT 56
+
+// Every incomplete task has a key below this bound
+#define TASK_ORDER_INCOMPLETE_END ((uint64_t)1 << TASK_ORDER_COMPLETE_SHIFT)
+
+AVL_DEFINE(task_order_index, uint64_t, (a > b) - (a < b))
+
+// Key Construction
+uint64_t task_order_pack(bool is_complete, unsigned int priority, MonthsInAYear month,
+                         char date, Time time, int id);
+uint64_t task_order_key(const Task *task);
+
+// Whether a due date fits its fields of the key: month 0-11, date 0-31 (0 for
+// none), hour 0-23, minute 0-59. task_order_pack masks anything wider, which
+// would sort the task somewhere else.
+bool task_order_schedule_valid(int month, int date, int hour, int minute);
+
+// First key of a priority level, for the given completion state
+uint64_t task_order_priority_start(bool is_complete, unsigned int priority);
+
+// Index Maintenance (remove a task before changing any field that is part of its key)
+bool task_order_insert(task_order_index *index, Task *task);
+bool task_order_remove(task_order_index *index, Task *task);
+
+// Range Scan: tasks with low <= key < high in key order, O(log n + k)
+int task_order_range(task_order_index *index, uint64_t low, uint64_t high, Task **out, int max_results);
+
+// Window by Rank: the tasks at ranks first_rank, first_rank + 1, ... in key
+// order, O(log n + k). A task's rank is task_order_index_rank of its key.
+int task_order_window(task_order_index *index, int first_rank, Task **out, int max_results);
+
+#endif // TASK_INDEX_H
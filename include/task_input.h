@@ -0,0 +1,103 @@
+#ifndef TASK_INPUT_H
+#define TASK_INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "task_view.h"
+#include "task_manager.h"
+#include "worker_pool.h"     // Finished background jobs wake the loop
+#include "recurrence.h"      // Minute stamps for the reminder clock
+
+// --- Input Loop --- //
+//
+// The event loop behind the TaskView. A frame reads every key already
+// waiting, without blocking, and applies them as a batch. Then it renders
+// once and flushes the terminal once. A frame stops reading early once half
+// of TASK_INPUT_FRAME_BUDGET_US has gone, which leaves the rest of the budget
+// to the redraw. Keys not yet read wait for the next frame.
+//
+// Within a batch, consecutive keys of one kind collapse into one operation:
+// - a run of row or day moves is a single move by the net amount;
+// - a run of page keys is a single page step;
+// - priority keys on the selected task make one update_task with the net
+//   change, clamped once;
+// - completion toggles make one change, or none if their count is even.
+// A held arrow key or a paste of commands therefore costs one model update
+// and one redraw per frame, not one per key. Runs are measured from where
+// they start, so a run that overshoots an end and comes back differs from
+// the keys taken one at a time.
+//
+// With nothing to do, the loop prefetches the list's next page and runs the
+// done callbacks of finished worker pool jobs. It then sleeps in poll() on
+// the terminal and worker_pool_fd.
+//
+// Every frame first advances the manager's reminders to the wall clock's
+// minute, so a due reminder promotes its task and runs the reminder handler
+// before the frame draws. The poll never sleeps past the reminder wheel's
+// next event, so an idle loop wakes for it too.
+//
+// Latency is measured for every key, from the moment the loop read it to the
+// doupdate that showed its effect. It is kept in a log2 histogram in
+// microseconds. Time a key spent queued before it was read is not included.
+// A caller that knows when keys were sent can use last_flush_us.
+//
+// Keys: j/k or arrows move, space/b or PgDn/PgUp page, g/G or Home/End jump
+// to the ends, +/- change priority, x toggles completion, v the calendar,
+// s the tree, q quits.
+
+#define TASK_INPUT_FRAME_BUDGET_US 16667 // One frame at 60 Hz
+#define TASK_INPUT_MAX_BATCH 1024        // Keys read in one frame at most
+#define TASK_INPUT_MAX_RESULTS 64        // Finished jobs drained per idle pass
+#define TASK_INPUT_LATENCY_BUCKETS 32    // Bucket b holds latencies below 2^b us
+
+typedef struct TaskInputStats {
+    uint64_t frames;                 // Frames rendered
+    uint64_t keys;                   // Keys read
+    uint64_t coalesced;              // Keys folded into another key's operation
+    uint64_t updates;                // Model updates and view operations applied
+    uint64_t over_budget;            // Frames that stopped reading at the batch size or the budget
+    uint64_t reminders;              // Reminders fired by the loop
+    uint64_t latency[TASK_INPUT_LATENCY_BUCKETS];
+    uint64_t latency_total_us;
+    uint64_t latency_max_us;
+} TaskInputStats;
+
+typedef struct TaskInputLoop {
+    TaskView *view;
+    TaskManager *manager;
+    Calendar *calendar;              // Shown by v, or NULL
+    MonthsInAYear month;
+    WorkerPool *pool;                // NULL if there is none
+    int input_fd;                    // The terminal, for poll()
+
+    int max_batch;                   // 1 handles every key in a frame of its own
+    bool coalesce;                   // False applies batched keys one at a time
+    bool quit;
+
+    int keys[TASK_INPUT_MAX_BATCH];  // This frame's keys
+    int64_t read_us[TASK_INPUT_MAX_BATCH];
+    int64_t last_flush_us;           // When the last frame reached the terminal (CLOCK_MONOTONIC)
+    TaskInputStats stats;
+} TaskInputLoop;
+
+// --- Loop Lifecycle --- //
+
+// Puts view's window in keypad, no-delay mode. calendar and pool may be NULL.
+void task_input_init(TaskInputLoop *loop, TaskView *view, int input_fd, Calendar *calendar, WorkerPool *pool);
+
+// --- Frames --- //
+
+// One frame: fires due reminders and, if nothing is pending, waits up to
+// timeout_ms (-1 for ever) or until the next reminder is due. Then reads,
+// applies and draws. Returns the keys handled, or -1 once q was pressed.
+int task_input_frame(TaskInputLoop *loop, int timeout_ms);
+
+// Frames until q
+void task_input_run(TaskInputLoop *loop);
+
+// --- Latency --- //
+
+// Upper bound, in microseconds, of the latency below which fraction of keys fell
+uint64_t task_input_latency_percentile(const TaskInputStats *stats, double fraction);
+
+#endif // TASK_INPUT_H
@@ -3,17 +3,46 @@
 
 #include <stdbool.h>
 #include "to_do_app.h"       // Task, Appointment, Calendar structures
-#include "tree_map_api.h"    // Fast lookup with TreeMap
-#include "avl_api.h"         // AVL tree for priority ordering
+#include "tree_map_api.h"    // Fast lookup with HashMapWithTree
+#include "../avl_api.h"      // AVL tree for priority ordering
 #include "doubly_linked_list.h" // Priority-based task and appointment management
+#include "task_index.h"      // Composite (completion, priority, due time) order
+#include "string_arena.h"    // Interned text and note blobs
+#include "task_store.h"      // Hot task fields in packed columns
+#include "calendar_index.h"  // Calendar items by day
+#include "reminder_wheel.h"  // Armed reminders by fire time
+
+#define TASK_MAP_BUCKETS 1024
+#define HIGHEST_PRIORITY 1  // Top of the task list
+#define LOWEST_PRIORITY 5
+
+struct TaskManager;
+
+// Runs after a fired reminder has promoted its task, e.g. to refresh the view
+typedef void (*TaskReminderHandler)(struct TaskManager *manager, Task *task, void *context);
+
+// Runs once items were attached in bulk from outside the log (an import); false if
+// they could not be made durable
+typedef bool (*TaskBulkLoadHandler)(struct TaskManager *manager, void *context);
 
 // --- TaskManager Structure --- //
 typedef struct TaskManager {
     AVL *task_tree;                  // Prioritizing tasks by urgency
-    TreeMap *task_map;               // Fast lookup by task ID
-    TreeMap *appointment_map;        // Fast lookup by appointment ID
+    HashMapWithTree *task_map;       // Fast lookup by task ID
+    HashMapWithTree *appointment_map; // Fast lookup by appointment ID
     DoublyLinkedList *task_list;     // Priority-based task list
     DoublyLinkedList *appointment_list; // Priority-based appointment list
+    task_order_index agenda_index;   // All tasks by (is_complete, priority, month, date, time, id)
+    TaskStore store;                 // Filterable fields of every task, one dense slot each
+    StringArena *strings;            // Interned descriptions, task notes and subtask text
+    void *snapshot;                  // Read-only mapping that loaded strings point into
+    size_t snapshot_size;
+    uint64_t log_sequence;           // Last write-ahead log record applied (see wal.h)
+    ReminderWheel reminders;         // Armed task reminders, by fire time in minute stamps
+    TaskReminderHandler on_reminder;
+    void *reminder_context;
+    TaskBulkLoadHandler on_bulk_load; // Installed by wal_open, which checkpoints on it
+    void *bulk_load_context;
 } TaskManager;
 
 // --- Core Management Functions --- //
@@ -27,6 +56,32 @@ Task *add_task(TaskManager *manager, int id, const char *description, unsigned i
 bool delete_task(TaskManager *manager, int task_id);
 Task *update_task(TaskManager *manager, int task_id, const char *new_description, unsigned int new_priority);
 
+// Fields that make up the agenda order or the status bitmaps must be changed
+// through these so the indexes stay in step. set_task_schedule returns NULL
+// for a date task_order_schedule_valid refuses.
+Task *set_task_schedule(TaskManager *manager, int task_id, MonthsInAYear month, char date, Time time);
+Task *set_task_completion(TaskManager *manager, int task_id, bool is_complete);
+Task *set_task_reminder(TaskManager *manager, int task_id, bool have_reminder, RecurrenceType recurrence);
+
+// Reminders: arming sets have_reminder and files the task in the timer wheel;
+// re-arming moves the existing timer. When advance_reminders passes the fire
+// time, the reminder is spent as by spend_task_reminder (have_reminder goes
+// false and the task moves to HIGHEST_PRIORITY) and the handler runs.
+// advance_reminders returns the number fired.
+//
+// Like every other mutation these are not logged by the manager. A caller with
+// a Wal logs arming with wal_log_arm_reminder, cancelling with
+// wal_log_task_reminder, and each firing with wal_log_reminder_spent from its
+// TaskReminderHandler; replay spends the reminder without running the handler.
+Task *arm_task_reminder(TaskManager *manager, int task_id, int64_t fire_at);
+Task *cancel_task_reminder(TaskManager *manager, int task_id);
+Task *spend_task_reminder(TaskManager *manager, int task_id);
+void set_reminder_handler(TaskManager *manager, TaskReminderHandler handler, void *context);
+int advance_reminders(TaskManager *manager, int64_t now);
+
+// Replaces the task's note; NULL removes it
+Task *set_task_note(TaskManager *manager, int task_id, const char *text);
+
 // SubTask Management
 SubTask *add_subtask(TaskManager *manager, int task_id, const char *description, unsigned int priority);
 bool delete_subtask(TaskManager *manager, int task_id, int subtask_position);
@@ -36,18 +91,66 @@ SubTask *update_subtask(TaskManager *manager, int task_id, int subtask_position,
 Appointment *add_appointment(TaskManager *manager, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence);
 bool delete_appointment(TaskManager *manager, int appointment_id);
 Appointment *update_appointment(TaskManager *manager, int appointment_id, char new_date, Time new_time, MonthsInAYear new_month, bool new_reminder, RecurrenceType new_recurrence);
+Appointment *add_appointment_note(TaskManager *manager, int appointment_id, const char *text);
 
 // Linking Tasks to Appointments
 void link_task_to_appointment(TaskManager *manager, int task_id, int appointment_id);
 
-// Calendar Management
+// Calendar Management: items are listed and, when scheduled, filed under
+// their day of the calendar's year for calendar_month_view(calendar->days, ...)
+//
+// The manager does not know which calendars hold an item, so set_task_schedule,
+// update_appointment and the deletes leave the day index alone (see the
+// remove-first rule in calendar_index.h). Move an item that is in a calendar
+// with the reschedule calls, and take it out of every calendar before deleting
+// it. A reschedule returns NULL, changing nothing, if the item is not in the
+// calendar or task_order_schedule_valid refuses its new date. It also returns
+// NULL if the new day cannot be filed: the item keeps its old schedule, and
+// leaves the calendar should its old day refuse it too.
 bool add_task_to_calendar(TaskManager *manager, Calendar *calendar, int task_id);
 bool add_appointment_to_calendar(TaskManager *manager, Calendar *calendar, int appointment_id);
+bool remove_task_from_calendar(TaskManager *manager, Calendar *calendar, int task_id);
+bool remove_appointment_from_calendar(TaskManager *manager, Calendar *calendar, int appointment_id);
+Task *reschedule_task_in_calendar(TaskManager *manager, Calendar *calendar, int task_id, MonthsInAYear month, char date, Time time);
+Appointment *reschedule_appointment_in_calendar(TaskManager *manager, Calendar *calendar, int appointment_id, MonthsInAYear month, char date, Time time);
+void free_calendar(Calendar *calendar);
+
+// Bulk Loading: link a fully built task or appointment into every index. The
+// manager takes ownership; on failure the caller keeps it. Heap strings are
+// swapped for interned copies and freed; snapshot strings are used in place.
+bool attach_task(TaskManager *manager, Task *task);
+bool attach_appointment(TaskManager *manager, Appointment *appointment);
+
+// No log record covers attached items. A loader other than the snapshot's own
+// (an import) calls bulk_load_finished when it is done; it runs the handler, if
+// any, and returns its result (true without one).
+void set_bulk_load_handler(TaskManager *manager, TaskBulkLoadHandler handler, void *context);
+bool bulk_load_finished(TaskManager *manager);
+
+// Attaches a batch of tasks. The agenda index takes the batch's sorted keys in
+// one merge, O(k log(n/k + 1)) into n tasks, and into an empty manager the id
+// map is built in one pass. Tasks that fail to attach are set to NULL in the
+// array and stay owned by the caller. Returns the number attached.
+int attach_tasks(TaskManager *manager, Task **tasks, int count);
+
+// True when text is owned by the manager's heap rather than its snapshot mapping
+bool task_manager_owns_string(TaskManager *manager, const char *text);
 
 // --- Data Access and Retrieval --- //
 Task *find_task(TaskManager *manager, int task_id);
 Appointment *find_appointment(TaskManager *manager, int appointment_id);
 
+// Incomplete tasks with min_priority <= priority <= max_priority, ordered by priority then
+// due time. Fills at most max_results entries and returns the count, in O(log n + k).
+int get_agenda(TaskManager *manager, unsigned int min_priority, unsigned int max_priority,
+               Task **out, int max_results);
+
+// Tasks with the given status, by intersecting the store's bitmap indexes: completion
+// and reminder are 0 or 1, recurrence a RecurrenceType, -1 matches anything. Fills
+// at most max_results entries and returns the count.
+int find_tasks_by_status(TaskManager *manager, int completion, int recurrence, int reminder,
+                         Task **out, int max_results);
+
 // --- Utility Functions --- //
 void print_all_tasks(TaskManager *manager);
 void print_all_appointments(TaskManager *manager);
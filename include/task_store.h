@@ -0,0 +1,98 @@
+#ifndef TASK_STORE_H
+#define TASK_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "to_do_app.h"
+#include "roaring_bitmap.h"
+
+// --- Columnar Task Store --- //
+//
+// The fields that filters look at are kept in packed parallel columns, one
+// entry per live task, indexed by a dense slot. Everything else stays in the
+// Task, which the tasks column points to. A scan over "incomplete tasks due
+// today" reads three byte columns front to back instead of following one
+// pointer per task into a struct that is mostly cold.
+//
+// Slots are dense: removing a task moves the last slot into the hole and
+// updates that task's slot, so columns never have gaps. Slot order is
+// therefore not stable and carries no meaning.
+//
+// The low-cardinality status fields also have a compressed bitmap of slots per
+// value: completion, recurrence type and reminder. They are kept in step with
+// the columns on every add, remove and refresh, so a status query is an
+// intersection of at most three bitmaps rather than a pass over every task.
+
+#define TASK_STORE_INITIAL_CAPACITY 1024
+#define TASK_STORE_BLOCK 256          // Rows evaluated per step of a scan
+
+// Bits of the flags column
+#define TASK_STORE_COMPLETE 0x01
+#define TASK_STORE_REMINDER 0x02
+
+#define TASK_STORE_RECURRENCES (YEARLY + 1)
+
+typedef struct TaskStore {
+    uint32_t count;
+    uint32_t capacity;
+    int32_t *id;
+    uint8_t *priority;
+    uint8_t *flags;
+    uint8_t *month;
+    uint8_t *date;
+    uint8_t *hour;
+    uint8_t *minute;
+    uint8_t *recurrence;
+    Task **tasks;                 // Cold side table: the full record of each slot
+    RoaringBitmap by_completion[2];  // Slots by is_complete
+    RoaringBitmap by_recurrence[TASK_STORE_RECURRENCES];
+    RoaringBitmap by_reminder[2];    // Slots by have_reminder
+} TaskStore;
+
+// Field ranges a scan keeps; see task_filter_all()
+typedef struct TaskFilter {
+    int completion;               // 0 incomplete, 1 complete, -1 either
+    unsigned int min_priority;
+    unsigned int max_priority;
+    int month;                    // MonthsInAYear, or -1 for any
+    int date;                     // Day of the month, or 0 for any
+} TaskFilter;
+
+// --- Store Lifecycle --- //
+void task_store_init(TaskStore *store);
+void task_store_free(TaskStore *store);
+
+// --- Maintenance --- //
+// Each keeps task->store_slot in step with the columns
+
+bool task_store_add(TaskStore *store, Task *task);
+void task_store_remove(TaskStore *store, Task *task);
+
+// Copies the task's hot fields into its slot again after they changed
+void task_store_refresh(TaskStore *store, const Task *task);
+
+// --- Scans --- //
+
+// A filter that keeps every task
+TaskFilter task_filter_all();
+
+// Slots of the tasks that pass the filter, in slot order. Fills at most
+// max_results entries and returns the count.
+int task_store_scan(const TaskStore *store, const TaskFilter *filter, uint32_t *out, int max_results);
+
+// Number of tasks that pass the filter
+uint32_t task_store_count(const TaskStore *store, const TaskFilter *filter);
+
+// Slots by status through the bitmap indexes: completion and reminder are 0 or 1,
+// recurrence a RecurrenceType, and -1 leaves a field out. Ascending slot order;
+// fills at most max_results entries and returns the count.
+int task_store_status_query(const TaskStore *store, int completion, int recurrence, int reminder,
+                            uint32_t *out, int max_results);
+uint64_t task_store_status_count(const TaskStore *store, int completion, int recurrence, int reminder);
+
+static inline Task *task_store_task(const TaskStore *store, uint32_t slot)
+{
+    return slot < store->count ? store->tasks[slot] : NULL;
+}
+
+#endif // TASK_STORE_H
@@ -0,0 +1,131 @@
+#ifndef TASK_VIEW_H
+#define TASK_VIEW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <curses.h>
+#include "task_manager.h"
+#include "calendar_index.h"
+#include "task_viewport.h"
+
+// --- Task View --- //
+//
+// The ncurses screens over a TaskManager: the task list in agenda order, one
+// month of a calendar, and a diagram of the task map around the selected
+// task. Drawing is damage-tracked. The list reads only its visible rows, from
+// a TaskViewport over the agenda index. Every body row remembers the task and
+// key it last showed, and only rows where these changed are redrawn. A row is
+// also redrawn when the cursor enters or leaves it, or when it was touched.
+// Scrolling moves the rows already drawn with the terminal's scroll region and
+// draws only the rows it uncovers. The calendar keeps each day's counts in the
+// same way. A frame costs O(log n + rows) at worst, whatever n is.
+//
+// The tree screen draws the hash bucket that holds the selected task's id, from
+// TASK_VIEW_TREE_ABOVE ancestors of its node down to TASK_VIEW_TREE_BELOW
+// levels under it, with deeper subtrees summarised (see HybridDiagram). The
+// diagram is a bounded number of lines whatever the store's size, and the
+// page shown is the one centred on the selected task.
+//
+// A row is compared by its task, the task's agenda key and a flags byte for the
+// reminder and recurrence marks, which the key leaves out. Together they cover
+// everything on the row except the description, so a description edit is
+// invisible to the view and the caller reports it with task_view_touch.
+//
+// task_view_render only stages the window (wnoutrefresh). The caller flushes
+// it with doupdate(), once per frame.
+
+#define TASK_VIEW_MAX_ROWS TASK_VIEWPORT_MAX_ROWS
+#define TASK_VIEW_MAX_COLUMNS 512
+#define TASK_VIEW_WEEK_LINES 2          // Screen lines per calendar week
+#define TASK_VIEW_TREE_ABOVE 3          // Ancestors of the selected task's node in the tree diagram
+#define TASK_VIEW_TREE_BELOW 3          // Levels drawn under it
+
+// TaskViewRow.flags
+#define TASK_VIEW_ROW_REMINDER 0x01     // Drawn with R
+#define TASK_VIEW_ROW_RECURRING 0x02    // Drawn with *
+
+typedef enum TaskViewMode {
+    TASK_VIEW_LIST,
+    TASK_VIEW_CALENDAR,
+    TASK_VIEW_TREE
+} TaskViewMode;
+
+// What one body row shows, as last drawn
+typedef struct TaskViewRow {
+    const Task *task;               // NULL for a blank row; compared, never followed
+    uint64_t key;                   // The task's agenda key when drawn
+    uint8_t flags;                  // TASK_VIEW_ROW_* when drawn
+    bool selected;
+    bool dirty;                     // Touched, or uncovered by a scroll
+} TaskViewRow;
+
+typedef struct TaskView {
+    TaskManager *manager;
+    WINDOW *window;
+    TaskViewMode mode;
+    int rows;                       // Body rows, below the status line
+    int columns;
+
+    TaskViewport viewport;          // The list's rows and selection, also followed by the tree
+    TaskViewRow shown[TASK_VIEW_MAX_ROWS];      // In the tree, key is a hash of the line
+    char status[TASK_VIEW_MAX_COLUMNS];
+
+    Calendar *calendar;             // Month shown in calendar mode
+    MonthsInAYear month;
+    int day;                        // Selected date, from 1
+    uint32_t day_tasks[CALENDAR_DAYS];         // Counts as last drawn
+    uint32_t day_appointments[CALENDAR_DAYS];
+    int drawn_day;
+
+    HybridDiagram diagram;          // Reused by every tree frame
+
+    bool redraw_all;                // First frame, resize, mode or month change
+    uint64_t frames;
+    uint64_t rows_drawn;            // Body rows and calendar cells redrawn
+} TaskView;
+
+// --- View Lifecycle --- //
+TaskView *create_task_view(TaskManager *manager, WINDOW *window);
+void free_task_view(TaskView *view);
+
+// Re-reads the window size; the next frame redraws everything
+void task_view_resize(TaskView *view);
+
+void task_view_set_mode(TaskView *view, TaskViewMode mode);
+
+// Shows month of calendar (filed under CALENDAR_BASE_YEAR + calendar->year) in calendar mode
+void task_view_show_month(TaskView *view, Calendar *calendar, MonthsInAYear month);
+
+// --- Navigation --- //
+
+// Moves the selection by delta rows in the list and tree, or delta days in the calendar
+void task_view_move(TaskView *view, int delta);
+
+// Scrolls the list by whole pages, negative for up (the tree follows the selection)
+void task_view_page(TaskView *view, int pages);
+
+// Selects the task at agenda rank position in the list
+void task_view_jump(TaskView *view, int position);
+
+// The selected task in the list or tree, or NULL
+Task *task_view_selected(TaskView *view);
+
+// Caches the list's next page; for when a frame is on screen and no key is waiting
+void task_view_prefetch(TaskView *view);
+
+// --- Damage --- //
+
+// task changed without moving (e.g. a new description); redraws its row if shown
+void task_view_touch(TaskView *view, const Task *task);
+
+// Redraws everything on the next frame
+void task_view_invalidate(TaskView *view);
+
+// Draws what changed since the last frame and stages the window. Returns the
+// body rows or calendar cells redrawn.
+int task_view_render(TaskView *view);
+
+// One list row as the view draws it, into line (at least width + 1 bytes)
+int task_view_format_task(const Task *task, char *line, int width);
+
+#endif // TASK_VIEW_H
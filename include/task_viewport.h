@@ -0,0 +1,74 @@
+#ifndef TASK_VIEWPORT_H
+#define TASK_VIEWPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "to_do_app.h"
+#include "task_index.h"
+
+// --- Task Viewport --- //
+//
+// A window of rows over the agenda index, anchored on the key of its top row
+// rather than on a rank. Inserts and removes elsewhere in the index therefore
+// leave the rows on screen where they are. If the top task goes away, the
+// window starts at its successor.
+//
+// The viewport caches its page, and task_viewport_prefetch adds the page after
+// it with successor steps. The caller runs that when idle, after a frame is
+// on screen, so that the next keypress finds its rows ready. Moving the
+// cursor within the page costs nothing. Scrolling by a row shifts the cache
+// and walks one successor or predecessor from its edge, and paging down swaps
+// in the prefetched page. A jump to any position is a select by rank, so
+// every operation is O(log n + rows) at worst, whatever n is. The cache is
+// refilled whenever the index's version moves, because a change anywhere can
+// shift what follows the anchor.
+//
+// Positions are agenda ranks from 0. The index must outlive the viewport.
+
+#define TASK_VIEWPORT_MAX_ROWS 256
+
+typedef struct TaskViewport {
+    task_order_index *index;
+    int rows;                       // Rows in a page
+    uint64_t top_key;               // Key of the top row, the anchor
+    int cursor;                     // Row of the selection within the page
+
+    // Cache, valid while version matches the index's
+    bool filled;
+    unsigned long version;
+    int top;                        // Rank of the top row
+    int count;                      // Tasks cached from the top row
+    Task *tasks[2 * TASK_VIEWPORT_MAX_ROWS];    // The page, then the prefetched page
+    uint64_t fills;                 // Times the cache was rebuilt from the index
+} TaskViewport;
+
+// --- Viewport Lifecycle --- //
+void task_viewport_init(TaskViewport *viewport, task_order_index *index, int rows);
+void task_viewport_resize(TaskViewport *viewport, int rows);
+
+// --- Reading --- //
+
+// The visible rows, top first; sets *count to how many there are (at most rows)
+Task **task_viewport_page(TaskViewport *viewport, int *count);
+
+// Ranks of the top row and of the selection
+int task_viewport_top(TaskViewport *viewport);
+int task_viewport_position(TaskViewport *viewport);
+
+Task *task_viewport_selected(TaskViewport *viewport);
+
+// Caches the page after the visible one; returns how many of its rows are cached
+int task_viewport_prefetch(TaskViewport *viewport);
+
+// --- Navigation --- //
+
+// Moves the selection by delta rows, scrolling just enough to keep it visible
+void task_viewport_move(TaskViewport *viewport, int delta);
+
+// Scrolls by whole pages (negative for up), keeping the selection on its row
+void task_viewport_page_by(TaskViewport *viewport, int pages);
+
+// Selects the task at rank position, centring it if it was off screen
+void task_viewport_jump(TaskViewport *viewport, int position);
+
+#endif // TASK_VIEWPORT_H
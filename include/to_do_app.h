@@ -2,6 +2,7 @@
 #define TO_DO_APP_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "doubly_linked_list.h"
 
 // --- ENUMS --- //
@@ -43,6 +44,13 @@ typedef struct Notes {
     char *description;
 } Notes;
 
+// Several notes packed into one allocation (see string_arena.h)
+typedef struct NoteBlob {
+    uint32_t count;
+    uint32_t size;      // Bytes used in text
+    char text[];        // NUL-terminated notes, back to back
+} NoteBlob;
+
 // SubTask Structure
 typedef struct SubTask {
     int task_id; // Linked parent task ID
@@ -56,11 +64,12 @@ typedef struct Appointment {
     char date;
     Time time;
     MonthsInAYear month;
-    DoublyLinkedList *notes;
+    NoteBlob *notes;
     bool is_complete;
     bool have_reminder;
     RecurrenceType recurrence_type;
     struct Task *linked_task; // Points back to linked task
+    struct Node *list_node; // Position in the manager's appointment_list
 } Appointment;
 
 // Task Structure
@@ -74,9 +83,13 @@ typedef struct Task {
     RecurrenceType recurrence_type;
     Time time;
     char date;
+    MonthsInAYear month;
     Notes *note; // A single note attached to the task
     DoublyLinkedList *subtasks; // List of subtasks
     Appointment *appointment; // Link to an appointment
+    struct Node *list_node; // Position in the manager's priority-ordered task_list
+    unsigned int store_slot; // Row in the manager's column store (see task_store.h)
+    struct ReminderTimer *reminder_timer; // Armed reminder, or NULL (see reminder_wheel.h)
 } Task;
 
 // Calendar Structure
@@ -87,6 +100,7 @@ typedef struct Calendar {
     MonthsInAYear month;
     DoublyLinkedList *appointments; // List of appointments
     DoublyLinkedList *tasks;        // List of tasks
+    struct CalendarIndex *days;     // The same items by day (see calendar_index.h)
 } Calendar;
 
 #endif // TO_DO_APP_H
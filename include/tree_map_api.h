@@ -9,11 +9,17 @@
 typedef struct DynamicArray DynamicArray;
 typedef struct HybridTree HybridTree;
 typedef struct HybridNode HybridNode;
+typedef struct HybridEntry HybridEntry;
 
 
 // Define the number of buckets in the hash map
 #define BUCKET_SIZE 1000
 
+// Parallel bulk build: fewer keys than this per thread are not worth a thread
+#define TREE_MAP_BUILD_MIN_PER_THREAD 65536
+#define TREE_MAP_BUILD_GRAB 16        // Buckets a build thread claims at a time
+#define TREE_MAP_SORT_MIN_PER_THREAD 262144  // Same, for sorting range query results
+
 // Define the HashMap structure with multiple Hybrid Trees (Red-Black Trees)
 typedef struct HashMapWithTree {
     struct HybridTree **buckets;  // Change from static array to pointer for flexibility
@@ -25,11 +31,18 @@ typedef struct HashMapWithTree {
 HashMapWithTree *create_tree_map(int map_capacity, int tree_capacity);
 unsigned int hash(int key, int capacity);  // Create a new tree map
 bool tree_map_insert(HashMapWithTree *map, int key, void *value); // Insert key into the tree map
+
+// Bulk build into an empty map: entries are partitioned by hash() in a parallel
+// counting pass, then threads take buckets and build each tree from its sorted
+// keys. As with repeated tree_map_insert, the first entry for a key wins.
+// threads <= 0 uses every CPU. Returns the keys inserted, or -1 if the map was
+// not empty or memory ran out (the map is then left empty).
+int tree_map_build(HashMapWithTree *map, const HybridEntry *entries, int count, int threads);
 bool tree_map_delete(HashMapWithTree *map, int key);  // Delete key from the tree map
 void free_tree_map(HashMapWithTree *map);  // Free all resources of the tree map
 HybridNode *tree_map_search(HashMapWithTree *map, int key); // Search for a key in the tree map
 void tree_map_print(HashMapWithTree *map);  // Print the tree map (all buckets)
-void tree_map_range_query_ordered(HashMapWithTree *map, int low, int high, DynamicArray *result);  // Range query for the tree map
+void tree_map_range_query_ordered(HashMapWithTree *map, int low, int high, DynamicArray *result);  // Range query for the tree map, in key order (large results sorted in parallel)
 void free_tree_map(HashMapWithTree *map);
 void print_range_query_result(DynamicArray *result);
 void perform_range_query_and_print(HybridTree *tree, int low, int high);
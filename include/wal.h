@@ -0,0 +1,159 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "task_manager.h"
+
+// --- Write-Ahead Log --- //
+//
+// Every mutation of a TaskManager is appended to "<snapshot>.wal" as one
+// WalRecord followed by its text. Appends only copy into memory; a flusher
+// thread writes whatever has accumulated and covers it with a single
+// fdatasync (group commit), so concurrent writers share the cost of a sync.
+//
+// On startup wal_recover() loads the snapshot and replays the log over it,
+// skipping records the snapshot already contains (SnapshotHeader.log_sequence).
+// Compaction seals the current log as "<snapshot>.wal.old", starts a fresh one,
+// and a background thread folds the sealed log into a new snapshot.
+//
+// Each append stamps its sequence into manager->log_sequence, so a snapshot saved
+// from the live manager names the last record it holds. Imports are not logged:
+// wal_open installs a bulk load handler that checkpoints the live manager instead.
+
+#define WAL_NO_TEXT UINT32_MAX
+#define WAL_BUFFER_SIZE (1 << 20)
+#define WAL_COMPACT_BYTES (64u << 20) // Seal and compact once the log grows past this
+#define WAL_LOAD_ATTEMPTS 8
+
+typedef enum WalOp {
+    WAL_ADD_TASK = 1,
+    WAL_UPDATE_TASK,
+    WAL_DELETE_TASK,
+    WAL_SCHEDULE_TASK,
+    WAL_COMPLETE_TASK,
+    WAL_ADD_SUBTASK,
+    WAL_UPDATE_SUBTASK,
+    WAL_DELETE_SUBTASK,
+    WAL_ADD_APPOINTMENT,
+    WAL_UPDATE_APPOINTMENT,
+    WAL_DELETE_APPOINTMENT,
+    WAL_LINK_TASK,
+    WAL_SET_TASK_NOTE,        // WAL_NO_TEXT removes the note
+    WAL_ADD_APPOINTMENT_NOTE,
+    WAL_SET_TASK_REMINDER,
+    WAL_ARM_REMINDER,
+    WAL_SPEND_REMINDER
+} WalOp;
+
+typedef struct WalRecord {
+    uint32_t length;          // Bytes after this field: the rest of the record and the text
+    uint32_t checksum;        // FNV-1a over those same bytes
+    uint64_t sequence;
+    uint8_t op;
+    uint8_t flags;            // SNAPSHOT_COMPLETE / SNAPSHOT_REMINDER
+    uint8_t recurrence_type;
+    uint8_t date;
+    uint8_t month;
+    uint8_t hour;
+    uint8_t minutes;
+    uint8_t padding;
+    int32_t id;               // Task or appointment id
+    int32_t target;           // Subtask position, linked appointment id or fire time's low half
+    uint32_t priority;        // Or a reminder's fire time's high half
+    uint32_t text_length;     // Bytes of text that follow, or WAL_NO_TEXT
+} WalRecord;
+
+typedef struct Wal {
+    TaskManager *manager;     // Live manager: appends advance its log_sequence
+    char *log_path;
+    char *sealed_path;
+    char *snapshot_path;
+    int fd;
+
+    pthread_mutex_t lock;
+    pthread_cond_t pending;   // Flusher: records are waiting
+    pthread_cond_t durable;   // Writers: durable_sequence moved
+    pthread_cond_t compacted; // Checkpoint: compact_running went false
+    char *buffer;             // Records appended since the last flush
+    size_t buffer_used;
+    size_t buffer_capacity;
+    char *flushing;           // Swapped with buffer while the flusher writes it
+    size_t flushing_capacity;
+    uint64_t next_sequence;
+    uint64_t durable_sequence;
+    uint64_t log_bytes;       // Size of the current log file
+    uint64_t syncs;           // fdatasync calls so far
+    bool failed;              // A write or sync failed; nothing after it is durable
+    bool closing;
+
+    pthread_t flusher;
+    pthread_t compactor;
+    bool compacting;          // Flusher only: compactor was started and must be joined
+    bool compact_running;     // Compactor has not finished yet
+    bool compact_requested;
+    bool compact_failed;
+    bool checkpointing;       // No compaction may start: it would fold the older snapshot
+} Wal;
+
+// --- Recovery --- //
+
+// Loads the snapshot (if any) into an empty manager, then replays the sealed and
+// current logs over it. A torn record at the end of the current log is cut off.
+bool wal_recover(TaskManager *manager, const char *snapshot_path);
+
+// Applies every record in a log file with a sequence above manager->log_sequence.
+// Returns the byte length of the valid prefix, or -1 if the file cannot be read.
+long wal_replay(TaskManager *manager, const char *log_path);
+
+// A new manager holding the snapshot and everything written to the logs so far,
+// for background readers. Leaves the files alone, so it is safe while a Wal is
+// open on the same path. NULL on failure.
+TaskManager *wal_load_private(const char *snapshot_path);
+
+// --- Logging --- //
+
+// Opens the log next to the snapshot and starts the flusher. Sequences continue
+// after manager->log_sequence, so call wal_recover() first.
+Wal *wal_open(TaskManager *manager, const char *snapshot_path);
+
+// Flushes everything appended so far, waits for compaction and closes the log
+bool wal_close(Wal *wal);
+
+// Queues a record and returns its sequence number (0 on failure). The record is
+// durable once wal_sync() for that sequence returns true. Append while still holding
+// whatever serialises changes to the manager, so log order matches apply order,
+// and call wal_sync() after letting go of it.
+uint64_t wal_append(Wal *wal, WalRecord *record, const char *text);
+
+// Blocks until every record up to sequence has been written and synced
+bool wal_sync(Wal *wal, uint64_t sequence);
+
+// Seals the current log and folds it into a new snapshot on a background thread
+bool wal_compact(Wal *wal);
+
+// Saves the live manager as the snapshot, after any running compaction and with
+// none starting meanwhile. For changes no record covers; call it like wal_append.
+bool wal_checkpoint(Wal *wal);
+
+// Record builders: log a mutation that was just applied to the manager
+uint64_t wal_log_add_task(Wal *wal, int id, const char *description, unsigned int priority);
+uint64_t wal_log_update_task(Wal *wal, int id, const char *new_description, unsigned int new_priority);
+uint64_t wal_log_delete_task(Wal *wal, int id);
+uint64_t wal_log_task_schedule(Wal *wal, int id, MonthsInAYear month, char date, Time time);
+uint64_t wal_log_task_completion(Wal *wal, int id, bool is_complete);
+uint64_t wal_log_add_subtask(Wal *wal, int task_id, const char *description, unsigned int priority);
+uint64_t wal_log_update_subtask(Wal *wal, int task_id, int position, const char *new_description, unsigned int new_priority);
+uint64_t wal_log_delete_subtask(Wal *wal, int task_id, int position);
+uint64_t wal_log_add_appointment(Wal *wal, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence);
+uint64_t wal_log_update_appointment(Wal *wal, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence);
+uint64_t wal_log_delete_appointment(Wal *wal, int id);
+uint64_t wal_log_link_task(Wal *wal, int task_id, int appointment_id);
+uint64_t wal_log_task_note(Wal *wal, int task_id, const char *text);
+uint64_t wal_log_appointment_note(Wal *wal, int appointment_id, const char *text);
+uint64_t wal_log_task_reminder(Wal *wal, int id, bool have_reminder, RecurrenceType recurrence);
+uint64_t wal_log_arm_reminder(Wal *wal, int id, int64_t fire_at);
+uint64_t wal_log_reminder_spent(Wal *wal, int id);
+
+#endif // WAL_H
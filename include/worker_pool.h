@@ -0,0 +1,111 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// --- Work-Stealing Worker Pool --- //
+//
+// Long jobs (exports, archive rebuilds, recurrence expansion, waiting on a log
+// sync) run here so the input loop never blocks on them. Each worker owns a
+// Chase-Lev deque: it pushes and pops jobs it spawns at the bottom, and idle
+// workers steal the oldest job from the top of someone else's. Jobs submitted
+// from outside the pool go through a locked injection queue.
+//
+// A finished job is pushed onto a lock-free multi-producer, single-consumer
+// queue and its done callback runs later on the thread that calls
+// worker_pool_drain(), normally the UI thread, so results are applied where
+// the TaskManager lives. worker_pool_fd() becomes readable when results are
+// waiting, for poll() alongside the terminal.
+//
+// Workers run at WORKER_NICE so a busy pool does not take the CPU from input.
+
+#define WORKER_DEQUE_CAPACITY 1024   // Power of two; a full deque spills to the injection queue
+#define WORKER_MAX_THREADS 64
+#define WORKER_NICE 10
+#define WORKER_CACHE_LINE 64
+
+struct WorkerJob;
+
+typedef void (*WorkerJobFn)(struct WorkerJob *job);
+
+// Embed in a larger struct for job state; it must stay alive until done has run
+typedef struct WorkerJob {
+    WorkerJobFn run;                 // On a worker thread
+    WorkerJobFn done;                // On the draining thread, or NULL
+    void *context;
+    struct WorkerJob *queued_next;   // Injection queue link
+    _Atomic(struct WorkerJob *) result_next;
+} WorkerJob;
+
+typedef struct WorkerDeque {
+    _Alignas(WORKER_CACHE_LINE) _Atomic int64_t top;      // Thieves take from here
+    _Alignas(WORKER_CACHE_LINE) _Atomic int64_t bottom;   // The owner pushes and pops here
+    _Atomic(WorkerJob *) slots[WORKER_DEQUE_CAPACITY];
+} WorkerDeque;
+
+typedef struct Worker {
+    WorkerDeque deque;
+    struct WorkerPool *pool;
+    pthread_t thread;
+    int index;
+    uint32_t victim;                 // Where the next steal attempt starts
+    _Atomic uint64_t executed;
+    _Atomic uint64_t stolen;
+} Worker;
+
+typedef struct WorkerPool {
+    Worker *workers;
+    int worker_count;
+
+    pthread_mutex_t lock;            // Guards the injection queue and sleeping
+    pthread_cond_t wake;
+    WorkerJob *injected_head;
+    WorkerJob *injected_tail;
+    _Atomic int64_t pending;         // Queued jobs no worker has taken yet
+    _Atomic int sleeping;
+    bool stopping;
+
+    _Atomic(WorkerJob *) results_head; // Producers swap themselves in here
+    WorkerJob *results_tail;         // Consumer only
+    WorkerJob results_stub;
+    _Atomic bool notified;           // A byte is in the pipe for the current batch
+    int notify[2];
+    _Atomic uint64_t in_flight;      // Submitted, done not yet run
+} WorkerPool;
+
+// --- Pool Lifecycle --- //
+
+// threads <= 0 picks one per CPU beyond the first, at least one
+WorkerPool *create_worker_pool(int threads);
+
+// Finishes every queued job, runs the outstanding done callbacks on the calling
+// thread and frees the pool
+void free_worker_pool(WorkerPool *pool);
+
+// --- Jobs --- //
+
+// From a worker the job goes on that worker's own deque, otherwise to the
+// injection queue. Returns false if the pool is shutting down.
+bool worker_pool_submit(WorkerPool *pool, WorkerJob *job);
+
+// --- Results --- //
+
+// Readable while finished jobs are waiting to be drained
+int worker_pool_fd(const WorkerPool *pool);
+
+// Runs the done callbacks of up to max finished jobs, in completion order.
+// Returns how many ran. Only one thread may drain.
+int worker_pool_drain(WorkerPool *pool, int max);
+
+// Drains until every submitted job has finished and its done callback has run
+void worker_pool_wait(WorkerPool *pool);
+
+static inline uint64_t worker_pool_in_flight(WorkerPool *pool)
+{
+    return atomic_load(&pool->in_flight);
+}
+
+#endif // WORKER_POOL_H
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "include/persistence.h"
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/persistence.c"
+
+#define DEFAULT_TASKS 1000000
+#define SNAPSHOT_PATH "persistence_bench.snapshot"
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+    char description[64];
+
+    TaskManager *manager = create_task_manager();
+    if (!manager)
+        return 1;
+
+    srand(31);
+    for (int id = 0; id < count; id++)
+    {
+        snprintf(description, sizeof(description), "Task %d: follow up on item %d", id, rand() % 1000);
+        Task *task = add_task(manager, id, description, 1 + rand() % LOWEST_PRIORITY);
+        Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+
+        if (id % 10 == 0)
+            add_subtask(manager, id, "check details", 2);
+        if (id % 50 == 0)
+        {
+            add_appointment(manager, id, task->date, due, task->month, true, WEEKLY);
+            link_task_to_appointment(manager, id, id);
+        }
+        if (id % 100 == 0)
+            arm_task_reminder(manager, id, 28000000 + id);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool saved = save_tasks_to_file(manager, SNAPSHOT_PATH);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Saved %d tasks: %s in %.2f ms\n", count, saved ? "ok" : "FAILED", elapsed_ms(start, end));
+
+    free_task_manager(manager);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TaskManager *loaded = create_task_manager();
+    bool ok = load_tasks_from_file(loaded, SNAPSHOT_PATH);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Loaded %d tasks: %s in %.2f ms (%.0f tasks/sec)\n", list_size(loaded->task_list),
+           ok ? "ok" : "FAILED", elapsed_ms(start, end), list_size(loaded->task_list) / (elapsed_ms(start, end) / 1e3));
+
+    // Spot checks: strings point into the mapping, links and subtasks survive
+    Task *task = find_task(loaded, count / 2 - (count / 2) % 50);
+    printf("Task %d: \"%s\" borrowed=%s subtasks=%d linked=%s\n", task->id, task->description,
+           task_manager_owns_string(loaded, task->description) ? "no" : "yes",
+           task->subtasks ? list_size(task->subtasks) : 0,
+           task->appointment && task->appointment->linked_task == task ? "yes" : "no");
+
+    Task *first = find_task(loaded, 0);
+    printf("Armed reminders kept: %s\n",
+           loaded->reminders.count == (uint64_t)(count + 99) / 100 && first && first->reminder_timer &&
+           first->reminder_timer->fire_at == 28000000 ? "ok" : "FAILED");
+
+    // Stream format round trip
+    FILE *stream = tmpfile();
+    serialize_task(stream, task);
+    rewind(stream);
+    Task *copy = deserialize_task(stream);
+    printf("Stream round trip: %s\n",
+           copy && copy->id == task->id && strcmp(copy->description, task->description) == 0 &&
+           copy->subtasks && list_size(copy->subtasks) == list_size(task->subtasks) ? "ok" : "FAILED");
+    fclose(stream);
+    if (copy)
+    {
+        free_subtasks(loaded, copy->subtasks);
+        free(copy->description);
+        free(copy);
+    }
+
+    // A stream record whose due date cannot exist is refused, not packed into another day's key
+    stream = tmpfile();
+    TaskRecord record;
+    bool stream_refused = stream && serialize_task(stream, task) && fseek(stream, sizeof(uint32_t), SEEK_SET) == 0 &&
+                          fread(&record, sizeof(record), 1, stream) == 1;
+    if (stream_refused)
+    {
+        record.month = 13;
+        fseek(stream, sizeof(uint32_t), SEEK_SET);
+        fwrite(&record, sizeof(record), 1, stream);
+        rewind(stream);
+        copy = deserialize_task(stream);
+        stream_refused = copy == NULL;
+        if (copy)
+        {
+            free_subtasks(loaded, copy->subtasks);
+            free(copy->description);
+            free(copy);
+        }
+    }
+    if (stream)
+        fclose(stream);
+    free_task_manager(loaded);
+
+    // The same in a snapshot: that task is skipped and the rest load
+    FILE *file = fopen(SNAPSHOT_PATH, "r+b");
+    bool skipped = false;
+    if (file && fseek(file, sizeof(SnapshotHeader), SEEK_SET) == 0 && fread(&record, sizeof(record), 1, file) == 1)
+    {
+        record.date = 40;
+        fseek(file, sizeof(SnapshotHeader), SEEK_SET);
+        fwrite(&record, sizeof(record), 1, file);
+        fclose(file);
+        file = NULL;
+        TaskManager *crafted = create_task_manager();
+        skipped = crafted && load_tasks_from_file(crafted, SNAPSHOT_PATH) &&
+                  list_size(crafted->task_list) == count - 1 && !find_task(crafted, record.id);
+        free_task_manager(crafted);
+    }
+    if (file)
+        fclose(file);
+    printf("Invalid due dates refused: %s\n", stream_refused && skipped ? "ok" : "FAILED");
+
+    // A count large enough to wrap the size check must not get past it
+    SnapshotHeader header;
+    file = fopen(SNAPSHOT_PATH, "r+b");
+    bool refused = false;
+    if (file && fread(&header, sizeof(header), 1, file) == 1)
+    {
+        header.note_count += (uint64_t)1 << 61;
+        rewind(file);
+        fwrite(&header, sizeof(header), 1, file);
+        fclose(file);
+        TaskManager *crafted = create_task_manager();
+        refused = crafted && !load_tasks_from_file(crafted, SNAPSHOT_PATH);
+        free_task_manager(crafted);
+    }
+    else if (file)
+        fclose(file);
+    printf("Wrapped header counts refused: %s\n", refused ? "ok" : "FAILED");
+
+    remove(SNAPSHOT_PATH);
+    return 0;
+}
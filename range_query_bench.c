@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+
+#define DEFAULT_KEYS 10000000
+#define DEFAULT_BUCKETS 1024         // TASK_MAP_BUCKETS
+#define ROUNDS 3                     // Best of
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// The range's nodes in bucket order, as range_query leaves them before sorting
+static DynamicArray *collect_range(HashMapWithTree *map, int low, int high)
+{
+    DynamicArray *result = create_dynamic_array(1024);
+    for (int i = 0; result && i < map->capacity; i++)
+        range_query(map->buckets[i]->root, low, high, result);
+    return result;
+}
+
+// free_dynamic_array also frees what the items point at; these belong to the map
+static void release_array(DynamicArray *array)
+{
+    if (array)
+        array->size = 0;
+    free_dynamic_array(array);
+}
+
+static bool strictly_ascending(const DynamicArray *result)
+{
+    for (int i = 1; i < result->size; i++)
+    {
+        if (void_ptr_to_int(result->items[i - 1]->key) >= void_ptr_to_int(result->items[i]->key))
+            return false;
+    }
+    return true;
+}
+
+static double time_qsort(const DynamicArray *unsorted, HybridNode **items)
+{
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        struct timespec start, end;
+        memcpy(items, unsorted->items, sizeof(HybridNode *) * unsorted->size);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        qsort(items, unsorted->size, sizeof(HybridNode *), compare_nodes);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        best = round == 0 || elapsed_ms(start, end) < best ? elapsed_ms(start, end) : best;
+    }
+    return best;
+}
+
+// Extract pairs, sort, write the nodes back: what tree_map_range_query_ordered does after collecting
+static double time_pairs(const DynamicArray *unsorted, HybridNode **items, HybridEntry *entries, int threads)
+{
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < unsorted->size; i++)
+        {
+            entries[i].key = void_ptr_to_int(unsorted->items[i]->key);
+            entries[i].value = unsorted->items[i];
+        }
+        if (!sort_entries_parallel(entries, unsorted->size, threads))
+            return -1;
+        for (int i = 0; i < unsorted->size; i++)
+            items[i] = (HybridNode *)entries[i].value;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        best = round == 0 || elapsed_ms(start, end) < best ? elapsed_ms(start, end) : best;
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYS;
+    int buckets = argc > 2 ? atoi(argv[2]) : DEFAULT_BUCKETS;
+    int max_threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    struct timespec start, end;
+
+    HybridEntry *input = (HybridEntry *)malloc(sizeof(HybridEntry) * count);
+    HashMapWithTree *map = create_tree_map(buckets, 0);
+    if (!input || !map)
+        return 1;
+
+    uint64_t state = 46;
+    for (int i = 0; i < count; i++)
+    {
+        input[i].key = (int)(uint32_t)next_random(&state);
+        input[i].value = NULL;
+    }
+    int keys = tree_map_build(map, input, count, 0);
+    free(input);
+    printf("%d keys in %d buckets, %d CPU(s) online\n", keys, buckets, (int)sysconf(_SC_NPROCESSORS_ONLN));
+
+    // A tenth of the key space, then all of it
+    int64_t tenth = (int64_t)UINT32_MAX / 10;
+    int ranges[2][2] = {{INT32_MIN, (int)(INT32_MIN + tenth)}, {INT32_MIN, INT32_MAX}};
+    bool ok = keys > 0;
+    for (int r = 0; r < 2 && ok; r++)
+    {
+        DynamicArray *unsorted = collect_range(map, ranges[r][0], ranges[r][1]);
+        HybridNode **items = unsorted ? (HybridNode **)malloc(sizeof(HybridNode *) * (unsorted->size + 1)) : NULL;
+        HybridEntry *entries = unsorted ? (HybridEntry *)malloc(sizeof(HybridEntry) * (unsorted->size + 1)) : NULL;
+        if (!unsorted || !items || !entries)
+            return 1;
+
+        printf("\n%d results\n", unsorted->size);
+        double qsort_ms = time_qsort(unsorted, items);
+        printf("%-28s %8.1f ms\n", "qsort(compare_nodes)", qsort_ms);
+        DynamicArray check = {items, unsorted->size, unsorted->size};
+        ok = strictly_ascending(&check);
+
+        for (int threads = 1; threads <= max_threads && ok; threads *= 2)
+        {
+            double pairs_ms = time_pairs(unsorted, items, entries, threads);
+            char label[40];
+            snprintf(label, sizeof(label), "radix on pairs x%d", threads);
+            printf("%-28s %8.1f ms  %5.1fx qsort\n", label, pairs_ms, qsort_ms / pairs_ms);
+            ok = pairs_ms >= 0 && strictly_ascending(&check);
+        }
+
+        // End to end through the public call
+        DynamicArray *result = create_dynamic_array(1024);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        tree_map_range_query_ordered(map, ranges[r][0], ranges[r][1], result);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%-28s %8.1f ms (collect and sort)\n", "tree_map_range_query_ordered", elapsed_ms(start, end));
+        ok = ok && result && result->size == unsorted->size && strictly_ascending(result) &&
+             memcmp(result->items, items, sizeof(HybridNode *) * result->size) == 0;
+
+        release_array(result);
+        release_array(unsorted);
+        free(items);
+        free(entries);
+    }
+
+    printf("\nResults in key order: %s\n", ok ? "yes" : "NO");
+    free_tree_map(map);
+    return ok ? 0 : 1;
+}
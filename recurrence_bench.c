@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/recurrence.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_ITEMS 100000
+#define YEAR 2026
+#define AGENDA 50
+#define REPEATS 5
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Mostly daily and weekly, with a few hourly rules that dominate the occurrence count
+static RecurrenceType random_rule(void)
+{
+    int pick = rand() % 100;
+    return pick < 5 ? HOURLY : pick < 35 ? DAILY : pick < 60 ? WEEKLY : pick < 75 ? BI_WEEKLY
+           : pick < 90 ? MONTHLY : YEARLY;
+}
+
+static int compare_occurrences(const void *a, const void *b)
+{
+    const Occurrence *x = (const Occurrence *)a, *y = (const Occurrence *)b;
+    if (x->stamp != y->stamp)
+        return x->stamp < y->stamp ? -1 : 1;
+    return x->id - y->id;
+}
+
+// Every occurrence in the window by stepping each rule from its anchor, then sorted.
+// Items are added in id order, so (stamp, id) is the order the merge emits.
+static uint32_t brute_force(const RecurrenceEngine *engine, int64_t start, int64_t end, Occurrence *out)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < engine->count; i++)
+    {
+        const RecurringItem *item = &engine->items[i];
+        for (uint32_t n = 0;; n++)
+        {
+            int64_t stamp = nth_occurrence(item, n);
+            if (stamp >= end)
+                break;
+            if (stamp >= start)
+                out[count++] = (Occurrence){stamp, item->id, item->kind};
+        }
+    }
+    qsort(out, count, sizeof(Occurrence), compare_occurrences);
+    return count;
+}
+
+static bool same_occurrences(const Occurrence *a, const Occurrence *b, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (a[i].stamp != b[i].stamp || a[i].id != b[i].id || a[i].kind != b[i].kind)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_ITEMS;
+    struct timespec start, end;
+
+    // Stamps and dates agree across the whole century
+    bool same = true;
+    for (int64_t day = 0; day < 100 * 366 && same; day += 7)
+    {
+        int year, date;
+        MonthsInAYear month;
+        Time time;
+        int64_t stamp = day * MINUTES_PER_DAY + 13 * MINUTES_PER_HOUR + 7;
+        recurrence_split(stamp, &year, &month, &date, &time);
+        same = recurrence_stamp(year, month, date, time) == stamp && date <= days_in_month(year, month);
+    }
+
+    TaskManager *manager = create_task_manager();
+    RecurrenceEngine engine;
+    recurrence_engine_init(&engine);
+    if (!manager)
+        return 1;
+
+    srand(41);
+    for (int id = 1; id <= count; id++)
+    {
+        MonthsInAYear month = (MonthsInAYear)(rand() % 6);
+        Time time = {(char)(rand() % 4 * 15), (char)(8 + rand() % 10)};
+        Appointment *appointment = add_appointment(manager, id, (char)(1 + rand() % days_in_month(YEAR, month)),
+                                                   time, month, false, random_rule());
+        same = same && recurrence_add_appointment(&engine, YEAR, appointment);
+    }
+
+    Time midnight = {0, 0};
+    int64_t week = recurrence_stamp(YEAR, JULY, 6, midnight);
+    int64_t week_end = week + 7 * MINUTES_PER_DAY;
+
+    // One week, fully expanded
+    uint32_t capacity = 8 * 1024 * 1024;
+    Occurrence *out = (Occurrence *)malloc(sizeof(Occurrence) * capacity);
+    Occurrence *expected = (Occurrence *)malloc(sizeof(Occurrence) * capacity);
+    if (!out || !expected)
+        return 1;
+
+    int expanded = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEATS; r++)
+        expanded = recurrence_expand(&engine, week, week_end, out, (int)capacity);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double week_ms = elapsed_ms(start, end) / REPEATS;
+    printf("%d recurring items, one week: %d occurrences in %.1f ms (%.1f M occurrences/s)\n", count, expanded,
+           week_ms, expanded / week_ms / 1e3);
+
+    uint32_t brute = brute_force(&engine, week, week_end, expected);
+    same = same && brute == (uint32_t)expanded && same_occurrences(out, expected, brute);
+
+    // The next AGENDA occurrences from a moment in the week: the merge stops early
+    int64_t now = week + 3 * MINUTES_PER_DAY + 10 * MINUTES_PER_HOUR + 5;
+    int listed = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEATS; r++)
+        listed = recurrence_expand(&engine, now, INT64_MAX, out, AGENDA);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("next %d occurrences from now: %.2f ms\n", listed, elapsed_ms(start, end) / REPEATS);
+    for (int i = 1; same && i < listed; i++)
+        same = out[i - 1].stamp <= out[i].stamp && out[0].stamp >= now;
+
+    // Month windows through the cache: the first lookup expands, the rest are hits
+    int64_t month_start = recurrence_stamp(YEAR, AUGUST, 1, midnight);
+    int64_t month_end = recurrence_stamp(YEAR, SEPTEMBER, 1, midnight);
+    uint32_t month_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const Occurrence *month = recurrence_window(&engine, month_start, month_end, &month_count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double miss_ms = elapsed_ms(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEATS * 1000; r++)
+        month = recurrence_window(&engine, month_start, month_end, &month_count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double hit_us = elapsed_ms(start, end) * 1e3 / (REPEATS * 1000);
+    printf("August window: %u occurrences, expanded in %.1f ms (%.1f M occurrences/s), cached hit %.3f us\n",
+           month_count, miss_ms, month_count / miss_ms / 1e3, hit_us);
+
+    brute = brute_force(&engine, month_start, month_end, expected);
+    same = same && month && brute == month_count && same_occurrences(month, expected, brute);
+
+    // A rule change invalidates the cached window
+    recurrence_remove(&engine, RECURRING_APPOINTMENT, 1);
+    month = recurrence_window(&engine, month_start, month_end, &month_count);
+    brute = brute_force(&engine, month_start, month_end, expected);
+    same = same && month && brute == month_count && same_occurrences(month, expected, brute) &&
+           engine.cache_misses == 2;
+
+    // Memory: rules and cached windows against every instance of the year stored
+    uint64_t year_occurrences = 0;
+    int64_t year_start = recurrence_stamp(YEAR, JANUARY, 1, midnight);
+    int64_t year_end = recurrence_stamp(YEAR + 1, JANUARY, 1, midnight);
+    for (uint32_t i = 0; i < engine.count; i++)
+        year_occurrences += first_occurrence(&engine.items[i], year_end) -
+                            first_occurrence(&engine.items[i], year_start);
+    size_t rules = sizeof(RecurringItem) * engine.capacity + sizeof(RecurrenceCursor) * engine.heap_capacity;
+    printf("memory: rules and heap %.1f MB, cached windows %.1f MB; the year's %llu occurrences materialised "
+           "would take %.1f MB\n",
+           rules / 1e6, (recurrence_memory(&engine) - rules) / 1e6, (unsigned long long)year_occurrences,
+           year_occurrences * (double)sizeof(Occurrence) / 1e6);
+
+    printf("Expansions match brute force: %s\n", same ? "yes" : "NO");
+    free(out);
+    free(expected);
+    recurrence_engine_free(&engine);
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/recurrence.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_REMINDERS 1000000
+#define SPREAD_DAYS 30               // Reminders fall within the next month
+#define RESCHEDULES 200000
+#define CANCELS 100000
+#define POLL_TICKS 20
+
+typedef struct FireCheck {
+    int64_t tick;                    // Minute being advanced to
+    int64_t last_fire;
+    uint64_t fired;
+    bool in_order;
+} FireCheck;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Timers fire in their own minute and in fire time order
+static void check_fire(int id, int64_t fire_at, void *context)
+{
+    FireCheck *check = (FireCheck *)context;
+    (void)id;
+    check->in_order = check->in_order && fire_at == check->tick && fire_at >= check->last_fire;
+    check->last_fire = fire_at;
+    check->fired++;
+}
+
+// Stands in for the UI: counts refreshes and checks the task was promoted first
+static void refresh_view(TaskManager *manager, Task *task, void *context)
+{
+    uint64_t *refreshes = (uint64_t *)context;
+    (void)manager;
+    if (task->priority == HIGHEST_PRIORITY && !task->have_reminder && !task->reminder_timer)
+        (*refreshes)++;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_REMINDERS;
+    struct timespec start, end;
+
+    Time midnight = {0, 0};
+    int64_t now = recurrence_stamp(2026, JULY, 6, midnight);
+    int64_t *fire_at = (int64_t *)malloc(sizeof(int64_t) * (count + 1));
+    TaskManager *manager = create_task_manager();
+    if (!fire_at || !manager)
+        return 1;
+
+    srand(42);
+    for (int id = 1; id <= count; id++)
+    {
+        add_task(manager, id, "Call back", 2 + rand() % (LOWEST_PRIORITY - 1));
+        fire_at[id] = now + 1 + rand() % (SPREAD_DAYS * MINUTES_PER_DAY);
+    }
+    advance_reminders(manager, now);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int id = 1; id <= count; id++)
+        arm_task_reminder(manager, id, fire_at[id]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d reminders armed in %.1f ms (%.0f ns each), pool %.1f MB\n", count, elapsed_ms(start, end),
+           elapsed_ms(start, end) * 1e6 / count, reminder_wheel_memory(&manager->reminders) / 1e6);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < RESCHEDULES; i++)
+    {
+        int id = 1 + rand() % count;
+        fire_at[id] = now + 1 + rand() % (SPREAD_DAYS * MINUTES_PER_DAY);
+        arm_task_reminder(manager, id, fire_at[id]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double reschedule_ns = elapsed_ms(start, end) * 1e6 / RESCHEDULES;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < CANCELS; i++)
+    {
+        int id = 1 + rand() % count;
+        cancel_task_reminder(manager, id);
+        fire_at[id] = INT64_MAX;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("reschedule %.0f ns, cancel %.0f ns\n", reschedule_ns, elapsed_ms(start, end) * 1e6 / CANCELS);
+
+    // Polling: look at every task's fire time each minute
+    uint64_t polled = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int tick = 1; tick <= POLL_TICKS; tick++)
+    {
+        for (int id = 1; id <= count; id++)
+            polled += fire_at[id] == now + tick;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double poll_us = elapsed_ms(start, end) * 1e3 / POLL_TICKS;
+
+    // The wheel on its own, one minute at a time through the first day
+    ReminderWheel wheel;
+    reminder_wheel_init(&wheel, now);
+    for (int id = 1; id <= count; id++)
+    {
+        if (fire_at[id] != INT64_MAX)
+            reminder_wheel_arm(&wheel, id, fire_at[id]);
+    }
+    FireCheck check = {now, now, 0, true};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int tick = 1; tick <= MINUTES_PER_DAY; tick++)
+    {
+        check.tick = now + tick;
+        reminder_wheel_advance(&wheel, now + tick, check_fire, &check);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double wheel_us = elapsed_ms(start, end) * 1e3 / MINUTES_PER_DAY;
+    printf("per tick: polling %.1f us (%llu due), wheel %.2f us including %.1f fires and %.1f cascaded timers per tick\n",
+           poll_us, (unsigned long long)polled, wheel_us, (double)check.fired / MINUTES_PER_DAY, (double)wheel.cascaded / MINUTES_PER_DAY);
+
+    // Through the manager: each fire promotes its task and refreshes the view
+    uint64_t refreshes = 0;
+    set_reminder_handler(manager, refresh_view, &refreshes);
+    int fired = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int tick = 1; tick <= MINUTES_PER_DAY; tick++)
+        fired += advance_reminders(manager, now + tick);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("manager: %d reminders fired over a day, %.2f us per tick with promotion\n", fired,
+           elapsed_ms(start, end) * 1e3 / MINUTES_PER_DAY);
+
+    // Everything due fired exactly once, and nothing else did
+    uint64_t due = 0;
+    bool same = check.in_order && check.fired == (uint64_t)fired && refreshes == (uint64_t)fired;
+    for (int id = 1; id <= count && same; id++)
+    {
+        Task *task = find_task(manager, id);
+        bool spent = fire_at[id] <= now + MINUTES_PER_DAY;
+        due += spent;
+        same = spent ? task->priority == HIGHEST_PRIORITY && !task->have_reminder && !task->reminder_timer
+                     : (task->reminder_timer != NULL) == (fire_at[id] != INT64_MAX);
+    }
+    same = same && due == (uint64_t)fired && manager->reminders.count == wheel.count &&
+           task_store_status_count(&manager->store, -1, -1, 1) == manager->reminders.count;
+
+    // The rest, in one jump to the end of the month, plus an overdue and a far-off timer
+    reminder_wheel_arm(&wheel, -1, now);
+    reminder_wheel_arm(&wheel, -2, now + ((int64_t)1 << 25));
+    uint64_t armed = wheel.count;
+    same = same && reminder_wheel_next(&wheel) == wheel.now + 1;   // The overdue one, at once
+    same = same && reminder_wheel_advance(&wheel, now + SPREAD_DAYS * MINUTES_PER_DAY + 1, NULL, NULL) == armed - 1;
+    same = same && reminder_wheel_next(&wheel) <= now + ((int64_t)1 << 25);
+    same = same && reminder_wheel_advance(&wheel, now + ((int64_t)1 << 25), NULL, NULL) == 1 && wheel.count == 0 &&
+           reminder_wheel_next(&wheel) == INT64_MAX;
+
+    printf("Reminders fired on time: %s\n", same ? "yes" : "NO");
+    reminder_wheel_free(&wheel);
+    free_task_manager(manager);
+    free(fire_at);
+    return same ? 0 : 1;
+}
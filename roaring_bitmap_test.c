@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "include/roaring_bitmap.h"
+#include "src/roaring_bitmap.c"
+
+#define UNIVERSE (4 * 65536)
+#define OPERATIONS 2000000
+
+// Checks a set against a plain array of flags
+static bool matches(const RoaringBitmap *set, const bool *reference)
+{
+    uint64_t expected = 0;
+    for (uint32_t v = 0; v < UNIVERSE; v++)
+    {
+        if (roaring_contains(set, v) != reference[v])
+        {
+            printf("Value %u: expected %s\n", v, reference[v] ? "present" : "absent");
+            return false;
+        }
+        expected += reference[v];
+    }
+    return roaring_cardinality(set) == expected;
+}
+
+int main()
+{
+    RoaringBitmap sets[3];
+    bool *reference[3];
+    for (int s = 0; s < 3; s++)
+    {
+        roaring_init(&sets[s]);
+        reference[s] = (bool *)calloc(UNIVERSE, sizeof(bool));
+    }
+
+    // Set 0 is dense in its first container and sparse elsewhere, so containers turn
+    // into bitmaps and back; sets 1 and 2 are dense and sparse throughout
+    srand(39);
+    for (int op = 0; op < OPERATIONS; op++)
+    {
+        int s = rand() % 3;
+        uint32_t value = (uint32_t)rand() % UNIVERSE;
+        int density = s == 0 ? (value < 65536 ? 60 : 3) : (s == 1 ? 50 : 4);
+        bool add = rand() % 100 < density;
+
+        if (add)
+        {
+            roaring_add(&sets[s], value);
+            reference[s][value] = true;
+        }
+        else if (roaring_remove(&sets[s], value) != reference[s][value])
+        {
+            printf("Remove of %u disagreed with the reference.\n", value);
+            return 1;
+        }
+        else
+            reference[s][value] = false;
+    }
+
+    for (int s = 0; s < 3; s++)
+    {
+        if (!matches(&sets[s], reference[s]))
+            return 1;
+        printf("Set %d: %llu values in %u containers, %zu bytes\n", s,
+               (unsigned long long)roaring_cardinality(&sets[s]), sets[s].count, roaring_memory(&sets[s]));
+    }
+
+    // Intersections of two and three sets, listed and counted
+    uint32_t *out = (uint32_t *)malloc(sizeof(uint32_t) * UNIVERSE);
+    const RoaringBitmap *all[3] = {&sets[0], &sets[1], &sets[2]};
+    for (int n = 2; n <= 3; n++)
+    {
+        int found = roaring_intersect(all, n, out, UNIVERSE);
+        int expected = 0;
+        for (uint32_t v = 0; v < UNIVERSE; v++)
+        {
+            bool everywhere = reference[0][v] && reference[1][v] && (n < 3 || reference[2][v]);
+            if (everywhere && (expected >= found || out[expected++] != v))
+            {
+                printf("Intersection of %d sets is missing %u.\n", n, v);
+                return 1;
+            }
+        }
+        if (found != expected || roaring_intersect_count(all, n) != (uint64_t)found)
+        {
+            printf("Intersection of %d sets: %d found, %d expected.\n", n, found, expected);
+            return 1;
+        }
+        printf("Intersection of %d sets: %d values\n", n, found);
+    }
+
+    // A capped intersection stops at max_results
+    if (roaring_intersect(all, 2, out, 10) != 10)
+    {
+        printf("Capped intersection returned the wrong count.\n");
+        return 1;
+    }
+
+    // Emptying a set frees its containers
+    for (uint32_t v = 0; v < UNIVERSE; v++)
+        roaring_remove(&sets[1], v);
+    if (sets[1].count != 0 || roaring_cardinality(&sets[1]) != 0)
+    {
+        printf("Emptied set still has %u containers.\n", sets[1].count);
+        return 1;
+    }
+
+    for (int s = 0; s < 3; s++)
+    {
+        roaring_free(&sets[s]);
+        free(reference[s]);
+    }
+    free(out);
+    printf("All roaring bitmap checks passed.\n");
+    return 0;
+}
@@ -0,0 +1,468 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/archive.h"
+
+#define ARCHIVE_IO_BUFFER (1 << 20)
+
+// --- Helpers --- //
+
+static uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static uint64_t archive_string_size(const char *text)
+{
+    return sizeof(uint32_t) + strlen(text) + 1;
+}
+
+static bool write_archive_string(FILE *file, const char *text)
+{
+    uint32_t length = (uint32_t)strlen(text);
+    return fwrite(&length, sizeof(length), 1, file) == 1 &&
+           fwrite(text, 1, length + 1, file) == length + 1;
+}
+
+// Zero-fills up to offset; sections start on their aligned offsets
+static bool pad_to(FILE *file, uint64_t *position, uint64_t offset)
+{
+    static const char zeros[ARCHIVE_PAGE];
+    while (*position < offset)
+    {
+        size_t chunk = offset - *position < sizeof(zeros) ? (size_t)(offset - *position) : sizeof(zeros);
+        if (fwrite(zeros, 1, chunk, file) != chunk)
+            return false;
+        *position += chunk;
+    }
+    return true;
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+    uint64_t x = ((const ArchiveEntry *)a)->key, y = ((const ArchiveEntry *)b)->key;
+    return (x > y) - (x < y);
+}
+
+uint64_t archive_date_key(MonthsInAYear month, char date, Time time, int id)
+{
+    // The agenda key without completion and priority is exactly (month, date, time, id)
+    return task_order_pack(false, 0, month, date, time, id);
+}
+
+uint64_t archive_key(ArchiveOrder order, const TaskRecord *record)
+{
+    Time time = {(char)record->minutes, (char)record->hour};
+    MonthsInAYear month = (MonthsInAYear)(record->month % 12);
+
+    switch (order)
+    {
+    case ARCHIVE_BY_ID:
+        return (uint32_t)record->id;
+    case ARCHIVE_BY_PRIORITY:
+        return task_order_pack((record->flags & SNAPSHOT_COMPLETE) != 0, record->priority, month,
+                               (char)record->date, time, record->id);
+    default:
+        return archive_date_key(month, (char)record->date, time, record->id);
+    }
+}
+
+// --- Writing --- //
+
+// Lays out the levels of one index starting at offset; returns the end offset
+static uint64_t plan_index(ArchiveIndex *index, uint64_t entries, uint64_t offset)
+{
+    memset(index, 0, sizeof(*index));
+    index->count[0] = entries;
+    index->levels = 1;
+    while (index->count[index->levels - 1] > ARCHIVE_FANOUT && index->levels < ARCHIVE_MAX_LEVELS)
+    {
+        uint64_t below = index->count[index->levels - 1];
+        index->count[index->levels++] = (below + ARCHIVE_FANOUT - 1) / ARCHIVE_FANOUT;
+    }
+
+    for (uint32_t level = 0; level < index->levels; level++)
+    {
+        offset = align_up(offset, ARCHIVE_PAGE);
+        index->offset[level] = offset;
+        offset += index->count[level] * (level == 0 ? sizeof(ArchiveEntry) : sizeof(uint64_t));
+    }
+    return offset;
+}
+
+static bool write_index(FILE *file, uint64_t *position, const ArchiveIndex *index, const ArchiveEntry *entries)
+{
+    bool ok = pad_to(file, position, index->offset[0]) &&
+              fwrite(entries, sizeof(ArchiveEntry), index->count[0], file) == index->count[0];
+    *position += index->count[0] * sizeof(ArchiveEntry);
+
+    // Level l holds the first key of every ARCHIVE_FANOUT entries of level l - 1;
+    // that is the key of leaf entry j * FANOUT^l
+    uint64_t stride = 1;
+    for (uint32_t level = 1; ok && level < index->levels; level++)
+    {
+        stride *= ARCHIVE_FANOUT;
+        ok = pad_to(file, position, index->offset[level]);
+        for (uint64_t j = 0; ok && j < index->count[level]; j++)
+            ok = fwrite(&entries[j * stride].key, sizeof(uint64_t), 1, file) == 1;
+        *position += index->count[level] * sizeof(uint64_t);
+    }
+    return ok;
+}
+
+bool write_archive(TaskManager *manager, const char *filename, bool completed_only)
+{
+    if (!manager || !filename)
+        return false;
+
+    // Records go in agenda order, which the index already walks
+    size_t capacity = manager->agenda_index.size > 0 ? (size_t)manager->agenda_index.size : 1;
+    Task **tasks = (Task **)malloc(sizeof(Task *) * capacity);
+    ArchiveEntry *entries = (ArchiveEntry *)malloc(sizeof(ArchiveEntry) * capacity);
+    if (!tasks || !entries)
+    {
+        free(tasks);
+        free(entries);
+        return false;
+    }
+
+    ArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ARCHIVE_MAGIC;
+    header.version = ARCHIVE_VERSION;
+
+    uint64_t count = 0;
+    for (task_order_index_node *node = task_order_index_first(&manager->agenda_index); node;
+         node = task_order_index_next(node))
+    {
+        Task *task = (Task *)first_value_in_list(&node->list);
+        if (completed_only && !task->is_complete)
+            continue;
+        tasks[count++] = task;
+        header.subtask_count += task->subtasks ? task->subtasks->size : 0;
+        header.heap_size += archive_string_size(task->description);
+        if (task->note && task->note->description)
+            header.heap_size += archive_string_size(task->note->description);
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+            header.heap_size += archive_string_size(((SubTask *)sub->data->value)->description);
+    }
+
+    header.task_count = count;
+    header.tasks_offset = align_up(sizeof(header), 8);
+    header.subtasks_offset = header.tasks_offset + count * sizeof(TaskRecord);
+    uint64_t end = header.subtasks_offset + header.subtask_count * sizeof(SubTaskRecord);
+    for (int order = 0; order < ARCHIVE_ORDERS; order++)
+        end = plan_index(&header.index[order], count, end);
+    header.heap_offset = align_up(end, 8);
+    header.file_size = header.heap_offset + header.heap_size;
+
+    size_t path_length = strlen(filename);
+    char *temp_path = (char *)malloc(path_length + 5);
+    FILE *file = NULL;
+    if (temp_path)
+    {
+        memcpy(temp_path, filename, path_length);
+        memcpy(temp_path + path_length, ".tmp", 5);
+        file = fopen(temp_path, "wb");
+    }
+    if (!file)
+    {
+        printf("Could not open archive %s for writing.\n", filename);
+        free(temp_path);
+        free(tasks);
+        free(entries);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, ARCHIVE_IO_BUFFER);
+
+    uint64_t position = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    position += sizeof(header);
+    ok = ok && pad_to(file, &position, header.tasks_offset);
+
+    // Task records; string offsets are handed out in the order the heap is written below
+    uint64_t heap_offset = 0, subtask_index = 0;
+    for (uint64_t i = 0; ok && i < count; i++)
+    {
+        Task *task = tasks[i];
+        TaskRecord record;
+        fill_task_record(&record, task);
+        record.first_subtask = subtask_index;
+        subtask_index += record.subtask_count;
+        record.description = heap_offset;
+        heap_offset += archive_string_size(task->description);
+        if (task->note && task->note->description)
+        {
+            record.note = heap_offset;
+            heap_offset += archive_string_size(task->note->description);
+        }
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+            heap_offset += archive_string_size(((SubTask *)sub->data->value)->description);
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    position += count * sizeof(TaskRecord);
+
+    // Subtask strings follow their task's description and note in the heap
+    heap_offset = 0;
+    for (uint64_t i = 0; ok && i < count; i++)
+    {
+        Task *task = tasks[i];
+        heap_offset += archive_string_size(task->description);
+        if (task->note && task->note->description)
+            heap_offset += archive_string_size(task->note->description);
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+        {
+            SubTask *subtask = (SubTask *)sub->data->value;
+            SubTaskRecord record = {subtask->task_id, subtask->priority, heap_offset};
+            heap_offset += archive_string_size(subtask->description);
+            ok = fwrite(&record, sizeof(record), 1, file) == 1;
+        }
+    }
+    position += header.subtask_count * sizeof(SubTaskRecord);
+
+    // Indexes: the priority order is the record order, the others are sorted
+    for (int order = 0; ok && order < ARCHIVE_ORDERS; order++)
+    {
+        for (uint64_t i = 0; i < count; i++)
+        {
+            TaskRecord record;
+            fill_task_record(&record, tasks[i]);
+            entries[i].key = archive_key((ArchiveOrder)order, &record);
+            entries[i].record = i;
+        }
+        if (order != ARCHIVE_BY_PRIORITY)
+            qsort(entries, count, sizeof(ArchiveEntry), compare_entries);
+        ok = write_index(file, &position, &header.index[order], entries);
+    }
+
+    ok = ok && pad_to(file, &position, header.heap_offset);
+    for (uint64_t i = 0; ok && i < count; i++)
+    {
+        Task *task = tasks[i];
+        ok = write_archive_string(file, task->description);
+        if (ok && task->note && task->note->description)
+            ok = write_archive_string(file, task->note->description);
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+            ok = write_archive_string(file, ((SubTask *)sub->data->value)->description);
+    }
+
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(temp_path, filename) == 0;
+    if (!ok)
+    {
+        printf("Failed to write archive %s.\n", filename);
+        remove(temp_path);
+    }
+
+    free(temp_path);
+    free(tasks);
+    free(entries);
+    return ok;
+}
+
+// --- Browsing --- //
+
+static bool valid_index(const ArchiveHeader *header, const ArchiveIndex *index)
+{
+    if (index->levels < 1 || index->levels > ARCHIVE_MAX_LEVELS || index->count[0] != header->task_count)
+        return false;
+
+    for (uint32_t level = 0; level < index->levels; level++)
+    {
+        uint64_t width = level == 0 ? sizeof(ArchiveEntry) : sizeof(uint64_t);
+        if (index->offset[level] % 8 != 0 || index->offset[level] > header->file_size ||
+            index->count[level] > (header->file_size - index->offset[level]) / width)
+            return false;
+        if (level > 0 && index->count[level] != (index->count[level - 1] + ARCHIVE_FANOUT - 1) / ARCHIVE_FANOUT)
+            return false;
+    }
+    return index->count[index->levels - 1] <= ARCHIVE_FANOUT;
+}
+
+TaskArchive *open_archive(const char *filename)
+{
+    if (!filename)
+        return NULL;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ArchiveHeader))
+    {
+        close(fd);
+        printf("Archive %s is too small.\n", filename);
+        return NULL;
+    }
+
+    size_t size = (size_t)info.st_size;
+    const char *base = (const char *)mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    // Lookups jump around; read only the pages a query touches
+    madvise((void *)base, size, MADV_RANDOM);
+
+    const ArchiveHeader *header = (const ArchiveHeader *)base;
+    bool ok = header->magic == ARCHIVE_MAGIC && header->version == ARCHIVE_VERSION &&
+              header->file_size == size && header->heap_offset <= size &&
+              header->heap_size == size - header->heap_offset &&
+              header->tasks_offset % 8 == 0 && header->subtasks_offset % 8 == 0 &&
+              header->task_count <= (size - header->tasks_offset) / sizeof(TaskRecord) &&
+              header->subtasks_offset == header->tasks_offset + header->task_count * sizeof(TaskRecord) &&
+              header->subtask_count <= (size - header->subtasks_offset) / sizeof(SubTaskRecord);
+    for (int order = 0; ok && order < ARCHIVE_ORDERS; order++)
+        ok = valid_index(header, &header->index[order]);
+
+    TaskArchive *archive = ok ? (TaskArchive *)malloc(sizeof(TaskArchive)) : NULL;
+    if (!archive)
+    {
+        if (!ok)
+            printf("Archive %s is not a version %d archive or is truncated.\n", filename, ARCHIVE_VERSION);
+        munmap((void *)base, size);
+        return NULL;
+    }
+
+    archive->base = base;
+    archive->size = size;
+    archive->header = header;
+    archive->tasks = (const TaskRecord *)(base + header->tasks_offset);
+    archive->subtasks = (const SubTaskRecord *)(base + header->subtasks_offset);
+    archive->heap = base + header->heap_offset;
+    return archive;
+}
+
+void close_archive(TaskArchive *archive)
+{
+    if (!archive)
+        return;
+
+    munmap((void *)archive->base, archive->size);
+    free(archive);
+}
+
+uint64_t archive_task_count(const TaskArchive *archive)
+{
+    return archive ? archive->header->task_count : 0;
+}
+
+const char *archive_text(const TaskArchive *archive, uint64_t offset)
+{
+    uint64_t heap_size = archive->header->heap_size;
+    uint32_t length;
+
+    if (offset == SNAPSHOT_NO_STRING || offset > heap_size || heap_size - offset < sizeof(length) + 1)
+        return NULL;
+
+    memcpy(&length, archive->heap + offset, sizeof(length));
+    if (length > heap_size - offset - sizeof(length) - 1 || archive->heap[offset + sizeof(length) + length] != '\0')
+        return NULL;
+
+    return archive->heap + offset + sizeof(length);
+}
+
+const SubTaskRecord *archive_subtask(const TaskArchive *archive, const TaskRecord *task, uint32_t i)
+{
+    if (!archive || !task || i >= task->subtask_count ||
+        task->first_subtask + i >= archive->header->subtask_count)
+        return NULL;
+    return &archive->subtasks[task->first_subtask + i];
+}
+
+// Position of the first leaf entry with key >= target, descending one page per level
+static uint64_t archive_lower_bound(const TaskArchive *archive, const ArchiveIndex *index, uint64_t target)
+{
+    uint64_t start = 0, end = index->count[index->levels - 1];
+
+    for (uint32_t level = index->levels - 1; level > 0; level--)
+    {
+        const uint64_t *keys = (const uint64_t *)(archive->base + index->offset[level]);
+        if (end > index->count[level])
+            end = index->count[level];
+
+        // Last block whose first key is <= target
+        uint64_t low = start, high = end;
+        while (low < high)
+        {
+            uint64_t middle = low + (high - low) / 2;
+            if (keys[middle] <= target)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        uint64_t block = low > start ? low - 1 : start;
+        start = block * ARCHIVE_FANOUT;
+        end = start + ARCHIVE_FANOUT;
+    }
+
+    const ArchiveEntry *entries = (const ArchiveEntry *)(archive->base + index->offset[0]);
+    if (end > index->count[0])
+        end = index->count[0];
+
+    uint64_t low = start, high = end;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low) / 2;
+        if (entries[middle].key < target)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+int archive_range(const TaskArchive *archive, ArchiveOrder order, uint64_t low, uint64_t high,
+                  const TaskRecord **out, int max_results)
+{
+    if (!archive || !out || order >= ARCHIVE_ORDERS)
+        return 0;
+
+    const ArchiveIndex *index = &archive->header->index[order];
+    const ArchiveEntry *entries = (const ArchiveEntry *)(archive->base + index->offset[0]);
+    int count = 0;
+
+    for (uint64_t i = archive_lower_bound(archive, index, low);
+         i < index->count[0] && entries[i].key < high && count < max_results; i++)
+    {
+        if (entries[i].record < archive->header->task_count)
+            out[count++] = &archive->tasks[entries[i].record];
+    }
+    return count;
+}
+
+const TaskRecord *archive_find_task(const TaskArchive *archive, int id)
+{
+    const TaskRecord *record = NULL;
+    uint64_t key = (uint32_t)id;
+    return archive_range(archive, ARCHIVE_BY_ID, key, key + 1, &record, 1) ? record : NULL;
+}
+
+int archive_agenda(const TaskArchive *archive, bool is_complete, unsigned int min_priority,
+                   unsigned int max_priority, const TaskRecord **out, int max_results)
+{
+    if (min_priority > max_priority)
+        return 0;
+
+    return archive_range(archive, ARCHIVE_BY_PRIORITY, task_order_priority_start(is_complete, min_priority),
+                         task_order_priority_start(is_complete, max_priority + 1), out, max_results);
+}
+
+int archive_day(const TaskArchive *archive, MonthsInAYear month, char date,
+                const TaskRecord **out, int max_results)
+{
+    Time midnight = {0, 0};
+    uint64_t low = archive_date_key(month, date, midnight, 0);
+    // One past the date field; a carry into the month is still the right bound
+    return archive_range(archive, ARCHIVE_BY_DATE, low, low + ((uint64_t)1 << TASK_ORDER_DATE_SHIFT),
+                         out, max_results);
+}
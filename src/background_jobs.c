@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/background_jobs.h"
+
+typedef struct BackgroundJob {
+    WorkerJob job;
+    BackgroundDone done;
+    void *context;
+    bool ok;
+
+    Wal *wal;                        // Sync
+    uint64_t sequence;
+    char *snapshot_path;             // Export and archive
+    char *filename;
+    ExchangeFormat format;
+    bool completed_only;
+    RecurrenceEngine engine;         // Expansion
+    RecurrenceExpansion expansion;
+} BackgroundJob;
+
+// --- Helpers --- //
+
+static BackgroundJob *create_background_job(WorkerJobFn run, BackgroundDone done, void *context)
+{
+    BackgroundJob *job = (BackgroundJob *)calloc(1, sizeof(BackgroundJob));
+    if (!job)
+    {
+        printf("Memory allocation failed for BackgroundJob.\n");
+        return NULL;
+    }
+    recurrence_engine_init(&job->engine);
+    job->job.run = run;
+    job->job.context = job;
+    job->done = done;
+    job->context = context;
+    return job;
+}
+
+static void free_background_job(BackgroundJob *job)
+{
+    recurrence_engine_free(&job->engine);
+    free(job->snapshot_path);
+    free(job->filename);
+    free(job);
+}
+
+static void finish_background_job(WorkerJob *worker_job)
+{
+    BackgroundJob *job = (BackgroundJob *)worker_job->context;
+    if (job->done)
+        job->done(job->ok, job->expansion.occurrences ? &job->expansion : NULL, job->context);
+    free_background_job(job);
+}
+
+static bool submit_background_job(WorkerPool *pool, BackgroundJob *job)
+{
+    job->job.done = finish_background_job;
+    if (worker_pool_submit(pool, &job->job))
+        return true;
+
+    free_background_job(job);
+    return false;
+}
+
+static bool copy_paths(BackgroundJob *job, const char *snapshot_path, const char *filename)
+{
+    job->snapshot_path = strdup(snapshot_path);
+    job->filename = strdup(filename);
+    if (job->snapshot_path && job->filename)
+        return true;
+
+    printf("Memory allocation failed for BackgroundJob paths.\n");
+    return false;
+}
+
+// --- Jobs --- //
+
+static void run_sync(WorkerJob *worker_job)
+{
+    BackgroundJob *job = (BackgroundJob *)worker_job->context;
+    job->ok = wal_sync(job->wal, job->sequence);
+}
+
+static void run_export(WorkerJob *worker_job)
+{
+    BackgroundJob *job = (BackgroundJob *)worker_job->context;
+    TaskManager *copy = wal_load_private(job->snapshot_path);
+    job->ok = copy && export_to_file(copy, job->filename, job->format);
+    free_task_manager(copy);
+}
+
+static void run_archive(WorkerJob *worker_job)
+{
+    BackgroundJob *job = (BackgroundJob *)worker_job->context;
+    TaskManager *copy = wal_load_private(job->snapshot_path);
+    job->ok = copy && write_archive(copy, job->filename, job->completed_only);
+    free_task_manager(copy);
+}
+
+static void run_expand(WorkerJob *worker_job)
+{
+    BackgroundJob *job = (BackgroundJob *)worker_job->context;
+    static const Occurrence no_occurrences[1];
+
+    uint32_t count = 0;
+    const Occurrence *occurrences = recurrence_window(&job->engine, job->expansion.start, job->expansion.end, &count);
+    job->ok = occurrences != NULL;
+    job->expansion.occurrences = occurrences ? occurrences : no_occurrences;
+    job->expansion.count = count;
+}
+
+bool background_sync(WorkerPool *pool, Wal *wal, uint64_t sequence, BackgroundDone done, void *context)
+{
+    if (!pool || !wal)
+        return false;
+
+    BackgroundJob *job = create_background_job(run_sync, done, context);
+    if (!job)
+        return false;
+    job->wal = wal;
+    job->sequence = sequence;
+    return submit_background_job(pool, job);
+}
+
+bool background_export(WorkerPool *pool, const char *snapshot_path, const char *filename, ExchangeFormat format,
+                       BackgroundDone done, void *context)
+{
+    if (!pool || !snapshot_path || !filename)
+        return false;
+
+    BackgroundJob *job = create_background_job(run_export, done, context);
+    if (!job)
+        return false;
+    if (!copy_paths(job, snapshot_path, filename))
+    {
+        free_background_job(job);
+        return false;
+    }
+    job->format = format;
+    return submit_background_job(pool, job);
+}
+
+bool background_archive(WorkerPool *pool, const char *snapshot_path, const char *filename, bool completed_only,
+                        BackgroundDone done, void *context)
+{
+    if (!pool || !snapshot_path || !filename)
+        return false;
+
+    BackgroundJob *job = create_background_job(run_archive, done, context);
+    if (!job)
+        return false;
+    if (!copy_paths(job, snapshot_path, filename))
+    {
+        free_background_job(job);
+        return false;
+    }
+    job->completed_only = completed_only;
+    return submit_background_job(pool, job);
+}
+
+bool background_expand(WorkerPool *pool, const RecurrenceEngine *engine, int64_t start, int64_t end,
+                       BackgroundDone done, void *context)
+{
+    if (!pool || !engine || start >= end)
+        return false;
+
+    BackgroundJob *job = create_background_job(run_expand, done, context);
+    if (!job)
+        return false;
+    if (!recurrence_engine_copy(&job->engine, engine))
+    {
+        free_background_job(job);
+        return false;
+    }
+    job->expansion.start = start;
+    job->expansion.end = end;
+    return submit_background_job(pool, job);
+}
@@ -0,0 +1,203 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/calendar_index.h"
+
+// --- Helpers --- //
+
+static bool valid_day(int month, int date)
+{
+    return month >= JANUARY && month <= DECEMBER && date >= 1 && date <= CALENDAR_DAYS;
+}
+
+static CalendarYear *find_calendar_year(const CalendarIndex *index, int year)
+{
+    if (!index || year < index->first_year || year - index->first_year >= (int)index->year_count)
+        return NULL;
+    return index->years[year - index->first_year];
+}
+
+// The year's block, widening the range of years held when it is new
+static CalendarYear *calendar_year_for(CalendarIndex *index, int year)
+{
+    CalendarYear *found = find_calendar_year(index, year);
+    if (found)
+        return found;
+
+    if (index->year_count == 0 || year < index->first_year ||
+        year - index->first_year >= (int)index->year_count)
+    {
+        int first = index->year_count && index->first_year < year ? index->first_year : year;
+        int last = index->year_count && index->first_year + (int)index->year_count - 1 > year
+                       ? index->first_year + (int)index->year_count - 1
+                       : year;
+        uint32_t count = (uint32_t)(last - first + 1);
+
+        CalendarYear **years = (CalendarYear **)calloc(count, sizeof(CalendarYear *));
+        if (!years)
+        {
+            printf("Memory allocation failed for CalendarIndex years.\n");
+            return NULL;
+        }
+        if (index->year_count)
+            memcpy(years + (index->first_year - first), index->years, sizeof(CalendarYear *) * index->year_count);
+        free(index->years);
+        index->years = years;
+        index->first_year = first;
+        index->year_count = count;
+    }
+
+    CalendarYear *block = (CalendarYear *)calloc(1, sizeof(CalendarYear));
+    if (!block)
+    {
+        printf("Memory allocation failed for CalendarYear.\n");
+        return NULL;
+    }
+    index->years[year - index->first_year] = block;
+    return block;
+}
+
+static bool append_handle(void ***handles, uint32_t *count, uint32_t *capacity, void *handle)
+{
+    if (*count == *capacity)
+    {
+        uint32_t grown = *capacity ? *capacity * 2 : CALENDAR_INITIAL_BUCKET;
+        void **resized = (void **)realloc(*handles, sizeof(void *) * grown);
+        if (!resized)
+        {
+            printf("Memory allocation failed for CalendarDay.\n");
+            return false;
+        }
+        *handles = resized;
+        *capacity = grown;
+    }
+    (*handles)[(*count)++] = handle;
+    return true;
+}
+
+// Order within a day is kept, so removal shifts the tail down
+static bool remove_handle(void **handles, uint32_t *count, const void *handle)
+{
+    for (uint32_t i = 0; i < *count; i++)
+    {
+        if (handles[i] == handle)
+        {
+            memmove(handles + i, handles + i + 1, sizeof(void *) * (*count - i - 1));
+            (*count)--;
+            return true;
+        }
+    }
+    return false;
+}
+
+static CalendarDay *bucket_for(CalendarIndex *index, int year, int month, int date, bool create)
+{
+    if (!index || !valid_day(month, date))
+        return NULL;
+
+    CalendarYear *block = create ? calendar_year_for(index, year) : find_calendar_year(index, year);
+    return block ? &block->days[month][date - 1] : NULL;
+}
+
+// --- Index Lifecycle --- //
+
+void calendar_index_init(CalendarIndex *index)
+{
+    memset(index, 0, sizeof(CalendarIndex));
+}
+
+void calendar_index_free(CalendarIndex *index)
+{
+    if (!index)
+        return;
+
+    for (uint32_t y = 0; y < index->year_count; y++)
+    {
+        CalendarYear *block = index->years[y];
+        if (!block)
+            continue;
+        for (int month = 0; month < CALENDAR_MONTHS; month++)
+        {
+            for (int date = 0; date < CALENDAR_DAYS; date++)
+            {
+                free(block->days[month][date].tasks);
+                free(block->days[month][date].appointments);
+            }
+        }
+        free(block);
+    }
+    free(index->years);
+    calendar_index_init(index);
+}
+
+// --- Filing --- //
+
+bool calendar_index_add_task(CalendarIndex *index, int year, Task *task)
+{
+    CalendarDay *day = task ? bucket_for(index, year, task->month, task->date, true) : NULL;
+    if (!day || !append_handle((void ***)&day->tasks, &day->task_count, &day->task_capacity, task))
+        return false;
+    index->tasks++;
+    return true;
+}
+
+bool calendar_index_add_appointment(CalendarIndex *index, int year, Appointment *appointment)
+{
+    CalendarDay *day = appointment ? bucket_for(index, year, appointment->month, appointment->date, true) : NULL;
+    if (!day || !append_handle((void ***)&day->appointments, &day->appointment_count, &day->appointment_capacity,
+                               appointment))
+        return false;
+    index->appointments++;
+    return true;
+}
+
+bool calendar_index_remove_task(CalendarIndex *index, int year, const Task *task)
+{
+    CalendarDay *day = task ? bucket_for(index, year, task->month, task->date, false) : NULL;
+    if (!day || !remove_handle((void **)day->tasks, &day->task_count, task))
+        return false;
+    index->tasks--;
+    return true;
+}
+
+bool calendar_index_remove_appointment(CalendarIndex *index, int year, const Appointment *appointment)
+{
+    CalendarDay *day = appointment ? bucket_for(index, year, appointment->month, appointment->date, false) : NULL;
+    if (!day || !remove_handle((void **)day->appointments, &day->appointment_count, appointment))
+        return false;
+    index->appointments--;
+    return true;
+}
+
+// --- Lookup --- //
+
+const CalendarDay *calendar_day(const CalendarIndex *index, int year, MonthsInAYear month, int date)
+{
+    if (!valid_day(month, date))
+        return NULL;
+
+    const CalendarYear *block = find_calendar_year(index, year);
+    return block ? &block->days[month][date - 1] : NULL;
+}
+
+int days_in_month(int year, MonthsInAYear month)
+{
+    static const int lengths[CALENDAR_MONTHS] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < JANUARY || month > DECEMBER)
+        return 0;
+
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == FEBRUARY && leap ? 29 : lengths[month];
+}
+
+int calendar_month_view(const CalendarIndex *index, int year, MonthsInAYear month,
+                        const CalendarDay *days[CALENDAR_DAYS])
+{
+    int length = days_in_month(year, month);
+    const CalendarYear *block = find_calendar_year(index, year);
+    for (int date = 0; date < length; date++)
+        days[date] = block ? &block->days[month][date] : NULL;
+    return length;
+}
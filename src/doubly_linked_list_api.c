@@ -55,7 +55,7 @@ bool is_empty(DoublyLinkedList *list)
 
 bool is_full(DoublyLinkedList *list)
 {
-    return list->size >= list->max_capacity;
+    return list->max_capacity != UNBOUNDED_LIST_CAPACITY && list->size >= (unsigned int)list->max_capacity;
 }
 
 int list_size(DoublyLinkedList *list)
@@ -379,6 +379,57 @@ Node *delete_by_value(DoublyLinkedList *list, void *target_value)
     return list->head;
 }
 
+Node *unlink_node(DoublyLinkedList *list, Node *node)
+{
+    if (!list || !node)
+        return NULL;
+
+    if (node->previous)
+        node->previous->next = node->next;
+    else
+        list->head = node->next;
+
+    if (node->next)
+        node->next->previous = node->previous;
+    else
+        list->tail = node->previous;
+
+    node->previous = node->next = NULL;
+    list->size--;
+    return node;
+}
+
+Node *relink_after(DoublyLinkedList *list, Node *previous_node, Node *node)
+{
+    if (!list || !node)
+        return NULL;
+
+    node->previous = previous_node;
+    node->next = previous_node ? previous_node->next : list->head;
+
+    if (node->next)
+        node->next->previous = node;
+    else
+        list->tail = node;
+
+    if (previous_node)
+        previous_node->next = node;
+    else
+        list->head = node;
+
+    list->size++;
+    return node;
+}
+
+void delete_node(DoublyLinkedList *list, Node *node)
+{
+    if (!unlink_node(list, node))
+        return;
+
+    free(node->data);
+    free(node);
+}
+
 Node *search_list(DoublyLinkedList *list, void *target_value)
 {
     if (!list)
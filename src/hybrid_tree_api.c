@@ -18,8 +18,6 @@
 
 #include "../include/hybrid_tree_api.h"
 
-#define IS_RED(n) ((n) != NULL && (n)->color == RED)
-
 #define REBALANCE_THRESHOLD 10
 #define CAPACiTY 1000
 
@@ -61,8 +59,7 @@ HybridNode *create_hybrid_node(int key, void *value)
     node->key = int_to_void_ptr(key); // Convert int to void pointer
     node->value = value;              // ✅ Store the passed-in value
 
-    node->color = RED; // New nodes are RED
-    node->height = 1;  // AVL height
+    node->height = 0;  // AVL height; an empty subtree is -1
     node->access_count = 0;
 
     node->parent = NULL;
@@ -104,8 +101,13 @@ HybridNode *avl_rotate_left(HybridNode *node)
     struct HybridNode *new_position = node->child[RIGHT];
 
     node->child[RIGHT] = new_position->child[LEFT];
+    if (node->child[RIGHT])
+        node->child[RIGHT]->parent = node;
     new_position->child[LEFT] = node;
 
+    new_position->parent = node->parent;
+    node->parent = new_position;
+
     update_height(node);         // Update height of the rotated node
     update_height(new_position); // Update height of the new root
 
@@ -117,8 +119,13 @@ HybridNode *avl_rotate_right(HybridNode *node)
     struct HybridNode *new_position = node->child[LEFT];
 
     node->child[LEFT] = new_position->child[RIGHT];
+    if (node->child[LEFT])
+        node->child[LEFT]->parent = node;
     new_position->child[RIGHT] = node;
 
+    new_position->parent = node->parent;
+    node->parent = new_position;
+
     update_height(node);         // Update height of the rotated node
     update_height(new_position); // Update height of the new root
 
@@ -166,24 +173,6 @@ HybridNode *rebalance_if_needed(HybridTree *tree, HybridNode *node)
     return node; // Return the potentially rebalanced node
 }
 
-void color_flip(HybridNode *node)
-{
-    if (!node)
-        return; // Ensure node is not NULL
-
-    node->color = (node->color == RED) ? BLACK : RED;
-
-    if (node->child[LEFT])
-    {
-        node->child[LEFT]->color = (node->child[LEFT]->color == RED) ? BLACK : RED;
-    }
-
-    if (node->child[RIGHT])
-    {
-        node->child[RIGHT]->color = (node->child[RIGHT]->color == RED) ? BLACK : RED;
-    }
-}
-
 void swap_keys(HybridNode *a, HybridNode *b)
 {
     int temp = void_ptr_to_int(a->key);
@@ -191,121 +180,29 @@ void swap_keys(HybridNode *a, HybridNode *b)
     b->key = int_to_void_ptr(temp);
 }
 
-HybridNode *rotate(struct HybridTree *tree, HybridNode *node, Direction dir)
-{
-    struct HybridNode *new_root = node->child[!dir]; // Get the child to rotate up
-
-    if (!new_root)
-        return node; // Safety check: return the original node if no child to rotate
-
-    node->child[!dir] = new_root->child[dir]; // Move the subtree
-    if (new_root->child[dir])
-    {
-        new_root->child[dir]->parent = node; // Update parent pointer
-    }
-
-    new_root->child[dir] = node;     // Perform the rotation
-    new_root->parent = node->parent; // Preserve the original parent's pointer
-
-    // Update the parent's child pointer if necessary
-    if (node->parent)
-    {
-        if (node->parent->child[LEFT] == node)
-            node->parent->child[LEFT] = new_root;
-        else
-            node->parent->child[RIGHT] = new_root;
-    }
-    else
-    {
-        tree->root = new_root; // Update the root if the node was the root
-    }
-
-    node->parent = new_root; // Update the original node's parent
-
-    // Swap colors (needed for Red-Black Tree balancing)
-    new_root->color = node->color;
-    node->color = RED;
-
-    // Update heights for AVL balancing
-    update_height(node);
-    update_height(new_root);
-
-    return new_root; // Return the new root after the rotation
-}
-
-HybridNode *double_rotate(HybridTree *tree, HybridNode *node, Direction dir)
-{
-    // Perform the first rotation in the opposite direction
-    node->child[!dir] = rotate(tree, node->child[!dir], (Direction)!dir);
-    // Perform the second rotation in the given direction
-    return rotate(tree, node, dir);
-}
-
-HybridNode *rb_insert_fixup(HybridTree *tree, HybridNode *node, Direction dir)
-{
-    while (node->parent && node->parent->color == RED)
-    {
-        struct HybridNode *grandparent = node->parent->parent;
-
-        if (grandparent == NULL)
-            break; // No grandparent, exit the loop
-
-        struct HybridNode *uncle = grandparent->child[!dir];
-
-        if (uncle && uncle->color == RED)
-        {
-            // Case 1: Uncle is red
-            node->parent->color = BLACK;
-            uncle->color = BLACK;
-            grandparent->color = RED;
-            node = grandparent; // Move up the tree
-        }
-        else
-        {
-            // Case 2: Uncle is black or NULL, and we need to rotate
-            if (node == node->parent->child[!dir])
-            {
-                // Perform rotation to make the node the outer child
-                node = node->parent;
-                rotate(tree, node, dir);
-            }
-
-            // Perform rotation to make the grandparent the inner child
-            node->parent->color = BLACK;
-            grandparent->color = RED;
-            rotate(tree, grandparent, (Direction)!dir);
-        }
-    }
-
-    // Ensure the root is black
-    tree->root->color = BLACK;
-
-    return node;
-}
-
 // Function definition in implementation file (hybrid_tree_api.c)
-HybridNode *insert_hybrid(HybridTree *tree, HybridNode *node, int key, void *value, Direction dir, bool *fixup_ok)
+HybridNode *insert_hybrid(HybridTree *tree, HybridNode *node, int key, void *value)
 {
     if (node == NULL)
     {
-        *fixup_ok = true;
         tree->size++;
         HybridNode *new_node = create_hybrid_node(key, value);
         return new_node;
     }
 
-    int cmp = key - void_ptr_to_int(node->key);
+    int node_key = void_ptr_to_int(node->key);
+    int cmp = (key > node_key) - (key < node_key);
 
     if (cmp < 0)
     {
-        HybridNode *inserted = insert_hybrid(tree, node->child[LEFT], key, value, LEFT, fixup_ok);
+        HybridNode *inserted = insert_hybrid(tree, node->child[LEFT], key, value);
         node->child[LEFT] = inserted;
         if (inserted)
             inserted->parent = node;
     }
     else if (cmp > 0)
     {
-        HybridNode *inserted = insert_hybrid(tree, node->child[RIGHT], key, value, RIGHT, fixup_ok);
+        HybridNode *inserted = insert_hybrid(tree, node->child[RIGHT], key, value);
         node->child[RIGHT] = inserted;
         if (inserted)
             inserted->parent = node;
@@ -313,16 +210,11 @@ HybridNode *insert_hybrid(HybridTree *tree, HybridNode *node, int key, void *val
     else
     {
         // Duplicate key — do not insert again
-        *fixup_ok = false;
         return node;
     }
 
-    // AVL balancing
     node = rebalance_if_needed(tree, node);
 
-    // Red-Black fix-up
-    node = rb_insert_fixup(tree, node, dir);
-
     return node;
 }
 
@@ -331,68 +223,12 @@ void insert_hybrid_public(HybridTree *tree, int key, void *value, bool *inserted
     if (!tree || !inserted)
         return;
 
-    Direction dir = LEFT; // Just for initial fixup
-    bool fixup_ok = false;
-
-    tree->root = insert_hybrid(tree, tree->root, key, value, dir, &fixup_ok);
-
-    *inserted = fixup_ok;
+    int size = tree->size;
+    tree->root = insert_hybrid(tree, tree->root, key, value);
+    *inserted = tree->size > size;
 
     if (tree->root)
-        tree->root->color = BLACK;
-}
-
-HybridNode *rb_delete_fixup(HybridTree *tree, HybridNode *node, bool dir, bool *ok)
-{
-    struct HybridNode *parent = node;
-    struct HybridNode *sibling = node->child[!dir];
-
-    // Case 1: Red sibling — reduce to Black Sibling Case via rotation
-    if (IS_RED(sibling))
-    {
-        node = rotate(tree, node, (Direction)dir);
-        sibling = parent->child[!dir]; // re-fetch sibling after rotation
-    }
-
-    if (sibling != NULL)
-    {
-        // Case 2: Black sibling with black or null children
-        if (!IS_RED(sibling->child[LEFT]) && !IS_RED(sibling->child[RIGHT]))
-        {
-            if (IS_RED(parent))
-                *ok = true;
-
-            parent->color = BLACK;
-            sibling->color = RED;
-        }
-        else
-        {
-            Color original_color = parent->color;
-            bool update_child = (node != parent); // if we're deeper in recursion
-
-            if (IS_RED(sibling->child[!dir])) // Outer child is red (RR or LL)
-            {
-                parent = rotate(tree, parent, (Direction)dir);
-            }
-            else // Inner child is red (RL or LR)
-            {
-                parent = double_rotate(tree, parent, (Direction)dir);
-            }
-
-            parent->color = original_color;
-            parent->child[LEFT]->color = BLACK;
-            parent->child[RIGHT]->color = BLACK;
-
-            if (update_child)
-                node->child[dir] = parent;
-            else
-                node = parent;
-
-            *ok = true;
-        }
-    }
-
-    return node;
+        tree->root->parent = NULL;
 }
 
 HybridNode *find_minimum(HybridNode *node)
@@ -415,20 +251,22 @@ HybridNode *find_maximum(HybridNode *node)
     return node;
 }
 
-HybridNode *delete_hybrid(HybridTree *tree, HybridNode *node, int key, Direction dir, bool *fixup_ok)
+HybridNode *delete_hybrid(HybridTree *tree, HybridNode *node, int key)
 {
     if (node == NULL)
         return NULL;
 
     if (key < void_ptr_to_int(node->key))
     {
-        dir = LEFT;
-        node->child[LEFT] = delete_hybrid(tree, node->child[LEFT], key, dir, fixup_ok);
+        node->child[LEFT] = delete_hybrid(tree, node->child[LEFT], key);
+        if (node->child[LEFT])
+            node->child[LEFT]->parent = node;
     }
     else if (key > void_ptr_to_int(node->key))
     {
-        dir = RIGHT;
-        node->child[RIGHT] = delete_hybrid(tree, node->child[RIGHT], key, dir, fixup_ok);
+        node->child[RIGHT] = delete_hybrid(tree, node->child[RIGHT], key);
+        if (node->child[RIGHT])
+            node->child[RIGHT]->parent = node;
     }
     else
     {
@@ -438,55 +276,89 @@ HybridNode *delete_hybrid(HybridTree *tree, HybridNode *node, int key, Direction
             // One or no child
             struct HybridNode *temp = node->child[LEFT] ? node->child[LEFT] : node->child[RIGHT];
 
-            if (!temp)
-            {
-                // No child case
-                free(node);
-                tree->size--;
-                return NULL;
-            }
-            else
-            {
-                // One child case: replace node with its child
-                struct HybridNode *to_free = node;
-                node = temp;
-                free(to_free);
-                tree->size--;
-                return node;
-            }
+            if (temp)
+                temp->parent = node->parent;
+
+            free(node);
+            tree->size--;
+            return temp;
         }
         else
         {
             // Node with two children: find inorder successor
             struct HybridNode *successor = find_minimum(node->child[RIGHT]);
 
-            // Swap keys
+            // Swap keys and values so the entry stays with its key
             swap_keys(node, successor);
+            void *value = node->value;
+            node->value = successor->value;
+            successor->value = value;
 
             // Delete successor (which now holds the key to delete)
-            dir = RIGHT;
-            node->child[RIGHT] = delete_hybrid(tree, node->child[RIGHT], key, dir, fixup_ok);
+            node->child[RIGHT] = delete_hybrid(tree, node->child[RIGHT], key);
+            if (node->child[RIGHT])
+                node->child[RIGHT]->parent = node;
         }
     }
 
     // Rebalancing
     node = rebalance_if_needed(tree, node);
-    node = rb_delete_fixup(tree, node, dir, fixup_ok);
 
     return node;
 }
 
+// The middle entry becomes the root, each half a subtree
+static HybridNode *build_balanced(HybridTree *tree, const HybridEntry *entries, int count, HybridNode *parent,
+                                  bool *ok)
+{
+    if (count <= 0)
+        return NULL;
+
+    int middle = count / 2;
+    HybridNode *node = create_hybrid_node(entries[middle].key, entries[middle].value);
+    if (!node)
+    {
+        *ok = false;
+        return NULL;
+    }
+
+    node->parent = parent;
+    node->child[LEFT] = build_balanced(tree, entries, middle, node, ok);
+    node->child[RIGHT] = build_balanced(tree, entries + middle + 1, count - middle - 1, node, ok);
+    update_height(node);
+    tree->size++;
+    return node;
+}
+
+bool build_hybrid_tree_sorted(HybridTree *tree, const HybridEntry *entries, int count)
+{
+    if (!tree || tree->root || (count > 0 && !entries))
+        return false;
+
+    bool ok = true;
+    tree->root = build_balanced(tree, entries, count, NULL, &ok);
+    if (!ok)
+    {
+        free_hybrid_tree(tree->root, NULL);
+        tree->root = NULL;
+        tree->size = 0;
+        return false;
+    }
+    return true;
+}
+
 void delete_from_hybrid_tree(HybridTree *tree, int key)
 {
-    bool fixup_ok = false;
-    tree->root = delete_hybrid(tree, tree->root, key, LEFT, &fixup_ok);
+    tree->root = delete_hybrid(tree, tree->root, key);
+    if (tree->root)
+        tree->root->parent = NULL;
 }
 
 // hybrid_tree_api.h
 HybridNode *search_hybrid(HybridTree *tree, void *key)
 {
-    if (!tree || !key)
-        return NULL;
+    if (!tree)
+        return NULL; // key may legitimately be 0, which converts to NULL
 
     HybridNode *node = tree->root;
     int search_key = void_ptr_to_int(key); // Convert void * to int
@@ -557,14 +429,41 @@ void increment_access_count(HybridNode *node)
     }
 }
 
+// Walks with its own stack, grown on the heap, so a deep tree cannot overflow the call stack
 void inorder_traversal(HybridNode *node)
 {
-    if (!node)
+    int capacity = HYBRID_DIAGRAM_MAX_DEPTH, count = 0;
+    HybridNode **stack = (HybridNode **)malloc(sizeof(HybridNode *) * capacity);
+    if (!stack)
+    {
+        fprintf(stderr, "Memory allocation failed for traversal stack.\n");
         return;
+    }
 
-    inorder_traversal(node->child[LEFT]);
-    printf("%d ", void_ptr_to_int(node->key));
-    inorder_traversal(node->child[RIGHT]);
+    while (node || count > 0)
+    {
+        while (node)
+        {
+            if (count == capacity)
+            {
+                HybridNode **grown = (HybridNode **)realloc(stack, sizeof(HybridNode *) * capacity * 2);
+                if (!grown)
+                {
+                    fprintf(stderr, "Memory allocation failed for traversal stack.\n");
+                    free(stack);
+                    return;
+                }
+                stack = grown;
+                capacity *= 2;
+            }
+            stack[count++] = node;
+            node = node->child[LEFT];
+        }
+        node = stack[--count];
+        printf("%d ", void_ptr_to_int(node->key));
+        node = node->child[RIGHT];
+    }
+    free(stack);
 }
 
 void print_hybrid_tree(HybridNode *root, int level)
@@ -573,20 +472,128 @@ void print_hybrid_tree(HybridNode *root, int level)
     printf("\n");
 }
 
-void print_tree(HybridNode *root, int space)
+// --- Tree Diagram --- //
+
+static void diagram_node_line(HybridDiagram *diagram, const HybridNode *node, int depth)
+{
+    int column = diagram->indent + depth * HYBRID_DIAGRAM_INDENT;
+    diagram->length = snprintf(diagram->line, sizeof(diagram->line), "%*s%d", column, "",
+                               void_ptr_to_int(node->key));
+    diagram->collapsed = false;
+}
+
+// One line for a whole subtree: its key range, found down its two edges
+static void diagram_summary_line(HybridDiagram *diagram, const HybridNode *node, int depth)
+{
+    const HybridNode *low = node, *high = node;
+    while (low->child[LEFT])
+        low = low->child[LEFT];
+    while (high->child[RIGHT])
+        high = high->child[RIGHT];
+
+    int column = diagram->indent + depth * HYBRID_DIAGRAM_INDENT;
+    diagram->length = snprintf(diagram->line, sizeof(diagram->line), "%*s%d [+ %d .. %d]", column, "",
+                               void_ptr_to_int(node->key), void_ptr_to_int(low->key), void_ptr_to_int(high->key));
+    diagram->collapsed = true;
+}
+
+void hybrid_diagram_init(HybridDiagram *diagram, const HybridNode *root, int depth_limit)
 {
-    if (root == NULL)
+    if (!diagram)
         return;
 
-    space += 5;
+    diagram->root = root;
+    diagram->focus = NULL;
+    diagram->depth_limit = depth_limit < 0 ? 0 : depth_limit > HYBRID_DIAGRAM_MAX_DEPTH ? HYBRID_DIAGRAM_MAX_DEPTH
+                                                                                       : depth_limit;
+    diagram->indent = 0;
+    diagram->count = 0;
+    diagram->pending = root;
+    diagram->pending_depth = 0;
+    diagram->line[0] = '\0';
+    diagram->length = 0;
+    diagram->depth = 0;
+    diagram->focused = false;
+    diagram->collapsed = false;
+    diagram->lines = 0;
+}
+
+bool hybrid_diagram_around(HybridDiagram *diagram, const HybridTree *tree, int key, int above, int below)
+{
+    if (!diagram)
+        return false;
+
+    // The last above + 1 nodes on the search path, in a ring
+    const HybridNode *path[HYBRID_DIAGRAM_MAX_DEPTH + 1];
+    above = above < 0 ? 0 : above > HYBRID_DIAGRAM_MAX_DEPTH ? HYBRID_DIAGRAM_MAX_DEPTH : above;
+    int steps = 0;
+    const HybridNode *node = tree ? tree->root : NULL, *last = NULL;
+    while (node)
+    {
+        path[steps++ % (above + 1)] = last = node;
+        int node_key = void_ptr_to_int(node->key);
+        if (node_key == key)
+            break;
+        node = node->child[key > node_key];
+    }
 
-    print_tree(root->child[RIGHT], space);
+    int top = steps - 1 - above < 0 ? 0 : steps - 1 - above;
+    hybrid_diagram_init(diagram, last ? path[top % (above + 1)] : NULL, steps - 1 - top + below);
+    diagram->focus = node;
+    return node != NULL;
+}
 
-    for (int i = 5; i < space; i++)
-        printf(" ");
-    printf("%d (%s)\n", void_ptr_to_int(root->key), root->color == RED ? "R" : "B");
+bool hybrid_diagram_next(HybridDiagram *diagram)
+{
+    if (!diagram)
+        return false;
 
-    print_tree(root->child[LEFT], space);
+    // Down the right edge first: the diagram is the tree turned on its side
+    while (diagram->pending)
+    {
+        const HybridNode *node = diagram->pending;
+        int depth = diagram->pending_depth;
+        diagram->pending = NULL;
+        if (depth >= diagram->depth_limit && (node->child[LEFT] || node->child[RIGHT]))
+        {
+            diagram_summary_line(diagram, node, depth);
+            diagram->depth = depth;
+            diagram->focused = node == diagram->focus;
+            diagram->lines++;
+            return true;
+        }
+        diagram->stack[diagram->count].node = node;
+        diagram->stack[diagram->count++].depth = depth;
+        if (node->child[RIGHT])
+        {
+            diagram->pending = node->child[RIGHT];
+            diagram->pending_depth = depth + 1;
+        }
+    }
+    if (diagram->count == 0)
+        return false;
+
+    HybridDiagramFrame frame = diagram->stack[--diagram->count];
+    diagram_node_line(diagram, frame.node, frame.depth);
+    diagram->depth = frame.depth;
+    diagram->focused = frame.node == diagram->focus;
+    diagram->lines++;
+    if (frame.node->child[LEFT])
+    {
+        diagram->pending = frame.node->child[LEFT];
+        diagram->pending_depth = frame.depth + 1;
+    }
+    return true;
+}
+
+// Subtrees below HYBRID_DIAGRAM_MAX_DEPTH levels are summarised rather than drawn
+void print_tree(HybridNode *root, int space)
+{
+    HybridDiagram diagram;
+    hybrid_diagram_init(&diagram, root, HYBRID_DIAGRAM_MAX_DEPTH);
+    diagram.indent = space;
+    while (hybrid_diagram_next(&diagram))
+        puts(diagram.line);
 }
 
 void destroy_hybrid_tree(HybridTree *tree)
@@ -633,9 +640,9 @@ void tree_map_delete_hybrid(HashMapWithTree *map, HybridTree *tree, int key)
     if (!tree || !tree->root)
         return;
 
-    bool fixup_ok = false;
-    Direction dir = LEFT; // Default direction (will be set properly in deletion)
-    tree->root = delete_hybrid(tree, tree->root, key, dir, &fixup_ok);
+    tree->root = delete_hybrid(tree, tree->root, key);
+    if (tree->root)
+        tree->root->parent = NULL;
 }
 
 // Searches for a key in the TreeMap via the HybridTree
@@ -736,9 +743,8 @@ void treemap_range_query(HybridTree *tree, int low, int high)
 //     HybridNode *found = search_hybrid(tree, int_to_void_ptr(8));
 //     if (found)
 //     {
-//         printf("Found node with key %d (color: %s)\n",
-//                void_ptr_to_int(found->key),
-//                found->color == RED ? "RED" : "BLACK");
+//         printf("Found node with key %d (height: %d)\n",
+//                void_ptr_to_int(found->key), found->height);
 //     }
 //     else
 //     {
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/id_allocator.h"
+
+// Ids are ints everywhere else, so marks never go past INT_MAX + 1
+#define ID_LIMIT ((int64_t)INT_MAX + 1)
+
+static uint32_t id_mark_checksum(uint64_t mark, uint32_t sequence)
+{
+    uint32_t hash = 2166136261u ^ ID_ALLOCATOR_MAGIC;
+    for (int i = 0; i < 8; i++)
+        hash = (hash ^ (uint8_t)(mark >> (8 * i))) * 16777619u;
+    for (int i = 0; i < 4; i++)
+        hash = (hash ^ (uint8_t)(sequence >> (8 * i))) * 16777619u;
+    return hash;
+}
+
+static bool valid_mark(const IdMark *slot)
+{
+    return slot->checksum == id_mark_checksum(slot->mark, slot->sequence) && slot->mark <= (uint64_t)ID_LIMIT;
+}
+
+// Overwrites the older slot and waits for it to reach the disk
+static bool write_mark(IdAllocator *allocator, int64_t mark)
+{
+    IdMark slot = {(uint64_t)mark, allocator->sequence + 1, 0};
+    slot.checksum = id_mark_checksum(slot.mark, slot.sequence);
+
+    bool ok = pwrite(allocator->fd, &slot, sizeof(slot), (off_t)(allocator->slot * sizeof(slot))) == (ssize_t)sizeof(slot) &&
+              fdatasync(allocator->fd) == 0;
+    allocator->syncs++;
+    if (ok)
+    {
+        allocator->sequence = slot.sequence;
+        allocator->slot ^= 1;
+    }
+    return ok;
+}
+
+// A new file only survives a crash once its directory entry is on disk
+static bool sync_directory_of(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    char *directory = slash ? strndup(path, slash == path ? 1 : (size_t)(slash - path)) : strdup(".");
+    if (!directory)
+        return false;
+
+    int fd = open(directory, O_RDONLY);
+    free(directory);
+    if (fd < 0)
+        return false;
+
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+IdAllocator *open_id_allocator(const char *filename)
+{
+    if (!filename)
+        return NULL;
+
+    bool created = false;
+    int fd = open(filename, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0)
+        created = true;
+    else
+        fd = open(filename, O_RDWR);
+
+    if (fd < 0 || (created && !sync_directory_of(filename)))
+    {
+        printf("Could not open ID file %s.\n", filename);
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    IdAllocator *allocator = (IdAllocator *)calloc(1, sizeof(IdAllocator));
+    if (!allocator)
+    {
+        printf("Memory allocation failed for IdAllocator.\n");
+        close(fd);
+        return NULL;
+    }
+
+    IdMark slots[2];
+    memset(slots, 0, sizeof(slots));
+    ssize_t got = pread(fd, slots, sizeof(slots), 0);
+
+    int64_t mark = ID_FIRST;
+    int newest = -1;
+    for (int i = 0; i < 2 && got > 0; i++)
+    {
+        if ((size_t)got < (i + 1) * sizeof(IdMark) || !valid_mark(&slots[i]))
+            continue;
+        if (newest < 0 || slots[i].sequence > slots[newest].sequence)
+            newest = i;
+    }
+    if (newest >= 0)
+    {
+        mark = (int64_t)slots[newest].mark;
+        allocator->sequence = slots[newest].sequence;
+    }
+    else if (got > 0)
+        printf("ID file %s has no valid mark; starting from %d.\n", filename, ID_FIRST);
+
+    allocator->fd = fd;
+    allocator->slot = newest == 0 ? 1 : 0;
+    pthread_mutex_init(&allocator->lock, NULL);
+    // Nothing is reserved yet; the first allocation writes the first block's mark
+    atomic_init(&allocator->next, mark < ID_FIRST ? ID_FIRST : mark);
+    atomic_init(&allocator->reserved_end, atomic_load(&allocator->next));
+    return allocator;
+}
+
+// Slow path: moves the mark on disk past id
+static bool reserve_through(IdAllocator *allocator, int64_t id)
+{
+    pthread_mutex_lock(&allocator->lock);
+
+    bool ok = !allocator->failed && id < ID_LIMIT;
+    int64_t reserved = atomic_load_explicit(&allocator->reserved_end, memory_order_relaxed);
+    if (ok && id >= reserved)
+    {
+        // Whole blocks, so writers that raced past the end are covered by one sync
+        int64_t end = (id / ID_BLOCK_SIZE + 1) * ID_BLOCK_SIZE;
+        if (end > ID_LIMIT)
+            end = ID_LIMIT;
+
+        ok = write_mark(allocator, end);
+        if (ok)
+            atomic_store_explicit(&allocator->reserved_end, end, memory_order_release);
+        else
+        {
+            printf("Could not persist the ID mark; no more IDs will be handed out.\n");
+            allocator->failed = true;
+        }
+    }
+
+    pthread_mutex_unlock(&allocator->lock);
+    return ok;
+}
+
+int allocate_id(IdAllocator *allocator)
+{
+    if (!allocator)
+        return -1;
+
+    int64_t id = atomic_fetch_add_explicit(&allocator->next, 1, memory_order_relaxed);
+    if (id < atomic_load_explicit(&allocator->reserved_end, memory_order_acquire))
+        return (int)id;
+
+    return reserve_through(allocator, id) ? (int)id : -1;
+}
+
+bool reserve_ids_through(IdAllocator *allocator, int id)
+{
+    if (!allocator)
+        return false;
+
+    int64_t next = atomic_load_explicit(&allocator->next, memory_order_relaxed);
+    while (next <= id && !atomic_compare_exchange_weak_explicit(&allocator->next, &next, (int64_t)id + 1,
+                                                                 memory_order_relaxed, memory_order_relaxed))
+        ;
+
+    // The outside ids must stay covered after a crash too
+    return id < atomic_load_explicit(&allocator->reserved_end, memory_order_acquire) ||
+           reserve_through(allocator, id);
+}
+
+bool close_id_allocator(IdAllocator *allocator)
+{
+    if (!allocator)
+        return false;
+
+    // Every id below next was handed out and none above it was, so the exact value is safe
+    pthread_mutex_lock(&allocator->lock);
+    int64_t next = atomic_load(&allocator->next);
+    bool ok = !allocator->failed && write_mark(allocator, next < ID_LIMIT ? next : ID_LIMIT);
+    pthread_mutex_unlock(&allocator->lock);
+
+    ok = close(allocator->fd) == 0 && ok;
+    pthread_mutex_destroy(&allocator->lock);
+    free(allocator);
+    return ok;
+}
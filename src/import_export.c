@@ -0,0 +1,1619 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../include/import_export.h"
+
+#define NO_LINK LONG_MIN
+#define CSV_FIELDS 13
+
+typedef enum RowKind {
+    ROW_UNKNOWN,
+    ROW_TASK,
+    ROW_SUBTASK,
+    ROW_APPOINTMENT,
+    ROW_NOTE
+} RowKind;
+
+static const char *row_kind_names[] = {"", "task", "subtask", "appointment", "note"};
+
+// One parsed item, whatever the format. Strings are borrowed from the parser's buffer.
+typedef struct ImportRecord {
+    RowKind kind;
+    long id;
+    long priority;
+    long recurrence;
+    long month;         // 1-12 in every exchange format
+    long date;
+    long hour;
+    long minute;
+    long link;          // Linked appointment id, or NO_LINK
+    bool complete;
+    bool reminder;
+    const char *description;
+    const char *note;
+} ImportRecord;
+
+static void reset_record(ImportRecord *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->month = 1;
+    record->link = NO_LINK;
+}
+
+static RowKind row_kind(const char *name)
+{
+    for (int kind = ROW_TASK; kind <= ROW_NOTE; kind++)
+        if (strcmp(name, row_kind_names[kind]) == 0)
+            return (RowKind)kind;
+    return ROW_UNKNOWN;
+}
+
+static long parse_long(const char *text, long fallback)
+{
+    if (!text || !*text)
+        return fallback;
+    char *end;
+    long value = strtol(text, &end, 10);
+    return end == text ? fallback : value;
+}
+
+static MonthsInAYear month_from_record(long month)
+{
+    return (month >= 1 && month <= 12) ? (MonthsInAYear)(month - 1) : JANUARY;
+}
+
+ExchangeFormat exchange_format_from_filename(const char *filename)
+{
+    const char *dot = filename ? strrchr(filename, '.') : NULL;
+    if (dot && (strcmp(dot, ".jsonl") == 0 || strcmp(dot, ".json") == 0))
+        return FORMAT_JSONL;
+    if (dot && strcmp(dot, ".ics") == 0)
+        return FORMAT_ICALENDAR;
+    return FORMAT_CSV;
+}
+
+// --- Export --- //
+
+static void write_csv_field(FILE *file, const char *text)
+{
+    if (!text)
+        return;
+
+    if (!strpbrk(text, ",\"\r\n"))
+    {
+        fputs(text, file);
+        return;
+    }
+
+    putc('"', file);
+    for (const char *p = text; *p; p++)
+    {
+        if (*p == '"')
+            putc('"', file);
+        putc(*p, file);
+    }
+    putc('"', file);
+}
+
+static void write_json_string(FILE *file, const char *text)
+{
+    putc('"', file);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++)
+    {
+        switch (*p)
+        {
+        case '"':
+            fputs("\\\"", file);
+            break;
+        case '\\':
+            fputs("\\\\", file);
+            break;
+        case '\n':
+            fputs("\\n", file);
+            break;
+        case '\r':
+            fputs("\\r", file);
+            break;
+        case '\t':
+            fputs("\\t", file);
+            break;
+        default:
+            if (*p < 0x20)
+                fprintf(file, "\\u%04x", *p);
+            else
+                putc(*p, file);
+        }
+    }
+    putc('"', file);
+}
+
+// Content lines are folded at 75 octets, never inside a UTF-8 sequence
+static void ical_put(FILE *file, int *column, const char *bytes, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char byte = (unsigned char)bytes[i];
+        if (*column >= 75 && (byte & 0xC0) != 0x80)
+        {
+            fputs("\r\n ", file);
+            *column = 1;
+        }
+        putc(byte, file);
+        (*column)++;
+    }
+}
+
+static void write_ical_text(FILE *file, const char *name, const char *text)
+{
+    int column = 0;
+    ical_put(file, &column, name, strlen(name));
+    ical_put(file, &column, ":", 1);
+    for (const char *p = text; *p; p++)
+    {
+        switch (*p)
+        {
+        case '\\':
+            ical_put(file, &column, "\\\\", 2);
+            break;
+        case ';':
+            ical_put(file, &column, "\\;", 2);
+            break;
+        case ',':
+            ical_put(file, &column, "\\,", 2);
+            break;
+        case '\n':
+            ical_put(file, &column, "\\n", 2);
+            break;
+        case '\r':
+            break;
+        default:
+            ical_put(file, &column, p, 1);
+        }
+    }
+    fputs("\r\n", file);
+}
+
+static const char *ical_frequency(RecurrenceType recurrence)
+{
+    switch (recurrence)
+    {
+    case HOURLY:
+        return "FREQ=HOURLY";
+    case DAILY:
+        return "FREQ=DAILY";
+    case BI_WEEKLY:
+        return "FREQ=WEEKLY;INTERVAL=2";
+    case WEEKLY:
+        return "FREQ=WEEKLY";
+    case MONTHLY:
+        return "FREQ=MONTHLY";
+    case YEARLY:
+        return "FREQ=YEARLY";
+    default:
+        return NULL;
+    }
+}
+
+static void write_ical_schedule(FILE *file, const char *name, MonthsInAYear month, char date, Time time,
+                                RecurrenceType recurrence, bool have_reminder)
+{
+    if (date > 0)
+        fprintf(file, "%s:%04d%02d%02dT%02d%02d00\r\n", name, ICAL_YEAR, (int)month + 1, (int)date,
+                (int)time.hour, (int)time.minutes);
+
+    const char *frequency = ical_frequency(recurrence);
+    if (frequency)
+        fprintf(file, "RRULE:%s\r\n", frequency);
+
+    if (have_reminder)
+        fputs("BEGIN:VALARM\r\nACTION:DISPLAY\r\nTRIGGER:PT0S\r\nDESCRIPTION:Reminder\r\nEND:VALARM\r\n", file);
+}
+
+static void export_csv(TaskManager *manager, FILE *file)
+{
+    fputs("kind,id,priority,complete,reminder,recurrence,month,date,hour,minute,link,description,note\n", file);
+
+    for (Node *node = manager->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        fprintf(file, "appointment,%d,,%d,%d,%d,%d,%d,%d,%d,,,\n", appointment->id,
+                appointment->is_complete, appointment->have_reminder, (int)appointment->recurrence_type,
+                (int)appointment->month + 1, (int)appointment->date, (int)appointment->time.hour,
+                (int)appointment->time.minutes);
+
+        for (const char *note = note_blob_first(appointment->notes); note; note = note_blob_next(appointment->notes, note))
+        {
+            fprintf(file, "note,%d,,,,,,,,,,", appointment->id);
+            write_csv_field(file, note);
+            fputs(",\n", file);
+        }
+    }
+
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        fprintf(file, "task,%d,%u,%d,%d,%d,%d,%d,%d,%d,", task->id, task->priority, task->is_complete,
+                task->have_reminder, (int)task->recurrence_type, (int)task->month + 1, (int)task->date,
+                (int)task->time.hour, (int)task->time.minutes);
+        if (task->appointment)
+            fprintf(file, "%d", task->appointment->id);
+        putc(',', file);
+        write_csv_field(file, task->description);
+        putc(',', file);
+        if (task->note)
+            write_csv_field(file, task->note->description);
+        putc('\n', file);
+
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+        {
+            SubTask *subtask = (SubTask *)sub->data->value;
+            fprintf(file, "subtask,%d,%u,,,,,,,,,", task->id, subtask->priority);
+            write_csv_field(file, subtask->description);
+            fputs(",\n", file);
+        }
+    }
+}
+
+static void export_jsonl(TaskManager *manager, FILE *file)
+{
+    for (Node *node = manager->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        fprintf(file, "{\"kind\":\"appointment\",\"id\":%d,\"complete\":%s,\"reminder\":%s,\"recurrence\":%d,"
+                      "\"month\":%d,\"date\":%d,\"hour\":%d,\"minute\":%d",
+                appointment->id, appointment->is_complete ? "true" : "false",
+                appointment->have_reminder ? "true" : "false", (int)appointment->recurrence_type,
+                (int)appointment->month + 1, (int)appointment->date, (int)appointment->time.hour,
+                (int)appointment->time.minutes);
+
+        if (note_blob_count(appointment->notes) > 0)
+        {
+            fputs(",\"notes\":[", file);
+            for (const char *note = note_blob_first(appointment->notes); note;)
+            {
+                write_json_string(file, note);
+                if ((note = note_blob_next(appointment->notes, note)))
+                    putc(',', file);
+            }
+            putc(']', file);
+        }
+        fputs("}\n", file);
+    }
+
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        fprintf(file, "{\"kind\":\"task\",\"id\":%d,\"priority\":%u,\"complete\":%s,\"reminder\":%s,"
+                      "\"recurrence\":%d,\"month\":%d,\"date\":%d,\"hour\":%d,\"minute\":%d",
+                task->id, task->priority, task->is_complete ? "true" : "false",
+                task->have_reminder ? "true" : "false", (int)task->recurrence_type, (int)task->month + 1,
+                (int)task->date, (int)task->time.hour, (int)task->time.minutes);
+        if (task->appointment)
+            fprintf(file, ",\"link\":%d", task->appointment->id);
+        fputs(",\"description\":", file);
+        write_json_string(file, task->description);
+        if (task->note)
+        {
+            fputs(",\"note\":", file);
+            write_json_string(file, task->note->description);
+        }
+
+        if (task->subtasks && task->subtasks->head)
+        {
+            fputs(",\"subtasks\":[", file);
+            for (Node *sub = task->subtasks->head; sub; sub = sub->next)
+            {
+                SubTask *subtask = (SubTask *)sub->data->value;
+                fprintf(file, "{\"priority\":%u,\"description\":", subtask->priority);
+                write_json_string(file, subtask->description);
+                fputs(sub->next ? "}," : "}", file);
+            }
+            putc(']', file);
+        }
+        fputs("}\n", file);
+    }
+}
+
+static void export_ical(TaskManager *manager, FILE *file)
+{
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%SZ", gmtime(&now));
+
+    fputs("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//to-do-ncurses-c-application//EN\r\n", file);
+
+    for (Node *node = manager->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        fprintf(file, "BEGIN:VEVENT\r\nUID:appointment-%d\r\nDTSTAMP:%s\r\n", appointment->id, stamp);
+        if (appointment->is_complete)
+            fputs("STATUS:CONFIRMED\r\n", file);
+        for (const char *note = note_blob_first(appointment->notes); note; note = note_blob_next(appointment->notes, note))
+            write_ical_text(file, "COMMENT", note);
+        write_ical_schedule(file, "DTSTART", appointment->month, appointment->date, appointment->time,
+                            appointment->recurrence_type, appointment->have_reminder);
+        fputs("END:VEVENT\r\n", file);
+    }
+
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        fprintf(file, "BEGIN:VTODO\r\nUID:task-%d\r\nDTSTAMP:%s\r\nPRIORITY:%u\r\nSTATUS:%s\r\n", task->id, stamp,
+                task->priority, task->is_complete ? "COMPLETED" : "NEEDS-ACTION");
+        write_ical_text(file, "SUMMARY", task->description);
+        if (task->note)
+            write_ical_text(file, "DESCRIPTION", task->note->description);
+        if (task->appointment)
+            fprintf(file, "RELATED-TO:appointment-%d\r\n", task->appointment->id);
+
+        char name[48];
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+        {
+            SubTask *subtask = (SubTask *)sub->data->value;
+            snprintf(name, sizeof(name), "X-TODO-SUBTASK;PRIORITY=%u", subtask->priority);
+            write_ical_text(file, name, subtask->description);
+        }
+        write_ical_schedule(file, "DUE", task->month, task->date, task->time, task->recurrence_type,
+                            task->have_reminder);
+        fputs("END:VTODO\r\n", file);
+    }
+
+    fputs("END:VCALENDAR\r\n", file);
+}
+
+bool export_to_file(TaskManager *manager, const char *filename, ExchangeFormat format)
+{
+    if (!manager || !filename)
+        return false;
+
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        printf("Could not open %s for writing.\n", filename);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, EXCHANGE_CHUNK_SIZE);
+
+    switch (format)
+    {
+    case FORMAT_JSONL:
+        export_jsonl(manager, file);
+        break;
+    case FORMAT_ICALENDAR:
+        export_ical(manager, file);
+        break;
+    default:
+        export_csv(manager, file);
+    }
+
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok)
+        printf("Failed to export to %s.\n", filename);
+    return ok;
+}
+
+// --- Chunked Line Reader --- //
+
+typedef struct LineReader {
+    FILE *file;
+    char *chunk;
+    size_t position;
+    size_t filled;
+    char *line;         // Current line without its line ending, NUL-terminated
+    size_t length;
+    size_t capacity;
+    bool too_long;      // The current line went past EXCHANGE_MAX_LINE and was cut short
+} LineReader;
+
+static bool refill(LineReader *reader)
+{
+    reader->position = 0;
+    reader->filled = fread(reader->chunk, 1, EXCHANGE_CHUNK_SIZE, reader->file);
+    return reader->filled > 0;
+}
+
+static bool append_to_line(LineReader *reader, const char *bytes, size_t count)
+{
+    if (reader->length + count + 1 > reader->capacity)
+    {
+        if (reader->length + count + 1 > EXCHANGE_MAX_LINE)
+        {
+            reader->too_long = true;
+            return false;
+        }
+        size_t capacity = reader->capacity * 2;
+        while (capacity < reader->length + count + 1)
+            capacity *= 2;
+        char *grown = (char *)realloc(reader->line, capacity);
+        if (!grown)
+        {
+            reader->too_long = true;
+            return false;
+        }
+        reader->line = grown;
+        reader->capacity = capacity;
+    }
+    memcpy(reader->line + reader->length, bytes, count);
+    reader->length += count;
+    reader->line[reader->length] = '\0';
+    return true;
+}
+
+// Reads the next line, or appends it to the current one; false at end of file
+static bool read_line(LineReader *reader, bool append)
+{
+    if (!append)
+    {
+        reader->length = 0;
+        reader->too_long = false;
+        reader->line[0] = '\0';
+    }
+
+    bool got_any = false;
+    for (;;)
+    {
+        if (reader->position == reader->filled && !refill(reader))
+            break;
+
+        char *start = reader->chunk + reader->position;
+        size_t available = reader->filled - reader->position;
+        char *newline = (char *)memchr(start, '\n', available);
+        size_t take = newline ? (size_t)(newline - start) : available;
+
+        if (!reader->too_long)
+            append_to_line(reader, start, take);
+        reader->position += take + (newline ? 1 : 0);
+        got_any = true;
+        if (newline)
+            break;
+    }
+
+    if (reader->length > 0 && reader->line[reader->length - 1] == '\r')
+        reader->line[--reader->length] = '\0';
+    return got_any;
+}
+
+static int peek_byte(LineReader *reader)
+{
+    if (reader->position == reader->filled && !refill(reader))
+        return EOF;
+    return (unsigned char)reader->chunk[reader->position];
+}
+
+// --- Batches and the Hand-off Queue --- //
+
+typedef struct ImportBatch {
+    Task *tasks[IMPORT_BATCH_SIZE];
+    Task *attached[IMPORT_BATCH_SIZE]; // Copy handed to attach_tasks, which clears rejected entries
+    long links[IMPORT_BATCH_SIZE];     // Appointment linked to tasks[i], or NO_LINK
+    int task_count;
+    Appointment *appointments[IMPORT_BATCH_SIZE];
+    int appointment_count;
+} ImportBatch;
+
+#define IMPORT_BATCHES (IMPORT_QUEUE_DEPTH + 2) // Queued ones, plus one being filled and one being inserted
+
+typedef struct ImportQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t filled;   // Inserter: a batch is ready or parsing has finished
+    pthread_cond_t drained;  // Parser: an empty batch came back
+    ImportBatch *ready[IMPORT_BATCHES];
+    int head;
+    int count;
+    ImportBatch *spare[IMPORT_BATCHES];
+    int spare_count;
+    bool finished;
+
+    // Owned by the inserter thread until it is joined
+    TaskManager *manager;
+    long (*deferred)[2];     // (task id, appointment id) links to appointments not seen yet
+    int deferred_count;
+    int deferred_capacity;   // Grows up to IMPORT_MAX_DEFERRED_LINKS
+    long tasks;
+    long appointments;
+    long rejected;
+    long unlinked;
+} ImportQueue;
+
+static ImportBatch *take_spare(ImportQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    while (queue->spare_count == 0)
+        pthread_cond_wait(&queue->drained, &queue->lock);
+    ImportBatch *batch = queue->spare[--queue->spare_count];
+    pthread_mutex_unlock(&queue->lock);
+
+    batch->task_count = 0;
+    batch->appointment_count = 0;
+    return batch;
+}
+
+static void give_back(ImportQueue *queue, ImportBatch *batch)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->spare[queue->spare_count++] = batch;
+    pthread_cond_signal(&queue->drained);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void push_ready(ImportQueue *queue, ImportBatch *batch)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->ready[(queue->head + queue->count) % IMPORT_BATCHES] = batch;
+    queue->count++;
+    pthread_cond_signal(&queue->filled);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// NULL once parsing has finished and every batch has been taken
+static ImportBatch *pop_ready(ImportQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->finished)
+        pthread_cond_wait(&queue->filled, &queue->lock);
+
+    ImportBatch *batch = NULL;
+    if (queue->count > 0)
+    {
+        batch = queue->ready[queue->head];
+        queue->head = (queue->head + 1) % IMPORT_BATCHES;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return batch;
+}
+
+static void free_imported_task(Task *task)
+{
+    free(task->description);
+    if (task->note)
+    {
+        free(task->note->description);
+        free(task->note);
+    }
+    for (Node *node = task->subtasks ? task->subtasks->head : NULL; node; node = node->next)
+    {
+        SubTask *subtask = (SubTask *)node->data->value;
+        free(subtask->description);
+        free(subtask);
+    }
+    free_list(task->subtasks);
+    free(task);
+}
+
+static void free_imported_appointment(Appointment *appointment)
+{
+    free(appointment->notes);
+    free(appointment);
+}
+
+static void defer_link(ImportQueue *queue, long task_id, long appointment_id)
+{
+    if (queue->deferred_count == queue->deferred_capacity)
+    {
+        int capacity = queue->deferred_capacity ? queue->deferred_capacity * 2 : 64;
+        capacity = capacity > IMPORT_MAX_DEFERRED_LINKS ? IMPORT_MAX_DEFERRED_LINKS : capacity;
+        long (*grown)[2] = capacity > queue->deferred_capacity
+                               ? (long (*)[2])realloc(queue->deferred, sizeof(long[2]) * capacity)
+                               : NULL;
+        if (!grown)
+        {
+            queue->unlinked++;
+            return;
+        }
+        queue->deferred = grown;
+        queue->deferred_capacity = capacity;
+    }
+    queue->deferred[queue->deferred_count][0] = task_id;
+    queue->deferred[queue->deferred_count][1] = appointment_id;
+    queue->deferred_count++;
+}
+
+// Links whose appointment has now arrived; the rest keep waiting
+static void resolve_deferred(ImportQueue *queue)
+{
+    int waiting = 0;
+    for (int i = 0; i < queue->deferred_count; i++)
+    {
+        long *link = queue->deferred[i];
+        if (find_appointment(queue->manager, (int)link[1]))
+            link_task_to_appointment(queue->manager, (int)link[0], (int)link[1]);
+        else
+        {
+            queue->deferred[waiting][0] = link[0];
+            queue->deferred[waiting][1] = link[1];
+            waiting++;
+        }
+    }
+    queue->deferred_count = waiting;
+}
+
+static void insert_batch(ImportQueue *queue, ImportBatch *batch)
+{
+    TaskManager *manager = queue->manager;
+
+    // Appointments first, so links from tasks in the same batch resolve right away
+    for (int i = 0; i < batch->appointment_count; i++)
+    {
+        if (attach_appointment(manager, batch->appointments[i]))
+            queue->appointments++;
+        else
+        {
+            free_imported_appointment(batch->appointments[i]);
+            queue->rejected++;
+        }
+    }
+    if (batch->appointment_count > 0 && queue->deferred_count > 0)
+        resolve_deferred(queue);
+
+    memcpy(batch->attached, batch->tasks, sizeof(Task *) * batch->task_count);
+    attach_tasks(manager, batch->attached, batch->task_count);
+
+    for (int i = 0; i < batch->task_count; i++)
+    {
+        Task *task = batch->attached[i];
+        if (!task)
+        {
+            free_imported_task(batch->tasks[i]);
+            queue->rejected++;
+            continue;
+        }
+
+        queue->tasks++;
+        if (batch->links[i] == NO_LINK)
+            continue;
+        if (find_appointment(manager, (int)batch->links[i]))
+            link_task_to_appointment(manager, task->id, (int)batch->links[i]);
+        else
+            defer_link(queue, task->id, batch->links[i]);
+    }
+}
+
+static void *run_inserter(void *arg)
+{
+    ImportQueue *queue = (ImportQueue *)arg;
+    ImportBatch *batch;
+
+    while ((batch = pop_ready(queue)))
+    {
+        insert_batch(queue, batch);
+        give_back(queue, batch);
+    }
+    return NULL;
+}
+
+// --- Building Items --- //
+
+typedef struct ImportParser {
+    ImportQueue *queue;
+    ImportBatch *batch;
+    Task *task;               // Item being built; subtask rows attach to it
+    Appointment *appointment; // Likewise for note rows
+    long link;
+    long rows;
+    long rejected;
+} ImportParser;
+
+static Data *wrap_item(void *key, void *value)
+{
+    Data *data = (Data *)malloc(sizeof(Data));
+    if (data)
+    {
+        data->key = key;
+        data->value = value;
+    }
+    return data;
+}
+
+// Hands the finished item to the batch, and a full batch to the inserter
+static void finish_item(ImportParser *parser)
+{
+    ImportBatch *batch = parser->batch;
+
+    if (parser->task)
+    {
+        batch->links[batch->task_count] = parser->link;
+        batch->tasks[batch->task_count++] = parser->task;
+        parser->task = NULL;
+    }
+    if (parser->appointment)
+    {
+        batch->appointments[batch->appointment_count++] = parser->appointment;
+        parser->appointment = NULL;
+    }
+
+    if (batch->task_count == IMPORT_BATCH_SIZE || batch->appointment_count == IMPORT_BATCH_SIZE)
+    {
+        push_ready(parser->queue, batch);
+        parser->batch = take_spare(parser->queue);
+    }
+}
+
+static bool add_child(ImportParser *parser, const ImportRecord *record)
+{
+    if (!record->description)
+        return false;
+
+    if (record->kind == ROW_SUBTASK && parser->task && parser->task->id == record->id)
+    {
+        Task *task = parser->task;
+        if (!task->subtasks && !(task->subtasks = create_list(UNBOUNDED_LIST_CAPACITY)))
+            return false;
+
+        SubTask *subtask = (SubTask *)malloc(sizeof(SubTask));
+        Data *data = subtask ? wrap_item(&subtask->task_id, subtask) : NULL;
+        if (!data || !(subtask->description = strdup(record->description)))
+        {
+            free(subtask);
+            free(data);
+            return false;
+        }
+        subtask->task_id = task->id;
+        subtask->priority = (unsigned int)record->priority;
+        insert_back(task->subtasks, data);
+        task->have_subtask = true;
+        return true;
+    }
+
+    if (record->kind == ROW_NOTE && parser->appointment && parser->appointment->id == record->id)
+    {
+        return note_blob_append(&parser->appointment->notes, record->description);
+    }
+
+    return false;
+}
+
+static bool begin_item(ImportParser *parser, const ImportRecord *record)
+{
+    Time time = {(char)record->minute, (char)record->hour};
+
+    if (record->kind == ROW_SUBTASK || record->kind == ROW_NOTE)
+        return add_child(parser, record);
+
+    finish_item(parser);
+    // A date outside its key field would sort as another date (task_order_schedule_valid)
+    if (record->date < 0 || record->date > 31 || record->hour < 0 || record->hour > 23 || record->minute < 0 ||
+        record->minute > 59)
+        return false;
+
+    if (record->kind == ROW_TASK && record->description)
+    {
+        Task *task = (Task *)calloc(1, sizeof(Task));
+        if (!task || !(task->description = strdup(record->description)))
+        {
+            free(task);
+            return false;
+        }
+        task->id = (int)record->id;
+        task->priority = (unsigned int)record->priority;
+        task->is_complete = record->complete;
+        task->have_reminder = record->reminder;
+        task->recurrence_type = (RecurrenceType)record->recurrence;
+        task->month = month_from_record(record->month);
+        task->date = (char)record->date;
+        task->time = time;
+
+        if (record->note && (task->note = (Notes *)malloc(sizeof(Notes))) &&
+            !(task->note->description = strdup(record->note)))
+        {
+            free(task->note);
+            task->note = NULL;
+        }
+
+        parser->task = task;
+        parser->link = record->link;
+        return true;
+    }
+
+    if (record->kind == ROW_APPOINTMENT)
+    {
+        Appointment *appointment = (Appointment *)calloc(1, sizeof(Appointment));
+        if (!appointment)
+            return false;
+        appointment->id = (int)record->id;
+        appointment->is_complete = record->complete;
+        appointment->have_reminder = record->reminder;
+        appointment->recurrence_type = (RecurrenceType)record->recurrence;
+        appointment->month = month_from_record(record->month);
+        appointment->date = (char)record->date;
+        appointment->time = time;
+        parser->appointment = appointment;
+
+        if (record->note)
+        {
+            ImportRecord note = *record;
+            note.kind = ROW_NOTE;
+            note.description = record->note;
+            add_child(parser, &note);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static void parsed(ImportParser *parser, const ImportRecord *record)
+{
+    parser->rows++;
+    if (!begin_item(parser, record))
+        parser->rejected++;
+}
+
+// --- CSV --- //
+
+static bool quotes_balanced(const char *text)
+{
+    bool inside = false;
+    for (; *text; text++)
+        if (*text == '"')
+            inside = !inside;
+    return !inside;
+}
+
+// Splits a record in place, removing quotes; returns the field count
+static int split_csv(char *text, char **fields, int max_fields)
+{
+    int count = 0;
+    char *p = text;
+
+    while (count < max_fields)
+    {
+        char *out = p;
+        fields[count++] = out;
+
+        if (*p == '"')
+        {
+            p++;
+            for (;;)
+            {
+                if (*p == '"' && p[1] == '"')
+                {
+                    *out++ = '"';
+                    p += 2;
+                }
+                else if (*p == '"' || *p == '\0')
+                {
+                    if (*p)
+                        p++;
+                    break;
+                }
+                else
+                    *out++ = *p++;
+            }
+            while (*p && *p != ',')
+                p++;
+        }
+        else
+        {
+            while (*p && *p != ',')
+                p++;
+            out = p;
+        }
+
+        bool more = *p == ',';
+        *out = '\0';
+        if (!more)
+            break;
+        p++;
+    }
+    return count;
+}
+
+static void parse_csv(ImportParser *parser, LineReader *reader)
+{
+    char *fields[CSV_FIELDS];
+    bool first = true;
+
+    while (read_line(reader, false))
+    {
+        // Quoted fields may hold line breaks
+        while (!reader->too_long && !quotes_balanced(reader->line))
+        {
+            append_to_line(reader, "\n", 1);
+            if (!read_line(reader, true))
+                break;
+        }
+
+        if (first && strncmp(reader->line, "kind,", 5) == 0)
+        {
+            first = false;
+            continue;
+        }
+        first = false;
+        if (reader->length == 0)
+            continue;
+        if (reader->too_long)
+        {
+            parser->rows++;
+            parser->rejected++;
+            continue;
+        }
+
+        int count = split_csv(reader->line, fields, CSV_FIELDS);
+        for (int i = count; i < CSV_FIELDS; i++)
+            fields[i] = "";
+
+        ImportRecord record;
+        reset_record(&record);
+        record.kind = row_kind(fields[0]);
+        record.id = parse_long(fields[1], 0);
+        record.priority = parse_long(fields[2], 0);
+        record.complete = parse_long(fields[3], 0) != 0;
+        record.reminder = parse_long(fields[4], 0) != 0;
+        record.recurrence = parse_long(fields[5], NONE);
+        record.month = parse_long(fields[6], 1);
+        record.date = parse_long(fields[7], 0);
+        record.hour = parse_long(fields[8], 0);
+        record.minute = parse_long(fields[9], 0);
+        record.link = parse_long(fields[10], NO_LINK);
+        record.description = count > 11 ? fields[11] : NULL;
+        record.note = *fields[12] ? fields[12] : NULL;
+        parsed(parser, &record);
+    }
+}
+
+// --- JSON Lines --- //
+
+static void skip_space(char **p)
+{
+    while (**p == ' ' || **p == '\t' || **p == '\r' || **p == '\n')
+        (*p)++;
+}
+
+static char *put_utf8(char *out, unsigned int code)
+{
+    if (code < 0x80)
+        *out++ = (char)code;
+    else if (code < 0x800)
+    {
+        *out++ = (char)(0xC0 | (code >> 6));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        *out++ = (char)(0xE0 | (code >> 12));
+        *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    }
+    return out;
+}
+
+// Decodes a string in place (it only ever shrinks) and returns it
+static char *json_string(char **p)
+{
+    if (**p != '"')
+        return NULL;
+
+    char *start = ++(*p), *out = start;
+    while (**p && **p != '"')
+    {
+        char c = *(*p)++;
+        if (c != '\\')
+        {
+            *out++ = c;
+            continue;
+        }
+
+        c = *(*p)++;
+        switch (c)
+        {
+        case 'n':
+            *out++ = '\n';
+            break;
+        case 'r':
+            *out++ = '\r';
+            break;
+        case 't':
+            *out++ = '\t';
+            break;
+        case 'b':
+            *out++ = '\b';
+            break;
+        case 'f':
+            *out++ = '\f';
+            break;
+        case 'u':
+        {
+            unsigned int code = 0;
+            for (int i = 0; i < 4; i++, (*p)++)
+            {
+                char h = **p;
+                if (!((h >= '0' && h <= '9') || (h >= 'a' && h <= 'f') || (h >= 'A' && h <= 'F')))
+                    return NULL;
+                code = code * 16 + (unsigned int)(h <= '9' ? h - '0' : (h | 0x20) - 'a' + 10);
+            }
+            // Surrogate halves cannot be encoded alone
+            out = put_utf8(out, (code >= 0xD800 && code <= 0xDFFF) ? '?' : code);
+            break;
+        }
+        case '\0':
+            return NULL;
+        default:
+            *out++ = c; // \" \\ \/
+        }
+    }
+
+    if (**p != '"')
+        return NULL;
+    (*p)++;
+    *out = '\0';
+    return start;
+}
+
+// Steps over any value without changing it
+static bool json_skip(char **p)
+{
+    skip_space(p);
+    char c = **p;
+
+    if (c == '"')
+    {
+        for ((*p)++; **p && **p != '"'; (*p)++)
+            if (**p == '\\' && (*p)[1])
+                (*p)++;
+        if (**p != '"')
+            return false;
+        (*p)++;
+        return true;
+    }
+
+    if (c == '{' || c == '[')
+    {
+        char close = c == '{' ? '}' : ']';
+        (*p)++;
+        skip_space(p);
+        if (**p == close)
+        {
+            (*p)++;
+            return true;
+        }
+        for (;;)
+        {
+            if (c == '{')
+            {
+                if (!json_skip(p))
+                    return false;
+                skip_space(p);
+                if (**p != ':')
+                    return false;
+                (*p)++;
+            }
+            if (!json_skip(p))
+                return false;
+            skip_space(p);
+            if (**p == ',')
+            {
+                (*p)++;
+                continue;
+            }
+            if (**p != close)
+                return false;
+            (*p)++;
+            return true;
+        }
+    }
+
+    // Number, true, false or null
+    char *start = *p;
+    while (**p && !strchr(",}] \t\r\n", **p))
+        (*p)++;
+    return *p > start;
+}
+
+// Reads a number, boolean or null; strings and containers are skipped and give fallback
+static long json_scalar(char **p, long fallback)
+{
+    skip_space(p);
+    if (strncmp(*p, "true", 4) == 0)
+    {
+        *p += 4;
+        return 1;
+    }
+    if (strncmp(*p, "false", 5) == 0)
+    {
+        *p += 5;
+        return 0;
+    }
+    if (**p == '-' || (**p >= '0' && **p <= '9'))
+        return strtol(*p, p, 10);
+
+    json_skip(p);
+    return fallback;
+}
+
+// Calls visit for every element of the array at *p (subtask objects or note strings)
+static bool json_children(ImportParser *parser, char **p, RowKind kind, long parent_id)
+{
+    skip_space(p);
+    if (**p != '[')
+        return json_skip(p);
+    (*p)++;
+
+    for (;;)
+    {
+        skip_space(p);
+        if (**p == ']')
+        {
+            (*p)++;
+            return true;
+        }
+
+        ImportRecord child;
+        reset_record(&child);
+        child.kind = kind;
+        child.id = parent_id;
+
+        if (**p == '"')
+            child.description = json_string(p);
+        else if (**p == '{')
+        {
+            (*p)++;
+            for (;;)
+            {
+                skip_space(p);
+                if (**p == '}')
+                {
+                    (*p)++;
+                    break;
+                }
+                char *key = json_string(p);
+                skip_space(p);
+                if (!key || **p != ':')
+                    return false;
+                (*p)++;
+                skip_space(p);
+
+                if (strcmp(key, "description") == 0)
+                    child.description = json_string(p);
+                else if (strcmp(key, "priority") == 0)
+                    child.priority = json_scalar(p, 0);
+                else if (!json_skip(p))
+                    return false;
+
+                skip_space(p);
+                if (**p == ',')
+                    (*p)++;
+            }
+        }
+        else if (!json_skip(p))
+            return false;
+
+        if (!add_child(parser, &child))
+            parser->rejected++;
+
+        skip_space(p);
+        if (**p == ',')
+            (*p)++;
+        else if (**p != ']')
+            return false;
+    }
+}
+
+static bool parse_json_object(ImportParser *parser, char *text)
+{
+    char *p = text, *children = NULL;
+    ImportRecord record;
+    reset_record(&record);
+
+    skip_space(&p);
+    if (*p != '{')
+        return false;
+    p++;
+
+    for (;;)
+    {
+        skip_space(&p);
+        if (*p == '}')
+            break;
+
+        char *key = json_string(&p);
+        skip_space(&p);
+        if (!key || *p != ':')
+            return false;
+        p++;
+        skip_space(&p);
+
+        if (strcmp(key, "kind") == 0)
+        {
+            char *kind = json_string(&p);
+            record.kind = kind ? row_kind(kind) : ROW_UNKNOWN;
+        }
+        else if (strcmp(key, "description") == 0)
+            record.description = json_string(&p);
+        else if (strcmp(key, "note") == 0)
+            record.note = json_string(&p);
+        else if (strcmp(key, "subtasks") == 0 || strcmp(key, "notes") == 0)
+        {
+            // Children need their parent built first; come back once the object is read
+            children = p;
+            if (!json_skip(&p))
+                return false;
+        }
+        else
+        {
+            long value = json_scalar(&p, LONG_MIN);
+            if (value != LONG_MIN)
+            {
+                if (strcmp(key, "id") == 0)
+                    record.id = value;
+                else if (strcmp(key, "priority") == 0)
+                    record.priority = value;
+                else if (strcmp(key, "complete") == 0)
+                    record.complete = value != 0;
+                else if (strcmp(key, "reminder") == 0)
+                    record.reminder = value != 0;
+                else if (strcmp(key, "recurrence") == 0)
+                    record.recurrence = value;
+                else if (strcmp(key, "month") == 0)
+                    record.month = value;
+                else if (strcmp(key, "date") == 0)
+                    record.date = value;
+                else if (strcmp(key, "hour") == 0)
+                    record.hour = value;
+                else if (strcmp(key, "minute") == 0)
+                    record.minute = value;
+                else if (strcmp(key, "link") == 0)
+                    record.link = value;
+            }
+        }
+
+        skip_space(&p);
+        if (*p == ',')
+            p++;
+        else if (*p != '}')
+            return false;
+    }
+
+    if (!begin_item(parser, &record))
+        parser->rejected++;
+
+    if (children)
+        return json_children(parser, &children, record.kind == ROW_TASK ? ROW_SUBTASK : ROW_NOTE, record.id);
+    return true;
+}
+
+static void parse_jsonl(ImportParser *parser, LineReader *reader)
+{
+    while (read_line(reader, false))
+    {
+        char *p = reader->line;
+        skip_space(&p);
+        if (!*p)
+            continue;
+
+        parser->rows++;
+        if (reader->too_long || !parse_json_object(parser, p))
+            parser->rejected++;
+    }
+}
+
+// --- iCalendar --- //
+
+typedef struct IcalChild {
+    long priority;
+    char *text;
+} IcalChild;
+
+// A component is read to its END line before it is built, so text is copied out of the line buffer
+typedef struct IcalItem {
+    ImportRecord record;
+    char *summary;
+    char *note;
+    IcalChild *children;
+    int child_count;
+    int child_capacity;
+    bool has_id;
+} IcalItem;
+
+static void clear_ical_item(IcalItem *item)
+{
+    free(item->summary);
+    free(item->note);
+    for (int i = 0; i < item->child_count; i++)
+        free(item->children[i].text);
+    item->summary = item->note = NULL;
+    item->child_count = 0;
+    item->has_id = false;
+    reset_record(&item->record);
+}
+
+static void ical_unescape(char *text)
+{
+    char *out = text;
+    for (char *p = text; *p; p++)
+    {
+        if (*p == '\\' && p[1])
+        {
+            p++;
+            *out++ = (*p == 'n' || *p == 'N') ? '\n' : *p;
+        }
+        else
+            *out++ = *p;
+    }
+    *out = '\0';
+}
+
+static void ical_add_child(IcalItem *item, long priority, const char *text)
+{
+    if (item->child_count == item->child_capacity)
+    {
+        int capacity = item->child_capacity ? item->child_capacity * 2 : 4;
+        IcalChild *grown = (IcalChild *)realloc(item->children, sizeof(IcalChild) * capacity);
+        if (!grown)
+            return;
+        item->children = grown;
+        item->child_capacity = capacity;
+    }
+    char *copy = strdup(text);
+    if (copy)
+        item->children[item->child_count++] = (IcalChild){priority, copy};
+}
+
+static void ical_schedule(ImportRecord *record, const char *value)
+{
+    int year, month, date, hour = 0, minute = 0;
+    if (sscanf(value, "%4d%2d%2dT%2d%2d", &year, &month, &date, &hour, &minute) >= 3)
+    {
+        record->month = month;
+        record->date = date;
+        record->hour = hour;
+        record->minute = minute;
+    }
+}
+
+static long ical_recurrence(const char *rule)
+{
+    if (strstr(rule, "FREQ=HOURLY"))
+        return HOURLY;
+    if (strstr(rule, "FREQ=DAILY"))
+        return DAILY;
+    if (strstr(rule, "FREQ=WEEKLY"))
+        return strstr(rule, "INTERVAL=2") ? BI_WEEKLY : WEEKLY;
+    if (strstr(rule, "FREQ=MONTHLY"))
+        return MONTHLY;
+    if (strstr(rule, "FREQ=YEARLY"))
+        return YEARLY;
+    return NONE;
+}
+
+static void ical_property(IcalItem *item, char *line)
+{
+    char *value = strchr(line, ':');
+    if (!value)
+        return;
+    *value++ = '\0';
+
+    char *params = strchr(line, ';');
+    if (params)
+        *params++ = '\0';
+
+    ImportRecord *record = &item->record;
+    if (strcmp(line, "UID") == 0)
+    {
+        const char *prefix = record->kind == ROW_TASK ? "task-" : "appointment-";
+        size_t length = strlen(prefix);
+        if (strncmp(value, prefix, length) == 0 && value[length])
+        {
+            record->id = parse_long(value + length, 0);
+            item->has_id = true;
+        }
+    }
+    else if (strcmp(line, "SUMMARY") == 0 && !item->summary)
+    {
+        ical_unescape(value);
+        item->summary = strdup(value);
+    }
+    else if ((strcmp(line, "DESCRIPTION") == 0 && record->kind == ROW_TASK && !item->note))
+    {
+        ical_unescape(value);
+        item->note = strdup(value);
+    }
+    else if (strcmp(line, "COMMENT") == 0)
+    {
+        ical_unescape(value);
+        ical_add_child(item, 0, value);
+    }
+    else if (strcmp(line, "X-TODO-SUBTASK") == 0)
+    {
+        const char *priority = params ? strstr(params, "PRIORITY=") : NULL;
+        ical_unescape(value);
+        ical_add_child(item, priority ? parse_long(priority + 9, 0) : 0, value);
+    }
+    else if (strcmp(line, "PRIORITY") == 0)
+    {
+        // iCalendar uses 0 for undefined and 1-9; ours stop at LOWEST_PRIORITY
+        long priority = parse_long(value, 0);
+        record->priority = (priority < HIGHEST_PRIORITY || priority > LOWEST_PRIORITY) ? LOWEST_PRIORITY : priority;
+    }
+    else if (strcmp(line, "STATUS") == 0)
+        record->complete = strcmp(value, "COMPLETED") == 0 || strcmp(value, "CONFIRMED") == 0;
+    else if (strcmp(line, "DUE") == 0 || strcmp(line, "DTSTART") == 0)
+        ical_schedule(record, value);
+    else if (strcmp(line, "RRULE") == 0)
+        record->recurrence = ical_recurrence(value);
+    else if (strcmp(line, "RELATED-TO") == 0 && strncmp(value, "appointment-", 12) == 0)
+        record->link = parse_long(value + 12, NO_LINK);
+}
+
+static void finish_ical_item(ImportParser *parser, IcalItem *item)
+{
+    ImportRecord *record = &item->record;
+    record->description = item->summary;
+    record->note = item->note;
+    if (record->kind == ROW_TASK && !record->description)
+        record->description = "";
+
+    parser->rows++;
+    if (!item->has_id || !begin_item(parser, record))
+    {
+        parser->rejected++;
+        return;
+    }
+
+    ImportRecord child;
+    reset_record(&child);
+    child.kind = record->kind == ROW_TASK ? ROW_SUBTASK : ROW_NOTE;
+    child.id = record->id;
+    for (int i = 0; i < item->child_count; i++)
+    {
+        child.priority = item->children[i].priority;
+        child.description = item->children[i].text;
+        if (!add_child(parser, &child))
+            parser->rejected++;
+    }
+}
+
+static void parse_ical(ImportParser *parser, LineReader *reader)
+{
+    IcalItem item;
+    memset(&item, 0, sizeof(item));
+    reset_record(&item.record);
+    bool in_item = false, in_alarm = false;
+
+    while (read_line(reader, false))
+    {
+        // Unfold continuation lines
+        int next;
+        while ((next = peek_byte(reader)) == ' ' || next == '\t')
+        {
+            reader->position++;
+            if (!read_line(reader, true))
+                break;
+        }
+
+        char *line = reader->line;
+        if (strcmp(line, "BEGIN:VTODO") == 0 || strcmp(line, "BEGIN:VEVENT") == 0)
+        {
+            clear_ical_item(&item);
+            item.record.kind = line[7] == 'T' ? ROW_TASK : ROW_APPOINTMENT;
+            item.record.priority = LOWEST_PRIORITY;
+            in_item = true;
+            in_alarm = false;
+        }
+        else if (!in_item)
+            continue;
+        else if (strcmp(line, "BEGIN:VALARM") == 0)
+        {
+            item.record.reminder = true;
+            in_alarm = true;
+        }
+        else if (strcmp(line, "END:VALARM") == 0)
+            in_alarm = false;
+        else if (strcmp(line, "END:VTODO") == 0 || strcmp(line, "END:VEVENT") == 0)
+        {
+            finish_ical_item(parser, &item);
+            in_item = false;
+        }
+        else if (!in_alarm && !reader->too_long)
+            ical_property(&item, line);
+    }
+
+    clear_ical_item(&item);
+    free(item.children);
+}
+
+// --- Import --- //
+
+bool import_from_file(TaskManager *manager, const char *filename, ExchangeFormat format, ImportStats *stats)
+{
+    if (!manager || !filename)
+        return false;
+
+    FILE *file = fopen(filename, "rb");
+    if (!file)
+    {
+        printf("Could not open %s for reading.\n", filename);
+        return false;
+    }
+    // Reads go straight into the reader's chunk buffer
+    setvbuf(file, NULL, _IONBF, 0);
+
+    LineReader reader = {file, (char *)malloc(EXCHANGE_CHUNK_SIZE), 0, 0, (char *)malloc(256), 0, 256, false};
+    ImportQueue queue;
+    memset(&queue, 0, sizeof(queue));
+    queue.manager = manager;
+    bool ok = reader.chunk && reader.line;
+
+    for (int i = 0; ok && i < IMPORT_BATCHES; i++)
+    {
+        ImportBatch *batch = (ImportBatch *)malloc(sizeof(ImportBatch));
+        if (batch)
+            queue.spare[queue.spare_count++] = batch;
+        else
+            ok = false;
+    }
+
+    pthread_t inserter;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.filled, NULL);
+    pthread_cond_init(&queue.drained, NULL);
+    if (ok && pthread_create(&inserter, NULL, run_inserter, &queue) != 0)
+    {
+        printf("Could not start the import thread.\n");
+        ok = false;
+    }
+
+    ImportParser parser = {&queue, NULL, NULL, NULL, NO_LINK, 0, 0};
+    if (ok)
+    {
+        parser.batch = take_spare(&queue);
+        switch (format)
+        {
+        case FORMAT_JSONL:
+            parse_jsonl(&parser, &reader);
+            break;
+        case FORMAT_ICALENDAR:
+            parse_ical(&parser, &reader);
+            break;
+        default:
+            parse_csv(&parser, &reader);
+        }
+        finish_item(&parser);
+
+        if (parser.batch->task_count || parser.batch->appointment_count)
+            push_ready(&queue, parser.batch);
+        else
+            give_back(&queue, parser.batch);
+
+        pthread_mutex_lock(&queue.lock);
+        queue.finished = true;
+        pthread_cond_signal(&queue.filled);
+        pthread_mutex_unlock(&queue.lock);
+        pthread_join(inserter, NULL);
+
+        // Links still waiting name appointments the file never had
+        queue.unlinked += queue.deferred_count;
+
+        ok = !ferror(file);
+
+        // Nothing attached here is in a log; a manager with one checkpoints now
+        if ((queue.tasks || queue.appointments) && !bulk_load_finished(manager))
+            ok = false;
+    }
+
+    if (stats)
+    {
+        stats->rows = parser.rows;
+        stats->tasks = queue.tasks;
+        stats->appointments = queue.appointments;
+        stats->rejected = parser.rejected + queue.rejected;
+        stats->unlinked = queue.unlinked;
+    }
+
+    for (int i = 0; i < queue.spare_count; i++)
+        free(queue.spare[i]);
+    free(queue.deferred);
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.filled);
+    pthread_cond_destroy(&queue.drained);
+    free(reader.chunk);
+    free(reader.line);
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,600 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/persistence.h"
+
+#define SNAPSHOT_IO_BUFFER (1 << 20)
+
+// --- Helpers --- //
+
+// Heap bytes taken by one string: length prefix, text and NUL
+static uint64_t heap_string_size(const char *text)
+{
+    return sizeof(uint32_t) + strlen(text) + 1;
+}
+
+static bool write_heap_string(FILE *file, const char *text)
+{
+    uint32_t length = (uint32_t)strlen(text);
+    return fwrite(&length, sizeof(length), 1, file) == 1 &&
+           fwrite(text, 1, length + 1, file) == length + 1;
+}
+
+// Returns the text of a heap string, or NULL when the offset or length is out of bounds
+static char *heap_string(const char *heap, uint64_t heap_size, uint64_t offset)
+{
+    uint32_t length;
+
+    if (offset == SNAPSHOT_NO_STRING || offset > heap_size || heap_size - offset < sizeof(length) + 1)
+        return NULL;
+
+    memcpy(&length, heap + offset, sizeof(length));
+    if (length > heap_size - offset - sizeof(length) - 1 || heap[offset + sizeof(length) + length] != '\0')
+        return NULL;
+
+    return (char *)heap + offset + sizeof(length);
+}
+
+static Data *wrap_value(void *key, void *value)
+{
+    Data *data = (Data *)malloc(sizeof(Data));
+    if (data)
+    {
+        data->key = key;
+        data->value = value;
+    }
+    return data;
+}
+
+void fill_task_record(TaskRecord *record, Task *task)
+{
+    memset(record, 0, sizeof(*record));
+    record->id = task->id;
+    record->priority = task->priority;
+    record->flags = (task->is_complete ? SNAPSHOT_COMPLETE : 0) |
+                    (task->have_reminder ? SNAPSHOT_REMINDER : 0) |
+                    (task->appointment ? SNAPSHOT_LINKED : 0) |
+                    (task->reminder_timer ? SNAPSHOT_ARMED : 0);
+    record->recurrence_type = (uint8_t)task->recurrence_type;
+    record->date = (uint8_t)task->date;
+    record->month = (uint8_t)task->month;
+    record->hour = (uint8_t)task->time.hour;
+    record->minutes = (uint8_t)task->time.minutes;
+    record->appointment_id = task->appointment ? task->appointment->id : 0;
+    record->subtask_count = task->subtasks ? task->subtasks->size : 0;
+    record->note = SNAPSHOT_NO_STRING;
+    record->reminder_at = task->reminder_timer ? task->reminder_timer->fire_at : 0;
+}
+
+static void apply_task_record(Task *task, const TaskRecord *record)
+{
+    task->id = record->id;
+    task->priority = record->priority;
+    task->is_complete = (record->flags & SNAPSHOT_COMPLETE) != 0;
+    task->have_reminder = (record->flags & SNAPSHOT_REMINDER) != 0;
+    task->recurrence_type = (RecurrenceType)record->recurrence_type;
+    task->date = (char)record->date;
+    task->month = (MonthsInAYear)record->month;
+    task->time.hour = (char)record->hour;
+    task->time.minutes = (char)record->minutes;
+}
+
+static SubTask *make_subtask(int task_id, unsigned int priority, char *description)
+{
+    SubTask *subtask = (SubTask *)malloc(sizeof(SubTask));
+    if (subtask)
+    {
+        subtask->task_id = task_id;
+        subtask->priority = priority;
+        subtask->description = description;
+    }
+    return subtask;
+}
+
+// Appends a loaded subtask; on failure nothing is kept and the caller still owns the description
+static bool append_subtask(DoublyLinkedList *subtasks, SubTask *subtask)
+{
+    Data *data = subtask ? wrap_value(&subtask->task_id, subtask) : NULL;
+    if (data && insert_back(subtasks, data))
+        return true;
+    free(data);
+    free(subtask);
+    return false;
+}
+
+// --- Core Persistence Functions --- //
+
+// Free a task built from the mapping that never made it into the manager;
+// its strings live in the snapshot and are left alone
+static void discard_loaded_task(Task *task)
+{
+    if (task->subtasks)
+    {
+        for (Node *node = task->subtasks->head; node; node = node->next)
+            free(node->data->value);
+        free_list(task->subtasks);
+    }
+    free(task->note);
+    free(task);
+}
+
+bool save_tasks_to_file(TaskManager *manager, const char *filename)
+{
+    if (!manager || !filename)
+        return false;
+
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, 0, 0, 0, 0, 0, manager->log_sequence};
+
+    // Pass 1: section sizes
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        header.task_count++;
+        header.heap_size += heap_string_size(task->description);
+        if (task->note && task->note->description)
+            header.heap_size += heap_string_size(task->note->description);
+
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+        {
+            header.subtask_count++;
+            header.heap_size += heap_string_size(((SubTask *)sub->data->value)->description);
+        }
+    }
+    for (Node *node = manager->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        header.appointment_count++;
+        for (const char *note = note_blob_first(appointment->notes); note; note = note_blob_next(appointment->notes, note))
+        {
+            header.note_count++;
+            header.heap_size += heap_string_size(note);
+        }
+    }
+
+    // Write to a temporary file and rename it, so a crash never leaves half a snapshot
+    size_t path_length = strlen(filename);
+    char *temp_path = (char *)malloc(path_length + 5);
+    if (!temp_path)
+        return false;
+    memcpy(temp_path, filename, path_length);
+    memcpy(temp_path + path_length, ".tmp", 5);
+
+    FILE *file = fopen(temp_path, "wb");
+    if (!file)
+    {
+        printf("Could not open %s for writing.\n", temp_path);
+        free(temp_path);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, SNAPSHOT_IO_BUFFER);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t heap_offset = 0, subtask_index = 0, note_index = 0;
+
+    // Pass 2: task records; heap offsets are handed out in the order pass 5 writes them
+    for (Node *node = manager->task_list->head; ok && node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        TaskRecord record;
+        fill_task_record(&record, task);
+
+        record.first_subtask = subtask_index;
+        subtask_index += record.subtask_count;
+
+        record.description = heap_offset;
+        heap_offset += heap_string_size(task->description);
+        if (task->note && task->note->description)
+        {
+            record.note = heap_offset;
+            heap_offset += heap_string_size(task->note->description);
+        }
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+
+    // Pass 3: subtask records, grouped by task in task order
+    for (Node *node = manager->task_list->head; ok && node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+        {
+            SubTask *subtask = (SubTask *)sub->data->value;
+            SubTaskRecord record = {subtask->task_id, subtask->priority, heap_offset};
+            heap_offset += heap_string_size(subtask->description);
+            ok = fwrite(&record, sizeof(record), 1, file) == 1;
+        }
+    }
+
+    // Pass 4: appointment records, then their note offsets
+    for (Node *node = manager->appointment_list->head; ok && node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        AppointmentRecord record;
+        memset(&record, 0, sizeof(record));
+        record.id = appointment->id;
+        record.flags = (appointment->is_complete ? SNAPSHOT_COMPLETE : 0) |
+                       (appointment->have_reminder ? SNAPSHOT_REMINDER : 0);
+        record.recurrence_type = (uint8_t)appointment->recurrence_type;
+        record.date = (uint8_t)appointment->date;
+        record.month = (uint8_t)appointment->month;
+        record.hour = (uint8_t)appointment->time.hour;
+        record.minutes = (uint8_t)appointment->time.minutes;
+        record.note_count = note_blob_count(appointment->notes);
+        record.first_note = note_index;
+        note_index += record.note_count;
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    for (Node *node = manager->appointment_list->head; ok && node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        for (const char *note = note_blob_first(appointment->notes); ok && note; note = note_blob_next(appointment->notes, note))
+        {
+            ok = fwrite(&heap_offset, sizeof(heap_offset), 1, file) == 1;
+            heap_offset += heap_string_size(note);
+        }
+    }
+
+    // Pass 5: the string heap
+    for (Node *node = manager->task_list->head; ok && node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        ok = write_heap_string(file, task->description);
+        if (ok && task->note && task->note->description)
+            ok = write_heap_string(file, task->note->description);
+    }
+    for (Node *node = manager->task_list->head; ok && node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+            ok = write_heap_string(file, ((SubTask *)sub->data->value)->description);
+    }
+    for (Node *node = manager->appointment_list->head; ok && node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        for (const char *note = note_blob_first(appointment->notes); ok && note; note = note_blob_next(appointment->notes, note))
+            ok = write_heap_string(file, note);
+    }
+
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(temp_path, filename) == 0;
+
+    if (!ok)
+    {
+        printf("Failed to write snapshot %s.\n", filename);
+        remove(temp_path);
+    }
+    free(temp_path);
+    return ok;
+}
+
+bool load_tasks_from_file(TaskManager *manager, const char *filename)
+{
+    if (!manager || !filename)
+        return false;
+
+    if (manager->snapshot)
+    {
+        printf("TaskManager already holds a loaded snapshot.\n");
+        return false;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        printf("Snapshot %s is too small.\n", filename);
+        return false;
+    }
+
+    size_t size = (size_t)info.st_size;
+    char *base = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    SnapshotHeader header;
+    memcpy(&header, base, sizeof(header));
+
+    // Each count is bounded by the file before it is multiplied, so a crafted header cannot wrap the sum
+    uint64_t body = size - sizeof(header);
+    bool counts_fit = header.task_count <= body / sizeof(TaskRecord) &&
+                      header.subtask_count <= body / sizeof(SubTaskRecord) &&
+                      header.appointment_count <= body / sizeof(AppointmentRecord) &&
+                      header.note_count <= body / sizeof(uint64_t) && header.heap_size <= body;
+    uint64_t records_size = counts_fit ? header.task_count * sizeof(TaskRecord) +
+                                             header.subtask_count * sizeof(SubTaskRecord) +
+                                             header.appointment_count * sizeof(AppointmentRecord) +
+                                             header.note_count * sizeof(uint64_t)
+                                       : 0;
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || !counts_fit ||
+        records_size != body - header.heap_size)
+    {
+        printf("Snapshot %s is not a version %d snapshot or is truncated.\n", filename, SNAPSHOT_VERSION);
+        munmap(base, size);
+        return false;
+    }
+
+    // Records are read once front to back; strings are only touched when displayed
+    madvise(base, sizeof(header) + records_size, MADV_SEQUENTIAL);
+
+    const TaskRecord *tasks = (const TaskRecord *)(base + sizeof(header));
+    const SubTaskRecord *subtasks = (const SubTaskRecord *)(tasks + header.task_count);
+    const AppointmentRecord *appointments = (const AppointmentRecord *)(subtasks + header.subtask_count);
+    const uint64_t *notes = (const uint64_t *)(appointments + header.appointment_count);
+    const char *heap = (const char *)(notes + header.note_count);
+
+    manager->snapshot = base;
+    manager->snapshot_size = size;
+    manager->log_sequence = header.log_sequence;
+    bool ok = true;
+
+    for (uint64_t i = 0; ok && i < header.appointment_count; i++)
+    {
+        const AppointmentRecord *record = &appointments[i];
+        if (!task_order_schedule_valid(record->month, record->date, record->hour, record->minutes))
+        {
+            printf("Appointment %d has an invalid date; skipped.\n", record->id);
+            continue;
+        }
+
+        Appointment *appointment = (Appointment *)calloc(1, sizeof(Appointment));
+        if (!appointment)
+        {
+            ok = false;
+            break;
+        }
+
+        appointment->id = record->id;
+        appointment->is_complete = (record->flags & SNAPSHOT_COMPLETE) != 0;
+        appointment->have_reminder = (record->flags & SNAPSHOT_REMINDER) != 0;
+        appointment->recurrence_type = (RecurrenceType)record->recurrence_type;
+        appointment->date = (char)record->date;
+        appointment->month = (MonthsInAYear)record->month;
+        appointment->time.hour = (char)record->hour;
+        appointment->time.minutes = (char)record->minutes;
+
+        // Notes are copied into the appointment's blob rather than borrowed from the mapping
+        bool notes_fit = record->first_note <= header.note_count &&
+                         record->note_count <= header.note_count - record->first_note;
+        for (uint32_t n = 0; notes_fit && n < record->note_count; n++)
+        {
+            const char *note = heap_string(heap, header.heap_size, notes[record->first_note + n]);
+            if (!note_blob_append(&appointment->notes, note ? note : ""))
+                break;
+        }
+
+        if (!attach_appointment(manager, appointment))
+        {
+            free(appointment->notes);
+            free(appointment);
+        }
+    }
+
+    // attach_tasks clears rejected entries, so keep the originals and their records alongside
+    uint64_t slots = header.task_count ? header.task_count : 1;
+    Task **loaded = (Task **)malloc(sizeof(Task *) * slots);
+    Task **built = (Task **)malloc(sizeof(Task *) * slots);
+    const TaskRecord **sources = (const TaskRecord **)malloc(sizeof(TaskRecord *) * slots);
+    int loaded_count = 0;
+    if (!loaded || !built || !sources)
+        ok = false;
+
+    for (uint64_t i = 0; ok && i < header.task_count; i++)
+    {
+        const TaskRecord *record = &tasks[i];
+        if (!task_order_schedule_valid(record->month, record->date, record->hour, record->minutes))
+        {
+            printf("Task %d has an invalid due date; skipped.\n", record->id);
+            continue;
+        }
+
+        Task *task = (Task *)calloc(1, sizeof(Task));
+        if (!task)
+        {
+            ok = false;
+            break;
+        }
+
+        apply_task_record(task, record);
+        task->description = heap_string(heap, header.heap_size, record->description);
+        if (!task->description)
+        {
+            printf("Task %d has a corrupt description; skipped.\n", record->id);
+            free(task);
+            continue;
+        }
+
+        char *note_text = heap_string(heap, header.heap_size, record->note);
+        if (note_text && (task->note = (Notes *)malloc(sizeof(Notes))))
+            task->note->description = note_text;
+
+        if (record->subtask_count > 0 && record->first_subtask <= header.subtask_count &&
+            record->subtask_count <= header.subtask_count - record->first_subtask)
+        {
+            task->subtasks = create_list(UNBOUNDED_LIST_CAPACITY);
+            for (uint32_t s = 0; task->subtasks && s < record->subtask_count; s++)
+            {
+                const SubTaskRecord *sub = &subtasks[record->first_subtask + s];
+                char *description = heap_string(heap, header.heap_size, sub->description);
+                if (!description)
+                {
+                    printf("Subtask of task %d has a corrupt description; skipped.\n", record->id);
+                    continue;
+                }
+                append_subtask(task->subtasks, make_subtask(sub->task_id, sub->priority, description));
+            }
+            task->have_subtask = task->subtasks && task->subtasks->size > 0;
+        }
+
+        sources[loaded_count] = record;
+        built[loaded_count] = task;
+        loaded[loaded_count++] = task;
+    }
+
+    attach_tasks(manager, loaded, loaded_count);
+
+    for (int i = 0; i < loaded_count; i++)
+    {
+        if (!loaded[i])
+        {
+            discard_loaded_task(built[i]);
+            continue;
+        }
+        if (sources[i]->flags & SNAPSHOT_LINKED)
+            link_task_to_appointment(manager, loaded[i]->id, sources[i]->appointment_id);
+        if (sources[i]->flags & SNAPSHOT_ARMED)
+            arm_task_reminder(manager, loaded[i]->id, sources[i]->reminder_at);
+    }
+
+    free(loaded);
+    free(built);
+    free(sources);
+    return ok;
+}
+
+// --- Utility Functions for Serialization --- //
+
+bool serialize_task(FILE *file, Task *task)
+{
+    if (!file || !task || !task->description)
+        return false;
+
+    uint32_t subtask_count = task->subtasks ? task->subtasks->size : 0;
+    TaskRecord record;
+    fill_task_record(&record, task);
+
+    // String offsets are relative to the string area after the subtask records
+    uint64_t offset = 0;
+    record.description = offset;
+    offset += heap_string_size(task->description);
+    if (task->note && task->note->description)
+    {
+        record.note = offset;
+        offset += heap_string_size(task->note->description);
+    }
+
+    uint64_t payload = sizeof(record) + subtask_count * sizeof(SubTaskRecord);
+    for (Node *sub = task->subtasks ? task->subtasks->head : NULL; sub; sub = sub->next)
+        offset += heap_string_size(((SubTask *)sub->data->value)->description);
+    payload += offset;
+
+    if (payload > UINT32_MAX)
+        return false;
+
+    uint32_t length = (uint32_t)payload;
+    bool ok = fwrite(&length, sizeof(length), 1, file) == 1 && fwrite(&record, sizeof(record), 1, file) == 1;
+
+    offset = record.note == SNAPSHOT_NO_STRING ? heap_string_size(task->description)
+                                               : record.note + heap_string_size(task->note->description);
+    for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+    {
+        SubTask *subtask = (SubTask *)sub->data->value;
+        SubTaskRecord sub_record = {subtask->task_id, subtask->priority, offset};
+        offset += heap_string_size(subtask->description);
+        ok = fwrite(&sub_record, sizeof(sub_record), 1, file) == 1;
+    }
+
+    ok = ok && write_heap_string(file, task->description);
+    if (ok && record.note != SNAPSHOT_NO_STRING)
+        ok = write_heap_string(file, task->note->description);
+    for (Node *sub = task->subtasks ? task->subtasks->head : NULL; ok && sub; sub = sub->next)
+        ok = write_heap_string(file, ((SubTask *)sub->data->value)->description);
+
+    return ok;
+}
+
+static char *copy_heap_string(const char *strings, uint64_t size, uint64_t offset)
+{
+    char *text = heap_string(strings, size, offset);
+    if (!text)
+        return NULL;
+
+    size_t length = strlen(text) + 1;
+    char *copy = (char *)malloc(length);
+    if (copy)
+        memcpy(copy, text, length);
+    return copy;
+}
+
+Task *deserialize_task(FILE *file)
+{
+    uint32_t length;
+    if (!file || fread(&length, sizeof(length), 1, file) != 1 || length < sizeof(TaskRecord))
+        return NULL;
+
+    char *payload = (char *)malloc(length);
+    if (!payload)
+        return NULL;
+    if (fread(payload, 1, length, file) != length)
+    {
+        free(payload);
+        return NULL;
+    }
+
+    TaskRecord record;
+    memcpy(&record, payload, sizeof(record));
+
+    uint64_t subtask_bytes = (uint64_t)record.subtask_count * sizeof(SubTaskRecord);
+    if (sizeof(record) + subtask_bytes > length ||
+        !task_order_schedule_valid(record.month, record.date, record.hour, record.minutes))
+    {
+        free(payload);
+        return NULL;
+    }
+
+    const char *strings = payload + sizeof(record) + subtask_bytes;
+    uint64_t strings_size = length - sizeof(record) - subtask_bytes;
+
+    Task *task = (Task *)calloc(1, sizeof(Task));
+    if (!task)
+    {
+        free(payload);
+        return NULL;
+    }
+
+    // The appointment link is not resolvable from the stream alone and is left unset
+    apply_task_record(task, &record);
+    task->description = copy_heap_string(strings, strings_size, record.description);
+    if (!task->description)
+    {
+        free(task);
+        free(payload);
+        return NULL;
+    }
+
+    char *note_text = copy_heap_string(strings, strings_size, record.note);
+    if (note_text && (task->note = (Notes *)malloc(sizeof(Notes))))
+        task->note->description = note_text;
+    else
+        free(note_text);
+
+    if (record.subtask_count > 0)
+        task->subtasks = create_list(UNBOUNDED_LIST_CAPACITY);
+
+    for (uint32_t i = 0; task->subtasks && i < record.subtask_count; i++)
+    {
+        SubTaskRecord sub;
+        memcpy(&sub, payload + sizeof(record) + i * sizeof(SubTaskRecord), sizeof(sub));
+        char *description = copy_heap_string(strings, strings_size, sub.description);
+        if (!description)
+            continue;
+        if (!append_subtask(task->subtasks, make_subtask(sub.task_id, sub.priority, description)))
+            free(description);
+    }
+    task->have_subtask = task->subtasks && task->subtasks->size > 0;
+
+    free(payload);
+    return task;
+}
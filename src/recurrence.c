@@ -0,0 +1,402 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/recurrence.h"
+
+// --- Helpers --- //
+
+// Days since 1970-01-01 of a proleptic Gregorian date, month 1-12
+static int64_t days_from_civil(int64_t year, int month, int date)
+{
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t year_of_era = year - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + date - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+static void civil_from_days(int64_t days, int *year, int *month, int *date)
+{
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t day_of_era = days - era * 146097;
+    int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int64_t shifted = (5 * day_of_year + 2) / 153;
+    *date = (int)(day_of_year - (153 * shifted + 2) / 5 + 1);
+    *month = (int)(shifted < 10 ? shifted + 3 : shifted - 9);
+    *year = (int)(year_of_era + era * 400 + (*month <= 2));
+}
+
+static int64_t base_days(void)
+{
+    return days_from_civil(CALENDAR_BASE_YEAR, 1, 1);
+}
+
+static int64_t fixed_step(RecurrenceType rule)
+{
+    switch (rule)
+    {
+    case HOURLY:
+        return MINUTES_PER_HOUR;
+    case DAILY:
+        return MINUTES_PER_DAY;
+    case WEEKLY:
+        return 7 * MINUTES_PER_DAY;
+    case BI_WEEKLY:
+        return 14 * MINUTES_PER_DAY;
+    default:
+        return 0;
+    }
+}
+
+// Stamp of the item's nth occurrence, INT64_MAX when there is none
+static int64_t nth_occurrence(const RecurringItem *item, uint32_t n)
+{
+    int64_t step = fixed_step((RecurrenceType)item->rule);
+    if (step)
+        return item->anchor + step * n;
+
+    int year = item->year, month = item->month;
+    if (item->rule == MONTHLY)
+    {
+        year += (int)((month + (int64_t)n) / 12);
+        month = (int)((month + (int64_t)n) % 12);
+    }
+    else if (item->rule == YEARLY)
+        year += (int)n;
+    else
+        return n == 0 ? item->anchor : INT64_MAX;
+
+    int last = days_in_month(year, (MonthsInAYear)month);
+    Time time = {(char)item->minute, (char)item->hour};
+    return recurrence_stamp(year, (MonthsInAYear)month, item->date < last ? item->date : last, time);
+}
+
+// Number of the item's first occurrence at or after start
+static uint32_t first_occurrence(const RecurringItem *item, int64_t start)
+{
+    if (start <= item->anchor)
+        return 0;
+
+    int64_t step = fixed_step((RecurrenceType)item->rule);
+    if (step)
+        return (uint32_t)((start - item->anchor + step - 1) / step);
+    if (item->rule != MONTHLY && item->rule != YEARLY)
+        return 1;
+
+    // Start from just before the start's month or year; at most two steps forward
+    int year, date;
+    MonthsInAYear month;
+    Time time;
+    recurrence_split(start, &year, &month, &date, &time);
+    int64_t n = item->rule == MONTHLY ? (int64_t)(year - item->year) * 12 + (month - item->month) - 1
+                                      : (int64_t)(year - item->year) - 1;
+    uint32_t first = n > 0 ? (uint32_t)n : 0;
+    while (nth_occurrence(item, first) < start)
+        first++;
+    return first;
+}
+
+static bool cursor_before(const RecurrenceCursor *a, const RecurrenceCursor *b)
+{
+    return a->next < b->next || (a->next == b->next && a->item < b->item);
+}
+
+static void recurrence_sift_down(RecurrenceCursor *heap, uint32_t size, uint32_t i)
+{
+    RecurrenceCursor moving = heap[i];
+    for (;;)
+    {
+        uint32_t child = 2 * i + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && cursor_before(&heap[child + 1], &heap[child]))
+            child++;
+        if (!cursor_before(&heap[child], &moving))
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = moving;
+}
+
+static bool append_occurrence(RecurrenceWindow *window, Occurrence occurrence)
+{
+    if (window->count == window->capacity)
+    {
+        uint32_t capacity = window->capacity ? window->capacity * 2 : RECURRENCE_INITIAL_ITEMS;
+        Occurrence *grown = (Occurrence *)realloc(window->occurrences, sizeof(Occurrence) * capacity);
+        if (!grown)
+        {
+            printf("Memory allocation failed for RecurrenceWindow.\n");
+            return false;
+        }
+        window->occurrences = grown;
+        window->capacity = capacity;
+    }
+    window->occurrences[window->count++] = occurrence;
+    return true;
+}
+
+// Merges every item's occurrences in [start, end) into out, or appends them to
+// window when out is NULL. Returns the count, or -1 when memory runs out.
+static int64_t merge_occurrences(RecurrenceEngine *engine, int64_t start, int64_t end, Occurrence *out,
+                                 int64_t max_results, RecurrenceWindow *window)
+{
+    if (engine->heap_capacity < engine->count)
+    {
+        RecurrenceCursor *heap = (RecurrenceCursor *)realloc(engine->heap, sizeof(RecurrenceCursor) * engine->capacity);
+        if (!heap)
+        {
+            printf("Memory allocation failed for RecurrenceEngine heap.\n");
+            return -1;
+        }
+        engine->heap = heap;
+        engine->heap_capacity = engine->capacity;
+    }
+
+    // Seed each item at its first occurrence in the window, then heapify bottom-up
+    RecurrenceCursor *heap = engine->heap;
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < engine->count; i++)
+    {
+        uint32_t n = first_occurrence(&engine->items[i], start);
+        int64_t next = nth_occurrence(&engine->items[i], n);
+        if (next < end)
+            heap[size++] = (RecurrenceCursor){next, i, n};
+    }
+    for (uint32_t i = size / 2; i-- > 0;)
+        recurrence_sift_down(heap, size, i);
+
+    int64_t found = 0;
+    while (size && found < max_results)
+    {
+        const RecurringItem *item = &engine->items[heap[0].item];
+        Occurrence occurrence = {heap[0].next, item->id, item->kind};
+        if (out)
+            out[found] = occurrence;
+        else if (!append_occurrence(window, occurrence))
+            return -1;
+        found++;
+
+        heap[0].next = nth_occurrence(item, ++heap[0].n);
+        if (heap[0].next >= end)
+            heap[0] = heap[--size];
+        if (size)
+            recurrence_sift_down(heap, size, 0);
+    }
+    return found;
+}
+
+// --- Minute Stamps --- //
+
+int64_t recurrence_stamp(int year, MonthsInAYear month, int date, Time time)
+{
+    int64_t days = days_from_civil(year, (int)month + 1, date) - base_days();
+    return days * MINUTES_PER_DAY + time.hour * MINUTES_PER_HOUR + time.minutes;
+}
+
+void recurrence_split(int64_t stamp, int *year, MonthsInAYear *month, int *date, Time *time)
+{
+    int64_t days = stamp / MINUTES_PER_DAY, minutes = stamp % MINUTES_PER_DAY;
+    if (minutes < 0)
+    {
+        days--;
+        minutes += MINUTES_PER_DAY;
+    }
+
+    int civil_month;
+    civil_from_days(days + base_days(), year, &civil_month, date);
+    *month = (MonthsInAYear)(civil_month - 1);
+    time->hour = (char)(minutes / MINUTES_PER_HOUR);
+    time->minutes = (char)(minutes % MINUTES_PER_HOUR);
+}
+
+// --- Engine Lifecycle --- //
+
+void recurrence_engine_init(RecurrenceEngine *engine)
+{
+    memset(engine, 0, sizeof(RecurrenceEngine));
+    engine->generation = 1;      // Empty cache entries have generation 0 and never match
+}
+
+void recurrence_engine_free(RecurrenceEngine *engine)
+{
+    if (!engine)
+        return;
+
+    free(engine->items);
+    free(engine->heap);
+    for (int i = 0; i < RECURRENCE_CACHE_WINDOWS; i++)
+        free(engine->cache[i].occurrences);
+    memset(engine, 0, sizeof(RecurrenceEngine));
+}
+
+bool recurrence_engine_copy(RecurrenceEngine *copy, const RecurrenceEngine *engine)
+{
+    if (!copy || !engine)
+        return false;
+
+    recurrence_engine_init(copy);
+    if (!engine->count)
+        return true;
+
+    copy->items = (RecurringItem *)malloc(sizeof(RecurringItem) * engine->count);
+    if (!copy->items)
+    {
+        printf("Memory allocation failed for RecurrenceEngine copy.\n");
+        return false;
+    }
+    memcpy(copy->items, engine->items, sizeof(RecurringItem) * engine->count);
+    copy->count = copy->capacity = engine->count;
+    return true;
+}
+
+// --- Rules --- //
+
+bool recurrence_add(RecurrenceEngine *engine, RecurringKind kind, int id, RecurrenceType rule, int year,
+                    MonthsInAYear month, int date, Time time)
+{
+    if (!engine || rule < NONE || rule > YEARLY || month < JANUARY || month > DECEMBER || date < 1 ||
+        date > days_in_month(year, month))
+        return false;
+
+    if (engine->count == engine->capacity)
+    {
+        uint32_t capacity = engine->capacity ? engine->capacity * 2 : RECURRENCE_INITIAL_ITEMS;
+        RecurringItem *items = (RecurringItem *)realloc(engine->items, sizeof(RecurringItem) * capacity);
+        if (!items)
+        {
+            printf("Memory allocation failed for RecurrenceEngine rules.\n");
+            return false;
+        }
+        engine->items = items;
+        engine->capacity = capacity;
+    }
+
+    RecurringItem *item = &engine->items[engine->count++];
+    item->anchor = recurrence_stamp(year, month, date, time);
+    item->id = id;
+    item->year = (int16_t)year;
+    item->month = (uint8_t)month;
+    item->date = (uint8_t)date;
+    item->hour = (uint8_t)time.hour;
+    item->minute = (uint8_t)time.minutes;
+    item->kind = (uint8_t)kind;
+    item->rule = (uint8_t)rule;
+    engine->generation++;
+    return true;
+}
+
+bool recurrence_add_task(RecurrenceEngine *engine, int year, const Task *task)
+{
+    return task && recurrence_add(engine, RECURRING_TASK, task->id, task->recurrence_type, year, task->month,
+                                  task->date, task->time);
+}
+
+bool recurrence_add_appointment(RecurrenceEngine *engine, int year, const Appointment *appointment)
+{
+    return appointment && recurrence_add(engine, RECURRING_APPOINTMENT, appointment->id,
+                                         appointment->recurrence_type, year, appointment->month,
+                                         appointment->date, appointment->time);
+}
+
+bool recurrence_remove(RecurrenceEngine *engine, RecurringKind kind, int id)
+{
+    if (!engine)
+        return false;
+
+    // Later rules shift down so ties keep coming out in the order rules were added
+    for (uint32_t i = 0; i < engine->count; i++)
+    {
+        if (engine->items[i].id == id && engine->items[i].kind == kind)
+        {
+            memmove(engine->items + i, engine->items + i + 1, sizeof(RecurringItem) * (engine->count - i - 1));
+            engine->count--;
+            engine->generation++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Expansion --- //
+
+int recurrence_expand(RecurrenceEngine *engine, int64_t start, int64_t end, Occurrence *out, int max_results)
+{
+    if (!engine || !out || max_results <= 0 || start >= end)
+        return 0;
+
+    int64_t found = merge_occurrences(engine, start, end, out, max_results, NULL);
+    return found < 0 ? 0 : (int)found;
+}
+
+const Occurrence *recurrence_window(RecurrenceEngine *engine, int64_t start, int64_t end, uint32_t *count)
+{
+    // An empty window still gets a non-NULL array
+    static const Occurrence no_occurrences[1];
+    if (!engine || !count)
+        return NULL;
+
+    engine->clock++;
+    for (int i = 0; i < RECURRENCE_CACHE_WINDOWS; i++)
+    {
+        RecurrenceWindow *window = &engine->cache[i];
+        if (window->generation == engine->generation && window->start == start && window->end == end)
+        {
+            engine->cache_hits++;
+            window->last_used = engine->clock;
+            *count = window->count;
+            return window->occurrences ? window->occurrences : no_occurrences;
+        }
+    }
+
+    // Expand into a window from before the last rule change if there is one, else the
+    // least recently used; the buffer is kept. Other stale windows let go of theirs.
+    RecurrenceWindow *victim = NULL, *oldest = &engine->cache[0];
+    for (int i = 0; i < RECURRENCE_CACHE_WINDOWS; i++)
+    {
+        RecurrenceWindow *window = &engine->cache[i];
+        if (window->last_used < oldest->last_used)
+            oldest = window;
+        if (window->generation == engine->generation)
+            continue;
+        if (!victim)
+            victim = window;
+        else
+        {
+            free(window->occurrences);
+            memset(window, 0, sizeof(RecurrenceWindow));
+        }
+    }
+    if (!victim)
+        victim = oldest;
+
+    engine->cache_misses++;
+    victim->count = 0;
+    victim->generation = 0;
+    if (start < end && merge_occurrences(engine, start, end, NULL, INT64_MAX, victim) < 0)
+        return NULL;
+
+    victim->start = start;
+    victim->end = end;
+    victim->generation = engine->generation;
+    victim->last_used = engine->clock;
+    *count = victim->count;
+    return victim->occurrences ? victim->occurrences : no_occurrences;
+}
+
+size_t recurrence_memory(const RecurrenceEngine *engine)
+{
+    if (!engine)
+        return 0;
+
+    size_t bytes = sizeof(RecurringItem) * engine->capacity + sizeof(RecurrenceCursor) * engine->heap_capacity;
+    for (int i = 0; i < RECURRENCE_CACHE_WINDOWS; i++)
+        bytes += sizeof(Occurrence) * engine->cache[i].capacity;
+    return bytes;
+}
@@ -0,0 +1,240 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/reminder_wheel.h"
+
+// --- Helpers --- //
+
+static ReminderTimer **timer_list(ReminderWheel *wheel, const ReminderTimer *timer)
+{
+    return timer->level == WHEEL_OVERFLOW ? &wheel->overflow : &wheel->slots[timer->level][timer->slot];
+}
+
+// Files the timer by how many leading bits its fire time shares with now. A
+// cascade runs before the current minute fires, so it may file into now itself;
+// anything else earlier than the next minute goes there.
+static void link_timer(ReminderWheel *wheel, ReminderTimer *timer, int64_t earliest)
+{
+    int64_t when = timer->fire_at > earliest ? timer->fire_at : earliest;
+
+    timer->level = WHEEL_OVERFLOW;
+    for (int level = 0; level < WHEEL_LEVELS; level++)
+    {
+        int above = WHEEL_SLOT_BITS * (level + 1);
+        if ((when >> above) == (wheel->now >> above))
+        {
+            timer->level = (uint8_t)level;
+            timer->slot = (uint8_t)((when >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1));
+            wheel->occupied[level] |= (uint64_t)1 << timer->slot;
+            break;
+        }
+    }
+
+    ReminderTimer **head = timer_list(wheel, timer);
+    timer->prev = NULL;
+    timer->next = *head;
+    if (*head)
+        (*head)->prev = timer;
+    *head = timer;
+}
+
+static void unlink_timer(ReminderWheel *wheel, ReminderTimer *timer)
+{
+    ReminderTimer **head = timer_list(wheel, timer);
+    if (timer->prev)
+        timer->prev->next = timer->next;
+    else
+        *head = timer->next;
+    if (timer->next)
+        timer->next->prev = timer->prev;
+
+    if (!*head && timer->level != WHEEL_OVERFLOW)
+        wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+}
+
+static ReminderTimer *take_timer(ReminderWheel *wheel)
+{
+    if (!wheel->free_timers)
+    {
+        ReminderChunk *chunk = (ReminderChunk *)malloc(sizeof(ReminderChunk));
+        if (!chunk)
+        {
+            printf("Memory allocation failed for ReminderWheel timers.\n");
+            return NULL;
+        }
+        chunk->next = wheel->chunks;
+        wheel->chunks = chunk;
+        for (int i = WHEEL_POOL_CHUNK - 1; i >= 0; i--)
+        {
+            chunk->timers[i].next = wheel->free_timers;
+            wheel->free_timers = &chunk->timers[i];
+        }
+    }
+
+    ReminderTimer *timer = wheel->free_timers;
+    wheel->free_timers = timer->next;
+    return timer;
+}
+
+static void return_timer(ReminderWheel *wheel, ReminderTimer *timer)
+{
+    timer->next = wheel->free_timers;
+    wheel->free_timers = timer;
+}
+
+// Re-files a whole list against the current time; its timers land on lower levels
+static void cascade(ReminderWheel *wheel, ReminderTimer *list)
+{
+    while (list)
+    {
+        ReminderTimer *next = list->next;
+        link_timer(wheel, list, wheel->now);
+        wheel->cascaded++;
+        list = next;
+    }
+}
+
+static void cascade_slot(ReminderWheel *wheel, int level, int slot)
+{
+    ReminderTimer *list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+    cascade(wheel, list);
+}
+
+// The next minute after now at which anything can happen, given which levels hold timers
+static int64_t next_event(const ReminderWheel *wheel)
+{
+    if (wheel->occupied[0])
+    {
+        int position = (int)((wheel->now + 1) & (WHEEL_SLOTS - 1));
+        uint64_t ahead = position ? wheel->occupied[0] & (~(uint64_t)0 << position) : 0;
+        if (ahead)
+            return (wheel->now & ~(int64_t)(WHEEL_SLOTS - 1)) + __builtin_ctzll(ahead);
+        return ((wheel->now >> WHEEL_SLOT_BITS) + 1) << WHEEL_SLOT_BITS;
+    }
+
+    // Nothing below the lowest occupied level, so nothing happens before its next boundary
+    int level = 1;
+    while (level < WHEEL_LEVELS && !wheel->occupied[level])
+        level++;
+    int bits = WHEEL_SLOT_BITS * level;
+    return ((wheel->now >> bits) + 1) << bits;
+}
+
+// --- Wheel Lifecycle --- //
+
+void reminder_wheel_init(ReminderWheel *wheel, int64_t now)
+{
+    memset(wheel, 0, sizeof(ReminderWheel));
+    wheel->now = now;
+}
+
+void reminder_wheel_free(ReminderWheel *wheel)
+{
+    if (!wheel)
+        return;
+
+    while (wheel->chunks)
+    {
+        ReminderChunk *next = wheel->chunks->next;
+        free(wheel->chunks);
+        wheel->chunks = next;
+    }
+    reminder_wheel_init(wheel, 0);
+}
+
+// --- Timers --- //
+
+ReminderTimer *reminder_wheel_arm(ReminderWheel *wheel, int id, int64_t fire_at)
+{
+    ReminderTimer *timer = wheel ? take_timer(wheel) : NULL;
+    if (!timer)
+        return NULL;
+
+    timer->id = id;
+    timer->fire_at = fire_at;
+    link_timer(wheel, timer, wheel->now + 1);
+    wheel->count++;
+    return timer;
+}
+
+void reminder_wheel_cancel(ReminderWheel *wheel, ReminderTimer *timer)
+{
+    if (!wheel || !timer)
+        return;
+
+    unlink_timer(wheel, timer);
+    return_timer(wheel, timer);
+    wheel->count--;
+}
+
+void reminder_wheel_reschedule(ReminderWheel *wheel, ReminderTimer *timer, int64_t fire_at)
+{
+    if (!wheel || !timer)
+        return;
+
+    unlink_timer(wheel, timer);
+    timer->fire_at = fire_at;
+    link_timer(wheel, timer, wheel->now + 1);
+}
+
+// --- Time --- //
+
+uint64_t reminder_wheel_advance(ReminderWheel *wheel, int64_t now, ReminderFire fire, void *context)
+{
+    uint64_t fired = 0;
+    while (wheel && wheel->now < now)
+    {
+        int64_t minute = wheel->count ? next_event(wheel) : now + 1;
+        if (minute > now)
+        {
+            wheel->now = now;
+            break;
+        }
+        wheel->now = minute;
+
+        // Cascade from the top down, so a slot pulled out of level 2 into level 1
+        // is there when level 1 cascades in the same minute
+        if ((minute & (((int64_t)1 << (WHEEL_SLOT_BITS * WHEEL_LEVELS)) - 1)) == 0)
+        {
+            ReminderTimer *list = wheel->overflow;
+            wheel->overflow = NULL;
+            cascade(wheel, list);
+        }
+        for (int level = WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            int bits = WHEEL_SLOT_BITS * level;
+            if ((minute & (((int64_t)1 << bits) - 1)) == 0)
+                cascade_slot(wheel, level, (int)((minute >> bits) & (WHEEL_SLOTS - 1)));
+        }
+
+        ReminderTimer **due = &wheel->slots[0][minute & (WHEEL_SLOTS - 1)];
+        while (*due)
+        {
+            ReminderTimer *timer = *due;
+            int id = timer->id;
+            int64_t fire_at = timer->fire_at;
+            reminder_wheel_cancel(wheel, timer);
+            fired++;
+            if (fire)
+                fire(id, fire_at, context);
+        }
+    }
+    return fired;
+}
+
+int64_t reminder_wheel_next(const ReminderWheel *wheel)
+{
+    return wheel && wheel->count ? next_event(wheel) : INT64_MAX;
+}
+
+size_t reminder_wheel_memory(const ReminderWheel *wheel)
+{
+    size_t bytes = 0;
+    for (const ReminderChunk *chunk = wheel ? wheel->chunks : NULL; chunk; chunk = chunk->next)
+        bytes += sizeof(ReminderChunk);
+    return bytes;
+}
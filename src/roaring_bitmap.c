@@ -0,0 +1,338 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/roaring_bitmap.h"
+
+#define ROARING_MAX_SETS 16
+
+// --- Helpers --- //
+
+// Position of the first element >= target
+static uint32_t lower_bound_u16(const uint16_t *values, uint32_t count, uint16_t target)
+{
+    uint32_t low = 0, high = count;
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        if (values[middle] < target)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+static const RoaringContainer *find_container(const RoaringBitmap *set, uint16_t key)
+{
+    uint32_t i = lower_bound_u16(set->keys, set->count, key);
+    return i < set->count && set->keys[i] == key ? &set->containers[i] : NULL;
+}
+
+static bool container_contains(const RoaringContainer *container, uint16_t low)
+{
+    if (container->bits)
+        return (container->bits[low >> 6] >> (low & 63)) & 1;
+
+    uint32_t i = lower_bound_u16(container->values, container->cardinality, low);
+    return i < container->cardinality && container->values[i] == low;
+}
+
+static bool array_to_bitmap(RoaringContainer *container)
+{
+    uint64_t *bits = (uint64_t *)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    if (!bits)
+        return false;
+
+    for (uint32_t i = 0; i < container->cardinality; i++)
+        bits[container->values[i] >> 6] |= (uint64_t)1 << (container->values[i] & 63);
+    free(container->values);
+    container->values = NULL;
+    container->bits = bits;
+    container->capacity = 0;
+    return true;
+}
+
+// Best effort: a bitmap that cannot shrink just stays a bitmap
+static void bitmap_to_array(RoaringContainer *container)
+{
+    uint16_t *values = (uint16_t *)malloc(sizeof(uint16_t) * (container->cardinality + 1));
+    if (!values)
+        return;
+
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++)
+    {
+        for (uint64_t word = container->bits[w]; word; word &= word - 1)
+            values[count++] = (uint16_t)(w * 64 + __builtin_ctzll(word));
+    }
+    free(container->bits);
+    container->bits = NULL;
+    container->values = values;
+    container->capacity = container->cardinality + 1;
+}
+
+// Adds low to the container; false when memory runs out, *added tells whether it was new
+static bool container_add(RoaringContainer *container, uint16_t low, bool *added)
+{
+    *added = false;
+    if (container->bits)
+    {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(container->bits[low >> 6] & bit))
+        {
+            container->bits[low >> 6] |= bit;
+            container->cardinality++;
+            *added = true;
+        }
+        return true;
+    }
+
+    uint32_t i = lower_bound_u16(container->values, container->cardinality, low);
+    if (i < container->cardinality && container->values[i] == low)
+        return true;
+
+    if (container->cardinality == ROARING_ARRAY_MAX)
+        return array_to_bitmap(container) && container_add(container, low, added);
+
+    if (container->cardinality == container->capacity)
+    {
+        uint32_t capacity = container->capacity ? container->capacity * 2 : ROARING_INITIAL_ARRAY;
+        if (capacity > ROARING_ARRAY_MAX)
+            capacity = ROARING_ARRAY_MAX;
+        uint16_t *values = (uint16_t *)realloc(container->values, sizeof(uint16_t) * capacity);
+        if (!values)
+            return false;
+        container->values = values;
+        container->capacity = capacity;
+    }
+
+    memmove(container->values + i + 1, container->values + i, sizeof(uint16_t) * (container->cardinality - i));
+    container->values[i] = low;
+    container->cardinality++;
+    *added = true;
+    return true;
+}
+
+static bool container_remove(RoaringContainer *container, uint16_t low)
+{
+    if (container->bits)
+    {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(container->bits[low >> 6] & bit))
+            return false;
+        container->bits[low >> 6] &= ~bit;
+        if (--container->cardinality < ROARING_ARRAY_MIN)
+            bitmap_to_array(container);
+        return true;
+    }
+
+    uint32_t i = lower_bound_u16(container->values, container->cardinality, low);
+    if (i >= container->cardinality || container->values[i] != low)
+        return false;
+    memmove(container->values + i, container->values + i + 1, sizeof(uint16_t) * (container->cardinality - i - 1));
+    container->cardinality--;
+    return true;
+}
+
+static void free_container(RoaringContainer *container)
+{
+    free(container->values);
+    free(container->bits);
+}
+
+// Intersects one container from each set into out (or only counts when out is NULL)
+static uint64_t intersect_containers(const RoaringContainer **containers, int count, uint32_t high,
+                                     uint32_t *out, uint64_t room)
+{
+    // Drive from the smallest array if there is one: each of its values is checked in the rest
+    int driver = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (!containers[i]->bits && (driver < 0 || containers[i]->cardinality < containers[driver]->cardinality))
+            driver = i;
+    }
+
+    uint64_t found = 0;
+    if (driver >= 0)
+    {
+        const RoaringContainer *array = containers[driver];
+        for (uint32_t v = 0; v < array->cardinality && found < room; v++)
+        {
+            bool everywhere = true;
+            for (int i = 0; everywhere && i < count; i++)
+                everywhere = i == driver || container_contains(containers[i], array->values[v]);
+            if (everywhere)
+            {
+                if (out)
+                    out[found] = high | array->values[v];
+                found++;
+            }
+        }
+        return found;
+    }
+
+    // All bitmaps: AND them a word at a time
+    for (uint32_t w = 0; w < ROARING_BITMAP_WORDS && found < room; w++)
+    {
+        uint64_t word = containers[0]->bits[w];
+        for (int i = 1; word && i < count; i++)
+            word &= containers[i]->bits[w];
+
+        if (!out)
+            found += (uint64_t)__builtin_popcountll(word);
+        for (; out && word && found < room; word &= word - 1)
+            out[found++] = high | (w * 64 + __builtin_ctzll(word));
+    }
+    return found;
+}
+
+static uint64_t intersect_sets(const RoaringBitmap *const *sets, int count, uint32_t *out, uint64_t room)
+{
+    if (!sets || count <= 0 || count > ROARING_MAX_SETS)
+        return 0;
+
+    // Only the keys of the set with the fewest containers can be in the result
+    int driver = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!sets[i])
+            return 0;
+        if (sets[i]->count < sets[driver]->count)
+            driver = i;
+    }
+
+    const RoaringContainer *containers[ROARING_MAX_SETS];
+    uint64_t found = 0;
+    for (uint32_t k = 0; k < sets[driver]->count && found < room; k++)
+    {
+        uint16_t key = sets[driver]->keys[k];
+        bool everywhere = true;
+        for (int i = 0; everywhere && i < count; i++)
+            everywhere = (containers[i] = find_container(sets[i], key)) != NULL;
+        if (everywhere)
+            found += intersect_containers(containers, count, (uint32_t)key << 16, out ? out + found : NULL,
+                                          room - found);
+    }
+    return found;
+}
+
+// --- Lifecycle --- //
+
+void roaring_init(RoaringBitmap *set)
+{
+    memset(set, 0, sizeof(RoaringBitmap));
+}
+
+void roaring_free(RoaringBitmap *set)
+{
+    if (!set)
+        return;
+
+    for (uint32_t i = 0; i < set->count; i++)
+        free_container(&set->containers[i]);
+    free(set->keys);
+    free(set->containers);
+    roaring_init(set);
+}
+
+// --- Updates --- //
+
+bool roaring_add(RoaringBitmap *set, uint32_t value)
+{
+    if (!set)
+        return false;
+
+    uint16_t key = (uint16_t)(value >> 16);
+    uint32_t i = lower_bound_u16(set->keys, set->count, key);
+    if (i == set->count || set->keys[i] != key)
+    {
+        if (set->count == set->capacity)
+        {
+            uint32_t capacity = set->capacity ? set->capacity * 2 : 4;
+            uint16_t *keys = (uint16_t *)realloc(set->keys, sizeof(uint16_t) * capacity);
+            if (keys)
+                set->keys = keys;
+            RoaringContainer *containers = keys ? (RoaringContainer *)realloc(set->containers,
+                                                                             sizeof(RoaringContainer) * capacity) : NULL;
+            if (!containers)
+                return false;
+            set->containers = containers;
+            set->capacity = capacity;
+        }
+
+        memmove(set->keys + i + 1, set->keys + i, sizeof(uint16_t) * (set->count - i));
+        memmove(set->containers + i + 1, set->containers + i, sizeof(RoaringContainer) * (set->count - i));
+        set->keys[i] = key;
+        memset(&set->containers[i], 0, sizeof(RoaringContainer));
+        set->count++;
+    }
+
+    bool added;
+    if (!container_add(&set->containers[i], (uint16_t)value, &added))
+    {
+        // Drop a container that was only just made for this value
+        if (set->containers[i].cardinality == 0)
+            roaring_remove(set, value);
+        return false;
+    }
+    set->cardinality += added;
+    return true;
+}
+
+bool roaring_remove(RoaringBitmap *set, uint32_t value)
+{
+    if (!set)
+        return false;
+
+    uint16_t key = (uint16_t)(value >> 16);
+    uint32_t i = lower_bound_u16(set->keys, set->count, key);
+    if (i == set->count || set->keys[i] != key)
+        return false;
+
+    RoaringContainer *container = &set->containers[i];
+    bool removed = container_remove(container, (uint16_t)value);
+    set->cardinality -= removed;
+
+    if (container->cardinality == 0)
+    {
+        free_container(container);
+        memmove(set->keys + i, set->keys + i + 1, sizeof(uint16_t) * (set->count - i - 1));
+        memmove(set->containers + i, set->containers + i + 1, sizeof(RoaringContainer) * (set->count - i - 1));
+        set->count--;
+    }
+    return removed;
+}
+
+// --- Queries --- //
+
+bool roaring_contains(const RoaringBitmap *set, uint32_t value)
+{
+    const RoaringContainer *container = set ? find_container(set, (uint16_t)(value >> 16)) : NULL;
+    return container && container_contains(container, (uint16_t)value);
+}
+
+int roaring_intersect(const RoaringBitmap *const *sets, int count, uint32_t *out, int max_results)
+{
+    if (!out || max_results <= 0)
+        return 0;
+    return (int)intersect_sets(sets, count, out, (uint64_t)max_results);
+}
+
+uint64_t roaring_intersect_count(const RoaringBitmap *const *sets, int count)
+{
+    return intersect_sets(sets, count, NULL, UINT64_MAX);
+}
+
+size_t roaring_memory(const RoaringBitmap *set)
+{
+    if (!set)
+        return 0;
+
+    size_t bytes = set->capacity * (sizeof(uint16_t) + sizeof(RoaringContainer));
+    for (uint32_t i = 0; i < set->count; i++)
+        bytes += set->containers[i].bits ? ROARING_BITMAP_WORDS * sizeof(uint64_t)
+                                         : set->containers[i].capacity * sizeof(uint16_t);
+    return bytes;
+}
@@ -0,0 +1,279 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/string_arena.h"
+
+#define ARENA_TOMBSTONE ((InternedString *)1)
+
+// --- Helpers --- //
+
+static uint32_t arena_hash(const char *text, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    return hash;
+}
+
+static size_t slot_size(size_t length)
+{
+    size_t size = sizeof(InternedString) + length + 1;
+    return (size + ARENA_SLOT_ALIGN - 1) & ~(size_t)(ARENA_SLOT_ALIGN - 1);
+}
+
+static InternedString *string_of(const char *text)
+{
+    return (InternedString *)(text - offsetof(InternedString, text));
+}
+
+// Slot holding text, or the first free slot of its probe sequence when it is absent
+static ArenaSlot *find_slot(StringArena *arena, const char *text, size_t length, uint32_t hash)
+{
+    size_t mask = arena->capacity - 1;
+    ArenaSlot *reuse = NULL;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        ArenaSlot *slot = &arena->slots[i];
+        if (!slot->string)
+            return reuse ? reuse : slot;
+        if (slot->string == ARENA_TOMBSTONE)
+        {
+            if (!reuse)
+                reuse = slot;
+        }
+        else if (slot->hash == hash && slot->string->length == length &&
+                 memcmp(slot->string->text, text, length) == 0)
+            return slot;
+    }
+}
+
+static bool resize_slots(StringArena *arena, size_t capacity)
+{
+    ArenaSlot *slots = (ArenaSlot *)calloc(capacity, sizeof(ArenaSlot));
+    if (!slots)
+        return false;
+
+    for (size_t i = 0; i < arena->capacity; i++)
+    {
+        InternedString *string = arena->slots[i].string;
+        if (!string || string == ARENA_TOMBSTONE)
+            continue;
+
+        size_t j = arena->slots[i].hash & (capacity - 1);
+        while (slots[j].string)
+            j = (j + 1) & (capacity - 1);
+        slots[j] = arena->slots[i];
+    }
+
+    free(arena->slots);
+    arena->slots = slots;
+    arena->capacity = capacity;
+    arena->tombstones = 0;
+    return true;
+}
+
+static InternedString *allocate_string(StringArena *arena, size_t size)
+{
+    if (size > ARENA_MAX_SLOT)
+    {
+        InternedString *string = (InternedString *)malloc(size);
+        if (string)
+            arena->bytes += size;
+        return string;
+    }
+
+    void **free_list = &arena->free_slots[size / ARENA_SLOT_ALIGN - 1];
+    if (*free_list)
+    {
+        void *slot = *free_list;
+        *free_list = *(void **)slot;
+        return (InternedString *)slot;
+    }
+
+    ArenaChunk *chunk = arena->chunks;
+    if (!chunk || chunk->used + size > ARENA_CHUNK_SIZE)
+    {
+        chunk = (ArenaChunk *)malloc(sizeof(ArenaChunk) + ARENA_CHUNK_SIZE);
+        if (!chunk)
+            return NULL;
+        chunk->next = arena->chunks;
+        chunk->used = 0;
+        arena->chunks = chunk;
+        arena->bytes += sizeof(ArenaChunk) + ARENA_CHUNK_SIZE;
+    }
+
+    InternedString *string = (InternedString *)(chunk->data + chunk->used);
+    chunk->used += size;
+    return string;
+}
+
+static void release_string_slot(StringArena *arena, InternedString *string)
+{
+    size_t size = slot_size(string->length);
+    if (size > ARENA_MAX_SLOT)
+    {
+        arena->bytes -= size;
+        free(string);
+        return;
+    }
+
+    void **free_list = &arena->free_slots[size / ARENA_SLOT_ALIGN - 1];
+    *(void **)string = *free_list;
+    *free_list = string;
+}
+
+// --- Arena Lifecycle --- //
+
+StringArena *create_string_arena()
+{
+    StringArena *arena = (StringArena *)calloc(1, sizeof(StringArena));
+    if (!arena)
+    {
+        printf("Memory allocation failed for StringArena.\n");
+        return NULL;
+    }
+
+    arena->slots = (ArenaSlot *)calloc(ARENA_INITIAL_SLOTS, sizeof(ArenaSlot));
+    if (!arena->slots)
+    {
+        printf("Memory allocation failed for StringArena.\n");
+        free(arena);
+        return NULL;
+    }
+    arena->capacity = ARENA_INITIAL_SLOTS;
+    return arena;
+}
+
+void free_string_arena(StringArena *arena)
+{
+    if (!arena)
+        return;
+
+    // Large strings are the only ones outside the chunks
+    for (size_t i = 0; i < arena->capacity; i++)
+    {
+        InternedString *string = arena->slots[i].string;
+        if (string && string != ARENA_TOMBSTONE && slot_size(string->length) > ARENA_MAX_SLOT)
+            free(string);
+    }
+
+    for (ArenaChunk *chunk = arena->chunks, *next; chunk; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+    free(arena->slots);
+    free(arena);
+}
+
+// --- Interning --- //
+
+char *intern_string(StringArena *arena, const char *text)
+{
+    if (!arena || !text)
+        return NULL;
+
+    size_t length = strlen(text);
+    if (length > UINT32_MAX - sizeof(InternedString) - ARENA_SLOT_ALIGN)
+        return NULL;
+
+    // Keep the table at most 3/4 full, counting tombstones, so probes stay short
+    if ((arena->count + arena->tombstones + 1) * 4 > arena->capacity * 3 &&
+        !resize_slots(arena, arena->count * 4 > arena->capacity ? arena->capacity * 2 : arena->capacity))
+        return NULL;
+
+    uint32_t hash = arena_hash(text, length);
+    ArenaSlot *slot = find_slot(arena, text, length, hash);
+    if (slot->string && slot->string != ARENA_TOMBSTONE)
+    {
+        slot->string->references++;
+        arena->interned++;
+        return slot->string->text;
+    }
+
+    InternedString *string = allocate_string(arena, slot_size(length));
+    if (!string)
+        return NULL;
+
+    string->references = 1;
+    string->length = (uint32_t)length;
+    memcpy(string->text, text, length + 1);
+
+    if (slot->string == ARENA_TOMBSTONE)
+        arena->tombstones--;
+    slot->string = string;
+    slot->hash = hash;
+    arena->count++;
+    arena->interned++;
+    return string->text;
+}
+
+bool release_interned(StringArena *arena, const char *text)
+{
+    if (!arena || !text)
+        return false;
+
+    // Look the text up rather than trusting its header: it may not be ours at all
+    size_t length = strlen(text);
+    uint32_t hash = arena_hash(text, length);
+    ArenaSlot *slot = find_slot(arena, text, length, hash);
+    if (!slot->string || slot->string == ARENA_TOMBSTONE || slot->string != string_of(text))
+        return false;
+
+    arena->interned--;
+    if (--slot->string->references > 0)
+        return true;
+
+    release_string_slot(arena, slot->string);
+    slot->string = ARENA_TOMBSTONE;
+    arena->count--;
+    arena->tombstones++;
+    return true;
+}
+
+// --- Note Blobs --- //
+
+bool note_blob_append(NoteBlob **blob, const char *text)
+{
+    if (!blob || !text)
+        return false;
+
+    size_t length = strlen(text) + 1;
+    size_t used = *blob ? (*blob)->size : 0;
+    if (used + length > UINT32_MAX)
+        return false;
+
+    NoteBlob *grown = (NoteBlob *)realloc(*blob, sizeof(NoteBlob) + used + length);
+    if (!grown)
+        return false;
+
+    if (!*blob)
+        grown->count = 0;
+    memcpy(grown->text + used, text, length);
+    grown->size = (uint32_t)(used + length);
+    grown->count++;
+    *blob = grown;
+    return true;
+}
+
+uint32_t note_blob_count(const NoteBlob *blob)
+{
+    return blob ? blob->count : 0;
+}
+
+const char *note_blob_first(const NoteBlob *blob)
+{
+    return blob && blob->count > 0 ? blob->text : NULL;
+}
+
+const char *note_blob_next(const NoteBlob *blob, const char *note)
+{
+    if (!blob || !note)
+        return NULL;
+
+    const char *next = note + strlen(note) + 1;
+    return next < blob->text + blob->size ? next : NULL;
+}
@@ -0,0 +1,248 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/task_filter.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TASK_FILTER_AVX2 1
+#endif
+
+#define SELECT_MAX_TERMS 4
+
+// One byte predicate: (column[i] & mask) - low <= span
+typedef struct SelectTerm {
+    const uint8_t *column;
+    uint8_t mask;
+    uint8_t low;
+    uint8_t span;
+} SelectTerm;
+
+// --- Helpers --- //
+
+static const uint8_t *column_bytes(const TaskStore *store, TaskColumn column)
+{
+    switch (column)
+    {
+    case TASK_COLUMN_PRIORITY: return store->priority;
+    case TASK_COLUMN_FLAGS: return store->flags;
+    case TASK_COLUMN_MONTH: return store->month;
+    case TASK_COLUMN_DATE: return store->date;
+    case TASK_COLUMN_HOUR: return store->hour;
+    case TASK_COLUMN_MINUTE: return store->minute;
+    case TASK_COLUMN_RECURRENCE: return store->recurrence;
+    }
+    return NULL;
+}
+
+static SelectTerm make_term(const uint8_t *column, uint8_t mask, uint8_t low, uint8_t high)
+{
+    SelectTerm term = {column, mask, low, (uint8_t)(high - low)};
+    return term;
+}
+
+// Rows from start (a multiple of 64) to rows, a word at a time
+static void select_terms_scalar(const SelectTerm *terms, int count, uint32_t start, uint32_t rows, uint64_t *out)
+{
+    for (uint32_t row = start; row < rows; row += 64)
+    {
+        uint32_t end = rows - row < 64 ? rows : row + 64;
+        uint64_t word = 0;
+        for (uint32_t i = row; i < end; i++)
+        {
+            unsigned int keep = 1;
+            for (int t = 0; t < count; t++)
+                keep &= (uint8_t)((terms[t].column[i] & terms[t].mask) - terms[t].low) <= terms[t].span;
+            word |= (uint64_t)keep << (i - row);
+        }
+        out[row / 64] = word;
+    }
+}
+
+#ifdef TASK_FILTER_AVX2
+
+// 32 rows per compare: unsigned x <= span is min(x, span) == x
+__attribute__((target("avx2")))
+static void select_terms_avx2(const SelectTerm *terms, int count, uint32_t rows, uint64_t *out)
+{
+    __m256i mask[SELECT_MAX_TERMS], low[SELECT_MAX_TERMS], span[SELECT_MAX_TERMS];
+    for (int t = 0; t < count; t++)
+    {
+        mask[t] = _mm256_set1_epi8((char)terms[t].mask);
+        low[t] = _mm256_set1_epi8((char)terms[t].low);
+        span[t] = _mm256_set1_epi8((char)terms[t].span);
+    }
+
+    uint32_t full = rows / 64 * 64;
+    for (uint32_t row = 0; row < full; row += 64)
+    {
+        __m256i keep_low = _mm256_set1_epi8(-1), keep_high = keep_low;
+        for (int t = 0; t < count; t++)
+        {
+            const __m256i *column = (const __m256i *)(terms[t].column + row);
+            __m256i x = _mm256_sub_epi8(_mm256_and_si256(_mm256_loadu_si256(column), mask[t]), low[t]);
+            __m256i y = _mm256_sub_epi8(_mm256_and_si256(_mm256_loadu_si256(column + 1), mask[t]), low[t]);
+            keep_low = _mm256_and_si256(keep_low, _mm256_cmpeq_epi8(_mm256_min_epu8(x, span[t]), x));
+            keep_high = _mm256_and_si256(keep_high, _mm256_cmpeq_epi8(_mm256_min_epu8(y, span[t]), y));
+        }
+        out[row / 64] = (uint64_t)(uint32_t)_mm256_movemask_epi8(keep_low) |
+                        (uint64_t)(uint32_t)_mm256_movemask_epi8(keep_high) << 32;
+    }
+    select_terms_scalar(terms, count, full, rows, out);
+}
+
+__attribute__((target("avx2,popcnt")))
+static uint32_t count_bits_popcnt(const uint64_t *bits, size_t words)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < words; i++)
+        total += (uint64_t)_mm_popcnt_u64(bits[i]);
+    return (uint32_t)total;
+}
+
+#endif
+
+static void select_terms(const SelectTerm *terms, int count, uint32_t rows, uint64_t *out)
+{
+#ifdef TASK_FILTER_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        select_terms_avx2(terms, count, rows, out);
+        return;
+    }
+#endif
+    select_terms_scalar(terms, count, 0, rows, out);
+}
+
+// --- Predicates --- //
+
+void task_select_range(const TaskStore *store, TaskColumn column, uint8_t low, uint8_t high, uint64_t *out)
+{
+    if (!store || !out)
+        return;
+
+    if (low > high || !column_bytes(store, column))
+    {
+        memset(out, 0, selection_words(store->count) * sizeof(uint64_t));
+        return;
+    }
+
+    SelectTerm term = make_term(column_bytes(store, column), 0xFF, low, high);
+    select_terms(&term, 1, store->count, out);
+}
+
+void task_select_masked(const TaskStore *store, TaskColumn column, uint8_t mask, uint8_t want, uint64_t *out)
+{
+    if (!store || !out)
+        return;
+
+    // A wanted bit outside the mask can never match
+    if ((want & ~mask) || !column_bytes(store, column))
+    {
+        memset(out, 0, selection_words(store->count) * sizeof(uint64_t));
+        return;
+    }
+
+    SelectTerm term = make_term(column_bytes(store, column), mask, want, want);
+    select_terms(&term, 1, store->count, out);
+}
+
+void task_select(const TaskStore *store, const TaskFilter *filter, uint64_t *out)
+{
+    if (!store || !filter || !out)
+        return;
+
+    if (filter->min_priority > filter->max_priority)
+    {
+        memset(out, 0, selection_words(store->count) * sizeof(uint64_t));
+        return;
+    }
+
+    // Terms that are switched off are left out rather than evaluated as always true
+    SelectTerm terms[SELECT_MAX_TERMS];
+    int count = 0;
+    if (filter->completion >= 0)
+    {
+        uint8_t want = filter->completion > 0 ? TASK_STORE_COMPLETE : 0;
+        terms[count++] = make_term(store->flags, TASK_STORE_COMPLETE, want, want);
+    }
+    if (filter->min_priority > 0 || filter->max_priority < UINT8_MAX)
+        terms[count++] = make_term(store->priority, 0xFF,
+                                   (uint8_t)(filter->min_priority > UINT8_MAX ? UINT8_MAX : filter->min_priority),
+                                   (uint8_t)(filter->max_priority > UINT8_MAX ? UINT8_MAX : filter->max_priority));
+    if (filter->month >= 0)
+        terms[count++] = make_term(store->month, 0xFF, (uint8_t)filter->month, (uint8_t)filter->month);
+    if (filter->date > 0)
+        terms[count++] = make_term(store->date, 0xFF, (uint8_t)filter->date, (uint8_t)filter->date);
+
+    if (count == 0)
+    {
+        // Every slot: set all full words and the low bits of the last one
+        size_t words = selection_words(store->count);
+        memset(out, 0xFF, words * sizeof(uint64_t));
+        if (store->count % 64)
+            out[words - 1] = ((uint64_t)1 << (store->count % 64)) - 1;
+        return;
+    }
+    select_terms(terms, count, store->count, out);
+}
+
+// --- Combining Selections --- //
+
+void selection_and(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words)
+{
+    for (size_t i = 0; i < words; i++)
+        out[i] = a[i] & b[i];
+}
+
+void selection_or(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words)
+{
+    for (size_t i = 0; i < words; i++)
+        out[i] = a[i] | b[i];
+}
+
+void selection_and_not(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t words)
+{
+    for (size_t i = 0; i < words; i++)
+        out[i] = a[i] & ~b[i];
+}
+
+uint32_t selection_count(const uint64_t *bits, size_t words)
+{
+    if (!bits)
+        return 0;
+
+#ifdef TASK_FILTER_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        return count_bits_popcnt(bits, words);
+#endif
+    uint32_t total = 0;
+    for (size_t i = 0; i < words; i++)
+        total += (uint32_t)__builtin_popcountll(bits[i]);
+    return total;
+}
+
+int selection_slots(const uint64_t *bits, size_t words, uint32_t *out, int max_results)
+{
+    if (!bits || !out)
+        return 0;
+
+    int count = 0;
+    for (size_t i = 0; i < words && count < max_results; i++)
+    {
+        for (uint64_t word = bits[i]; word && count < max_results; word &= word - 1)
+            out[count++] = (uint32_t)(i * 64 + __builtin_ctzll(word));
+    }
+    return count;
+}
+
+bool task_filter_simd()
+{
+#ifdef TASK_FILTER_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,88 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "../include/task_index.h"
+
+uint64_t task_order_pack(bool is_complete, unsigned int priority, MonthsInAYear month,
+                         char date, Time time, int id)
+{
+    if (priority > 15)
+        priority = 15;
+
+    return ((uint64_t)(is_complete ? 1 : 0) << TASK_ORDER_COMPLETE_SHIFT) |
+           ((uint64_t)priority << TASK_ORDER_PRIORITY_SHIFT) |
+           ((uint64_t)(month & 0xF) << TASK_ORDER_MONTH_SHIFT) |
+           ((uint64_t)((unsigned char)date & 0x1F) << TASK_ORDER_DATE_SHIFT) |
+           ((uint64_t)((unsigned char)time.hour & 0x1F) << TASK_ORDER_HOUR_SHIFT) |
+           ((uint64_t)((unsigned char)time.minutes & 0x3F) << TASK_ORDER_MINUTE_SHIFT) |
+           (uint64_t)(uint32_t)id;
+}
+
+bool task_order_schedule_valid(int month, int date, int hour, int minute)
+{
+    return month >= JANUARY && month <= DECEMBER && date >= 0 && date <= 31 && hour >= 0 && hour <= 23 &&
+           minute >= 0 && minute <= 59;
+}
+
+uint64_t task_order_key(const Task *task)
+{
+    return task_order_pack(task->is_complete, task->priority, task->month,
+                           task->date, task->time, task->id);
+}
+
+uint64_t task_order_priority_start(bool is_complete, unsigned int priority)
+{
+    Time midnight = {0, 0};
+    return task_order_pack(is_complete, priority, JANUARY, 0, midnight, 0);
+}
+
+bool task_order_insert(task_order_index *index, Task *task)
+{
+    if (!index || !task)
+        return false;
+
+    return task_order_index_insert(index, task_order_key(task), task);
+}
+
+bool task_order_remove(task_order_index *index, Task *task)
+{
+    if (!index || !task)
+        return false;
+
+    return task_order_index_remove(index, task_order_key(task), task);
+}
+
+int task_order_range(task_order_index *index, uint64_t low, uint64_t high, Task **out, int max_results)
+{
+    if (!index || !out)
+        return 0;
+
+    int count = 0;
+    task_order_index_node *node = task_order_index_lower_bound(index, low);
+
+    while (node && node->key < high && count < max_results)
+    {
+        // Keys carry the task id, so each node holds exactly one task
+        out[count++] = (Task *)first_value_in_list(&node->list);
+        node = task_order_index_next(node);
+    }
+
+    return count;
+}
+
+int task_order_window(task_order_index *index, int first_rank, Task **out, int max_results)
+{
+    if (!index || !out || first_rank < 0)
+        return 0;
+
+    int count = 0;
+    task_order_index_node *node = task_order_index_select(index, first_rank);
+
+    while (node && count < max_results)
+    {
+        out[count++] = (Task *)first_value_in_list(&node->list);
+        node = task_order_index_next(node);
+    }
+
+    return count;
+}
@@ -0,0 +1,335 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <poll.h>
+
+#include "../include/task_input.h"
+
+typedef enum InputAction {
+    INPUT_NONE,
+    INPUT_MOVE,                      // Rows in the list and tree, days in the calendar
+    INPUT_PAGE,
+    INPUT_JUMP,
+    INPUT_PRIORITY,                  // Negative raises, toward HIGHEST_PRIORITY
+    INPUT_COMPLETE,
+    INPUT_CALENDAR,
+    INPUT_TREE,
+    INPUT_RESIZE,
+    INPUT_QUIT
+} InputAction;
+
+// Consecutive keys of one action, applied as one
+typedef struct InputRun {
+    InputAction action;
+    int amount;
+    int keys;
+} InputRun;
+
+// --- Helpers --- //
+
+static int64_t input_now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// The wall clock as a minute stamp, and the milliseconds already gone in that minute
+static int64_t input_now_minute(int *elapsed_ms)
+{
+    struct timespec now;
+    struct tm local;
+    clock_gettime(CLOCK_REALTIME, &now);
+    localtime_r(&now.tv_sec, &local);
+    *elapsed_ms = local.tm_sec * 1000 + (int)(now.tv_nsec / 1000000);
+    Time time = {(char)local.tm_min, (char)local.tm_hour};
+    return recurrence_stamp(local.tm_year + 1900, (MonthsInAYear)local.tm_mon, local.tm_mday, time);
+}
+
+// Shortens timeout_ms so the poll wakes when the reminder wheel next has work
+static int reminder_timeout(const TaskInputLoop *loop, int64_t minute, int elapsed_ms, int timeout_ms)
+{
+    int64_t next = reminder_wheel_next(&loop->manager->reminders);
+    if (next == INT64_MAX)
+        return timeout_ms;
+
+    int64_t wait = next > minute ? (next - minute) * 60000 - elapsed_ms : 0;
+    wait = wait < 0 ? 0 : wait;
+    return timeout_ms >= 0 && timeout_ms < wait ? timeout_ms : (int)(wait < INT_MAX ? wait : INT_MAX);
+}
+
+// What key does in the view's current mode, and by how much
+static InputAction classify_key(const TaskView *view, int key, int *amount)
+{
+    bool calendar = view->mode == TASK_VIEW_CALENDAR;
+    *amount = 1;
+    switch (key)
+    {
+    case 'j':
+    case KEY_DOWN:
+        *amount = calendar ? 7 : 1;
+        return INPUT_MOVE;
+    case 'k':
+    case KEY_UP:
+        *amount = calendar ? -7 : -1;
+        return INPUT_MOVE;
+    case 'l':
+    case KEY_RIGHT:
+        return calendar ? INPUT_MOVE : INPUT_NONE;
+    case 'h':
+    case KEY_LEFT:
+        *amount = -1;
+        return calendar ? INPUT_MOVE : INPUT_NONE;
+    case ' ':
+    case KEY_NPAGE:
+        return INPUT_PAGE;
+    case 'b':
+    case KEY_PPAGE:
+        *amount = -1;
+        return INPUT_PAGE;
+    case 'g':
+    case KEY_HOME:
+        *amount = 0;
+        return INPUT_JUMP;
+    case 'G':
+    case KEY_END:
+        *amount = INT_MAX;
+        return INPUT_JUMP;
+    case '+':
+        *amount = -1;
+        return INPUT_PRIORITY;
+    case '-':
+        return INPUT_PRIORITY;
+    case 'x':
+        return INPUT_COMPLETE;
+    case 'v':
+        return INPUT_CALENDAR;
+    case 's':
+        return INPUT_TREE;
+    case KEY_RESIZE:
+        return INPUT_RESIZE;
+    case 'q':
+        return INPUT_QUIT;
+    default:
+        return INPUT_NONE;
+    }
+}
+
+// Whether a run of the action means the same as one key with the combined amount
+static bool input_merges(InputAction action)
+{
+    return action == INPUT_MOVE || action == INPUT_PAGE || action == INPUT_JUMP || action == INPUT_PRIORITY ||
+           action == INPUT_COMPLETE || action == INPUT_RESIZE;
+}
+
+static void apply_run(TaskInputLoop *loop, const InputRun *run)
+{
+    TaskView *view = loop->view;
+    Task *selected = task_view_selected(view);
+    switch (run->action)
+    {
+    case INPUT_MOVE:
+        task_view_move(view, run->amount);
+        break;
+    case INPUT_PAGE:
+        task_view_page(view, run->amount);
+        break;
+    case INPUT_JUMP:
+        task_view_jump(view, run->amount);
+        break;
+    case INPUT_PRIORITY:
+        if (selected)
+        {
+            long priority = (long)selected->priority + run->amount;
+            priority = priority < HIGHEST_PRIORITY ? HIGHEST_PRIORITY : priority;
+            priority = priority > LOWEST_PRIORITY ? LOWEST_PRIORITY : priority;
+            if (priority != (long)selected->priority)
+                update_task(loop->manager, selected->id, NULL, (unsigned int)priority);
+        }
+        break;
+    case INPUT_COMPLETE:
+        if (selected && run->keys % 2)
+            set_task_completion(loop->manager, selected->id, !selected->is_complete);
+        break;
+    case INPUT_CALENDAR:
+        if (view->mode == TASK_VIEW_CALENDAR)
+            task_view_set_mode(view, TASK_VIEW_LIST);
+        else if (loop->calendar)
+            task_view_show_month(view, loop->calendar, loop->month);
+        break;
+    case INPUT_TREE:
+        task_view_set_mode(view, view->mode == TASK_VIEW_TREE ? TASK_VIEW_LIST : TASK_VIEW_TREE);
+        break;
+    case INPUT_RESIZE:
+        task_view_resize(view);
+        break;
+    case INPUT_QUIT:
+        loop->quit = true;
+        break;
+    default:
+        return;
+    }
+
+    loop->stats.updates++;
+    loop->stats.coalesced += run->keys - 1;
+}
+
+// Applies the frame's keys in order, one operation per run
+static void apply_keys(TaskInputLoop *loop, int count)
+{
+    InputRun run = {INPUT_NONE, 0, 0};
+    for (int i = 0; i < count && !loop->quit; i++)
+    {
+        int amount;
+        InputAction action = classify_key(loop->view, loop->keys[i], &amount);
+        if (action == INPUT_NONE)
+            continue;
+
+        if (loop->coalesce && run.keys > 0 && action == run.action && input_merges(action))
+        {
+            run.amount = action == INPUT_JUMP ? amount : run.amount + amount;   // A batch of 7s cannot overflow
+            run.keys++;
+            continue;
+        }
+
+        // Keys after this one are classified in the mode it leaves behind
+        if (run.keys > 0)
+            apply_run(loop, &run);
+        run.action = action;
+        run.amount = amount;
+        run.keys = 1;
+        if (!input_merges(action))
+        {
+            apply_run(loop, &run);
+            run.keys = 0;
+        }
+    }
+    if (run.keys > 0 && !loop->quit)
+        apply_run(loop, &run);
+}
+
+// Every key already waiting, up to the batch size and half the frame budget
+static int read_keys(TaskInputLoop *loop)
+{
+    int64_t start = input_now_us();
+    int count = 0;
+    while (count < loop->max_batch)
+    {
+        int key = wgetch(loop->view->window);
+        if (key == ERR)
+            return count;
+
+        loop->keys[count] = key;
+        loop->read_us[count] = input_now_us();
+        if (++count % 16 == 0 && loop->read_us[count - 1] - start > TASK_INPUT_FRAME_BUDGET_US / 2)
+            break;
+    }
+    loop->stats.over_budget++;
+    return count;
+}
+
+static void record_latency(TaskInputStats *stats, int64_t latency_us)
+{
+    uint64_t latency = latency_us > 0 ? (uint64_t)latency_us : 0;
+    int bucket = 0;
+    while (bucket < TASK_INPUT_LATENCY_BUCKETS - 1 && latency >= ((uint64_t)1 << bucket))
+        bucket++;
+
+    stats->latency[bucket]++;
+    stats->latency_total_us += latency;
+    if (latency > stats->latency_max_us)
+        stats->latency_max_us = latency;
+}
+
+// --- Loop Lifecycle --- //
+
+void task_input_init(TaskInputLoop *loop, TaskView *view, int input_fd, Calendar *calendar, WorkerPool *pool)
+{
+    if (!loop || !view)
+        return;
+
+    *loop = (TaskInputLoop){0};
+    loop->view = view;
+    loop->manager = view->manager;
+    loop->calendar = calendar;
+    loop->month = view->month;
+    loop->pool = pool;
+    loop->input_fd = input_fd;
+    loop->max_batch = TASK_INPUT_MAX_BATCH;
+    loop->coalesce = true;
+    keypad(view->window, TRUE);
+    nodelay(view->window, TRUE);
+}
+
+// --- Frames --- //
+
+int task_input_frame(TaskInputLoop *loop, int timeout_ms)
+{
+    if (!loop || loop->quit)
+        return -1;
+
+    // Due reminders promote their tasks before this frame draws
+    int elapsed_ms;
+    int64_t minute = input_now_minute(&elapsed_ms);
+    int fired = advance_reminders(loop->manager, minute);
+    loop->stats.reminders += fired;
+
+    int count = read_keys(loop);
+    bool changed = count > 0 || fired > 0;
+    if (!changed)
+    {
+        // Idle: get ahead on the next page and apply finished background work
+        task_view_prefetch(loop->view);
+        changed = loop->pool && worker_pool_drain(loop->pool, TASK_INPUT_MAX_RESULTS) > 0;
+    }
+    if (!changed)
+    {
+        struct pollfd ready[2] = {{loop->input_fd, POLLIN, 0},
+                                  {loop->pool ? worker_pool_fd(loop->pool) : -1, POLLIN, 0}};
+        if (poll(ready, 2, reminder_timeout(loop, minute, elapsed_ms, timeout_ms)) <= 0)
+            return 0;
+        if (ready[1].revents & POLLIN)
+            changed = worker_pool_drain(loop->pool, TASK_INPUT_MAX_RESULTS) > 0;
+        count = read_keys(loop);
+        changed = changed || count > 0;
+        if (!changed)
+            return 0;
+    }
+
+    apply_keys(loop, count);
+    task_view_render(loop->view);
+    doupdate();
+
+    loop->last_flush_us = input_now_us();
+    loop->stats.frames++;
+    loop->stats.keys += count;
+    for (int i = 0; i < count; i++)
+        record_latency(&loop->stats, loop->last_flush_us - loop->read_us[i]);
+    return loop->quit ? -1 : count;
+}
+
+void task_input_run(TaskInputLoop *loop)
+{
+    while (task_input_frame(loop, -1) >= 0)
+        ;
+}
+
+// --- Latency --- //
+
+uint64_t task_input_latency_percentile(const TaskInputStats *stats, double fraction)
+{
+    uint64_t total = 0, seen = 0;
+    for (int bucket = 0; bucket < TASK_INPUT_LATENCY_BUCKETS; bucket++)
+        total += stats->latency[bucket];
+
+    uint64_t wanted = (uint64_t)(fraction * total + 0.5);
+    for (int bucket = 0; bucket < TASK_INPUT_LATENCY_BUCKETS; bucket++)
+    {
+        seen += stats->latency[bucket];
+        if (seen >= wanted && seen > 0)
+            return (uint64_t)1 << bucket;
+    }
+    return 0;
+}
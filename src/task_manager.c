@@ -0,0 +1,1046 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "../include/task_manager.h"
+
+// --- Helpers --- //
+
+static int compare_priority(void *a, void *b)
+{
+    unsigned int x = *(unsigned int *)a, y = *(unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+static bool valid_priority(unsigned int priority)
+{
+    return priority >= HIGHEST_PRIORITY && priority <= LOWEST_PRIORITY;
+}
+
+static Data *wrap_data(void *key, void *value)
+{
+    Data *data = (Data *)malloc(sizeof(Data));
+    if (!data)
+        return NULL;
+
+    data->key = key;
+    data->value = value;
+    return data;
+}
+
+bool task_manager_owns_string(TaskManager *manager, const char *text)
+{
+    const char *base = (const char *)manager->snapshot;
+    return !base || text < base || text >= base + manager->snapshot_size;
+}
+
+// Strings loaded from a snapshot point into the mapping and are never freed one by one;
+// anything else is interned, unless it was attached as-is when interning failed
+static void release_string(TaskManager *manager, char *text)
+{
+    if (text && task_manager_owns_string(manager, text) && !release_interned(manager->strings, text))
+        free(text);
+}
+
+// Swaps a string the caller allocated for the interned copy
+static void adopt_string(TaskManager *manager, char **text)
+{
+    if (!*text || !task_manager_owns_string(manager, *text))
+        return;
+
+    char *interned = intern_string(manager->strings, *text);
+    if (interned)
+    {
+        free(*text);
+        *text = interned;
+    }
+}
+
+static void adopt_task_strings(TaskManager *manager, Task *task)
+{
+    adopt_string(manager, &task->description);
+    if (task->note)
+        adopt_string(manager, &task->note->description);
+    for (Node *node = task->subtasks ? task->subtasks->head : NULL; node; node = node->next)
+        adopt_string(manager, &((SubTask *)node->data->value)->description);
+}
+
+static void free_subtasks(TaskManager *manager, DoublyLinkedList *subtasks)
+{
+    if (!subtasks)
+        return;
+
+    for (Node *node = subtasks->head; node; node = node->next)
+    {
+        SubTask *subtask = (SubTask *)node->data->value;
+        release_string(manager, subtask->description);
+        free(subtask);
+    }
+    free_list(subtasks);
+}
+
+static void free_task(TaskManager *manager, Task *task)
+{
+    if (!task)
+        return;
+
+    release_string(manager, task->description);
+    if (task->note)
+    {
+        release_string(manager, task->note->description);
+        free(task->note);
+    }
+    free_subtasks(manager, task->subtasks);
+    free(task);
+}
+
+static void free_appointment(Appointment *appointment)
+{
+    if (!appointment)
+        return;
+
+    free(appointment->notes);
+    free(appointment);
+}
+
+// Last task that sorts at or before `priority` in the task list. Within a priority
+// the AVL value list is kept in list order, so its tail is the group's tail.
+static Task *last_task_up_to(TaskManager *manager, unsigned int priority)
+{
+    for (unsigned int p = priority; p >= HIGHEST_PRIORITY; p--)
+    {
+        AVLNode *group = find_avl(manager->task_tree, manager->task_tree->root, &p);
+        if (group)
+            return (Task *)last_value_in_list(group->list);
+    }
+    return NULL;
+}
+
+// Links a task at the end of its priority group in both the list and the priority
+// tree, O(log n). The task must not currently be in either.
+static void place_task(TaskManager *manager, Task *task)
+{
+    Task *previous = last_task_up_to(manager, task->priority);
+    relink_after(manager->task_list, previous ? previous->list_node : NULL, task->list_node);
+    add_to_avl(manager->task_tree, &task->priority, task);
+}
+
+// --- TaskManager Lifecycle --- //
+
+TaskManager *create_task_manager()
+{
+    TaskManager *manager = (TaskManager *)malloc(sizeof(TaskManager));
+    if (!manager)
+    {
+        printf("Memory allocation failed for TaskManager.\n");
+        return NULL;
+    }
+
+    manager->task_tree = create_avl_inline(compare_priority, sizeof(unsigned int), LOWEST_PRIORITY);
+    manager->task_map = create_tree_map(TASK_MAP_BUCKETS, 0);
+    manager->appointment_map = create_tree_map(TASK_MAP_BUCKETS, 0);
+    manager->task_list = create_list(UNBOUNDED_LIST_CAPACITY);
+    manager->appointment_list = create_list(UNBOUNDED_LIST_CAPACITY);
+    manager->strings = create_string_arena();
+    task_order_index_init(&manager->agenda_index);
+    task_store_init(&manager->store);
+    manager->snapshot = NULL;
+    manager->snapshot_size = 0;
+    manager->log_sequence = 0;
+    reminder_wheel_init(&manager->reminders, 0);
+    manager->on_reminder = NULL;
+    manager->reminder_context = NULL;
+    manager->on_bulk_load = NULL;
+    manager->bulk_load_context = NULL;
+
+    if (!manager->task_tree || !manager->task_map || !manager->appointment_map ||
+        !manager->task_list || !manager->appointment_list || !manager->strings)
+    {
+        printf("Failed to create TaskManager indexes.\n");
+        free_task_manager(manager);
+        return NULL;
+    }
+
+    return manager;
+}
+
+void free_task_manager(TaskManager *manager)
+{
+    if (!manager)
+        return;
+
+    if (manager->task_list)
+    {
+        for (Node *node = manager->task_list->head; node; node = node->next)
+            free_task(manager, (Task *)node->data->value);
+        free_list(manager->task_list);
+    }
+
+    if (manager->appointment_list)
+    {
+        for (Node *node = manager->appointment_list->head; node; node = node->next)
+            free_appointment((Appointment *)node->data->value);
+        free_list(manager->appointment_list);
+    }
+
+    task_order_index_free(&manager->agenda_index);
+    task_store_free(&manager->store);
+    reminder_wheel_free(&manager->reminders);
+    if (manager->task_tree)
+    {
+        free_avl(manager->task_tree->root, NULL);
+        free(manager->task_tree);
+    }
+    free_tree_map(manager->task_map);
+    free_tree_map(manager->appointment_map);
+    free_string_arena(manager->strings);
+    if (manager->snapshot)
+        munmap(manager->snapshot, manager->snapshot_size);
+    free(manager);
+}
+
+// --- Task Management --- //
+
+// attach_task without adopting strings, for tasks whose text is already interned
+static bool link_task(TaskManager *manager, Task *task)
+{
+    if (!manager || !task || !valid_priority(task->priority))
+        return false;
+
+    Data *data = wrap_data(&task->id, task);
+    task->list_node = data ? create_node(data) : NULL;
+
+    if (!task->list_node || !task_store_add(&manager->store, task) ||
+        !tree_map_insert(manager->task_map, task->id, task))
+    {
+        printf("Task %d could not be added.\n", task->id);
+        task_store_remove(&manager->store, task);
+        if (task->list_node)
+            free(task->list_node);
+        free(data);
+        task->list_node = NULL;
+        return false;
+    }
+
+    place_task(manager, task);
+    task_order_insert(&manager->agenda_index, task);
+    return true;
+}
+
+bool attach_task(TaskManager *manager, Task *task)
+{
+    if (!link_task(manager, task))
+        return false;
+
+    adopt_task_strings(manager, task);
+    return true;
+}
+
+typedef struct KeyedTask
+{
+    uint64_t key;
+    Task *task;
+} KeyedTask;
+
+static int compare_keyed_tasks(const void *a, const void *b)
+{
+    uint64_t x = ((const KeyedTask *)a)->key, y = ((const KeyedTask *)b)->key;
+    return (x > y) - (x < y);
+}
+
+int attach_tasks(TaskManager *manager, Task **tasks, int count)
+{
+    if (!manager || !tasks || count <= 0)
+        return 0;
+
+    KeyedTask *keyed = (KeyedTask *)malloc(sizeof(KeyedTask) * count);
+    uint64_t *keys = (uint64_t *)malloc(sizeof(uint64_t) * count);
+    void **values = (void **)malloc(sizeof(void *) * count);
+    HybridEntry *ids = (HybridEntry *)malloc(sizeof(HybridEntry) * count);
+    if (!keyed || !keys || !values || !ids)
+    {
+        free(keyed);
+        free(keys);
+        free(values);
+        free(ids);
+        return 0;
+    }
+
+    // Into an empty manager the id map is built in one parallel pass; a task whose
+    // id was taken by an earlier one is then refused just as tree_map_insert would
+    // have refused it. Otherwise each id is inserted, which is O(1) in the map.
+    int id_count = 0;
+    for (int i = 0; manager->agenda_index.size == 0 && i < count; i++)
+    {
+        if (tasks[i] && valid_priority(tasks[i]->priority))
+        {
+            ids[id_count].key = tasks[i]->id;
+            ids[id_count].value = tasks[i];
+            id_count++;
+        }
+    }
+    bool prebuilt = id_count > 0 && tree_map_build(manager->task_map, ids, id_count, 0) >= 0;
+    free(ids);
+
+    int attached = 0;
+    for (int i = 0; i < count; i++)
+    {
+        Task *task = tasks[i];
+        if (!task)
+            continue;
+
+        Data *data = valid_priority(task->priority) ? wrap_data(&task->id, task) : NULL;
+        task->list_node = data ? create_node(data) : NULL;
+        HybridNode *owner = prebuilt && data ? tree_map_search(manager->task_map, task->id) : NULL;
+        bool owns_id = owner && owner->value == task;
+
+        if (!task->list_node || !task_store_add(&manager->store, task) ||
+            !(prebuilt ? owns_id : tree_map_insert(manager->task_map, task->id, task)))
+        {
+            printf("Task %d could not be added.\n", task->id);
+            if (owns_id)
+                tree_map_delete(manager->task_map, task->id);
+            task_store_remove(&manager->store, task);
+            free(task->list_node);
+            free(data);
+            task->list_node = NULL;
+            tasks[i] = NULL;
+            continue;
+        }
+
+        adopt_task_strings(manager, task);
+        place_task(manager, task);
+        keyed[attached].key = task_order_key(task);
+        keyed[attached].task = task;
+        attached++;
+    }
+
+    qsort(keyed, attached, sizeof(KeyedTask), compare_keyed_tasks);
+    for (int i = 0; i < attached; i++)
+    {
+        keys[i] = keyed[i].key;
+        values[i] = keyed[i].task;
+    }
+    // One sorted merge, however many tasks the index already holds; after a failure
+    // the keys it did not place are inserted one at a time
+    if (!task_order_index_merge_sorted(&manager->agenda_index, keys, values, attached))
+    {
+        for (int i = 0; i < attached; i++)
+        {
+            if (!task_order_index_find(&manager->agenda_index, keys[i]))
+                task_order_insert(&manager->agenda_index, keyed[i].task);
+        }
+    }
+
+    free(keyed);
+    free(keys);
+    free(values);
+    return attached;
+}
+
+void set_bulk_load_handler(TaskManager *manager, TaskBulkLoadHandler handler, void *context)
+{
+    if (!manager)
+        return;
+    manager->on_bulk_load = handler;
+    manager->bulk_load_context = context;
+}
+
+bool bulk_load_finished(TaskManager *manager)
+{
+    if (!manager)
+        return false;
+    return !manager->on_bulk_load || manager->on_bulk_load(manager, manager->bulk_load_context);
+}
+
+Task *add_task(TaskManager *manager, int id, const char *description, unsigned int priority)
+{
+    if (!manager || !description)
+        return NULL;
+
+    if (!valid_priority(priority))
+    {
+        printf("Priority %u is out of range (%d-%d).\n", priority, HIGHEST_PRIORITY, LOWEST_PRIORITY);
+        return NULL;
+    }
+
+    Task *task = (Task *)calloc(1, sizeof(Task));
+    if (!task)
+    {
+        printf("Memory allocation failed for Task.\n");
+        return NULL;
+    }
+
+    task->id = id;
+    task->priority = priority;
+    task->recurrence_type = NONE;
+    task->month = JANUARY;
+    task->description = intern_string(manager->strings, description);
+
+    if (!task->description || !link_task(manager, task))
+    {
+        free_task(manager, task);
+        return NULL;
+    }
+
+    return task;
+}
+
+bool delete_task(TaskManager *manager, int task_id)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return false;
+
+    remove_from_avl(manager->task_tree, &task->priority, task);
+    task_order_remove(&manager->agenda_index, task);
+    task_store_remove(&manager->store, task);
+    reminder_wheel_cancel(&manager->reminders, task->reminder_timer);
+    delete_node(manager->task_list, task->list_node);
+    tree_map_delete(manager->task_map, task_id);
+
+    if (task->appointment)
+        task->appointment->linked_task = NULL;
+
+    free_task(manager, task);
+    return true;
+}
+
+Task *update_task(TaskManager *manager, int task_id, const char *new_description, unsigned int new_priority)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (new_priority != task->priority && !valid_priority(new_priority))
+    {
+        printf("Priority %u is out of range (%d-%d).\n", new_priority, HIGHEST_PRIORITY, LOWEST_PRIORITY);
+        return NULL;
+    }
+
+    if (new_description)
+    {
+        char *description = intern_string(manager->strings, new_description);
+        if (!description)
+            return NULL;
+        release_string(manager, task->description);
+        task->description = description;
+    }
+
+    if (new_priority != task->priority)
+    {
+        // A move: the task keeps its map entry and list node, only the links change
+        task_order_remove(&manager->agenda_index, task);
+        remove_from_avl(manager->task_tree, &task->priority, task);
+        unlink_node(manager->task_list, task->list_node);
+
+        task->priority = new_priority;
+        place_task(manager, task);
+        task_order_insert(&manager->agenda_index, task);
+        task_store_refresh(&manager->store, task);
+    }
+
+    return task;
+}
+
+Task *set_task_schedule(TaskManager *manager, int task_id, MonthsInAYear month, char date, Time time)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task || !task_order_schedule_valid(month, date, time.hour, time.minutes))
+        return NULL;
+
+    task_order_remove(&manager->agenda_index, task);
+    task->month = month;
+    task->date = date;
+    task->time = time;
+    task_order_insert(&manager->agenda_index, task);
+    task_store_refresh(&manager->store, task);
+
+    return task;
+}
+
+Task *set_task_completion(TaskManager *manager, int task_id, bool is_complete)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (task->is_complete != is_complete)
+    {
+        task_order_remove(&manager->agenda_index, task);
+        task->is_complete = is_complete;
+        task_order_insert(&manager->agenda_index, task);
+        task_store_refresh(&manager->store, task);
+    }
+
+    return task;
+}
+
+Task *set_task_reminder(TaskManager *manager, int task_id, bool have_reminder, RecurrenceType recurrence)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (!have_reminder && task->reminder_timer)
+    {
+        reminder_wheel_cancel(&manager->reminders, task->reminder_timer);
+        task->reminder_timer = NULL;
+    }
+    task->have_reminder = have_reminder;
+    task->recurrence_type = recurrence;
+    task_store_refresh(&manager->store, task);
+    return task;
+}
+
+// --- Reminders --- //
+
+Task *arm_task_reminder(TaskManager *manager, int task_id, int64_t fire_at)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (task->reminder_timer)
+        reminder_wheel_reschedule(&manager->reminders, task->reminder_timer, fire_at);
+    else if (!(task->reminder_timer = reminder_wheel_arm(&manager->reminders, task_id, fire_at)))
+        return NULL;
+
+    if (!task->have_reminder)
+    {
+        task->have_reminder = true;
+        task_store_refresh(&manager->store, task);
+    }
+    return task;
+}
+
+Task *cancel_task_reminder(TaskManager *manager, int task_id)
+{
+    Task *task = find_task(manager, task_id);
+    return task ? set_task_reminder(manager, task_id, false, task->recurrence_type) : NULL;
+}
+
+void set_reminder_handler(TaskManager *manager, TaskReminderHandler handler, void *context)
+{
+    if (!manager)
+        return;
+    manager->on_reminder = handler;
+    manager->reminder_context = context;
+}
+
+Task *spend_task_reminder(TaskManager *manager, int task_id)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (task->reminder_timer)
+    {
+        reminder_wheel_cancel(&manager->reminders, task->reminder_timer);
+        task->reminder_timer = NULL;
+    }
+    task->have_reminder = false;
+    if (task->priority != HIGHEST_PRIORITY)
+        update_task(manager, task_id, NULL, HIGHEST_PRIORITY);
+    else
+        task_store_refresh(&manager->store, task);
+    return task;
+}
+
+// The wheel has already released the timer
+static void fire_task_reminder(int task_id, int64_t fire_at, void *context)
+{
+    TaskManager *manager = (TaskManager *)context;
+    Task *task = find_task(manager, task_id);
+    (void)fire_at;
+    if (!task)
+        return;
+
+    task->reminder_timer = NULL;
+    spend_task_reminder(manager, task_id);
+    if (manager->on_reminder)
+        manager->on_reminder(manager, task, manager->reminder_context);
+}
+
+int advance_reminders(TaskManager *manager, int64_t now)
+{
+    if (!manager)
+        return 0;
+    return (int)reminder_wheel_advance(&manager->reminders, now, fire_task_reminder, manager);
+}
+
+Task *set_task_note(TaskManager *manager, int task_id, const char *text)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task)
+        return NULL;
+
+    if (!text)
+    {
+        if (task->note)
+            release_string(manager, task->note->description);
+        free(task->note);
+        task->note = NULL;
+        return task;
+    }
+
+    char *description = intern_string(manager->strings, text);
+    if (!description)
+        return NULL;
+
+    if (!task->note && !(task->note = (Notes *)calloc(1, sizeof(Notes))))
+    {
+        release_string(manager, description);
+        return NULL;
+    }
+
+    release_string(manager, task->note->description);
+    task->note->description = description;
+    return task;
+}
+
+// --- SubTask Management --- //
+
+static Node *subtask_at(Task *task, int subtask_position)
+{
+    if (!task || !task->subtasks || subtask_position < 0 ||
+        (unsigned int)subtask_position >= task->subtasks->size)
+        return NULL;
+
+    Node *node = task->subtasks->head;
+    for (int i = 0; i < subtask_position; i++)
+        node = node->next;
+    return node;
+}
+
+SubTask *add_subtask(TaskManager *manager, int task_id, const char *description, unsigned int priority)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task || !description)
+        return NULL;
+
+    if (!task->subtasks && !(task->subtasks = create_list(UNBOUNDED_LIST_CAPACITY)))
+        return NULL;
+
+    SubTask *subtask = (SubTask *)malloc(sizeof(SubTask));
+    if (!subtask)
+        return NULL;
+
+    subtask->task_id = task_id;
+    subtask->priority = priority;
+    subtask->description = intern_string(manager->strings, description);
+
+    Data *data = wrap_data(&subtask->task_id, subtask);
+    if (!subtask->description || !data || !insert_back(task->subtasks, data))
+    {
+        free(data);
+        release_string(manager, subtask->description);
+        free(subtask);
+        return NULL;
+    }
+
+    task->have_subtask = true;
+    return subtask;
+}
+
+bool delete_subtask(TaskManager *manager, int task_id, int subtask_position)
+{
+    Task *task = find_task(manager, task_id);
+    Node *node = subtask_at(task, subtask_position);
+    if (!node)
+        return false;
+
+    SubTask *subtask = (SubTask *)node->data->value;
+    delete_node(task->subtasks, node);
+    release_string(manager, subtask->description);
+    free(subtask);
+
+    task->have_subtask = task->subtasks->size > 0;
+    return true;
+}
+
+SubTask *update_subtask(TaskManager *manager, int task_id, int subtask_position, const char *new_description, unsigned int new_priority)
+{
+    Node *node = subtask_at(find_task(manager, task_id), subtask_position);
+    if (!node)
+        return NULL;
+
+    SubTask *subtask = (SubTask *)node->data->value;
+    if (new_description)
+    {
+        char *description = intern_string(manager->strings, new_description);
+        if (!description)
+            return NULL;
+        release_string(manager, subtask->description);
+        subtask->description = description;
+    }
+    subtask->priority = new_priority;
+    return subtask;
+}
+
+// --- Appointment Management --- //
+
+bool attach_appointment(TaskManager *manager, Appointment *appointment)
+{
+    if (!manager || !appointment)
+        return false;
+
+    Data *data = wrap_data(&appointment->id, appointment);
+    if (!data || !tree_map_insert(manager->appointment_map, appointment->id, appointment))
+    {
+        printf("Appointment %d could not be added.\n", appointment->id);
+        free(data);
+        return false;
+    }
+
+    appointment->list_node = insert_back(manager->appointment_list, data);
+    if (!appointment->list_node)
+    {
+        // Saves and exports walk the list, so an appointment missing from it must not stay in the map
+        printf("Appointment %d could not be added.\n", appointment->id);
+        tree_map_delete(manager->appointment_map, appointment->id);
+        free(data);
+        return false;
+    }
+    return true;
+}
+
+Appointment *add_appointment(TaskManager *manager, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence)
+{
+    if (!manager)
+        return NULL;
+
+    Appointment *appointment = (Appointment *)calloc(1, sizeof(Appointment));
+    if (!appointment)
+    {
+        printf("Memory allocation failed for Appointment.\n");
+        return NULL;
+    }
+
+    appointment->id = id;
+    appointment->date = date;
+    appointment->time = time;
+    appointment->month = month;
+    appointment->have_reminder = have_reminder;
+    appointment->recurrence_type = recurrence;
+
+    if (!attach_appointment(manager, appointment))
+    {
+        free(appointment);
+        return NULL;
+    }
+
+    return appointment;
+}
+
+bool delete_appointment(TaskManager *manager, int appointment_id)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!appointment)
+        return false;
+
+    tree_map_delete(manager->appointment_map, appointment_id);
+    delete_node(manager->appointment_list, appointment->list_node);
+
+    if (appointment->linked_task)
+        appointment->linked_task->appointment = NULL;
+
+    free_appointment(appointment);
+    return true;
+}
+
+Appointment *update_appointment(TaskManager *manager, int appointment_id, char new_date, Time new_time, MonthsInAYear new_month, bool new_reminder, RecurrenceType new_recurrence)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!appointment)
+        return NULL;
+
+    appointment->date = new_date;
+    appointment->time = new_time;
+    appointment->month = new_month;
+    appointment->have_reminder = new_reminder;
+    appointment->recurrence_type = new_recurrence;
+    return appointment;
+}
+
+Appointment *add_appointment_note(TaskManager *manager, int appointment_id, const char *text)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!appointment || !text || !note_blob_append(&appointment->notes, text))
+        return NULL;
+    return appointment;
+}
+
+// --- Linking Tasks to Appointments --- //
+
+void link_task_to_appointment(TaskManager *manager, int task_id, int appointment_id)
+{
+    Task *task = find_task(manager, task_id);
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!task || !appointment)
+        return;
+
+    if (task->appointment)
+        task->appointment->linked_task = NULL;
+    if (appointment->linked_task)
+        appointment->linked_task->appointment = NULL;
+
+    task->appointment = appointment;
+    appointment->linked_task = task;
+}
+
+// --- Calendar Management --- //
+
+// The calendar's day index, made on first use
+static CalendarIndex *calendar_days(Calendar *calendar)
+{
+    if (!calendar->days && (calendar->days = (CalendarIndex *)malloc(sizeof(CalendarIndex))))
+        calendar_index_init(calendar->days);
+    return calendar->days;
+}
+
+bool add_task_to_calendar(TaskManager *manager, Calendar *calendar, int task_id)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task || !calendar)
+        return false;
+
+    if (!calendar->tasks && !(calendar->tasks = create_list(UNBOUNDED_LIST_CAPACITY)))
+        return false;
+
+    // Unscheduled tasks are listed but have no day to be filed under
+    int year = CALENDAR_BASE_YEAR + calendar->year;
+    bool scheduled = task->date > 0;
+    if (scheduled && (!calendar_days(calendar) || !calendar_index_add_task(calendar->days, year, task)))
+        return false;
+
+    Data *data = wrap_data(&task->id, task);
+    if (!data || !insert_back(calendar->tasks, data))
+    {
+        free(data);
+        if (scheduled)
+            calendar_index_remove_task(calendar->days, year, task);
+        return false;
+    }
+    return true;
+}
+
+bool add_appointment_to_calendar(TaskManager *manager, Calendar *calendar, int appointment_id)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!appointment || !calendar)
+        return false;
+
+    if (!calendar->appointments && !(calendar->appointments = create_list(UNBOUNDED_LIST_CAPACITY)))
+        return false;
+
+    int year = CALENDAR_BASE_YEAR + calendar->year;
+    bool scheduled = appointment->date > 0;
+    if (scheduled &&
+        (!calendar_days(calendar) || !calendar_index_add_appointment(calendar->days, year, appointment)))
+        return false;
+
+    Data *data = wrap_data(&appointment->id, appointment);
+    if (!data || !insert_back(calendar->appointments, data))
+    {
+        free(data);
+        if (scheduled)
+            calendar_index_remove_appointment(calendar->days, year, appointment);
+        return false;
+    }
+    return true;
+}
+
+// The calendar list's node for an item, or NULL if it is not listed
+static Node *calendar_node(DoublyLinkedList *list, const void *item)
+{
+    for (Node *node = list ? list->head : NULL; node; node = node->next)
+        if (node->data->value == item)
+            return node;
+    return NULL;
+}
+
+bool remove_task_from_calendar(TaskManager *manager, Calendar *calendar, int task_id)
+{
+    Task *task = find_task(manager, task_id);
+    Node *node = task && calendar ? calendar_node(calendar->tasks, task) : NULL;
+    if (!node)
+        return false;
+
+    if (task->date > 0 && calendar->days)
+        calendar_index_remove_task(calendar->days, CALENDAR_BASE_YEAR + calendar->year, task);
+    delete_node(calendar->tasks, node);
+    return true;
+}
+
+bool remove_appointment_from_calendar(TaskManager *manager, Calendar *calendar, int appointment_id)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    Node *node = appointment && calendar ? calendar_node(calendar->appointments, appointment) : NULL;
+    if (!node)
+        return false;
+
+    if (appointment->date > 0 && calendar->days)
+        calendar_index_remove_appointment(calendar->days, CALENDAR_BASE_YEAR + calendar->year, appointment);
+    delete_node(calendar->appointments, node);
+    return true;
+}
+
+// Takes the task out of its old day before the schedule changes and files it under the new one
+Task *reschedule_task_in_calendar(TaskManager *manager, Calendar *calendar, int task_id, MonthsInAYear month,
+                                  char date, Time time)
+{
+    Task *task = find_task(manager, task_id);
+    if (!task || !calendar || !task_order_schedule_valid(month, date, time.hour, time.minutes))
+        return NULL;
+
+    // An unscheduled task is only in the list
+    int year = CALENDAR_BASE_YEAR + calendar->year;
+    bool filed = task->date > 0;
+    if (filed ? !calendar->days || !calendar_index_remove_task(calendar->days, year, task)
+              : !calendar_node(calendar->tasks, task))
+        return NULL;
+
+    MonthsInAYear old_month = task->month;
+    char old_date = task->date;
+    Time old_time = task->time;
+    if (set_task_schedule(manager, task_id, month, date, time) &&
+        (task->date <= 0 || (calendar_days(calendar) && calendar_index_add_task(calendar->days, year, task))))
+        return task;
+
+    set_task_schedule(manager, task_id, old_month, old_date, old_time);
+    if (filed && !calendar_index_add_task(calendar->days, year, task))
+        delete_node(calendar->tasks, calendar_node(calendar->tasks, task));
+    return NULL;
+}
+
+// The same for an appointment, whose schedule update_appointment does not check
+Appointment *reschedule_appointment_in_calendar(TaskManager *manager, Calendar *calendar, int appointment_id,
+                                                MonthsInAYear month, char date, Time time)
+{
+    Appointment *appointment = find_appointment(manager, appointment_id);
+    if (!appointment || !calendar || !task_order_schedule_valid(month, date, time.hour, time.minutes))
+        return NULL;
+
+    int year = CALENDAR_BASE_YEAR + calendar->year;
+    bool filed = appointment->date > 0;
+    if (filed ? !calendar->days || !calendar_index_remove_appointment(calendar->days, year, appointment)
+              : !calendar_node(calendar->appointments, appointment))
+        return NULL;
+
+    MonthsInAYear old_month = appointment->month;
+    char old_date = appointment->date;
+    Time old_time = appointment->time;
+    update_appointment(manager, appointment_id, date, time, month, appointment->have_reminder,
+                       appointment->recurrence_type);
+    if (appointment->date <= 0 ||
+        (calendar_days(calendar) && calendar_index_add_appointment(calendar->days, year, appointment)))
+        return appointment;
+
+    update_appointment(manager, appointment_id, old_date, old_time, old_month, appointment->have_reminder,
+                       appointment->recurrence_type);
+    if (filed && !calendar_index_add_appointment(calendar->days, year, appointment))
+        delete_node(calendar->appointments, calendar_node(calendar->appointments, appointment));
+    return NULL;
+}
+
+// Frees the calendar's lists and index; the tasks and appointments stay with the manager
+void free_calendar(Calendar *calendar)
+{
+    if (!calendar)
+        return;
+
+    free_list(calendar->tasks);
+    free_list(calendar->appointments);
+    calendar_index_free(calendar->days);
+    free(calendar->days);
+    calendar->tasks = NULL;
+    calendar->appointments = NULL;
+    calendar->days = NULL;
+}
+
+// --- Data Access and Retrieval --- //
+
+Task *find_task(TaskManager *manager, int task_id)
+{
+    if (!manager)
+        return NULL;
+
+    HybridNode *node = tree_map_search(manager->task_map, task_id);
+    return node ? (Task *)node->value : NULL;
+}
+
+Appointment *find_appointment(TaskManager *manager, int appointment_id)
+{
+    if (!manager)
+        return NULL;
+
+    HybridNode *node = tree_map_search(manager->appointment_map, appointment_id);
+    return node ? (Appointment *)node->value : NULL;
+}
+
+int get_agenda(TaskManager *manager, unsigned int min_priority, unsigned int max_priority,
+               Task **out, int max_results)
+{
+    if (!manager || min_priority > max_priority)
+        return 0;
+
+    uint64_t low = task_order_priority_start(false, min_priority);
+    uint64_t high = max_priority >= LOWEST_PRIORITY ? TASK_ORDER_INCOMPLETE_END
+                                                    : task_order_priority_start(false, max_priority + 1);
+
+    return task_order_range(&manager->agenda_index, low, high, out, max_results);
+}
+
+int find_tasks_by_status(TaskManager *manager, int completion, int recurrence, int reminder,
+                         Task **out, int max_results)
+{
+    if (!manager || !out || max_results <= 0)
+        return 0;
+
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * max_results);
+    if (!slots)
+        return 0;
+
+    int count = task_store_status_query(&manager->store, completion, recurrence, reminder, slots, max_results);
+    for (int i = 0; i < count; i++)
+        out[i] = task_store_task(&manager->store, slots[i]);
+
+    free(slots);
+    return count;
+}
+
+// --- Utility Functions --- //
+
+void print_all_tasks(TaskManager *manager)
+{
+    if (!manager)
+        return;
+
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        printf("[%c] P%u %02d/%02d %02d:%02d #%d %s\n", task->is_complete ? 'x' : ' ',
+               task->priority, task->month + 1, task->date, task->time.hour, task->time.minutes,
+               task->id, task->description);
+    }
+}
+
+void print_all_appointments(TaskManager *manager)
+{
+    if (!manager)
+        return;
+
+    for (Node *node = manager->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        printf("[%c] %02d/%02d %02d:%02d #%d%s", appointment->is_complete ? 'x' : ' ',
+               appointment->month + 1, appointment->date, appointment->time.hour,
+               appointment->time.minutes, appointment->id, appointment->have_reminder ? " (reminder)" : "");
+        if (appointment->linked_task)
+            printf(" -> task #%d", appointment->linked_task->id);
+        printf("\n");
+    }
+}
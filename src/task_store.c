@@ -0,0 +1,311 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/task_store.h"
+
+// --- Helpers --- //
+
+static bool grow_column(void **column, size_t element, uint32_t capacity)
+{
+    void *grown = realloc(*column, element * capacity);
+    if (!grown)
+        return false;
+    *column = grown;
+    return true;
+}
+
+static bool grow_store(TaskStore *store)
+{
+    uint32_t capacity = store->capacity ? store->capacity * 2 : TASK_STORE_INITIAL_CAPACITY;
+
+    // Columns that did grow keep their new size; capacity only moves once all have
+    bool ok = grow_column((void **)&store->id, sizeof(int32_t), capacity) &&
+              grow_column((void **)&store->priority, 1, capacity) &&
+              grow_column((void **)&store->flags, 1, capacity) &&
+              grow_column((void **)&store->month, 1, capacity) &&
+              grow_column((void **)&store->date, 1, capacity) &&
+              grow_column((void **)&store->hour, 1, capacity) &&
+              grow_column((void **)&store->minute, 1, capacity) &&
+              grow_column((void **)&store->recurrence, 1, capacity) &&
+              grow_column((void **)&store->tasks, sizeof(Task *), capacity);
+    if (ok)
+        store->capacity = capacity;
+    else
+        printf("Memory allocation failed for TaskStore columns.\n");
+    return ok;
+}
+
+static void write_slot(TaskStore *store, uint32_t slot, const Task *task)
+{
+    store->id[slot] = task->id;
+    store->priority[slot] = (uint8_t)(task->priority > UINT8_MAX ? UINT8_MAX : task->priority);
+    store->flags[slot] = (task->is_complete ? TASK_STORE_COMPLETE : 0) |
+                         (task->have_reminder ? TASK_STORE_REMINDER : 0);
+    store->month[slot] = (uint8_t)task->month;
+    store->date[slot] = (uint8_t)task->date;
+    store->hour[slot] = (uint8_t)task->time.hour;
+    store->minute[slot] = (uint8_t)task->time.minutes;
+    store->recurrence[slot] = (uint8_t)(task->recurrence_type < TASK_STORE_RECURRENCES ? task->recurrence_type : NONE);
+}
+
+static bool index_values(TaskStore *store, uint32_t slot, uint8_t flags, uint8_t recurrence)
+{
+    return roaring_add(&store->by_completion[flags & TASK_STORE_COMPLETE ? 1 : 0], slot) &&
+           roaring_add(&store->by_reminder[flags & TASK_STORE_REMINDER ? 1 : 0], slot) &&
+           roaring_add(&store->by_recurrence[recurrence], slot);
+}
+
+static void unindex_values(TaskStore *store, uint32_t slot, uint8_t flags, uint8_t recurrence)
+{
+    roaring_remove(&store->by_completion[flags & TASK_STORE_COMPLETE ? 1 : 0], slot);
+    roaring_remove(&store->by_reminder[flags & TASK_STORE_REMINDER ? 1 : 0], slot);
+    roaring_remove(&store->by_recurrence[recurrence], slot);
+}
+
+static void unindex_slot(TaskStore *store, uint32_t slot)
+{
+    unindex_values(store, slot, store->flags[slot], store->recurrence[slot]);
+}
+
+// Moves slot from one bitmap of a family to another; nothing to do when the value is unchanged
+static bool move_in_family(RoaringBitmap *family, uint32_t slot, unsigned int from, unsigned int to)
+{
+    if (from == to)
+        return true;
+    roaring_remove(&family[from], slot);
+    return roaring_add(&family[to], slot);
+}
+
+// Re-files slot from the old flags and recurrence to its current ones
+static void reindex_slot(TaskStore *store, uint32_t slot, uint8_t flags, uint8_t recurrence)
+{
+    uint8_t updated = store->flags[slot];
+    if (!move_in_family(store->by_completion, slot, flags & TASK_STORE_COMPLETE ? 1 : 0,
+                        updated & TASK_STORE_COMPLETE ? 1 : 0) ||
+        !move_in_family(store->by_reminder, slot, flags & TASK_STORE_REMINDER ? 1 : 0,
+                        updated & TASK_STORE_REMINDER ? 1 : 0) ||
+        !move_in_family(store->by_recurrence, slot, recurrence, store->recurrence[slot]))
+        printf("Memory allocation failed for the status index of slot %u.\n", slot);
+}
+
+// The bitmaps a status query intersects; returns how many
+static int status_sets(const TaskStore *store, int completion, int recurrence, int reminder,
+                       const RoaringBitmap **sets)
+{
+    int count = 0;
+    if (completion >= 0)
+        sets[count++] = &store->by_completion[completion ? 1 : 0];
+    if (recurrence >= 0)
+        sets[count++] = &store->by_recurrence[recurrence];
+    if (reminder >= 0)
+        sets[count++] = &store->by_reminder[reminder ? 1 : 0];
+    return count;
+}
+
+// Evaluates the filter over rows [start, start + length) into keep[], one byte per row.
+// Plain byte arithmetic with no branches, so the compiler vectorises the loop.
+static void match_block(const TaskStore *store, const TaskFilter *filter, uint32_t start, uint32_t length,
+                        uint8_t *keep)
+{
+    uint8_t complete_mask = filter->completion < 0 ? 0 : TASK_STORE_COMPLETE;
+    uint8_t complete_want = filter->completion > 0 ? TASK_STORE_COMPLETE : 0;
+    uint8_t month_mask = filter->month < 0 ? 0 : 0xFF;
+    uint8_t month_want = (uint8_t)filter->month & month_mask;
+    uint8_t date_mask = filter->date <= 0 ? 0 : 0xFF;
+    uint8_t date_want = (uint8_t)filter->date & date_mask;
+    uint8_t low = (uint8_t)(filter->min_priority > UINT8_MAX ? UINT8_MAX : filter->min_priority);
+    uint8_t high = (uint8_t)(filter->max_priority > UINT8_MAX ? UINT8_MAX : filter->max_priority);
+    uint8_t span = (uint8_t)(high - low);
+
+    const uint8_t *flags = store->flags + start, *priority = store->priority + start;
+    const uint8_t *month = store->month + start, *date = store->date + start;
+    for (uint32_t i = 0; i < length; i++)
+        keep[i] = ((flags[i] & complete_mask) == complete_want) &
+                  ((uint8_t)(priority[i] - low) <= span) &
+                  ((month[i] & month_mask) == month_want) &
+                  ((date[i] & date_mask) == date_want);
+}
+
+// --- Store Lifecycle --- //
+
+void task_store_init(TaskStore *store)
+{
+    memset(store, 0, sizeof(TaskStore));
+}
+
+void task_store_free(TaskStore *store)
+{
+    if (!store)
+        return;
+
+    free(store->id);
+    free(store->priority);
+    free(store->flags);
+    free(store->month);
+    free(store->date);
+    free(store->hour);
+    free(store->minute);
+    free(store->recurrence);
+    free(store->tasks);
+    for (int i = 0; i < 2; i++)
+    {
+        roaring_free(&store->by_completion[i]);
+        roaring_free(&store->by_reminder[i]);
+    }
+    for (int i = 0; i < TASK_STORE_RECURRENCES; i++)
+        roaring_free(&store->by_recurrence[i]);
+    task_store_init(store);
+}
+
+// --- Maintenance --- //
+
+bool task_store_add(TaskStore *store, Task *task)
+{
+    if (!store || !task || (store->count == store->capacity && !grow_store(store)))
+        return false;
+
+    uint32_t slot = store->count;
+    write_slot(store, slot, task);
+    if (!index_values(store, slot, store->flags[slot], store->recurrence[slot]))
+    {
+        unindex_slot(store, slot);
+        return false;
+    }
+
+    store->count++;
+    store->tasks[slot] = task;
+    task->store_slot = slot;
+    return true;
+}
+
+void task_store_remove(TaskStore *store, Task *task)
+{
+    if (!store || !task || task->store_slot >= store->count || store->tasks[task->store_slot] != task)
+        return;
+
+    uint32_t slot = task->store_slot, last = --store->count;
+    if (slot == last)
+    {
+        unindex_slot(store, slot);
+        return;
+    }
+
+    // The last slot's bits go away and the hole takes over its values, so a family
+    // where both hold the same value only loses the last slot's bit
+    uint8_t flags = store->flags[slot], recurrence = store->recurrence[slot];
+    unindex_slot(store, last);
+
+    Task *moved = store->tasks[last];
+    store->id[slot] = store->id[last];
+    store->priority[slot] = store->priority[last];
+    store->flags[slot] = store->flags[last];
+    store->month[slot] = store->month[last];
+    store->date[slot] = store->date[last];
+    store->hour[slot] = store->hour[last];
+    store->minute[slot] = store->minute[last];
+    store->recurrence[slot] = store->recurrence[last];
+    store->tasks[slot] = moved;
+    moved->store_slot = slot;
+    reindex_slot(store, slot, flags, recurrence);
+}
+
+void task_store_refresh(TaskStore *store, const Task *task)
+{
+    if (!store || !task || task->store_slot >= store->count || store->tasks[task->store_slot] != task)
+        return;
+
+    uint32_t slot = task->store_slot;
+    uint8_t flags = store->flags[slot], recurrence = store->recurrence[slot];
+    write_slot(store, slot, task);
+    if (flags == store->flags[slot] && recurrence == store->recurrence[slot])
+        return;
+
+    reindex_slot(store, slot, flags, recurrence);
+}
+
+// --- Scans --- //
+
+TaskFilter task_filter_all()
+{
+    TaskFilter filter = {-1, 0, UINT8_MAX, -1, 0};
+    return filter;
+}
+
+int task_store_scan(const TaskStore *store, const TaskFilter *filter, uint32_t *out, int max_results)
+{
+    if (!store || !filter || !out || max_results <= 0 || filter->min_priority > filter->max_priority)
+        return 0;
+
+    uint8_t keep[TASK_STORE_BLOCK];
+    uint32_t found[TASK_STORE_BLOCK];
+    int count = 0;
+
+    for (uint32_t start = 0; start < store->count && count < max_results; start += TASK_STORE_BLOCK)
+    {
+        uint32_t length = store->count - start < TASK_STORE_BLOCK ? store->count - start : TASK_STORE_BLOCK;
+        match_block(store, filter, start, length, keep);
+
+        // Branch-free compaction: every row is written, only matches advance the cursor
+        uint32_t matches = 0;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            found[matches] = start + i;
+            matches += keep[i];
+        }
+
+        uint32_t room = (uint32_t)(max_results - count);
+        uint32_t copied = matches < room ? matches : room;
+        memcpy(out + count, found, copied * sizeof(uint32_t));
+        count += (int)copied;
+    }
+    return count;
+}
+
+uint32_t task_store_count(const TaskStore *store, const TaskFilter *filter)
+{
+    if (!store || !filter || filter->min_priority > filter->max_priority)
+        return 0;
+
+    uint8_t keep[TASK_STORE_BLOCK];
+    uint32_t total = 0;
+    for (uint32_t start = 0; start < store->count; start += TASK_STORE_BLOCK)
+    {
+        uint32_t length = store->count - start < TASK_STORE_BLOCK ? store->count - start : TASK_STORE_BLOCK;
+        match_block(store, filter, start, length, keep);
+        for (uint32_t i = 0; i < length; i++)
+            total += keep[i];
+    }
+    return total;
+}
+
+int task_store_status_query(const TaskStore *store, int completion, int recurrence, int reminder,
+                            uint32_t *out, int max_results)
+{
+    if (!store || !out || max_results <= 0 || recurrence >= TASK_STORE_RECURRENCES)
+        return 0;
+
+    const RoaringBitmap *sets[3];
+    int count = status_sets(store, completion, recurrence, reminder, sets);
+
+    if (count == 0)
+    {
+        int all = store->count < (uint32_t)max_results ? (int)store->count : max_results;
+        for (int i = 0; i < all; i++)
+            out[i] = (uint32_t)i;
+        return all;
+    }
+    return roaring_intersect(sets, count, out, max_results);
+}
+
+uint64_t task_store_status_count(const TaskStore *store, int completion, int recurrence, int reminder)
+{
+    if (!store || recurrence >= TASK_STORE_RECURRENCES)
+        return 0;
+
+    const RoaringBitmap *sets[3];
+    int count = status_sets(store, completion, recurrence, reminder, sets);
+
+    return count ? roaring_intersect_count(sets, count) : store->count;
+}
@@ -0,0 +1,466 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/task_view.h"
+
+static const char *const month_names[CALENDAR_MONTHS] = {"January", "February", "March",     "April",
+                                                          "May",     "June",     "July",      "August",
+                                                          "September", "October", "November", "December"};
+static const char *const weekday_names[7] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+
+// --- Helpers --- //
+
+// Day of the week of the first of the month, 0 for Sunday (Sakamoto's method)
+static int first_weekday(int year, MonthsInAYear month)
+{
+    static const int offsets[CALENDAR_MONTHS] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+    int y = year - (month < MARCH);
+    return (y + y / 4 - y / 100 + y / 400 + offsets[month] + 1) % 7;
+}
+
+static int calendar_year(const TaskView *view)
+{
+    return CALENDAR_BASE_YEAR + (view->calendar ? view->calendar->year : 0);
+}
+
+// Pads to width so a selected row is highlighted across the window
+static void pad_line(char *line, int length, int width)
+{
+    if (length < 0)
+        length = 0;
+    if (length > width)
+        length = width;
+    memset(line + length, ' ', width - length);
+    line[width] = '\0';
+}
+
+// Writes to column width - 1 at most, so the bottom right cell never scrolls the window
+static int line_width(const TaskView *view)
+{
+    return view->columns > 1 ? view->columns - 1 : 1;
+}
+
+static void draw_text(TaskView *view, int line, int column, const char *text, attr_t attributes)
+{
+    wattron(view->window, attributes);
+    mvwaddstr(view->window, line, column, text);
+    wattroff(view->window, attributes);
+}
+
+static void draw_status(TaskView *view, const char *text)
+{
+    char line[TASK_VIEW_MAX_COLUMNS + 1];
+    int width = line_width(view);
+    pad_line(strncpy(line, text, width + 1), (int)strlen(text), width);
+    if (!view->redraw_all && strcmp(line, view->status) == 0)
+        return;
+
+    draw_text(view, 0, 0, line, A_BOLD);
+    memcpy(view->status, line, width + 1);
+}
+
+// --- Task List --- //
+
+// The marks on a task's row that its agenda key does not cover
+static uint8_t row_flags(const Task *task)
+{
+    return (task->have_reminder ? TASK_VIEW_ROW_REMINDER : 0) |
+           (task->recurrence_type != NONE ? TASK_VIEW_ROW_RECURRING : 0);
+}
+
+// How far the rows last drawn moved to become page, matched by key. The top
+// row's key is the viewport's anchor, so inserts and removes above it leave
+// the page where it is even though every rank on it changed.
+static int scroll_delta(const TaskView *view, Task **page, int count)
+{
+    if (count == 0 || !view->shown[0].task)
+        return 0;
+
+    uint64_t top = task_order_key(page[0]);
+    for (int row = 0; row < view->rows; row++)
+    {
+        if (view->shown[row].task && view->shown[row].key == top)
+            return row;
+    }
+    for (int row = 1; row < count; row++)
+    {
+        if (task_order_key(page[row]) == view->shown[0].key)
+            return -row;
+    }
+    return view->rows;
+}
+
+// Moves what is on screen by delta rows; only the rows uncovered need drawing
+static void scroll_rows(TaskView *view, int delta)
+{
+    int rows = view->rows;
+    if (delta >= rows || -delta >= rows)
+    {
+        for (int row = 0; row < rows; row++)
+            view->shown[row].dirty = true;
+        return;
+    }
+
+    scrollok(view->window, TRUE);
+    wsetscrreg(view->window, 1, rows);
+    wscrl(view->window, delta);
+    wsetscrreg(view->window, 0, getmaxy(view->window) - 1);
+    scrollok(view->window, FALSE);
+
+    int kept = rows - (delta > 0 ? delta : -delta);
+    if (delta > 0)
+        memmove(view->shown, view->shown + delta, sizeof(TaskViewRow) * kept);
+    else
+        memmove(view->shown - delta, view->shown, sizeof(TaskViewRow) * kept);
+
+    int uncovered = delta > 0 ? kept : 0;
+    for (int row = uncovered; row < uncovered + rows - kept; row++)
+    {
+        view->shown[row].task = NULL;
+        view->shown[row].dirty = true;
+    }
+}
+
+static int render_list(TaskView *view)
+{
+    task_order_index *agenda = &view->manager->agenda_index;
+    int total = agenda->size;
+    int count;
+    Task **page = task_viewport_page(&view->viewport, &count);
+    int delta = view->redraw_all ? 0 : scroll_delta(view, page, count);
+    if (delta != 0)
+        scroll_rows(view, delta);
+
+    int cursor = view->viewport.cursor;
+    int width = line_width(view);
+    char line[TASK_VIEW_MAX_COLUMNS + 1];
+    int drawn = 0;
+
+    for (int row = 0; row < view->rows; row++)
+    {
+        Task *task = row < count ? page[row] : NULL;
+        uint64_t key = task ? task_order_key(task) : 0;
+        uint8_t flags = task ? row_flags(task) : 0;
+        bool selected = task && row == cursor;
+        TaskViewRow *shown = &view->shown[row];
+        if (!view->redraw_all && !shown->dirty && shown->task == task && shown->key == key &&
+            shown->flags == flags && shown->selected == selected)
+            continue;
+
+        if (task)
+            task_view_format_task(task, line, width);
+        else
+            pad_line(line, 0, width);
+        draw_text(view, 1 + row, 0, line, selected ? A_REVERSE : A_NORMAL);
+
+        shown->task = task;
+        shown->key = key;
+        shown->flags = flags;
+        shown->selected = selected;
+        shown->dirty = false;
+        drawn++;
+    }
+
+    // Incomplete tasks sort first, so their count is the rank of the first complete key
+    int open = task_order_index_rank(agenda, TASK_ORDER_INCOMPLETE_END);
+    char status[TASK_VIEW_MAX_COLUMNS];
+    snprintf(status, sizeof(status), " Tasks: %d open, %d done   %d/%d   v calendar  q quit", open, total - open,
+             count ? view->viewport.top + cursor + 1 : 0, total);
+    draw_status(view, status);
+    return drawn;
+}
+
+// --- Calendar --- //
+
+static int render_calendar(TaskView *view)
+{
+    int year = calendar_year(view);
+    const CalendarDay *days[CALENDAR_DAYS] = {NULL};
+    int length = view->calendar && view->calendar->days
+                     ? calendar_month_view(view->calendar->days, year, view->month, days)
+                     : days_in_month(year, view->month);
+    if (view->day > length)
+        view->day = length;
+    if (view->day < 1)
+        view->day = 1;
+
+    int cell = view->columns / 7;
+    int first = first_weekday(year, view->month);
+    char text[TASK_VIEW_MAX_COLUMNS + 1];
+    int drawn = 0;
+
+    if (view->redraw_all)
+    {
+        for (int weekday = 0; weekday < 7 && view->rows > 0; weekday++)
+            draw_text(view, 1, weekday * cell, weekday_names[weekday], A_UNDERLINE);
+    }
+
+    for (int date = 1; date <= length; date++)
+    {
+        uint32_t tasks = days[date - 1] ? days[date - 1]->task_count : 0;
+        uint32_t appointments = days[date - 1] ? days[date - 1]->appointment_count : 0;
+        bool selected = date == view->day;
+        bool was_selected = date == view->drawn_day;
+        if (!view->redraw_all && tasks == view->day_tasks[date - 1] &&
+            appointments == view->day_appointments[date - 1] && selected == was_selected)
+            continue;
+
+        int slot = first + date - 1;
+        int line = 2 + (slot / 7) * TASK_VIEW_WEEK_LINES;
+        view->day_tasks[date - 1] = tasks;
+        view->day_appointments[date - 1] = appointments;
+        if (line > view->rows || cell < 2)
+            continue;
+
+        int length_drawn = snprintf(text, sizeof(text), "%2d %ut %ua", date, tasks, appointments);
+        pad_line(text, length_drawn, cell - 1);
+        draw_text(view, line, (slot % 7) * cell, text, selected ? A_REVERSE : A_NORMAL);
+        drawn++;
+    }
+    view->drawn_day = view->day;
+
+    const CalendarDay *today = days[view->day - 1];
+    char status[TASK_VIEW_MAX_COLUMNS];
+    snprintf(status, sizeof(status), " %s %d   %02d/%02d: %u tasks, %u appointments   v list  q quit",
+             month_names[view->month], year, view->month + 1, view->day, today ? today->task_count : 0,
+             today ? today->appointment_count : 0);
+    draw_status(view, status);
+    return drawn;
+}
+
+// --- Tree --- //
+
+static uint64_t hash_line(const char *line)
+{
+    uint64_t hash = 14695981039346656037ull;    // FNV-1a
+    while (*line)
+        hash = (hash ^ (unsigned char)*line++) * 1099511628211ull;
+    return hash;
+}
+
+static bool diagram_selected(TaskView *view, HybridTree *bucket, const Task *selected)
+{
+    return hybrid_diagram_around(&view->diagram, bucket, selected ? selected->id : 0, TASK_VIEW_TREE_ABOVE,
+                                 TASK_VIEW_TREE_BELOW);
+}
+
+static int render_tree(TaskView *view)
+{
+    HashMapWithTree *map = view->manager->task_map;
+    Task *selected = task_viewport_selected(&view->viewport);
+    HybridTree *bucket = map->buckets[selected ? hash(selected->id, map->capacity) : 0];
+
+    // First pass: where the selected task's line falls, to centre the page on it
+    int focus_line = 0;
+    bool found = diagram_selected(view, bucket, selected);
+    while (hybrid_diagram_next(&view->diagram))
+    {
+        if (view->diagram.focused)
+            focus_line = view->diagram.lines - 1;
+    }
+    int total = view->diagram.lines;
+    int first = focus_line - view->rows / 2;
+    first = first > total - view->rows ? total - view->rows : first;
+    first = first < 0 ? 0 : first;
+
+    diagram_selected(view, bucket, selected);
+    for (int line = 0; line < first && hybrid_diagram_next(&view->diagram); line++)
+        ;
+
+    int width = line_width(view);
+    char text[TASK_VIEW_MAX_COLUMNS + 1];
+    int drawn = 0;
+    for (int row = 0; row < view->rows; row++)
+    {
+        bool more = hybrid_diagram_next(&view->diagram);
+        int length = more ? snprintf(text, width + 1, "%s", view->diagram.line) : 0;
+        pad_line(text, length, width);
+        uint64_t key = hash_line(text);
+        bool focused = more && view->diagram.focused;
+        TaskViewRow *shown = &view->shown[row];
+        if (!view->redraw_all && !shown->dirty && !shown->task && shown->key == key && shown->selected == focused)
+            continue;
+
+        draw_text(view, 1 + row, 0, text, focused ? A_REVERSE : view->diagram.collapsed && more ? A_DIM : A_NORMAL);
+        shown->task = NULL;
+        shown->key = key;
+        shown->selected = focused;
+        shown->dirty = false;
+        drawn++;
+    }
+
+    char status[TASK_VIEW_MAX_COLUMNS];
+    if (selected)
+        snprintf(status, sizeof(status), " Task map bucket %u: %d ids   #%d%s   %d lines   s list  q quit",
+                 hash(selected->id, map->capacity), bucket->size, selected->id, found ? "" : " (not in the map)",
+                 total);
+    else
+        snprintf(status, sizeof(status), " Task map: no task selected   s list  q quit");
+    draw_status(view, status);
+    return drawn;
+}
+
+// --- View Lifecycle --- //
+
+TaskView *create_task_view(TaskManager *manager, WINDOW *window)
+{
+    if (!manager || !window)
+        return NULL;
+
+    TaskView *view = (TaskView *)calloc(1, sizeof(TaskView));
+    if (!view)
+    {
+        printf("Memory allocation failed for TaskView.\n");
+        return NULL;
+    }
+
+    view->manager = manager;
+    view->window = window;
+    view->mode = TASK_VIEW_LIST;
+    view->month = JANUARY;
+    view->day = 1;
+    task_viewport_init(&view->viewport, &manager->agenda_index, 0);
+    idlok(window, TRUE);    // Lets doupdate scroll the terminal rather than repaint
+    task_view_resize(view);
+    return view;
+}
+
+void free_task_view(TaskView *view)
+{
+    free(view);
+}
+
+void task_view_resize(TaskView *view)
+{
+    if (!view)
+        return;
+
+    int height, width;
+    getmaxyx(view->window, height, width);
+    view->rows = height - 1 < TASK_VIEW_MAX_ROWS ? height - 1 : TASK_VIEW_MAX_ROWS;
+    view->columns = width < TASK_VIEW_MAX_COLUMNS ? width : TASK_VIEW_MAX_COLUMNS;
+    if (view->rows < 0)
+        view->rows = 0;
+    task_viewport_resize(&view->viewport, view->rows);
+    task_view_invalidate(view);
+}
+
+void task_view_set_mode(TaskView *view, TaskViewMode mode)
+{
+    if (view && view->mode != mode)
+    {
+        view->mode = mode;
+        task_view_invalidate(view);
+    }
+}
+
+void task_view_show_month(TaskView *view, Calendar *calendar, MonthsInAYear month)
+{
+    if (!view)
+        return;
+
+    view->calendar = calendar;
+    view->month = month;
+    view->mode = TASK_VIEW_CALENDAR;
+    task_view_invalidate(view);
+}
+
+// --- Navigation --- //
+
+void task_view_move(TaskView *view, int delta)
+{
+    if (!view)
+        return;
+
+    if (view->mode == TASK_VIEW_CALENDAR)
+    {
+        int length = days_in_month(calendar_year(view), view->month);
+        view->day += delta;
+        view->day = view->day < 1 ? 1 : view->day > length ? length : view->day;
+        return;
+    }
+
+    task_viewport_move(&view->viewport, delta);
+}
+
+void task_view_page(TaskView *view, int pages)
+{
+    if (view && view->mode != TASK_VIEW_CALENDAR)
+        task_viewport_page_by(&view->viewport, pages);
+}
+
+void task_view_jump(TaskView *view, int position)
+{
+    if (view && view->mode != TASK_VIEW_CALENDAR)
+        task_viewport_jump(&view->viewport, position);
+}
+
+Task *task_view_selected(TaskView *view)
+{
+    if (!view || view->mode == TASK_VIEW_CALENDAR)
+        return NULL;
+
+    return task_viewport_selected(&view->viewport);
+}
+
+void task_view_prefetch(TaskView *view)
+{
+    if (view && view->mode == TASK_VIEW_LIST)
+        task_viewport_prefetch(&view->viewport);
+}
+
+// --- Damage --- //
+
+void task_view_touch(TaskView *view, const Task *task)
+{
+    for (int row = 0; view && task && row < view->rows; row++)
+    {
+        if (view->shown[row].task == task)
+            view->shown[row].dirty = true;
+    }
+}
+
+void task_view_invalidate(TaskView *view)
+{
+    if (!view)
+        return;
+
+    view->redraw_all = true;
+    view->drawn_day = 0;
+}
+
+int task_view_render(TaskView *view)
+{
+    if (!view)
+        return 0;
+
+    if (view->redraw_all)
+        werase(view->window);
+    int drawn = view->mode == TASK_VIEW_LIST   ? render_list(view)
+                : view->mode == TASK_VIEW_TREE ? render_tree(view)
+                                               : render_calendar(view);
+    view->redraw_all = false;
+    view->frames++;
+    view->rows_drawn += drawn;
+    wnoutrefresh(view->window);
+    return drawn;
+}
+
+int task_view_format_task(const Task *task, char *line, int width)
+{
+    char due[32];
+    if (task->date > 0)
+        snprintf(due, sizeof(due), "%02d/%02d %02d:%02d", task->month + 1, task->date, task->time.hour,
+                 task->time.minutes);
+    else
+        snprintf(due, sizeof(due), "--/-- --:--");
+
+    int length = snprintf(line, width + 1, "[%c] P%u %s %c%c #%-7d %s", task->is_complete ? 'x' : ' ',
+                          task->priority, due, task->have_reminder ? 'R' : ' ',
+                          task->recurrence_type != NONE ? '*' : ' ', task->id,
+                          task->description ? task->description : "");
+    pad_line(line, length, width);
+    return width;
+}
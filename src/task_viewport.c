@@ -0,0 +1,239 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../include/task_viewport.h"
+
+// --- Helpers --- //
+
+static Task *viewport_task(task_order_index_node *node)
+{
+    return (Task *)first_value_in_list(&node->list);
+}
+
+static int viewport_page_count(const TaskViewport *viewport)
+{
+    return viewport->count < viewport->rows ? viewport->count : viewport->rows;
+}
+
+// Rank of the top row when the last page is on screen
+static int viewport_last_top(const TaskViewport *viewport)
+{
+    int total = viewport->index->size;
+    return total > viewport->rows ? total - viewport->rows : 0;
+}
+
+static void viewport_clamp_cursor(TaskViewport *viewport)
+{
+    int shown = viewport_page_count(viewport);
+    if (viewport->cursor >= shown)
+        viewport->cursor = shown - 1;
+    if (viewport->cursor < 0)
+        viewport->cursor = 0;
+}
+
+// Caches one page, starting at node, which has rank rank
+static void viewport_fill_from(TaskViewport *viewport, task_order_index_node *node, int rank)
+{
+    int limit = viewport->rows;
+    viewport->top = rank;
+    viewport->top_key = node ? node->key : 0;
+    viewport->count = 0;
+    while (node && viewport->count < limit)
+    {
+        viewport->tasks[viewport->count++] = viewport_task(node);
+        node = task_order_index_next(node);
+    }
+
+    viewport->filled = true;
+    viewport->version = viewport->index->version;
+    viewport->fills++;
+    viewport_clamp_cursor(viewport);
+}
+
+// Starts from the anchor again (or its successor, if the top task went away),
+// pulled back so that the last page is always a full one
+static void viewport_refill(TaskViewport *viewport)
+{
+    task_order_index *index = viewport->index;
+    task_order_index_node *node = task_order_index_lower_bound(index, viewport->top_key);
+    int rank = node ? task_order_index_rank(index, node->key) : index->size;
+    if (rank > viewport_last_top(viewport))
+    {
+        rank = viewport_last_top(viewport);
+        node = task_order_index_select(index, rank);
+    }
+    viewport_fill_from(viewport, node, rank);
+}
+
+static void viewport_sync(TaskViewport *viewport)
+{
+    if (!viewport->filled || viewport->version != viewport->index->version)
+        viewport_refill(viewport);
+}
+
+// Tops the cache up to limit tasks with the successors of its last task
+static void viewport_extend(TaskViewport *viewport, int limit)
+{
+    if (viewport->count == 0 || viewport->count >= limit ||
+        viewport->top + viewport->count >= viewport->index->size)
+        return;
+
+    task_order_index_node *node =
+        task_order_index_find(viewport->index, task_order_key(viewport->tasks[viewport->count - 1]));
+    node = node ? task_order_index_next(node) : NULL;
+    while (node && viewport->count < limit)
+    {
+        viewport->tasks[viewport->count++] = viewport_task(node);
+        node = task_order_index_next(node);
+    }
+}
+
+// Puts rank top on the top row, keeping whatever part of the cache stays in view
+static void viewport_scroll_to(TaskViewport *viewport, int top)
+{
+    int last = viewport_last_top(viewport);
+    top = top > last ? last : top < 0 ? 0 : top;
+    int delta = top - viewport->top;
+    if (delta == 0)
+        return;
+
+    if (delta > 0 && delta < viewport->count)
+    {
+        // Forward within the cache: the prefetched rows slide up into the page
+        viewport->count -= delta;
+        memmove(viewport->tasks, viewport->tasks + delta, sizeof(Task *) * viewport->count);
+        viewport->top = top;
+        viewport->top_key = task_order_key(viewport->tasks[0]);
+        viewport_extend(viewport, viewport->rows);
+    }
+    else if (delta < 0 && -delta < viewport->rows)
+    {
+        // Back by less than a page: the predecessors of the top row
+        int back = -delta;
+        int kept = viewport->count + back > 2 * viewport->rows ? 2 * viewport->rows - back : viewport->count;
+        task_order_index_node *node = task_order_index_find(viewport->index, viewport->top_key);
+        memmove(viewport->tasks + back, viewport->tasks, sizeof(Task *) * kept);
+        for (int i = back - 1; i >= 0; i--)
+        {
+            node = node ? task_order_index_prev(node) : NULL;
+            if (!node)
+            {
+                viewport_fill_from(viewport, task_order_index_select(viewport->index, top), top);
+                return;
+            }
+            viewport->tasks[i] = viewport_task(node);
+        }
+        viewport->count = kept + back;
+        viewport->top = top;
+        viewport->top_key = node->key;
+    }
+    else
+    {
+        viewport_fill_from(viewport, task_order_index_select(viewport->index, top), top);
+    }
+}
+
+// --- Viewport Lifecycle --- //
+
+void task_viewport_init(TaskViewport *viewport, task_order_index *index, int rows)
+{
+    if (!viewport)
+        return;
+
+    memset(viewport, 0, sizeof(TaskViewport));
+    viewport->index = index;
+    task_viewport_resize(viewport, rows);
+}
+
+void task_viewport_resize(TaskViewport *viewport, int rows)
+{
+    if (!viewport)
+        return;
+
+    viewport->rows = rows < 0 ? 0 : rows > TASK_VIEWPORT_MAX_ROWS ? TASK_VIEWPORT_MAX_ROWS : rows;
+    viewport->filled = false;
+}
+
+// --- Reading --- //
+
+Task **task_viewport_page(TaskViewport *viewport, int *count)
+{
+    viewport_sync(viewport);
+    if (count)
+        *count = viewport_page_count(viewport);
+    return viewport->tasks;
+}
+
+int task_viewport_top(TaskViewport *viewport)
+{
+    viewport_sync(viewport);
+    return viewport->top;
+}
+
+int task_viewport_position(TaskViewport *viewport)
+{
+    viewport_sync(viewport);
+    return viewport->top + viewport->cursor;
+}
+
+Task *task_viewport_selected(TaskViewport *viewport)
+{
+    viewport_sync(viewport);
+    return viewport->cursor < viewport_page_count(viewport) ? viewport->tasks[viewport->cursor] : NULL;
+}
+
+int task_viewport_prefetch(TaskViewport *viewport)
+{
+    viewport_sync(viewport);
+    viewport_extend(viewport, 2 * viewport->rows);
+    return viewport->count - viewport_page_count(viewport);
+}
+
+// --- Navigation --- //
+
+void task_viewport_move(TaskViewport *viewport, int delta)
+{
+    viewport_sync(viewport);
+    int total = viewport->index->size;
+    if (total == 0 || viewport->rows == 0)
+        return;
+
+    long position = (long)viewport->top + viewport->cursor + delta;
+    position = position >= total ? total - 1 : position < 0 ? 0 : position;
+    if (position < viewport->top)
+        viewport_scroll_to(viewport, (int)position);
+    else if (position >= viewport->top + viewport->rows)
+        viewport_scroll_to(viewport, (int)position - viewport->rows + 1);
+    viewport->cursor = (int)position - viewport->top;
+}
+
+void task_viewport_page_by(TaskViewport *viewport, int pages)
+{
+    viewport_sync(viewport);
+    if (viewport->index->size == 0 || viewport->rows == 0)
+        return;
+
+    long step = (long)pages * viewport->rows;
+    long position = viewport->top + viewport->cursor + step;
+    long top = viewport->top + step;
+    viewport_scroll_to(viewport, top > viewport->index->size ? viewport->index->size : top < 0 ? 0 : (int)top);
+
+    // At either end the page stops short, and the selection goes the rest of the way
+    long row = position - viewport->top;
+    viewport->cursor = row < 0 ? 0 : row >= viewport->rows ? viewport->rows - 1 : (int)row;
+    viewport_clamp_cursor(viewport);
+}
+
+void task_viewport_jump(TaskViewport *viewport, int position)
+{
+    viewport_sync(viewport);
+    int total = viewport->index->size;
+    if (total == 0 || viewport->rows == 0)
+        return;
+
+    position = position >= total ? total - 1 : position < 0 ? 0 : position;
+    if (position < viewport->top || position >= viewport->top + viewport->rows)
+        viewport_scroll_to(viewport, position - viewport->rows / 2);
+    viewport->cursor = position - viewport->top;
+}
@@ -2,6 +2,10 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "../include/hybrid_tree_api.h"
 
 // Basic hash function (Knuth's variant)
@@ -111,11 +115,386 @@ void tree_map_print(HashMapWithTree *map)
     }
 }
 
+// --- Parallel Helpers --- //
+
+typedef struct TreeMapTeam TreeMapTeam;
+typedef void (*TreeMapTeamFn)(TreeMapTeam *team, int index);
+
+typedef struct TreeMapTeam {
+    TreeMapTeamFn run;
+    void *job;
+    int threads;
+    pthread_barrier_t barrier;    // Counts every member
+    pthread_mutex_t gate_lock;    // Members wait here until all of them exist
+    pthread_cond_t gate_open;
+    int gate;                     // 0 waiting, 1 go, -1 give up
+} TreeMapTeam;
+
+typedef struct TreeMapMember {
+    TreeMapTeam *team;
+    int index;
+    pthread_t thread;
+} TreeMapMember;
+
+static int tree_map_threads(int threads, int count, int min_per_thread)
+{
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > count / min_per_thread)
+        threads = count / min_per_thread;
+    return threads < 1 ? 1 : threads;
+}
+
+static void *run_team_member(void *arg)
+{
+    TreeMapMember *member = (TreeMapMember *)arg;
+    TreeMapTeam *team = member->team;
+
+    pthread_mutex_lock(&team->gate_lock);
+    while (!team->gate)
+        pthread_cond_wait(&team->gate_open, &team->gate_lock);
+    bool go = team->gate > 0;
+    pthread_mutex_unlock(&team->gate_lock);
+    if (go)
+        team->run(team, member->index);
+    return NULL;
+}
+
+// Runs team->run on team->threads threads, the caller being member 0. A barrier
+// stalls unless every member exists, so none starts until all have been created;
+// if some cannot be, the work runs on the caller alone and team->threads says so.
+static bool run_team(TreeMapTeam *team)
+{
+    TreeMapMember *members = (TreeMapMember *)malloc(sizeof(TreeMapMember) * team->threads);
+    if (!members)
+        return false;
+
+    pthread_mutex_init(&team->gate_lock, NULL);
+    pthread_cond_init(&team->gate_open, NULL);
+    team->gate = 0;
+
+    int started = 1;
+    for (; started < team->threads; started++)
+    {
+        members[started].team = team;
+        members[started].index = started;
+        if (pthread_create(&members[started].thread, NULL, run_team_member, &members[started]) != 0)
+            break;
+    }
+
+    bool all_started = started == team->threads;
+    if (all_started)
+        pthread_barrier_init(&team->barrier, NULL, team->threads);
+    pthread_mutex_lock(&team->gate_lock);
+    team->gate = all_started ? 1 : -1;
+    pthread_cond_broadcast(&team->gate_open);
+    pthread_mutex_unlock(&team->gate_lock);
+    if (!all_started)
+    {
+        for (int t = 1; t < started; t++)
+            pthread_join(members[t].thread, NULL);
+        team->threads = 1;
+        pthread_barrier_init(&team->barrier, NULL, 1);
+    }
+
+    team->run(team, 0);
+    for (int t = 1; t < team->threads; t++)
+        pthread_join(members[t].thread, NULL);
+
+    pthread_barrier_destroy(&team->barrier);
+    pthread_mutex_destroy(&team->gate_lock);
+    pthread_cond_destroy(&team->gate_open);
+    free(members);
+    return true;
+}
+
+// The radix digit of a key at shift, with the sign flipped so negatives sort first
+static inline unsigned int key_digit(int key, int shift)
+{
+    return (((uint32_t)key ^ 0x80000000u) >> shift) & 0xff;
+}
+
+// Stable LSD radix sort on the key, one byte at a time; bytes every key shares are skipped
+static bool sort_entries(HybridEntry *entries, int count, HybridEntry **scratch, int *scratch_capacity)
+{
+    if (count < 2)
+        return true;
+    if (*scratch_capacity < count)
+    {
+        HybridEntry *grown = (HybridEntry *)realloc(*scratch, sizeof(HybridEntry) * count);
+        if (!grown)
+            return false;
+        *scratch = grown;
+        *scratch_capacity = count;
+    }
+
+    HybridEntry *from = entries, *to = *scratch;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t counts[256] = {0};
+        for (int i = 0; i < count; i++)
+            counts[key_digit(from[i].key, shift)]++;
+        if (counts[key_digit(from[0].key, shift)] == (uint32_t)count)
+            continue;
+
+        uint32_t position = 0;
+        for (int digit = 0; digit < 256; digit++)
+        {
+            uint32_t digits = counts[digit];
+            counts[digit] = position;
+            position += digits;
+        }
+        for (int i = 0; i < count; i++)
+            to[counts[key_digit(from[i].key, shift)]++] = from[i];
+
+        HybridEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != entries)
+        memcpy(entries, from, sizeof(HybridEntry) * count);
+    return true;
+}
+
+// --- Parallel Bulk Build --- //
+
+typedef struct TreeMapBuild {
+    HashMapWithTree *map;
+    const HybridEntry *input;
+    HybridEntry *grouped;         // Input regrouped by bucket, in input order within each
+    uint32_t *bucket_of;          // Bucket of each input entry, so hash() runs once
+    uint32_t *offsets;            // threads x capacity: each thread's next slot per bucket
+    uint32_t *bucket_start;       // capacity + 1
+    int count;
+    _Atomic int next_bucket;
+    _Atomic long inserted;
+    _Atomic bool failed;
+} TreeMapBuild;
+
+static void run_tree_map_builder(TreeMapTeam *team, int index)
+{
+    TreeMapBuild *build = (TreeMapBuild *)team->job;
+    int capacity = build->map->capacity;
+    int first = (int)((int64_t)build->count * index / team->threads);
+    int last = (int)((int64_t)build->count * (index + 1) / team->threads);
+    uint32_t *offsets = build->offsets + (size_t)index * capacity;
+
+    // Histogram of this thread's share of the input
+    for (int i = first; i < last; i++)
+    {
+        uint32_t bucket = hash(build->input[i].key, capacity);
+        build->bucket_of[i] = bucket;
+        offsets[bucket]++;
+    }
+    pthread_barrier_wait(&team->barrier);
+
+    // Bucket-major prefix sum, so each thread's entries of a bucket follow the previous thread's
+    if (index == 0)
+    {
+        uint32_t position = 0;
+        for (int bucket = 0; bucket < capacity; bucket++)
+        {
+            build->bucket_start[bucket] = position;
+            for (int t = 0; t < team->threads; t++)
+            {
+                uint32_t *slot = &build->offsets[(size_t)t * capacity + bucket];
+                uint32_t entries = *slot;
+                *slot = position;
+                position += entries;
+            }
+        }
+        build->bucket_start[capacity] = position;
+    }
+    pthread_barrier_wait(&team->barrier);
+
+    for (int i = first; i < last; i++)
+        build->grouped[offsets[build->bucket_of[i]]++] = build->input[i];
+    pthread_barrier_wait(&team->barrier);
+
+    // Buckets are independent: sort, drop repeated keys, build
+    HybridEntry *scratch = NULL;
+    int scratch_capacity = 0;
+    long inserted = 0;
+    for (;;)
+    {
+        int bucket = atomic_fetch_add(&build->next_bucket, TREE_MAP_BUILD_GRAB);
+        if (bucket >= capacity || atomic_load(&build->failed))
+            break;
+
+        int end = bucket + TREE_MAP_BUILD_GRAB < capacity ? bucket + TREE_MAP_BUILD_GRAB : capacity;
+        for (; bucket < end; bucket++)
+        {
+            HybridEntry *entries = build->grouped + build->bucket_start[bucket];
+            int count = (int)(build->bucket_start[bucket + 1] - build->bucket_start[bucket]);
+            if (!sort_entries(entries, count, &scratch, &scratch_capacity))
+            {
+                atomic_store(&build->failed, true);
+                break;
+            }
+
+            int unique = 0;
+            for (int i = 0; i < count; i++)
+            {
+                if (!unique || entries[i].key != entries[unique - 1].key)
+                    entries[unique++] = entries[i];
+            }
+            if (!build_hybrid_tree_sorted(build->map->buckets[bucket], entries, unique))
+            {
+                atomic_store(&build->failed, true);
+                break;
+            }
+            inserted += unique;
+        }
+    }
+    free(scratch);
+    atomic_fetch_add(&build->inserted, inserted);
+}
+
+int tree_map_build(HashMapWithTree *map, const HybridEntry *entries, int count, int threads)
+{
+    if (!map || count < 0 || (count > 0 && !entries))
+        return -1;
+    for (int i = 0; i < map->capacity; i++)
+    {
+        if (map->buckets[i]->root)
+            return -1;
+    }
+    if (count == 0)
+        return 0;
+
+    threads = tree_map_threads(threads, count, TREE_MAP_BUILD_MIN_PER_THREAD);
+    TreeMapBuild build;
+    memset(&build, 0, sizeof(build));
+    build.map = map;
+    build.input = entries;
+    build.count = count;
+    build.grouped = (HybridEntry *)malloc(sizeof(HybridEntry) * count);
+    build.bucket_of = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    build.offsets = (uint32_t *)calloc((size_t)threads * map->capacity, sizeof(uint32_t));
+    build.bucket_start = (uint32_t *)malloc(sizeof(uint32_t) * (map->capacity + 1));
+    atomic_init(&build.next_bucket, 0);
+    atomic_init(&build.inserted, 0);
+    atomic_init(&build.failed, false);
+
+    TreeMapTeam team = {.run = run_tree_map_builder, .job = &build, .threads = threads};
+    bool ok = build.grouped && build.bucket_of && build.offsets && build.bucket_start && run_team(&team) &&
+              !atomic_load(&build.failed);
+
+    free(build.grouped);
+    free(build.bucket_of);
+    free(build.offsets);
+    free(build.bucket_start);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Bulk build of HashMapWithTree failed.\n");
+        for (int i = 0; i < map->capacity; i++)
+        {
+            free_hybrid_tree(map->buckets[i]->root, NULL);
+            map->buckets[i]->root = NULL;
+            map->buckets[i]->size = 0;
+        }
+        return -1;
+    }
+    return (int)atomic_load(&build.inserted);
+}
+
+// --- Ordered Range Query --- //
+
+typedef struct TreeMapSort {
+    HybridEntry *entries;
+    HybridEntry *scratch;
+    int count;
+    uint32_t (*counts)[256];      // threads x 256: each thread's digit histogram, then its next slot
+    bool skip;                    // Every key shares the current digit
+} TreeMapSort;
+
+// Parallel form of sort_entries: per pass, each thread counts its share of the
+// input, thread 0 turns the counts into digit-major offsets, and each thread
+// scatters its share, which keeps the sort stable
+static void run_tree_map_sorter(TreeMapTeam *team, int index)
+{
+    TreeMapSort *sort = (TreeMapSort *)team->job;
+    int first = (int)((int64_t)sort->count * index / team->threads);
+    int last = (int)((int64_t)sort->count * (index + 1) / team->threads);
+    uint32_t *counts = sort->counts[index];
+    HybridEntry *from = sort->entries, *to = sort->scratch;
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        memset(counts, 0, sizeof(uint32_t) * 256);
+        for (int i = first; i < last; i++)
+            counts[key_digit(from[i].key, shift)]++;
+        pthread_barrier_wait(&team->barrier);
+
+        if (index == 0)
+        {
+            unsigned int digit_of_first = key_digit(from[0].key, shift);
+            uint32_t same = 0;
+            for (int t = 0; t < team->threads; t++)
+                same += sort->counts[t][digit_of_first];
+            sort->skip = same == (uint32_t)sort->count;
+
+            uint32_t position = 0;
+            for (int digit = 0; digit < 256 && !sort->skip; digit++)
+            {
+                for (int t = 0; t < team->threads; t++)
+                {
+                    uint32_t digits = sort->counts[t][digit];
+                    sort->counts[t][digit] = position;
+                    position += digits;
+                }
+            }
+        }
+        pthread_barrier_wait(&team->barrier);
+        if (sort->skip)
+            continue;
+
+        for (int i = first; i < last; i++)
+            to[counts[key_digit(from[i].key, shift)]++] = from[i];
+        pthread_barrier_wait(&team->barrier);
+
+        HybridEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != sort->entries)
+        memcpy(sort->entries + first, from + first, sizeof(HybridEntry) * (last - first));
+}
+
+// Orders entries by key on up to threads threads (<= 0 for every CPU)
+static bool sort_entries_parallel(HybridEntry *entries, int count, int threads)
+{
+    threads = tree_map_threads(threads, count, TREE_MAP_SORT_MIN_PER_THREAD);
+    HybridEntry *scratch = (HybridEntry *)malloc(sizeof(HybridEntry) * count);
+    if (!scratch)
+        return false;
+
+    bool ok;
+    if (threads == 1)
+    {
+        int scratch_capacity = count;
+        ok = sort_entries(entries, count, &scratch, &scratch_capacity);
+    }
+    else
+    {
+        TreeMapSort sort = {entries, scratch, count, NULL, false};
+        sort.counts = (uint32_t(*)[256])malloc(sizeof(uint32_t) * 256 * threads);
+        TreeMapTeam team = {.run = run_tree_map_sorter, .job = &sort, .threads = threads};
+        ok = sort.counts && run_team(&team);
+        free(sort.counts);
+    }
+    free(scratch);
+    return ok;
+}
+
 int compare_nodes(const void *a, const void *b)
 {
-    const HybridNode *na = *(const HybridNode **)a;
-    const HybridNode *nb = *(const HybridNode **)b;
-    return void_ptr_to_int(na->key) - void_ptr_to_int(nb->key);
+    int ka = void_ptr_to_int((*(const HybridNode **)a)->key);
+    int kb = void_ptr_to_int((*(const HybridNode **)b)->key);
+    return (ka > kb) - (ka < kb);
 }
 
 // Perform range query across all HybridTrees in the map
@@ -129,7 +508,28 @@ void tree_map_range_query_ordered(HashMapWithTree *map, int low, int high, Dynam
         range_query(map->buckets[i]->root, low, high, result);
     }
 
-    qsort(result->items, result->size, sizeof(HybridNode *), compare_nodes);
+    // Sort (key, node) pairs rather than chase two node pointers per comparison
+    int count = result->size;
+    HybridEntry *entries = count > 1 ? (HybridEntry *)malloc(sizeof(HybridEntry) * count) : NULL;
+    if (!entries)
+    {
+        qsort(result->items, count, sizeof(HybridNode *), compare_nodes);
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        entries[i].key = void_ptr_to_int(result->items[i]->key);
+        entries[i].value = result->items[i];
+    }
+    if (sort_entries_parallel(entries, count, 0))
+    {
+        for (int i = 0; i < count; i++)
+            result->items[i] = (HybridNode *)entries[i].value;
+    }
+    else
+        qsort(result->items, count, sizeof(HybridNode *), compare_nodes);
+    free(entries);
 }
 
 // Free the map and its contents
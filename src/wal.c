@@ -0,0 +1,751 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "../include/wal.h"
+#include "../include/persistence.h"
+
+// Bytes covered by WalRecord.length and WalRecord.checksum
+#define WAL_RECORD_BODY (sizeof(WalRecord) - offsetof(WalRecord, sequence))
+
+// --- Helpers --- //
+
+static char *make_path(const char *base, const char *suffix)
+{
+    size_t base_length = strlen(base), suffix_length = strlen(suffix);
+    char *path = (char *)malloc(base_length + suffix_length + 1);
+    if (path)
+    {
+        memcpy(path, base, base_length);
+        memcpy(path + base_length, suffix, suffix_length + 1);
+    }
+    return path;
+}
+
+static uint32_t fnv1a(const void *bytes, size_t size, uint32_t hash)
+{
+    const unsigned char *p = (const unsigned char *)bytes;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t record_checksum(const WalRecord *record, const char *text, uint32_t text_length)
+{
+    uint32_t hash = fnv1a(&record->sequence, WAL_RECORD_BODY, 2166136261u);
+    return fnv1a(text, text_length, hash);
+}
+
+static bool write_all(int fd, const char *bytes, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0)
+            return false;
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+// A rename or a newly created file is only durable once its directory is synced
+static bool sync_parent_directory(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    char *directory = slash ? strndup(path, slash == path ? 1 : (size_t)(slash - path)) : strdup(".");
+    if (!directory)
+        return false;
+
+    int fd = open(directory, O_RDONLY);
+    free(directory);
+    if (fd < 0)
+        return false;
+
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+static bool file_exists(const char *path)
+{
+    struct stat info;
+    return stat(path, &info) == 0;
+}
+
+// --- Replay --- //
+
+static bool apply_record(TaskManager *manager, const WalRecord *record, const char *text)
+{
+    Time time = {(char)record->minutes, (char)record->hour};
+    bool reminder = (record->flags & SNAPSHOT_REMINDER) != 0;
+    // Appointments are checked here; set_task_schedule checks a task's own
+    bool schedule_valid = task_order_schedule_valid(record->month, record->date, record->hour, record->minutes);
+
+    switch ((WalOp)record->op)
+    {
+    case WAL_ADD_TASK:
+        return add_task(manager, record->id, text, record->priority) != NULL;
+    case WAL_UPDATE_TASK:
+        return update_task(manager, record->id, text, record->priority) != NULL;
+    case WAL_DELETE_TASK:
+        return delete_task(manager, record->id);
+    case WAL_SCHEDULE_TASK:
+        return set_task_schedule(manager, record->id, (MonthsInAYear)record->month, (char)record->date, time) != NULL;
+    case WAL_COMPLETE_TASK:
+        return set_task_completion(manager, record->id, (record->flags & SNAPSHOT_COMPLETE) != 0) != NULL;
+    case WAL_ADD_SUBTASK:
+        return add_subtask(manager, record->id, text, record->priority) != NULL;
+    case WAL_UPDATE_SUBTASK:
+        return update_subtask(manager, record->id, record->target, text, record->priority) != NULL;
+    case WAL_DELETE_SUBTASK:
+        return delete_subtask(manager, record->id, record->target);
+    case WAL_ADD_APPOINTMENT:
+        return schedule_valid &&
+               add_appointment(manager, record->id, (char)record->date, time, (MonthsInAYear)record->month, reminder,
+                               (RecurrenceType)record->recurrence_type) != NULL;
+    case WAL_UPDATE_APPOINTMENT:
+        return schedule_valid &&
+               update_appointment(manager, record->id, (char)record->date, time, (MonthsInAYear)record->month,
+                                  reminder, (RecurrenceType)record->recurrence_type) != NULL;
+    case WAL_DELETE_APPOINTMENT:
+        return delete_appointment(manager, record->id);
+    case WAL_LINK_TASK:
+        link_task_to_appointment(manager, record->id, record->target);
+        return true;
+    case WAL_SET_TASK_NOTE:
+        return set_task_note(manager, record->id, text) != NULL;
+    case WAL_ADD_APPOINTMENT_NOTE:
+        return add_appointment_note(manager, record->id, text) != NULL;
+    case WAL_SET_TASK_REMINDER:
+        return set_task_reminder(manager, record->id, reminder, (RecurrenceType)record->recurrence_type) != NULL;
+    case WAL_ARM_REMINDER:
+        return arm_task_reminder(manager, record->id,
+                                 (int64_t)((uint64_t)record->priority << 32 | (uint32_t)record->target)) != NULL;
+    case WAL_SPEND_REMINDER:
+        return spend_task_reminder(manager, record->id) != NULL;
+    }
+    return false;
+}
+
+long wal_replay(TaskManager *manager, const char *log_path)
+{
+    if (!manager || !log_path)
+        return -1;
+
+    FILE *file = fopen(log_path, "rb");
+    if (!file)
+        return -1;
+    setvbuf(file, NULL, _IOFBF, WAL_BUFFER_SIZE);
+
+    long valid = 0;
+    size_t text_capacity = 256;
+    char *text = (char *)malloc(text_capacity);
+    int applied = 0, rejected = 0;
+
+    WalRecord record;
+    while (text && fread(&record, sizeof(record), 1, file) == 1)
+    {
+        uint32_t text_length = record.text_length == WAL_NO_TEXT ? 0 : record.text_length;
+        if (record.length != WAL_RECORD_BODY + text_length || text_length > (1u << 30))
+            break;
+
+        if (text_length + 1 > text_capacity)
+        {
+            char *grown = (char *)realloc(text, text_length + 1);
+            if (!grown)
+                break;
+            text = grown;
+            text_capacity = text_length + 1;
+        }
+        if (fread(text, 1, text_length, file) != text_length ||
+            record_checksum(&record, text, text_length) != record.checksum)
+            break; // Torn or corrupt tail: everything before it is the log
+        text[text_length] = '\0';
+
+        valid += (long)(sizeof(record) + text_length);
+        if (record.sequence <= manager->log_sequence)
+            continue; // Already folded into the snapshot
+
+        if (apply_record(manager, &record, record.text_length == WAL_NO_TEXT ? NULL : text))
+            applied++;
+        else
+            rejected++;
+        manager->log_sequence = record.sequence;
+    }
+
+    if (rejected > 0)
+        printf("Log %s: %d records applied, %d could not be applied.\n", log_path, applied, rejected);
+
+    free(text);
+    fclose(file);
+    return valid;
+}
+
+bool wal_recover(TaskManager *manager, const char *snapshot_path)
+{
+    if (!manager || !snapshot_path)
+        return false;
+
+    char *log_path = make_path(snapshot_path, ".wal");
+    char *sealed_path = make_path(snapshot_path, ".wal.old");
+    bool ok = log_path && sealed_path;
+
+    if (ok && file_exists(snapshot_path))
+        ok = load_tasks_from_file(manager, snapshot_path);
+
+    // A sealed log is left behind when compaction did not finish
+    if (ok && file_exists(sealed_path))
+        ok = wal_replay(manager, sealed_path) >= 0;
+
+    if (ok && file_exists(log_path))
+    {
+        long valid = wal_replay(manager, log_path);
+        struct stat info;
+        ok = valid >= 0 && stat(log_path, &info) == 0;
+        if (ok && valid < info.st_size)
+        {
+            printf("Log %s: dropping %ld bytes of incomplete records.\n", log_path, (long)info.st_size - valid);
+            ok = truncate(log_path, valid) == 0;
+        }
+    }
+
+    free(log_path);
+    free(sealed_path);
+    return ok;
+}
+
+// Identity of the files a private load reads; 0 for a missing file
+static void file_identities(const char *const paths[3], ino_t identities[3])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        struct stat info;
+        identities[i] = stat(paths[i], &info) == 0 ? info.st_ino : 0;
+    }
+}
+
+TaskManager *wal_load_private(const char *snapshot_path)
+{
+    if (!snapshot_path)
+        return NULL;
+
+    char *log_path = make_path(snapshot_path, ".wal");
+    char *sealed_path = make_path(snapshot_path, ".wal.old");
+    const char *paths[3] = {snapshot_path, sealed_path, log_path};
+    TaskManager *manager = NULL;
+
+    for (int attempt = 0; log_path && sealed_path && attempt < WAL_LOAD_ATTEMPTS; attempt++)
+    {
+        ino_t before[3], after[3];
+        file_identities(paths, before);
+
+        manager = create_task_manager();
+        bool ok = manager != NULL;
+        if (ok && before[0])
+            ok = load_tasks_from_file(manager, snapshot_path);
+        if (ok && before[1])
+            ok = wal_replay(manager, sealed_path) >= 0;
+        if (ok && before[2])
+            ok = wal_replay(manager, log_path) >= 0;
+
+        // A seal renames the log and a compaction replaces the snapshot; if either
+        // happened meanwhile, records may have been missed, so read again
+        file_identities(paths, after);
+        if (ok && !memcmp(before, after, sizeof(before)))
+            break;
+
+        free_task_manager(manager);
+        manager = NULL;
+    }
+
+    if (!manager)
+        printf("Could not load a private copy of %s.\n", snapshot_path);
+    free(log_path);
+    free(sealed_path);
+    return manager;
+}
+
+// --- Compaction --- //
+
+static void end_compaction(Wal *wal)
+{
+    pthread_mutex_lock(&wal->lock);
+    wal->compact_running = false;
+    pthread_cond_signal(&wal->pending); // A request may have come in meanwhile
+    pthread_cond_broadcast(&wal->compacted);
+    pthread_mutex_unlock(&wal->lock);
+}
+
+// Snapshot + sealed log -> new snapshot, built in a private manager so the live one is untouched
+static void *compact_logs(void *arg)
+{
+    Wal *wal = (Wal *)arg;
+    TaskManager *folded = create_task_manager();
+    bool ok = folded != NULL;
+
+    if (ok && file_exists(wal->snapshot_path))
+        ok = load_tasks_from_file(folded, wal->snapshot_path);
+    if (ok)
+        ok = wal_replay(folded, wal->sealed_path) >= 0;
+    if (ok)
+        ok = save_tasks_to_file(folded, wal->snapshot_path);
+    // Only drop the sealed log once the snapshot holding its records is in place
+    if (ok)
+        ok = unlink(wal->sealed_path) == 0 && sync_parent_directory(wal->sealed_path);
+
+    free_task_manager(folded);
+
+    pthread_mutex_lock(&wal->lock);
+    wal->compact_failed = !ok;
+    pthread_mutex_unlock(&wal->lock);
+    end_compaction(wal);
+    return NULL;
+}
+
+// Runs on the flusher thread, which is the only user of wal->fd and wal->compactor.
+// The flusher set compact_running when it decided to compact; it is cleared here
+// if no compactor starts.
+static void start_compaction(Wal *wal)
+{
+    if (wal->compacting)
+    {
+        pthread_join(wal->compactor, NULL);
+        wal->compacting = false;
+    }
+
+    // A sealed log that is still on disk has to be folded in before another can be sealed
+    if (!file_exists(wal->sealed_path))
+    {
+        int fd = -1;
+        if (rename(wal->log_path, wal->sealed_path) != 0 ||
+            (fd = open(wal->log_path, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0 ||
+            !sync_parent_directory(wal->log_path))
+        {
+            printf("Could not seal log %s.\n", wal->log_path);
+            if (fd >= 0)
+                close(fd);
+            end_compaction(wal);
+            return;
+        }
+        close(wal->fd);
+        wal->fd = fd;
+
+        pthread_mutex_lock(&wal->lock);
+        wal->log_bytes = 0;
+        pthread_mutex_unlock(&wal->lock);
+    }
+
+    if (pthread_create(&wal->compactor, NULL, compact_logs, wal) == 0)
+        wal->compacting = true;
+    else
+        end_compaction(wal);
+}
+
+// --- Group Commit --- //
+
+static void *flush_log(void *arg)
+{
+    Wal *wal = (Wal *)arg;
+
+    pthread_mutex_lock(&wal->lock);
+    for (;;)
+    {
+        while (!wal->buffer_used && !wal->closing &&
+               !(wal->compact_requested && !wal->compact_running && !wal->checkpointing))
+            pthread_cond_wait(&wal->pending, &wal->lock);
+
+        if (wal->buffer_used)
+        {
+            // Take the whole batch; writers keep appending into the other buffer meanwhile
+            char *batch = wal->buffer;
+            size_t batch_size = wal->buffer_used;
+            uint64_t batch_end = wal->next_sequence - 1;
+            wal->buffer = wal->flushing;
+            wal->flushing = batch;
+            size_t capacity = wal->buffer_capacity;
+            wal->buffer_capacity = wal->flushing_capacity;
+            wal->flushing_capacity = capacity;
+            wal->buffer_used = 0;
+            pthread_mutex_unlock(&wal->lock);
+
+            bool ok = write_all(wal->fd, batch, batch_size) && fdatasync(wal->fd) == 0;
+
+            pthread_mutex_lock(&wal->lock);
+            wal->syncs++;
+            if (ok && !wal->failed)
+            {
+                wal->durable_sequence = batch_end;
+                wal->log_bytes += batch_size;
+            }
+            else
+            {
+                if (!wal->failed)
+                    printf("Write to log %s failed; later changes are not durable.\n", wal->log_path);
+                wal->failed = true;
+            }
+            pthread_cond_broadcast(&wal->durable);
+        }
+
+        if (!wal->failed && !wal->closing && !wal->compact_running && !wal->checkpointing &&
+            (wal->compact_requested || wal->log_bytes >= WAL_COMPACT_BYTES))
+        {
+            // Set before letting go of the lock, so a checkpoint waits for this one
+            wal->compact_requested = false;
+            wal->compact_running = true;
+            pthread_mutex_unlock(&wal->lock);
+            start_compaction(wal);
+            pthread_mutex_lock(&wal->lock);
+        }
+
+        if (wal->closing && !wal->buffer_used)
+            break;
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return NULL;
+}
+
+// Imports attach items no record covers, so they are saved in a checkpoint
+static bool checkpoint_bulk_load(TaskManager *manager, void *context)
+{
+    (void)manager;
+    return wal_checkpoint((Wal *)context);
+}
+
+Wal *wal_open(TaskManager *manager, const char *snapshot_path)
+{
+    if (!manager || !snapshot_path)
+        return NULL;
+
+    Wal *wal = (Wal *)calloc(1, sizeof(Wal));
+    if (!wal)
+    {
+        printf("Memory allocation failed for the log.\n");
+        return NULL;
+    }
+
+    wal->manager = manager;
+    wal->log_path = make_path(snapshot_path, ".wal");
+    wal->sealed_path = make_path(snapshot_path, ".wal.old");
+    wal->snapshot_path = make_path(snapshot_path, "");
+    wal->buffer = (char *)malloc(WAL_BUFFER_SIZE);
+    wal->flushing = (char *)malloc(WAL_BUFFER_SIZE);
+    wal->buffer_capacity = wal->flushing_capacity = WAL_BUFFER_SIZE;
+    wal->next_sequence = manager->log_sequence + 1;
+    wal->durable_sequence = manager->log_sequence;
+    wal->fd = -1;
+
+    struct stat info;
+    if (wal->log_path && wal->sealed_path && wal->snapshot_path && wal->buffer && wal->flushing)
+        wal->fd = open(wal->log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+    if (wal->fd < 0 || fstat(wal->fd, &info) != 0 || !sync_parent_directory(wal->log_path))
+    {
+        printf("Could not open log for %s.\n", snapshot_path);
+        if (wal->fd >= 0)
+            close(wal->fd);
+        free(wal->log_path);
+        free(wal->sealed_path);
+        free(wal->snapshot_path);
+        free(wal->buffer);
+        free(wal->flushing);
+        free(wal);
+        return NULL;
+    }
+    wal->log_bytes = (uint64_t)info.st_size;
+
+    // Finish folding a log that was sealed before a crash
+    wal->compact_requested = file_exists(wal->sealed_path);
+
+    pthread_mutex_init(&wal->lock, NULL);
+    pthread_cond_init(&wal->pending, NULL);
+    pthread_cond_init(&wal->durable, NULL);
+    pthread_cond_init(&wal->compacted, NULL);
+    if (pthread_create(&wal->flusher, NULL, flush_log, wal) != 0)
+    {
+        wal->closing = true;
+        wal->failed = true;
+        wal_close(wal);
+        return NULL;
+    }
+    set_bulk_load_handler(manager, checkpoint_bulk_load, wal);
+    return wal;
+}
+
+bool wal_close(Wal *wal)
+{
+    if (!wal)
+        return false;
+
+    pthread_mutex_lock(&wal->lock);
+    bool started = !wal->closing;
+    wal->closing = true;
+    pthread_cond_signal(&wal->pending);
+    pthread_mutex_unlock(&wal->lock);
+
+    if (started)
+        pthread_join(wal->flusher, NULL);
+    if (wal->compacting)
+        pthread_join(wal->compactor, NULL);
+    if (wal->manager->bulk_load_context == wal)
+        set_bulk_load_handler(wal->manager, NULL, NULL);
+
+    bool ok = !wal->failed && !wal->compact_failed;
+    close(wal->fd);
+    pthread_mutex_destroy(&wal->lock);
+    pthread_cond_destroy(&wal->pending);
+    pthread_cond_destroy(&wal->durable);
+    pthread_cond_destroy(&wal->compacted);
+    free(wal->log_path);
+    free(wal->sealed_path);
+    free(wal->snapshot_path);
+    free(wal->buffer);
+    free(wal->flushing);
+    free(wal);
+    return ok;
+}
+
+uint64_t wal_append(Wal *wal, WalRecord *record, const char *text)
+{
+    if (!wal || !record)
+        return 0;
+
+    size_t text_length = text ? strlen(text) : 0;
+    if (text_length >= WAL_NO_TEXT)
+        return 0;
+    size_t size = sizeof(WalRecord) + text_length;
+
+    record->text_length = text ? (uint32_t)text_length : WAL_NO_TEXT;
+    record->length = (uint32_t)(WAL_RECORD_BODY + text_length);
+
+    pthread_mutex_lock(&wal->lock);
+    if (wal->failed || wal->closing)
+    {
+        pthread_mutex_unlock(&wal->lock);
+        return 0;
+    }
+
+    if (wal->buffer_used + size > wal->buffer_capacity)
+    {
+        size_t capacity = wal->buffer_capacity * 2;
+        while (capacity < wal->buffer_used + size)
+            capacity *= 2;
+        char *grown = (char *)realloc(wal->buffer, capacity);
+        if (!grown)
+        {
+            pthread_mutex_unlock(&wal->lock);
+            return 0;
+        }
+        wal->buffer = grown;
+        wal->buffer_capacity = capacity;
+    }
+
+    // Sequence and position are taken together so the log is in sequence order.
+    // The caller has already applied the change, so the live manager now holds it.
+    record->sequence = wal->next_sequence++;
+    wal->manager->log_sequence = record->sequence;
+    record->checksum = record_checksum(record, text, (uint32_t)text_length);
+    memcpy(wal->buffer + wal->buffer_used, record, sizeof(WalRecord));
+    if (text_length)
+        memcpy(wal->buffer + wal->buffer_used + sizeof(WalRecord), text, text_length);
+    wal->buffer_used += size;
+
+    uint64_t sequence = record->sequence;
+    pthread_cond_signal(&wal->pending);
+    pthread_mutex_unlock(&wal->lock);
+    return sequence;
+}
+
+bool wal_sync(Wal *wal, uint64_t sequence)
+{
+    if (!wal || sequence == 0)
+        return false;
+
+    pthread_mutex_lock(&wal->lock);
+    while (wal->durable_sequence < sequence && !wal->failed)
+        pthread_cond_wait(&wal->durable, &wal->lock);
+    bool ok = wal->durable_sequence >= sequence;
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+bool wal_compact(Wal *wal)
+{
+    if (!wal)
+        return false;
+
+    pthread_mutex_lock(&wal->lock);
+    bool ok = !wal->failed && !wal->closing;
+    if (ok)
+    {
+        wal->compact_requested = true;
+        pthread_cond_signal(&wal->pending);
+    }
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+bool wal_checkpoint(Wal *wal)
+{
+    if (!wal)
+        return false;
+
+    // A running compaction would replace this snapshot with one folded from the old
+    pthread_mutex_lock(&wal->lock);
+    wal->checkpointing = true;
+    while (wal->compact_running)
+        pthread_cond_wait(&wal->compacted, &wal->lock);
+    pthread_mutex_unlock(&wal->lock);
+
+    // Records up to log_sequence stay in the logs; replay skips them
+    bool ok = save_tasks_to_file(wal->manager, wal->snapshot_path);
+
+    pthread_mutex_lock(&wal->lock);
+    wal->checkpointing = false;
+    pthread_cond_signal(&wal->pending); // A compaction may have been held back
+    pthread_mutex_unlock(&wal->lock);
+    return ok;
+}
+
+// --- Record Builders --- //
+
+static uint64_t log_record(Wal *wal, WalOp op, int id, int target, unsigned int priority, const char *text)
+{
+    WalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op = (uint8_t)op;
+    record.id = id;
+    record.target = target;
+    record.priority = priority;
+    return wal_append(wal, &record, text);
+}
+
+static uint64_t log_appointment(Wal *wal, WalOp op, int id, char date, Time time, MonthsInAYear month,
+                                bool have_reminder, RecurrenceType recurrence)
+{
+    WalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op = (uint8_t)op;
+    record.id = id;
+    record.flags = have_reminder ? SNAPSHOT_REMINDER : 0;
+    record.recurrence_type = (uint8_t)recurrence;
+    record.date = (uint8_t)date;
+    record.month = (uint8_t)month;
+    record.hour = (uint8_t)time.hour;
+    record.minutes = (uint8_t)time.minutes;
+    return wal_append(wal, &record, NULL);
+}
+
+uint64_t wal_log_add_task(Wal *wal, int id, const char *description, unsigned int priority)
+{
+    return log_record(wal, WAL_ADD_TASK, id, 0, priority, description);
+}
+
+uint64_t wal_log_update_task(Wal *wal, int id, const char *new_description, unsigned int new_priority)
+{
+    return log_record(wal, WAL_UPDATE_TASK, id, 0, new_priority, new_description);
+}
+
+uint64_t wal_log_delete_task(Wal *wal, int id)
+{
+    return log_record(wal, WAL_DELETE_TASK, id, 0, 0, NULL);
+}
+
+uint64_t wal_log_task_schedule(Wal *wal, int id, MonthsInAYear month, char date, Time time)
+{
+    WalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op = WAL_SCHEDULE_TASK;
+    record.id = id;
+    record.date = (uint8_t)date;
+    record.month = (uint8_t)month;
+    record.hour = (uint8_t)time.hour;
+    record.minutes = (uint8_t)time.minutes;
+    return wal_append(wal, &record, NULL);
+}
+
+uint64_t wal_log_task_completion(Wal *wal, int id, bool is_complete)
+{
+    WalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op = WAL_COMPLETE_TASK;
+    record.id = id;
+    record.flags = is_complete ? SNAPSHOT_COMPLETE : 0;
+    return wal_append(wal, &record, NULL);
+}
+
+uint64_t wal_log_add_subtask(Wal *wal, int task_id, const char *description, unsigned int priority)
+{
+    return log_record(wal, WAL_ADD_SUBTASK, task_id, 0, priority, description);
+}
+
+uint64_t wal_log_update_subtask(Wal *wal, int task_id, int position, const char *new_description, unsigned int new_priority)
+{
+    return log_record(wal, WAL_UPDATE_SUBTASK, task_id, position, new_priority, new_description);
+}
+
+uint64_t wal_log_delete_subtask(Wal *wal, int task_id, int position)
+{
+    return log_record(wal, WAL_DELETE_SUBTASK, task_id, position, 0, NULL);
+}
+
+uint64_t wal_log_add_appointment(Wal *wal, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence)
+{
+    return log_appointment(wal, WAL_ADD_APPOINTMENT, id, date, time, month, have_reminder, recurrence);
+}
+
+uint64_t wal_log_update_appointment(Wal *wal, int id, char date, Time time, MonthsInAYear month, bool have_reminder, RecurrenceType recurrence)
+{
+    return log_appointment(wal, WAL_UPDATE_APPOINTMENT, id, date, time, month, have_reminder, recurrence);
+}
+
+uint64_t wal_log_delete_appointment(Wal *wal, int id)
+{
+    return log_record(wal, WAL_DELETE_APPOINTMENT, id, 0, 0, NULL);
+}
+
+uint64_t wal_log_link_task(Wal *wal, int task_id, int appointment_id)
+{
+    return log_record(wal, WAL_LINK_TASK, task_id, appointment_id, 0, NULL);
+}
+
+uint64_t wal_log_task_note(Wal *wal, int task_id, const char *text)
+{
+    return log_record(wal, WAL_SET_TASK_NOTE, task_id, 0, 0, text);
+}
+
+uint64_t wal_log_appointment_note(Wal *wal, int appointment_id, const char *text)
+{
+    return log_record(wal, WAL_ADD_APPOINTMENT_NOTE, appointment_id, 0, 0, text);
+}
+
+uint64_t wal_log_task_reminder(Wal *wal, int id, bool have_reminder, RecurrenceType recurrence)
+{
+    WalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op = WAL_SET_TASK_REMINDER;
+    record.id = id;
+    record.flags = have_reminder ? SNAPSHOT_REMINDER : 0;
+    record.recurrence_type = (uint8_t)recurrence;
+    return wal_append(wal, &record, NULL);
+}
+
+uint64_t wal_log_arm_reminder(Wal *wal, int id, int64_t fire_at)
+{
+    return log_record(wal, WAL_ARM_REMINDER, id, (int32_t)(uint32_t)fire_at, (uint32_t)((uint64_t)fire_at >> 32), NULL);
+}
+
+uint64_t wal_log_reminder_spent(Wal *wal, int id)
+{
+    return log_record(wal, WAL_SPEND_REMINDER, id, 0, 0, NULL);
+}
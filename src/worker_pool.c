@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "../include/worker_pool.h"
+
+// The worker running on this thread, so jobs it spawns stay on its own deque
+static _Thread_local Worker *current_worker;
+
+// --- Deque (Chase-Lev) --- //
+
+static bool deque_push(WorkerDeque *deque, WorkerJob *job)
+{
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t top = atomic_load(&deque->top);
+    if (bottom - top >= WORKER_DEQUE_CAPACITY)
+        return false;
+
+    atomic_store_explicit(&deque->slots[bottom & (WORKER_DEQUE_CAPACITY - 1)], job, memory_order_relaxed);
+    atomic_store(&deque->bottom, bottom + 1);
+    return true;
+}
+
+// Owner only: the newest job, racing thieves only for the last one
+static WorkerJob *deque_pop(WorkerDeque *deque)
+{
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store(&deque->bottom, bottom);
+    int64_t top = atomic_load(&deque->top);
+
+    if (top > bottom)
+    {
+        atomic_store(&deque->bottom, bottom + 1);
+        return NULL;
+    }
+
+    WorkerJob *job = atomic_load_explicit(&deque->slots[bottom & (WORKER_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (top == bottom)
+    {
+        if (!atomic_compare_exchange_strong(&deque->top, &top, top + 1))
+            job = NULL;
+        atomic_store(&deque->bottom, bottom + 1);
+    }
+    return job;
+}
+
+// Any thread: the oldest job, or NULL if empty or another thief got there first
+static WorkerJob *deque_steal(WorkerDeque *deque)
+{
+    int64_t top = atomic_load(&deque->top);
+    int64_t bottom = atomic_load(&deque->bottom);
+    if (top >= bottom)
+        return NULL;
+
+    WorkerJob *job = atomic_load_explicit(&deque->slots[top & (WORKER_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    return atomic_compare_exchange_strong(&deque->top, &top, top + 1) ? job : NULL;
+}
+
+// --- Result Queue (intrusive MPSC) --- //
+
+static void push_result(WorkerPool *pool, WorkerJob *job)
+{
+    atomic_store_explicit(&job->result_next, NULL, memory_order_relaxed);
+    WorkerJob *previous = atomic_exchange(&pool->results_head, job);
+    atomic_store(&previous->result_next, job);
+}
+
+// Consumer only. NULL when empty, or when a producer is between its two steps;
+// that job is picked up by a later drain.
+static WorkerJob *pop_result(WorkerPool *pool)
+{
+    WorkerJob *tail = pool->results_tail;
+    WorkerJob *next = atomic_load(&tail->result_next);
+
+    if (tail == &pool->results_stub)
+    {
+        if (!next)
+            return NULL;
+        pool->results_tail = tail = next;
+        next = atomic_load(&tail->result_next);
+    }
+    if (next)
+    {
+        pool->results_tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load(&pool->results_head))
+        return NULL;
+
+    // tail is the only job left: put the stub behind it so it can be detached
+    push_result(pool, &pool->results_stub);
+    next = atomic_load(&tail->result_next);
+    if (next)
+    {
+        pool->results_tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+static void notify_results(WorkerPool *pool)
+{
+    if (!atomic_exchange(&pool->notified, true))
+    {
+        char byte = 1;
+        while (write(pool->notify[1], &byte, 1) < 0 && errno == EINTR)
+            ;
+    }
+}
+
+// --- Workers --- //
+
+static void inject(WorkerPool *pool, WorkerJob *job)
+{
+    job->queued_next = NULL;
+    if (pool->injected_tail)
+        pool->injected_tail->queued_next = job;
+    else
+        pool->injected_head = job;
+    pool->injected_tail = job;
+}
+
+static WorkerJob *take_injected(WorkerPool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    WorkerJob *job = pool->injected_head;
+    if (job)
+    {
+        pool->injected_head = job->queued_next;
+        if (!pool->injected_head)
+            pool->injected_tail = NULL;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return job;
+}
+
+static WorkerJob *find_job(Worker *worker)
+{
+    WorkerPool *pool = worker->pool;
+    WorkerJob *job = deque_pop(&worker->deque);
+    if (!job && atomic_load(&pool->pending) > 0)
+        job = take_injected(pool);
+
+    // Start from the last worker that had something to steal
+    for (int i = 0; !job && i < pool->worker_count; i++)
+    {
+        uint32_t victim = (worker->victim + i) % pool->worker_count;
+        if (victim != (uint32_t)worker->index && (job = deque_steal(&pool->workers[victim].deque)))
+        {
+            worker->victim = victim;
+            atomic_fetch_add_explicit(&worker->stolen, 1, memory_order_relaxed);
+        }
+    }
+
+    if (job)
+        atomic_fetch_sub(&pool->pending, 1);
+    return job;
+}
+
+static void *run_worker(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    WorkerPool *pool = worker->pool;
+    current_worker = worker;
+
+    // Per-thread on Linux: only the workers give way
+    setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), WORKER_NICE);
+
+    for (;;)
+    {
+        WorkerJob *job = find_job(worker);
+        if (job)
+        {
+            job->run(job);
+            atomic_fetch_add_explicit(&worker->executed, 1, memory_order_relaxed);
+            push_result(pool, job);
+            notify_results(pool);
+            continue;
+        }
+
+        // Submitters bump pending before they look at sleeping, so a job queued
+        // after this check still finds the worker waiting and signals it
+        pthread_mutex_lock(&pool->lock);
+        if (atomic_load(&pool->pending) == 0)
+        {
+            if (pool->stopping)
+            {
+                pthread_mutex_unlock(&pool->lock);
+                break;
+            }
+            atomic_fetch_add(&pool->sleeping, 1);
+            if (atomic_load(&pool->pending) == 0 && !pool->stopping)
+                pthread_cond_wait(&pool->wake, &pool->lock);
+            atomic_fetch_sub(&pool->sleeping, 1);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    current_worker = NULL;
+    return NULL;
+}
+
+// Workers finish what is queued before they exit
+static void stop_workers(WorkerPool *pool, int started)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < started; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+}
+
+static void release_pool(WorkerPool *pool)
+{
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    close(pool->notify[0]);
+    close(pool->notify[1]);
+    free(pool->workers);
+    free(pool);
+}
+
+// --- Pool Lifecycle --- //
+
+WorkerPool *create_worker_pool(int threads)
+{
+    if (threads <= 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 1 ? (int)cpus - 1 : 1;
+    }
+    if (threads > WORKER_MAX_THREADS)
+        threads = WORKER_MAX_THREADS;
+
+    WorkerPool *pool = (WorkerPool *)calloc(1, sizeof(WorkerPool));
+    Worker *workers = (Worker *)aligned_alloc(WORKER_CACHE_LINE, sizeof(Worker) * threads);
+    if (!pool || !workers || pipe(pool->notify) != 0)
+    {
+        printf("Memory allocation failed for WorkerPool.\n");
+        free(pool);
+        free(workers);
+        return NULL;
+    }
+    fcntl(pool->notify[0], F_SETFL, O_NONBLOCK);
+    fcntl(pool->notify[1], F_SETFL, O_NONBLOCK);
+
+    memset(workers, 0, sizeof(Worker) * threads);
+    pool->workers = workers;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    atomic_init(&pool->results_stub.result_next, NULL);
+    atomic_init(&pool->results_head, &pool->results_stub);
+    pool->results_tail = &pool->results_stub;
+
+    // Workers read worker_count while stealing, so it is set before any of them start
+    pool->worker_count = threads;
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].pool = pool;
+        workers[i].index = i;
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        if (pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) != 0)
+        {
+            printf("Could not start worker thread %d.\n", i);
+            stop_workers(pool, i);
+            release_pool(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void free_worker_pool(WorkerPool *pool)
+{
+    if (!pool)
+        return;
+
+    stop_workers(pool, pool->worker_count);
+
+    // Every job has run; hand back whatever was not drained
+    while (worker_pool_drain(pool, INT32_MAX))
+        ;
+    release_pool(pool);
+}
+
+// --- Jobs --- //
+
+bool worker_pool_submit(WorkerPool *pool, WorkerJob *job)
+{
+    if (!pool || !job || !job->run)
+        return false;
+
+    atomic_fetch_add(&pool->in_flight, 1);
+    Worker *worker = current_worker;
+    if (worker && worker->pool == pool)
+    {
+        atomic_fetch_add(&pool->pending, 1);
+        if (!deque_push(&worker->deque, job))
+        {
+            pthread_mutex_lock(&pool->lock);
+            inject(pool, job);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        if (atomic_load(&pool->sleeping) > 0)
+        {
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_signal(&pool->wake);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        return true;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->stopping)
+    {
+        pthread_mutex_unlock(&pool->lock);
+        atomic_fetch_sub(&pool->in_flight, 1);
+        return false;
+    }
+    inject(pool, job);
+    atomic_fetch_add(&pool->pending, 1);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    return true;
+}
+
+// --- Results --- //
+
+int worker_pool_fd(const WorkerPool *pool)
+{
+    return pool ? pool->notify[0] : -1;
+}
+
+int worker_pool_drain(WorkerPool *pool, int max)
+{
+    if (!pool)
+        return 0;
+
+    // Empty the pipe first, then re-arm, so a job finishing from here on writes again
+    char bytes[64];
+    while (read(pool->notify[0], bytes, sizeof(bytes)) > 0)
+        ;
+    atomic_store(&pool->notified, false);
+
+    int drained = 0;
+    WorkerJob *job;
+    while (drained < max && (job = pop_result(pool)))
+    {
+        drained++;
+        if (job->done)
+            job->done(job); // May free the job
+        atomic_fetch_sub(&pool->in_flight, 1);
+    }
+
+    // Left some behind: keep the descriptor readable
+    if (drained == max && atomic_load(&pool->in_flight) > 0)
+        notify_results(pool);
+    return drained;
+}
+
+void worker_pool_wait(WorkerPool *pool)
+{
+    while (pool && atomic_load(&pool->in_flight) > 0)
+    {
+        if (!worker_pool_drain(pool, INT32_MAX))
+        {
+            struct pollfd ready = {pool->notify[0], POLLIN, 0};
+            poll(&ready, 1, 10);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_TASKS 1000000
+#define RECURRING_TITLES 500
+#define UNIQUE_PERCENT 30
+
+static const char *chores[] = {"Water the plants", "Weekly review", "Pay rent", "Take out recycling",
+                               "Team standup notes", "Back up laptop", "Call parents", "Gym session"};
+static const char *steps[] = {"prepare", "check with the team", "sign off", "file the paperwork"};
+static const char *remarks[] = {"Moved from last week", "Needs a second pair of eyes", "Low effort"};
+
+static size_t heap_in_use(void)
+{
+    return mallinfo2().uordblks;
+}
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Mostly recurring tasks that repeat one of a few hundred titles, plus a share of one-off ones
+static TaskManager *build(int count)
+{
+    TaskManager *manager = create_task_manager();
+    char text[96];
+
+    srand(36);
+    for (int id = 1; id <= count && manager; id++)
+    {
+        if (rand() % 100 < UNIQUE_PERCENT)
+            snprintf(text, sizeof(text), "Follow up with client %d about invoice %d", id, rand());
+        else
+        {
+            int title = rand() % RECURRING_TITLES;
+            snprintf(text, sizeof(text), "%s (%d)", chores[title % 8], title);
+        }
+
+        add_task(manager, id, text, 1 + rand() % LOWEST_PRIORITY);
+        if (id % 5 == 0)
+            set_task_note(manager, id, remarks[rand() % 3]);
+        if (id % 10 == 0)
+        {
+            add_subtask(manager, id, steps[rand() % 4], 2);
+            add_subtask(manager, id, steps[rand() % 4], 3);
+        }
+        if (id % 50 == 0)
+        {
+            Time due = {0, 9};
+            add_appointment(manager, id, 1 + id % 28, due, (MonthsInAYear)(id % 12), true, WEEKLY);
+            add_appointment_note(manager, id, "Bring the signed form; room 4");
+            add_appointment_note(manager, id, remarks[id % 3]);
+        }
+    }
+    return manager;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+
+    size_t before = heap_in_use();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TaskManager *manager = build(count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (!manager)
+        return 1;
+    size_t used = heap_in_use() - before;
+
+    StringArena *strings = manager->strings;
+    printf("%d tasks built in %.1f ms\n", count, elapsed_ms(start, end));
+    printf("heap: %.1f MB, %.1f bytes/task\n", used / 1e6, (double)used / count);
+    printf("strings: %zu distinct for %zu references, arena %.1f MB\n", strings->count, strings->interned,
+           strings->bytes / 1e6);
+
+    // Every task still reads back its own text, and shared text is one copy
+    bool same = true;
+    Task *first = NULL;
+    for (int id = 1; same && id <= count; id++)
+    {
+        Task *task = find_task(manager, id);
+        same = task && task->description && (id % 5 != 0 || task->note) &&
+               (id % 10 != 0 || (task->subtasks && task->subtasks->size == 2));
+        if (same && strncmp(task->description, "Follow up", 9) != 0)
+        {
+            if (first && strcmp(first->description, task->description) == 0)
+                same = first->description == task->description;
+            else if (!first)
+                first = task;
+        }
+    }
+    Appointment *appointment = find_appointment(manager, 50);
+    same = same && appointment && note_blob_count(appointment->notes) == 2 &&
+           strcmp(note_blob_first(appointment->notes), "Bring the signed form; room 4") == 0;
+
+    // Releasing the last reference gives the slot back
+    for (int id = 1; id <= count; id++)
+        update_task(manager, id, "Archived", LOWEST_PRIORITY);
+    printf("after renaming every task: %zu distinct strings\n", strings->count);
+    same = same && strings->count < 16;
+
+    printf("Text intact and shared: %s\n", same ? "yes" : "NO");
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
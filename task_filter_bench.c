@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_filter.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_TASKS 1000000
+#define REPEATS 200
+
+typedef struct NamedFilter {
+    const char *name;
+    TaskFilter filter;
+} NamedFilter;
+
+static NamedFilter filters[] = {
+    {"incomplete, due 03/14", {0, HIGHEST_PRIORITY, LOWEST_PRIORITY, MARCH, 14}},
+    {"incomplete, P1-P2", {0, 1, 2, -1, 0}},
+    {"complete in June", {1, HIGHEST_PRIORITY, LOWEST_PRIORITY, JUNE, 0}},
+    {"P3 in December", {-1, 3, 3, DECEMBER, 0}},
+};
+#define FILTERS (int)(sizeof(filters) / sizeof(filters[0]))
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static TaskManager *build(int count)
+{
+    TaskManager *manager = create_task_manager();
+    char description[48];
+
+    srand(38);
+    for (int id = 1; id <= count && manager; id++)
+    {
+        snprintf(description, sizeof(description), "Task %d", id);
+        add_task(manager, id, description, 1 + rand() % LOWEST_PRIORITY);
+        Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+        set_task_completion(manager, id, rand() % 3 == 0);
+    }
+    return manager;
+}
+
+// The same fused filter through the scalar kernel, to show what the vector path buys
+static void select_scalar(const TaskStore *store, const TaskFilter *filter, uint64_t *out)
+{
+    uint8_t want = filter->completion > 0 ? TASK_STORE_COMPLETE : 0;
+    SelectTerm terms[SELECT_MAX_TERMS];
+    int count = 0;
+    if (filter->completion >= 0)
+        terms[count++] = make_term(store->flags, TASK_STORE_COMPLETE, want, want);
+    terms[count++] = make_term(store->priority, 0xFF, filter->min_priority, filter->max_priority);
+    if (filter->month >= 0)
+        terms[count++] = make_term(store->month, 0xFF, filter->month, filter->month);
+    if (filter->date > 0)
+        terms[count++] = make_term(store->date, 0xFF, filter->date, filter->date);
+    select_terms_scalar(terms, count, 0, store->count, out);
+}
+
+// (incomplete AND P1) OR due 03/14, built from single-column selections
+static void select_composed(const TaskStore *store, uint64_t *out, uint64_t *scratch, size_t words)
+{
+    task_select_masked(store, TASK_COLUMN_FLAGS, TASK_STORE_COMPLETE, 0, out);
+    task_select_range(store, TASK_COLUMN_PRIORITY, 1, 1, scratch);
+    selection_and(out, out, scratch, words);
+
+    uint64_t *day = scratch;
+    task_select_range(store, TASK_COLUMN_MONTH, MARCH, MARCH, day);
+    uint64_t *date = scratch + words;
+    task_select_range(store, TASK_COLUMN_DATE, 14, 14, date);
+    selection_and(day, day, date, words);
+    selection_or(out, out, day, words);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+
+    TaskManager *manager = build(count);
+    if (!manager)
+        return 1;
+
+    const TaskStore *store = &manager->store;
+    size_t words = selection_words(store->count);
+    uint64_t *bits = (uint64_t *)malloc(sizeof(uint64_t) * words);
+    uint64_t *scratch = (uint64_t *)malloc(sizeof(uint64_t) * words * 2);
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    uint32_t *scanned = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    if (!bits || !scratch || !slots || !scanned)
+        return 1;
+
+    printf("%d tasks, AVX2 kernels: %s\n", count, task_filter_simd() ? "yes" : "no");
+
+    bool same = true;
+    double mix_ms[3] = {0, 0, 0};
+    for (int f = 0; f < FILTERS; f++)
+    {
+        const TaskFilter *filter = &filters[f].filter;
+        double ms[3];
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS / 10; r++)
+            task_store_count(store, filter);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ms[0] = elapsed_ms(start, end) / (REPEATS / 10);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS / 10; r++)
+            select_scalar(store, filter, scratch);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ms[1] = elapsed_ms(start, end) / (REPEATS / 10);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            task_select(store, filter, bits);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ms[2] = elapsed_ms(start, end) / REPEATS;
+
+        // The bitmap selects exactly the slots the byte-at-a-time scan finds
+        int selected = selection_slots(bits, words, slots, count);
+        int expected = task_store_scan(store, filter, scanned, count);
+        same = same && selected == expected && memcmp(slots, scanned, sizeof(uint32_t) * selected) == 0 &&
+               selection_count(bits, words) == (uint32_t)selected &&
+               memcmp(bits, scratch, sizeof(uint64_t) * words) == 0;
+
+        for (int k = 0; k < 3; k++)
+            mix_ms[k] += ms[k];
+        printf("%-22s %7d rows  block scan %6.1f M rows/s  scalar bitmap %6.1f M rows/s  kernel %7.1f M rows/s\n",
+               filters[f].name, selected, count / ms[0] / 1e3, count / ms[1] / 1e3, count / ms[2] / 1e3);
+    }
+    printf("filter mix: block scan %.2f G rows/s, scalar bitmap %.2f G rows/s, kernel %.2f G rows/s\n",
+           FILTERS * (double)count / mix_ms[0] / 1e6, FILTERS * (double)count / mix_ms[1] / 1e6,
+           FILTERS * (double)count / mix_ms[2] / 1e6);
+
+    // Composition: four single-column kernels, two ANDs and an OR
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < REPEATS; r++)
+        select_composed(store, bits, scratch, words);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double composed_ms = elapsed_ms(start, end) / REPEATS;
+
+    uint32_t composed = 0;
+    for (uint32_t slot = 0; slot < store->count; slot++)
+        composed += (!(store->flags[slot] & TASK_STORE_COMPLETE) && store->priority[slot] == 1) ||
+                    (store->month[slot] == MARCH && store->date[slot] == 14);
+    same = same && selection_count(bits, words) == composed;
+    printf("(incomplete AND P1) OR due 03/14: %u rows in %.3f ms (%.2f G rows/s)\n", composed, composed_ms,
+           count / composed_ms / 1e6);
+
+    printf("Bitmaps match scans: %s\n", same ? "yes" : "NO");
+    free(bits);
+    free(scratch);
+    free(slots);
+    free(scanned);
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
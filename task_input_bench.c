@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pty.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/recurrence.c"
+#include "src/task_manager.c"
+#include "src/worker_pool.c"
+#include "src/task_viewport.c"
+#include "src/task_view.c"
+#include "src/task_input.c"
+
+#define DEFAULT_TASKS 100000
+#define SCREEN_ROWS 50
+#define SCREEN_COLUMNS 160
+#define HELD_KEYS 2000
+#define HELD_INTERVAL_US 500         // Auto-repeat far faster than a person, as from a macro or a stuck key
+#define PASTES 4
+#define PASTE_BYTES 500
+#define PASTE_GAP_US 200000
+#define MAX_SENT (HELD_KEYS + PASTES * PASTE_BYTES)
+
+// Commands as someone might paste them: walk, reprioritise, complete
+static const char paste_pattern[] = "jjjj+jj-xkk jj+b";
+
+typedef struct Script {
+    int master;
+    const char *keys;                // One byte per key
+    int count;
+    int burst;                       // Keys written together
+    int interval_us;                 // Between writes
+    int64_t sent_us[MAX_SENT];
+} Script;
+
+static _Atomic bool draining = true;
+static bool job_done;
+
+static int64_t now_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int compare_int64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// The terminal's side of the pty: swallow what curses writes
+static void *drain_terminal(void *arg)
+{
+    int master = *(int *)arg;
+    char buffer[65536];
+    while (atomic_load(&draining) && read(master, buffer, sizeof(buffer)) > 0)
+        ;
+    return NULL;
+}
+
+static void run_nothing(WorkerJob *job)
+{
+    (void)job;
+    usleep(20000);
+}
+
+static void finish_nothing(WorkerJob *job)
+{
+    (void)job;
+    job_done = true;
+}
+
+static void count_reminder(TaskManager *manager, Task *task, void *context)
+{
+    (void)manager;
+    (void)task;
+    (*(int *)context)++;
+}
+
+// The keyboard: writes the script to the pty, stamping each key as it goes
+static void *type_script(void *arg)
+{
+    Script *script = (Script *)arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (int at = 0; at < script->count; at += script->burst)
+    {
+        int length = script->count - at < script->burst ? script->count - at : script->burst;
+        int64_t stamp = now_us();
+        for (int i = 0; i < length; i++)
+            script->sent_us[at + i] = stamp;
+        if (write(script->master, script->keys + at, length) != length)
+            break;
+
+        next.tv_nsec += (long)script->interval_us * 1000;
+        next.tv_sec += next.tv_nsec / 1000000000;
+        next.tv_nsec %= 1000000000;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+// Runs the loop until every key of the script has reached the screen. Latency
+// is from the write to the pty to the doupdate after the loop applied the key.
+static void run_script(TaskInputLoop *loop, Script *script, const char *label, int64_t *latencies)
+{
+    loop->stats = (TaskInputStats){0};
+    pthread_t typist;
+    pthread_create(&typist, NULL, type_script, script);
+
+    int seen = 0;
+    while (seen < script->count)
+    {
+        int handled = task_input_frame(loop, 100);
+        for (int i = 0; i < handled && seen < script->count; i++, seen++)
+            latencies[seen] = loop->last_flush_us - script->sent_us[seen];
+    }
+    pthread_join(typist, NULL);
+
+    qsort(latencies, script->count, sizeof(int64_t), compare_int64);
+    const TaskInputStats *stats = &loop->stats;
+    printf("  %-22s %5llu frames %5llu updates   p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms   in loop p99 < %.2f ms\n",
+           label, (unsigned long long)stats->frames, (unsigned long long)stats->updates, latencies[seen / 2] / 1e3,
+           latencies[(int)(seen * 0.99)] / 1e3, latencies[seen - 1] / 1e3,
+           task_input_latency_percentile(stats, 0.99) / 1e3);
+}
+
+// The list's rows against the agenda window at the viewport's top
+static bool screen_matches(TaskView *view)
+{
+    char expected[TASK_VIEW_MAX_COLUMNS + 1], actual[TASK_VIEW_MAX_COLUMNS + 1];
+    Task *window[TASK_VIEW_MAX_ROWS];
+    int width = view->columns - 1;
+    int count = task_order_window(&view->manager->agenda_index, task_viewport_top(&view->viewport), window,
+                                  view->rows);
+    for (int row = 0; row < view->rows; row++)
+    {
+        if (row < count)
+            task_view_format_task(window[row], expected, width);
+        else
+            pad_line(expected, 0, width);
+        mvwinnstr(view->window, 1 + row, 0, actual, width);
+        if (strcmp(expected, actual) != 0)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int task_count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    int master, slave;
+    struct winsize size = {SCREEN_ROWS, SCREEN_COLUMNS, 0, 0};
+    if (openpty(&master, &slave, NULL, NULL, &size) != 0)
+    {
+        printf("Could not open a pseudo-terminal.\n");
+        return 1;
+    }
+    pthread_t drainer;
+    pthread_create(&drainer, NULL, drain_terminal, &master);
+
+    unsetenv("LINES");
+    unsetenv("COLUMNS");
+    FILE *output = fdopen(slave, "w");
+    FILE *input = fdopen(dup(slave), "r");
+    SCREEN *screen = newterm("xterm-256color", output, input);
+    static Script script;
+    int64_t *latencies = (int64_t *)malloc(sizeof(int64_t) * MAX_SENT);
+    char *keys = (char *)malloc(MAX_SENT);
+    TaskManager *manager = create_task_manager();
+    if (!screen || !latencies || !keys || !manager)
+        return 1;
+    set_term(screen);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    raw();
+    noecho();
+    curs_set(0);
+
+    srand(50);
+    for (int id = 1; id <= task_count; id++)
+    {
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        add_task(manager, id, "Follow up on the vendor contract renewal", 1 + rand() % LOWEST_PRIORITY);
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), time);
+    }
+    TaskView *view = create_task_view(manager, stdscr);
+    if (!view)
+        return 1;
+    printf("%d tasks, %dx%d terminal, frame budget %d us\n", task_count, SCREEN_ROWS, SCREEN_COLUMNS,
+           TASK_INPUT_FRAME_BUDGET_US);
+
+    // A reminder that came due while the loop was not running fires on its first frame,
+    // promotes the task and redraws without a key
+    int reminded = 0;
+    TaskInputLoop first;
+    task_input_init(&first, view, fileno(input), NULL, NULL);
+    set_reminder_handler(manager, count_reminder, &reminded);
+    update_task(manager, 1, NULL, LOWEST_PRIORITY);
+    arm_task_reminder(manager, 1, recurrence_stamp(2020, JANUARY, 1, (Time){0, 9}));
+    bool ok = task_input_frame(&first, 0) == 0 && first.stats.reminders == 1 && first.stats.frames == 1 &&
+              reminded == 1 && find_task(manager, 1)->priority == HIGHEST_PRIORITY &&
+              !find_task(manager, 1)->have_reminder;
+    printf("Due reminder fired on the first frame: %s\n", ok ? "yes" : "NO");
+
+    script.master = master;
+    for (int batched = 0; batched < 2 && ok; batched++)
+    {
+        TaskInputLoop loop;
+        task_input_init(&loop, view, fileno(input), NULL, NULL);
+        loop.max_batch = batched ? TASK_INPUT_MAX_BATCH : 1;
+        loop.coalesce = batched;
+        printf("%s\n", batched ? "Batched and coalesced" : "One key per frame");
+
+        // A held key on the tree screen, whose frames cost the most
+        int start = task_count / 4;
+        task_view_set_mode(view, TASK_VIEW_TREE);
+        task_view_jump(view, start);
+        memset(keys, 'j', HELD_KEYS);
+        script.keys = keys;
+        script.count = HELD_KEYS;
+        script.burst = 1;
+        script.interval_us = HELD_INTERVAL_US;
+        run_script(&loop, &script, "held key, tree", latencies);
+        ok = task_viewport_position(&view->viewport) == start + HELD_KEYS;
+
+        // Pasted commands on the list
+        task_view_set_mode(view, TASK_VIEW_LIST);
+        task_view_jump(view, start);
+        for (int i = 0; i < PASTES * PASTE_BYTES; i++)
+            keys[i] = paste_pattern[i % (sizeof(paste_pattern) - 1)];
+        script.count = PASTES * PASTE_BYTES;
+        script.burst = PASTE_BYTES;
+        script.interval_us = PASTE_GAP_US;
+        run_script(&loop, &script, "pasted commands, list", latencies);
+        ok = ok && screen_matches(view) && manager->agenda_index.size == task_count;
+    }
+
+    // A finished background job wakes an idle loop
+    WorkerPool *pool = create_worker_pool(1);
+    WorkerJob job = {.run = run_nothing, .done = finish_nothing};
+    TaskInputLoop loop;
+    task_input_init(&loop, view, fileno(input), NULL, pool);
+    ok = ok && pool && worker_pool_submit(pool, &job);
+    for (int frame = 0; ok && frame < 5 && !job_done; frame++)
+        task_input_frame(&loop, 1000);
+    ok = ok && job_done;
+    free_worker_pool(pool);
+
+    // q ends the loop and nothing after it is applied
+    task_input_init(&loop, view, fileno(input), NULL, NULL);
+    ok = ok && write(master, "qj", 2) == 2;
+    int position = task_viewport_position(&view->viewport);
+    int frames = 0;
+    while (ok && frames++ < 50 && task_input_frame(&loop, 100) >= 0)
+        ;
+    ok = ok && loop.quit && task_viewport_position(&view->viewport) == position;
+
+    free_task_view(view);
+    endwin();
+    delscreen(screen);
+    atomic_store(&draining, false);
+    fclose(output);
+    fclose(input);
+    close(master);
+    pthread_join(drainer, NULL);
+    free_task_manager(manager);
+    free(latencies);
+    free(keys);
+
+    printf("Loop applied every key: %s\n", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include "include/task_manager.h"
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_OPERATIONS 1000000
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Walks every structure once and checks they agree with each other
+static bool check_consistency(TaskManager *manager, int live)
+{
+    unsigned int previous_priority = HIGHEST_PRIORITY;
+    int listed = 0;
+
+    for (Node *node = manager->task_list->head; node; node = node->next, listed++)
+    {
+        Task *task = (Task *)node->data->value;
+        const TaskStore *store = &manager->store;
+        if (task->priority < previous_priority || task->list_node != node ||
+            find_task(manager, task->id) != task || task_store_task(store, task->store_slot) != task ||
+            store->priority[task->store_slot] != task->priority ||
+            store->date[task->store_slot] != (uint8_t)task->date ||
+            (store->flags[task->store_slot] & TASK_STORE_COMPLETE) != (task->is_complete ? TASK_STORE_COMPLETE : 0))
+            return false;
+        previous_priority = task->priority;
+    }
+
+    int grouped = 0;
+    for (unsigned int p = HIGHEST_PRIORITY; p <= LOWEST_PRIORITY; p++)
+    {
+        AVLNode *group = find_avl(manager->task_tree, manager->task_tree->root, &p);
+        grouped += group ? (int)group->list->size : 0;
+    }
+
+    int ordered = 0;
+    for (task_order_index_node *node = task_order_index_first(&manager->agenda_index); node;
+         node = task_order_index_next(node), ordered++)
+    {
+        if (task_order_index_select(&manager->agenda_index, ordered) != node ||
+            task_order_index_rank(&manager->agenda_index, node->key) != ordered)
+            return false;
+    }
+
+    return listed == live && grouped == live && ordered == live && manager->store.count == (uint32_t)live;
+}
+
+int main(int argc, char **argv)
+{
+    int operations = argc > 1 ? atoi(argv[1]) : DEFAULT_OPERATIONS;
+    TaskManager *manager = create_task_manager();
+    int *ids = (int *)malloc(sizeof(int) * operations);
+    if (!manager || !ids)
+        return 1;
+
+    long counts[6] = {0};
+    int live = 0, next_id = 0;
+    Task *agenda[32];
+    struct timespec start, end;
+
+    srand(2024);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < operations; i++)
+    {
+        int roll = rand() % 100;
+
+        // Keep the store growing: adds win whenever it is nearly empty
+        if (roll < 35 || live < 16)
+        {
+            int id = next_id++;
+            if (add_task(manager, id, "benchmark task", 1 + rand() % LOWEST_PRIORITY))
+                ids[live++] = id;
+            counts[0]++;
+            continue;
+        }
+
+        int slot = rand() % live;
+        int id = ids[slot];
+
+        if (roll < 55)
+        {
+            update_task(manager, id, NULL, 1 + rand() % LOWEST_PRIORITY);
+            counts[1]++;
+        }
+        else if (roll < 65)
+        {
+            Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+            set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+            counts[2]++;
+        }
+        else if (roll < 72)
+        {
+            set_task_completion(manager, id, rand() % 2);
+            counts[3]++;
+        }
+        else if (roll < 90)
+        {
+            if (rand() % 4 == 0)
+                get_agenda(manager, HIGHEST_PRIORITY, LOWEST_PRIORITY, agenda, 32);
+            else
+                find_task(manager, id);
+            counts[4]++;
+        }
+        else
+        {
+            delete_task(manager, id);
+            ids[slot] = ids[--live];
+            counts[5]++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ms = elapsed_ms(start, end);
+
+    printf("%d operations in %.2f ms (%.0f ops/sec), %d live tasks\n",
+           operations, ms, operations / (ms / 1e3), live);
+    printf("add %ld, reprioritise %ld, schedule %ld, complete %ld, lookup %ld, delete %ld\n",
+           counts[0], counts[1], counts[2], counts[3], counts[4], counts[5]);
+    printf("Structures consistent: %s\n", check_consistency(manager, live) ? "yes" : "NO");
+
+    free_task_manager(manager);
+    free(ids);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "include/task_manager.h"
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+static void print_agenda(TaskManager *manager, unsigned int low, unsigned int high)
+{
+    Task *agenda[16];
+    int count = get_agenda(manager, low, high, agenda, 16);
+
+    printf("Agenda P%u-P%u:", low, high);
+    for (int i = 0; i < count; i++)
+        printf(" #%d", agenda[i]->id);
+    printf("\n");
+}
+
+int main()
+{
+    TaskManager *manager = create_task_manager();
+    if (!manager)
+    {
+        printf("Failed to create task manager.\n");
+        return 1;
+    }
+
+    add_task(manager, 1, "File taxes", 3);
+    add_task(manager, 2, "Buy milk", 5);
+    add_task(manager, 3, "Call plumber", 1);
+    add_task(manager, 4, "Book flights", 3);
+    add_task(manager, 5, "Renew passport", 3);
+
+    Time morning = {30, 9};
+    Time evening = {0, 18};
+    set_task_schedule(manager, 1, APRIL, 15, evening);
+    set_task_schedule(manager, 4, MARCH, 2, morning);
+    set_task_schedule(manager, 5, APRIL, 15, morning);
+
+    // Expected: 3, then the priority 3 tasks by due time (4, 5, 1), then 2
+    print_agenda(manager, HIGHEST_PRIORITY, LOWEST_PRIORITY);
+
+    set_task_completion(manager, 4, true);
+    update_task(manager, 2, NULL, 2);
+    delete_task(manager, 3);
+
+    // Expected: 2, 5, 1
+    print_agenda(manager, HIGHEST_PRIORITY, LOWEST_PRIORITY);
+    // Expected: 5, 1
+    print_agenda(manager, 3, 3);
+
+    printf("Duplicate id rejected: %s\n", add_task(manager, 1, "Again", 2) == NULL ? "yes" : "no");
+    printf("Date 40 rejected: %s\n", set_task_schedule(manager, 1, APRIL, 40, evening) == NULL ? "yes" : "no");
+    printf("Task 4 found after completion: %s\n", find_task(manager, 4) ? "yes" : "no");
+
+    // The task list stays grouped by priority with moved tasks at the end of their group
+    update_task(manager, 5, NULL, 2);
+    printf("Task list order:");
+    for (Node *node = manager->task_list->head; node; node = node->next)
+        printf(" #%d", ((Task *)node->data->value)->id);
+    printf("\n"); // Expected: #2 #5 #1 #4
+
+    add_subtask(manager, 1, "Find receipts", 2);
+    add_subtask(manager, 1, "Fill in forms", 3);
+    update_subtask(manager, 1, 1, "Fill in and sign forms", 3);
+    delete_subtask(manager, 1, 0);
+    printf("Task 1 subtasks: %d, first: %s\n", list_size(find_task(manager, 1)->subtasks),
+           ((SubTask *)find_task(manager, 1)->subtasks->head->data->value)->description);
+
+    add_appointment(manager, 10, 14, evening, APRIL, true, NONE);
+    add_appointment(manager, 11, 3, morning, MAY, false, WEEKLY);
+    link_task_to_appointment(manager, 1, 10);
+    delete_appointment(manager, 11);
+    printf("Appointment 10 linked to task: %d\n", find_appointment(manager, 10)->linked_task->id);
+
+    Calendar calendar = {0};
+    calendar.year = 26;
+    add_task_to_calendar(manager, &calendar, 1);
+    add_appointment_to_calendar(manager, &calendar, 10);
+    printf("Calendar holds %d task(s) and %d appointment(s)\n",
+           list_size(calendar.tasks), list_size(calendar.appointments));
+
+    const CalendarDay *april[CALENDAR_DAYS];
+    int days = calendar_month_view(calendar.days, CALENDAR_BASE_YEAR + calendar.year, APRIL, april);
+    for (int day = 0; day < days; day++)
+    {
+        if (april[day] && (april[day]->task_count || april[day]->appointment_count))
+            printf("April %d: %u task(s), %u appointment(s)\n", day + 1, april[day]->task_count,
+                   april[day]->appointment_count);
+    }
+    free_calendar(&calendar);
+
+    print_all_tasks(manager);
+    print_all_appointments(manager);
+    free_task_manager(manager);
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_TASKS 1000000
+#define CHURN 200000
+#define REPEATS 20
+
+typedef struct StatusQuery {
+    const char *name;
+    int completion;
+    int recurrence;
+    int reminder;
+} StatusQuery;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Most tasks do not repeat; the rest spread over the recurrence types
+static RecurrenceType random_recurrence(void)
+{
+    return rand() % 10 < 6 ? NONE : (RecurrenceType)(1 + rand() % YEARLY);
+}
+
+static bool task_matches(const Task *task, const StatusQuery *query)
+{
+    return (query->completion < 0 || task->is_complete == (query->completion > 0)) &&
+           (query->recurrence < 0 || task->recurrence_type == (RecurrenceType)query->recurrence) &&
+           (query->reminder < 0 || task->have_reminder == (query->reminder > 0));
+}
+
+static void add_random_task(TaskManager *manager, int id)
+{
+    add_task(manager, id, "Recurring chore", 1 + rand() % LOWEST_PRIORITY);
+    set_task_reminder(manager, id, rand() % 10 < 3, random_recurrence());
+    set_task_completion(manager, id, rand() % 3 == 0);
+}
+
+// Every slot is in exactly one bitmap of each family, the one its columns say
+static bool indexes_consistent(const TaskStore *store)
+{
+    uint64_t completion = 0, reminder = 0, recurrence = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        completion += roaring_cardinality(&store->by_completion[i]);
+        reminder += roaring_cardinality(&store->by_reminder[i]);
+    }
+    for (int i = 0; i < TASK_STORE_RECURRENCES; i++)
+        recurrence += roaring_cardinality(&store->by_recurrence[i]);
+    if (completion != store->count || reminder != store->count || recurrence != store->count)
+        return false;
+
+    for (uint32_t slot = 0; slot < store->count; slot++)
+    {
+        const Task *task = store->tasks[slot];
+        if (!roaring_contains(&store->by_completion[task->is_complete], slot) ||
+            !roaring_contains(&store->by_reminder[task->have_reminder], slot) ||
+            !roaring_contains(&store->by_recurrence[task->recurrence_type], slot))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+
+    TaskManager *manager = create_task_manager();
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    Task **tasks = (Task **)malloc(sizeof(Task *) * count);
+    int *ids = (int *)malloc(sizeof(int) * count);
+    if (!manager || !slots || !tasks || !ids)
+        return 1;
+
+    srand(39);
+    for (int id = 1; id <= count; id++)
+    {
+        add_random_task(manager, id);
+        ids[id - 1] = id;
+    }
+
+    // Incremental maintenance: every kind of change that moves a task between bitmaps
+    int next_id = count + 1;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int op = 0; op < CHURN; op++)
+    {
+        int pick = rand() % count, id = ids[pick];
+        switch (rand() % 4)
+        {
+        case 0:
+            set_task_completion(manager, id, rand() % 2);
+            break;
+        case 1:
+            set_task_reminder(manager, id, rand() % 2, random_recurrence());
+            break;
+        case 2:
+            update_task(manager, id, NULL, 1 + rand() % LOWEST_PRIORITY);
+            break;
+        default:
+            delete_task(manager, id);
+            add_random_task(manager, next_id);
+            ids[pick] = next_id++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d tasks, %d updates in %.1f ms (%.0f ns/update including the other indexes)\n", count, CHURN,
+           elapsed_ms(start, end), elapsed_ms(start, end) * 1e6 / CHURN);
+
+    const TaskStore *store = &manager->store;
+    bool same = indexes_consistent(store);
+
+    size_t bytes = 0;
+    for (int i = 0; i < 2; i++)
+        bytes += roaring_memory(&store->by_completion[i]) + roaring_memory(&store->by_reminder[i]);
+    for (int i = 0; i < TASK_STORE_RECURRENCES; i++)
+        bytes += roaring_memory(&store->by_recurrence[i]);
+    printf("status bitmaps: %.2f MB (%.2f bytes/task)\n", bytes / 1e6, (double)bytes / count);
+
+    StatusQuery queries[] = {
+        {"incomplete + weekly + reminder", 0, WEEKLY, 1},
+        {"incomplete + yearly", 0, YEARLY, -1},
+        {"complete + no reminder", 1, -1, 0},
+        {"repeats daily", -1, DAILY, -1},
+    };
+
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++)
+    {
+        const StatusQuery *query = &queries[q];
+
+        int walked = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+        {
+            walked = 0;
+            for (Node *node = manager->task_list->head; node; node = node->next)
+            {
+                Task *task = (Task *)node->data->value;
+                if (task_matches(task, query))
+                    tasks[walked++] = task;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double walk_ms = elapsed_ms(start, end) / REPEATS;
+
+        int found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            found = task_store_status_query(store, query->completion, query->recurrence, query->reminder, slots,
+                                            count);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double bitmap_ms = elapsed_ms(start, end) / REPEATS;
+
+        uint64_t counted = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            counted = task_store_status_count(store, query->completion, query->recurrence, query->reminder);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double count_ms = elapsed_ms(start, end) / REPEATS;
+
+        same = same && walked == found && counted == (uint64_t)found;
+        for (int i = 0; same && i < found; i++)
+            same = (i == 0 || slots[i - 1] < slots[i]) && task_matches(task_store_task(store, slots[i]), query);
+
+        printf("%-32s %7d tasks  list walk %7.2f ms  bitmaps %6.3f ms  count %6.3f ms\n", query->name, found,
+               walk_ms, bitmap_ms, count_ms);
+    }
+
+    Task *first[8];
+    int listed = find_tasks_by_status(manager, 0, WEEKLY, 1, first, 8);
+    for (int i = 0; same && i < listed; i++)
+        same = !first[i]->is_complete && first[i]->recurrence_type == WEEKLY && first[i]->have_reminder;
+
+    printf("Bitmap indexes consistent with the tasks: %s\n", same ? "yes" : "NO");
+    free(slots);
+    free(tasks);
+    free(ids);
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+
+#define DEFAULT_TASKS 1000000
+#define REPEATS 10
+#define MAX_MATCHES 2000000
+
+typedef struct NamedFilter {
+    const char *name;
+    TaskFilter filter;
+} NamedFilter;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static bool task_passes(const Task *task, const TaskFilter *filter)
+{
+    return (filter->completion < 0 || task->is_complete == (filter->completion > 0)) &&
+           task->priority >= filter->min_priority && task->priority <= filter->max_priority &&
+           (filter->month < 0 || (int)task->month == filter->month) &&
+           (filter->date <= 0 || task->date == filter->date);
+}
+
+// The old way: follow the priority list and look at every Task
+static int walk_list(TaskManager *manager, const TaskFilter *filter, Task **out)
+{
+    int count = 0;
+    for (Node *node = manager->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        if (task_passes(task, filter))
+            out[count++] = task;
+    }
+    return count;
+}
+
+static TaskManager *build(int count)
+{
+    TaskManager *manager = create_task_manager();
+    char description[48];
+
+    srand(37);
+    for (int id = 1; id <= count && manager; id++)
+    {
+        snprintf(description, sizeof(description), "Task %d", id);
+        add_task(manager, id, description, 1 + rand() % LOWEST_PRIORITY);
+        Time due = {(char)(rand() % 60), (char)(rand() % 24)};
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), due);
+        set_task_completion(manager, id, rand() % 3 == 0);
+    }
+
+    // Some churn, so slots are no longer in id order
+    for (int id = 1; id <= count && manager; id += 7)
+    {
+        delete_task(manager, id);
+        add_task(manager, id, "Re-added", 1 + id % LOWEST_PRIORITY);
+    }
+    return manager;
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    struct timespec start, end;
+
+    TaskManager *manager = build(count);
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * MAX_MATCHES);
+    Task **tasks = (Task **)malloc(sizeof(Task *) * MAX_MATCHES);
+    if (!manager || !slots || !tasks)
+        return 1;
+
+    NamedFilter filters[] = {
+        {"incomplete, due 03/14", {0, HIGHEST_PRIORITY, LOWEST_PRIORITY, MARCH, 14}},
+        {"incomplete, P1-P2", {0, 1, 2, -1, 0}},
+        {"complete in June", {1, HIGHEST_PRIORITY, LOWEST_PRIORITY, JUNE, 0}},
+        {"everything", task_filter_all()},
+    };
+
+    bool same = manager->store.count == (uint32_t)count;
+    for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+    {
+        const TaskFilter *filter = &filters[f].filter;
+
+        int listed = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            listed = walk_list(manager, filter, tasks);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double list_ms = elapsed_ms(start, end) / REPEATS;
+
+        int scanned = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            scanned = task_store_scan(&manager->store, filter, slots, MAX_MATCHES);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double scan_ms = elapsed_ms(start, end) / REPEATS;
+
+        uint32_t counted = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < REPEATS; r++)
+            counted = task_store_count(&manager->store, filter);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double count_ms = elapsed_ms(start, end) / REPEATS;
+
+        // Same tasks either way: every scanned slot passes and the totals agree
+        same = same && listed == scanned && (uint32_t)scanned == counted;
+        for (int i = 0; same && i < scanned; i++)
+            same = task_passes(task_store_task(&manager->store, slots[i]), filter);
+
+        printf("%-22s %7d matches  list walk %7.2f ms (%6.1f M rows/s)  column scan %6.2f ms (%7.1f M rows/s)"
+               "  count %5.2f ms (%7.1f M rows/s)\n",
+               filters[f].name, scanned, list_ms, count / list_ms / 1e3, scan_ms, count / scan_ms / 1e3,
+               count_ms, count / count_ms / 1e3);
+    }
+
+    printf("Column scans match list walks: %s\n", same ? "yes" : "NO");
+    free(slots);
+    free(tasks);
+    free_task_manager(manager);
+    return same ? 0 : 1;
+}
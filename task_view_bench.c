@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pty.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/task_viewport.c"
+#include "src/task_view.c"
+
+#define SCREEN_ROWS 50
+#define SCREEN_COLUMNS 160
+#define FRAMES 2000
+#define EDIT_EVERY 4                 // One keypress in this many edits a task; the rest scroll
+#define FULL_REDRAW_FRAMES 200       // The old way is slow enough that fewer frames tell the story
+#define CALENDAR_FRAMES 500
+#define TREE_FRAMES 500
+#define PRINT_FRAMES 3               // Whole-map dumps, for the tree screen's baseline
+#define CHAIN_NODES 1000000          // A degenerate tree, deeper than any call stack
+
+static _Atomic uint64_t terminal_bytes;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// The terminal's side of the pty: swallow and count what curses writes
+static void *drain_terminal(void *arg)
+{
+    int master = *(int *)arg;
+    char buffer[65536];
+    ssize_t got;
+    while ((got = read(master, buffer, sizeof(buffer))) > 0)
+        atomic_fetch_add(&terminal_bytes, (uint64_t)got);
+    return NULL;
+}
+
+// Waits for the terminal to read everything written so far
+static uint64_t settled_bytes(void)
+{
+    uint64_t bytes;
+    do
+    {
+        bytes = atomic_load(&terminal_bytes);
+        usleep(20000);
+    } while (bytes != atomic_load(&terminal_bytes));
+    return bytes;
+}
+
+static void fill_manager(TaskManager *manager, int count, Calendar *calendar)
+{
+    srand(47);
+    for (int id = 1; id <= count; id++)
+    {
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        add_task(manager, id, "Follow up on the vendor contract renewal", 1 + rand() % LOWEST_PRIORITY);
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), time);
+        if (id % 10 == 0)
+            add_task_to_calendar(manager, calendar, id);
+    }
+}
+
+// The same keypress for both renderers: scroll down a row, or reprioritise a random task
+static void press_key(TaskManager *manager, int count, int frame, int *top, int *cursor)
+{
+    if (frame % EDIT_EVERY == EDIT_EVERY - 1)
+    {
+        update_task(manager, 1 + rand() % count, NULL, 1 + rand() % LOWEST_PRIORITY);
+        return;
+    }
+    if (*cursor < SCREEN_ROWS - 2)
+        (*cursor)++;
+    else
+        (*top)++;
+}
+
+static void report(const char *label, double *frame_ms, int frames, uint64_t bytes, double rows)
+{
+    qsort(frame_ms, frames, sizeof(double), compare_doubles);
+    double total = 0;
+    for (int i = 0; i < frames; i++)
+        total += frame_ms[i];
+    printf("  %-16s mean %8.3f ms  p99 %8.3f ms  %7.0f bytes/frame", label, total / frames,
+           frame_ms[(int)(frames * 0.99)], (double)bytes / frames);
+    if (rows >= 0)
+        printf("  %5.1f rows/frame", rows);
+    printf("\n");
+}
+
+// The old way: walk every task in order, then clear and repaint the screen
+static void full_redraw(TaskManager *manager, Task **all, int top, int cursor)
+{
+    int total = task_order_window(&manager->agenda_index, 0, all, manager->agenda_index.size);
+    char line[SCREEN_COLUMNS + 1];
+    werase(stdscr);
+    mvaddstr(0, 0, " Tasks");
+    for (int row = 0; row < SCREEN_ROWS - 1 && top + row < total; row++)
+    {
+        task_view_format_task(all[top + row], line, SCREEN_COLUMNS - 1);
+        if (row == cursor)
+            attron(A_REVERSE);
+        mvaddstr(1 + row, 0, line);
+        attroff(A_REVERSE);
+    }
+    wnoutrefresh(stdscr);
+    doupdate();
+}
+
+// What the screen holds against the agenda window the view claims to show
+static bool screen_matches(TaskView *view)
+{
+    char expected[TASK_VIEW_MAX_COLUMNS + 1], actual[TASK_VIEW_MAX_COLUMNS + 1];
+    Task *window[TASK_VIEW_MAX_ROWS];
+    int width = view->columns - 1;
+    int top = task_viewport_top(&view->viewport);
+    int count = task_order_window(&view->manager->agenda_index, top, window, view->rows);
+    for (int row = 0; row < view->rows; row++)
+    {
+        if (row < count)
+            task_view_format_task(window[row], expected, width);
+        else
+            pad_line(expected, 0, width);
+        mvwinnstr(view->window, 1 + row, 0, actual, width);
+        if (strcmp(expected, actual) != 0)
+        {
+            printf("Row %d shows \"%s\"\n       expected \"%s\"\n", row, actual, expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+// The old tree diagram: every node of every bucket, recursively
+static void recursive_print_tree(FILE *out, HybridNode *root, int space)
+{
+    if (root == NULL)
+        return;
+
+    space += 5;
+    recursive_print_tree(out, root->child[RIGHT], space);
+    for (int i = 5; i < space; i++)
+        fputc(' ', out);
+    fprintf(out, "%d\n", void_ptr_to_int(root->key));
+    recursive_print_tree(out, root->child[LEFT], space);
+}
+
+// With no depth limit in reach, the diagram is print_tree's output line for line
+static bool diagram_matches_print(HybridTree *bucket)
+{
+    char *expected = NULL, *actual = NULL;
+    size_t expected_size = 0, actual_size = 0;
+    FILE *out = open_memstream(&expected, &expected_size);
+    recursive_print_tree(out, bucket->root, 0);
+    fclose(out);
+
+    HybridDiagram diagram;
+    hybrid_diagram_init(&diagram, bucket->root, HYBRID_DIAGRAM_MAX_DEPTH);
+    out = open_memstream(&actual, &actual_size);
+    while (hybrid_diagram_next(&diagram))
+        fprintf(out, "%s\n", diagram.line);
+    fclose(out);
+
+    bool ok = expected_size == actual_size && strcmp(expected, actual) == 0;
+    free(expected);
+    free(actual);
+    return ok;
+}
+
+// Exactly one body row is highlighted on the tree screen, and it is the selected task's node
+static bool tree_matches(TaskView *view)
+{
+    Task *selected = task_view_selected(view);
+    char text[TASK_VIEW_MAX_COLUMNS + 1], expected[32];
+    int length = snprintf(expected, sizeof(expected), "%d", selected ? selected->id : 0);
+    int highlighted = 0;
+    for (int row = 0; row < view->rows; row++)
+    {
+        mvwinnstr(view->window, 1 + row, 0, text, view->columns - 1);
+        const char *start = text + strspn(text, " ");
+        if (*start && (mvwinch(view->window, 1 + row, start - text) & A_REVERSE))
+            highlighted += strncmp(start, expected, length) == 0 && (start[length] == ' ' || !start[length]) ? 1 : 2;
+    }
+    return highlighted == 1;
+}
+
+// A chain a million nodes long: drawn down to the depth limit, then summarised
+static bool deep_chain_holds(void)
+{
+    HybridNode *nodes = (HybridNode *)calloc(CHAIN_NODES, sizeof(HybridNode));
+    if (!nodes)
+        return false;
+    for (int i = 0; i < CHAIN_NODES; i++)
+    {
+        nodes[i].key = int_to_void_ptr(i);
+        nodes[i].parent = i > 0 ? &nodes[i - 1] : NULL;
+        nodes[i].child[RIGHT] = i + 1 < CHAIN_NODES ? &nodes[i + 1] : NULL;
+    }
+
+    HybridDiagram diagram;
+    hybrid_diagram_init(&diagram, nodes, HYBRID_DIAGRAM_MAX_DEPTH);
+    bool summarised = false;
+    while (hybrid_diagram_next(&diagram))
+        summarised = summarised || diagram.collapsed;
+
+    // The printers used to recurse once per level
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *null = freopen("/dev/null", "w", stdout);
+    print_tree(nodes, 0);
+    print_hybrid_tree(nodes, 0);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    clearerr(stdout);
+
+    free(nodes);
+    return null && summarised && diagram.lines == HYBRID_DIAGRAM_MAX_DEPTH + 1;
+}
+
+static bool run_size(int count, double *frame_ms)
+{
+    TaskManager *manager = create_task_manager();
+    Calendar calendar = {0};
+    Task **all = (Task **)malloc(sizeof(Task *) * count);
+    if (!manager || !all)
+        return false;
+    fill_manager(manager, count, &calendar);
+    printf("%d tasks, %dx%d terminal\n", count, SCREEN_ROWS, SCREEN_COLUMNS);
+
+    struct timespec start, end;
+    int top = 0, cursor = 0;
+    clear();
+    refresh();
+    uint64_t bytes = settled_bytes();
+    for (int frame = 0; frame < FULL_REDRAW_FRAMES; frame++)
+    {
+        press_key(manager, count, frame, &top, &cursor);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        full_redraw(manager, all, top, cursor);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        frame_ms[frame] = elapsed_ms(start, end);
+    }
+    report("full redraw", frame_ms, FULL_REDRAW_FRAMES, settled_bytes() - bytes, -1);
+
+    TaskView *view = create_task_view(manager, stdscr);
+    if (!view)
+        return false;
+    clear();
+    refresh();
+    task_view_render(view);
+    doupdate();
+    uint64_t rows_before = view->rows_drawn;
+    bytes = settled_bytes();
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        if (frame % EDIT_EVERY == EDIT_EVERY - 1)
+            update_task(manager, 1 + rand() % count, NULL, 1 + rand() % LOWEST_PRIORITY);
+        else
+            task_view_move(view, 1);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        task_view_render(view);
+        doupdate();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        frame_ms[frame] = elapsed_ms(start, end);
+    }
+    report("damage-tracked", frame_ms, FRAMES, settled_bytes() - bytes,
+           (double)(view->rows_drawn - rows_before) / FRAMES);
+    bool ok = screen_matches(view);
+
+    // An edit the key does not see, reported with a touch
+    Task *selected = task_view_selected(view);
+    if (selected)
+    {
+        update_task(manager, selected->id, "Renamed while on screen", selected->priority);
+        task_view_touch(view, selected);
+        ok = ok && task_view_render(view) == 1 && screen_matches(view);
+        doupdate();
+
+        // The reminder and recurrence marks are outside the key but still redraw the row
+        set_task_reminder(manager, selected->id, !selected->have_reminder, WEEKLY);
+        ok = ok && task_view_render(view) == 1 && screen_matches(view);
+        doupdate();
+    }
+
+    // The calendar redraws only the days whose counts changed
+    task_view_show_month(view, &calendar, MARCH);
+    task_view_render(view);
+    rows_before = view->rows_drawn;
+    bytes = settled_bytes();
+    for (int frame = 0; frame < CALENDAR_FRAMES; frame++)
+    {
+        if (frame % 2)
+        {
+            // Odd ids were never filed, and a filed task may not be rescheduled
+            int id = frame;
+            Time time = {0, 9};
+            set_task_schedule(manager, id, MARCH, (char)(1 + rand() % 28), time);
+            add_task_to_calendar(manager, &calendar, id);
+        }
+        else
+            task_view_move(view, frame % 4 ? 1 : -7);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        task_view_render(view);
+        doupdate();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        frame_ms[frame] = elapsed_ms(start, end);
+    }
+    report("calendar", frame_ms, CALENDAR_FRAMES, settled_bytes() - bytes,
+           (double)(view->rows_drawn - rows_before) / CALENDAR_FRAMES);
+
+    // The tree screen against dumping the whole map, as the old diagram did
+    FILE *null = fopen("/dev/null", "w");
+    for (int frame = 0; null && frame < PRINT_FRAMES; frame++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < manager->task_map->capacity; i++)
+            recursive_print_tree(null, manager->task_map->buckets[i]->root, 0);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        frame_ms[frame] = elapsed_ms(start, end);
+    }
+    if (null)
+        fclose(null);
+    report("print whole map", frame_ms, PRINT_FRAMES, 0, -1);
+
+    task_view_set_mode(view, TASK_VIEW_TREE);
+    task_view_render(view);
+    doupdate();
+    rows_before = view->rows_drawn;
+    bytes = settled_bytes();
+    for (int frame = 0; frame < TREE_FRAMES; frame++)
+    {
+        task_view_move(view, frame % 5 ? 1 : -3);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        task_view_render(view);
+        doupdate();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        frame_ms[frame] = elapsed_ms(start, end);
+    }
+    report("tree", frame_ms, TREE_FRAMES, settled_bytes() - bytes,
+           (double)(view->rows_drawn - rows_before) / TREE_FRAMES);
+    ok = ok && tree_matches(view) && diagram_matches_print(manager->task_map->buckets[0]);
+
+    free_task_view(view);
+    free_calendar(&calendar);
+    free_task_manager(manager);
+    free(all);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int master, slave;
+    struct winsize size = {SCREEN_ROWS, SCREEN_COLUMNS, 0, 0};
+    if (openpty(&master, &slave, NULL, NULL, &size) != 0)
+    {
+        printf("Could not open a pseudo-terminal.\n");
+        return 1;
+    }
+    pthread_t drainer;
+    pthread_create(&drainer, NULL, drain_terminal, &master);
+
+    unsetenv("LINES");
+    unsetenv("COLUMNS");
+    FILE *output = fdopen(slave, "w");
+    FILE *input = fdopen(dup(slave), "r");
+    SCREEN *screen = newterm("xterm-256color", output, input);
+    double *frame_ms = (double *)malloc(sizeof(double) * FRAMES);
+    if (!screen || !frame_ms)
+        return 1;
+    set_term(screen);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    noecho();
+    curs_set(0);
+
+    bool ok = deep_chain_holds();
+    int sizes[] = {10000, 100000, 1000000};
+    for (int i = 0; i < 3 && ok; i++)
+    {
+        int count = argc > 1 + i ? atoi(argv[1 + i]) : sizes[i];
+        if (count > 0)
+            ok = run_size(count, frame_ms);
+    }
+
+    endwin();
+    delscreen(screen);
+    fclose(output);
+    fclose(input);
+    pthread_join(drainer, NULL);
+    close(master);
+    free(frame_ms);
+
+    printf("Screen matches the agenda: %s\n", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
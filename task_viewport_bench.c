@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/task_viewport.c"
+
+#define PAGE_ROWS 49                 // A 50 line terminal less the status line
+#define STEPS 200000
+#define EDIT_EVERY 4                 // In the edits run, one step in this many reprioritises a task
+#define INSERTED_ABOVE 1000
+
+typedef enum Step {
+    STEP_SCROLL,                     // Selection on the bottom row, one row down
+    STEP_PAGE,                       // Page down, back to the top at the end
+    STEP_JUMP,                       // Select a random rank
+    STEP_EDITS                       // Scroll, with a task reprioritised every EDIT_EVERY steps
+} Step;
+
+static const char *const step_names[] = {"scroll by row", "page down", "jump", "scroll + edits"};
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void fill_manager(TaskManager *manager, int count)
+{
+    srand(48);
+    for (int id = 1; id <= count; id++)
+    {
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        add_task(manager, id, "Follow up on the vendor contract renewal", 2 + rand() % (LOWEST_PRIORITY - 1));
+        set_task_schedule(manager, id, (MonthsInAYear)(rand() % 12), (char)(1 + rand() % 28), time);
+    }
+}
+
+// The viewport's page against the agenda window at its top rank
+static bool page_matches(TaskViewport *viewport, Task **window)
+{
+    int count;
+    Task **page = task_viewport_page(viewport, &count);
+    int top = task_viewport_top(viewport);
+    int expected = task_order_window(viewport->index, top, window, viewport->rows);
+    int position = task_viewport_position(viewport);
+    Task *selected = task_viewport_selected(viewport);
+    return count == expected && memcmp(page, window, sizeof(Task *) * count) == 0 &&
+           (count == 0 || (selected == window[position - top] &&
+                           task_order_index_rank(viewport->index, task_order_key(selected)) == position));
+}
+
+// One step of the old way: the page fetched by rank from a top the caller keeps
+static int window_step(TaskManager *manager, Step step, int *top, Task **window)
+{
+    int total = manager->agenda_index.size;
+    if (step == STEP_PAGE)
+        *top = *top + PAGE_ROWS > total - PAGE_ROWS ? 0 : *top + PAGE_ROWS;
+    else if (step == STEP_JUMP)
+        *top = rand() % total;
+    else
+        *top = *top + 1 > total - PAGE_ROWS ? 0 : *top + 1;
+    return task_order_window(&manager->agenda_index, *top, window, PAGE_ROWS);
+}
+
+static int viewport_step(TaskViewport *viewport, Step step)
+{
+    int total = viewport->index->size;
+    int count;
+    if (step == STEP_PAGE)
+    {
+        if (task_viewport_top(viewport) + PAGE_ROWS > total - PAGE_ROWS)
+            task_viewport_jump(viewport, 0);
+        else
+            task_viewport_page_by(viewport, 1);
+    }
+    else if (step == STEP_JUMP)
+        task_viewport_jump(viewport, rand() % total);
+    else if (task_viewport_position(viewport) == total - 1)
+        task_viewport_jump(viewport, 0);
+    else
+        task_viewport_move(viewport, 1);
+    task_viewport_page(viewport, &count);
+    return count;
+}
+
+// Runs steps of one kind both ways, then replays the viewport's steps with checks
+static bool run_steps(TaskManager *manager, Step step, Task **window)
+{
+    struct timespec start, end;
+    TaskViewport viewport;
+    int top = 0;
+    long shown = 0;
+
+    srand(1);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < STEPS; i++)
+    {
+        if (step == STEP_EDITS && i % EDIT_EVERY == EDIT_EVERY - 1)
+            update_task(manager, 1 + rand() % manager->agenda_index.size, NULL, 2 + rand() % (LOWEST_PRIORITY - 1));
+        shown += window_step(manager, step, &top, window);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double window_ms = elapsed_ms(start, end);
+
+    // Each keypress is timed on its own; the prefetch runs after it, as when idle
+    struct timespec idle;
+    double viewport_ms = 0, prefetch_ms = 0;
+    srand(1);
+    task_viewport_init(&viewport, &manager->agenda_index, PAGE_ROWS);
+    task_viewport_move(&viewport, PAGE_ROWS - 1);
+    for (int i = 0; i < STEPS; i++)
+    {
+        if (step == STEP_EDITS && i % EDIT_EVERY == EDIT_EVERY - 1)
+            update_task(manager, 1 + rand() % manager->agenda_index.size, NULL, 2 + rand() % (LOWEST_PRIORITY - 1));
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        shown += viewport_step(&viewport, step);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        task_viewport_prefetch(&viewport);
+        clock_gettime(CLOCK_MONOTONIC, &idle);
+        viewport_ms += elapsed_ms(start, end);
+        prefetch_ms += elapsed_ms(end, idle);
+    }
+
+    printf("  %-15s by rank %7.0f ns  viewport %7.0f ns  %5.1fx   idle prefetch %6.0f ns  refills %5.1f%%\n",
+           step_names[step], window_ms * 1e6 / STEPS, viewport_ms * 1e6 / STEPS, window_ms / viewport_ms,
+           prefetch_ms * 1e6 / STEPS, 100.0 * viewport.fills / STEPS);
+
+    bool ok = shown > 0;
+    srand(2);
+    task_viewport_init(&viewport, &manager->agenda_index, PAGE_ROWS);
+    for (int i = 0; i < STEPS / 10 && ok; i++)
+    {
+        if (step == STEP_EDITS && i % EDIT_EVERY == EDIT_EVERY - 1)
+            update_task(manager, 1 + rand() % manager->agenda_index.size, NULL, 2 + rand() % (LOWEST_PRIORITY - 1));
+        viewport_step(&viewport, step);
+        if (i % 7 == 0)
+            task_viewport_move(&viewport, -(rand() % (2 * PAGE_ROWS)));
+        if (i % 11 == 0)
+            task_viewport_page_by(&viewport, -1);
+        if (i % 3 == 0)
+            task_viewport_prefetch(&viewport);
+        ok = page_matches(&viewport, window);
+    }
+    return ok;
+}
+
+// Tasks added ahead of the page shift every rank on it but not what it shows
+static bool anchor_holds(TaskManager *manager, Task **window, int next_id)
+{
+    TaskViewport viewport;
+    Task *before[PAGE_ROWS];
+    int count, shown;
+    task_viewport_init(&viewport, &manager->agenda_index, PAGE_ROWS);
+    task_viewport_jump(&viewport, manager->agenda_index.size / 2);
+    Task **page = task_viewport_page(&viewport, &count);
+    memcpy(before, page, sizeof(Task *) * count);
+    int top = task_viewport_top(&viewport);
+
+    for (int i = 0; i < INSERTED_ABOVE; i++)
+        add_task(manager, next_id + i, "Urgent", HIGHEST_PRIORITY);
+    page = task_viewport_page(&viewport, &shown);
+    bool ok = shown == count && memcmp(page, before, sizeof(Task *) * count) == 0 &&
+              task_viewport_top(&viewport) == top + INSERTED_ABOVE && page_matches(&viewport, window);
+
+    // The top task going away moves the page to its successor
+    Task *second = before[1];
+    delete_task(manager, before[0]->id);
+    page = task_viewport_page(&viewport, &shown);
+    return ok && page[0] == second && page_matches(&viewport, window);
+}
+
+int main(int argc, char **argv)
+{
+    Task *window[TASK_VIEWPORT_MAX_ROWS];
+    bool ok = true;
+    int sizes[] = {10000, 100000, 1000000};
+    for (int i = 0; i < 3 && ok; i++)
+    {
+        int count = argc > 1 + i ? atoi(argv[1 + i]) : sizes[i];
+        if (count <= 2 * PAGE_ROWS)
+            continue;
+
+        TaskManager *manager = create_task_manager();
+        if (!manager)
+            return 1;
+        fill_manager(manager, count);
+        printf("%d tasks, %d rows, mean per step\n", count, PAGE_ROWS);
+        for (Step step = STEP_SCROLL; step <= STEP_EDITS && ok; step++)
+            ok = run_steps(manager, step, window);
+        ok = ok && anchor_holds(manager, window, count + 1);
+        free_task_manager(manager);
+    }
+
+    printf("Pages match the agenda: %s\n", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+
+#define DEFAULT_KEYS 10000000
+#define DEFAULT_BUCKETS 1024         // TASK_MAP_BUCKETS
+#define DUPLICATE_EVERY 50           // One key in this many repeats an earlier one
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// In order with parents set; with balanced, also height-balanced with heights as
+// update_height computes them. Returns the node count, or -1.
+static int check_subtree(const HybridNode *node, const HybridNode *parent, bool balanced, long *previous,
+                         int *height)
+{
+    if (!node)
+    {
+        *height = -1;
+        return 0;
+    }
+
+    int left_height, right_height;
+    int left = check_subtree(node->child[LEFT], node, balanced, previous, &left_height);
+    int key = void_ptr_to_int(node->key);
+    if (left < 0 || node->parent != parent || key <= *previous)
+        return -1;
+    *previous = key;
+    int right = check_subtree(node->child[RIGHT], node, balanced, previous, &right_height);
+    if (right < 0 || (balanced && abs(left_height - right_height) > 1))
+        return -1;
+
+    *height = (left_height > right_height ? left_height : right_height) + 1;
+    return !balanced || node->height == *height ? left + right + 1 : -1;
+}
+
+static bool check_map(HashMapWithTree *map, long expected, bool balanced)
+{
+    long total = 0;
+    for (int i = 0; i < map->capacity; i++)
+    {
+        HybridTree *tree = map->buckets[i];
+        long previous = (long)INT32_MIN - 1;
+        int height;
+        int nodes = check_subtree(tree->root, NULL, balanced, &previous, &height);
+        if (nodes < 0 || nodes != tree->size)
+        {
+            printf("Bucket %d is malformed.\n", i);
+            return false;
+        }
+        total += nodes;
+    }
+    return total == expected;
+}
+
+// Every key resolves, to the value of its first entry, in the bucket hash() names
+static bool same_lookups(HashMapWithTree *map, HashMapWithTree *reference, const HybridEntry *entries, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        HybridNode *node = tree_map_search(map, entries[i].key);
+        HybridNode *expected = tree_map_search(reference, entries[i].key);
+        if (!node || !expected || node->value != expected->value)
+        {
+            printf("Key %d resolves differently.\n", entries[i].key);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void clear_map(HashMapWithTree *map)
+{
+    for (int i = 0; i < map->capacity; i++)
+    {
+        free_hybrid_tree(map->buckets[i]->root, NULL);
+        map->buckets[i]->root = NULL;
+        map->buckets[i]->size = 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_KEYS;
+    int buckets = argc > 2 ? atoi(argv[2]) : DEFAULT_BUCKETS;
+    int max_threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    struct timespec start, end;
+
+    HybridEntry *entries = (HybridEntry *)malloc(sizeof(HybridEntry) * count);
+    HashMapWithTree *reference = create_tree_map(buckets, 0);
+    HashMapWithTree *map = create_tree_map(buckets, 0);
+    if (!entries || !reference || !map)
+        return 1;
+
+    uint64_t state = 45;
+    for (int i = 0; i < count; i++)
+    {
+        bool repeat = i > 0 && next_random(&state) % DUPLICATE_EVERY == 0;
+        entries[i].key = repeat ? entries[next_random(&state) % i].key : (int)(uint32_t)next_random(&state);
+        entries[i].value = (void *)(intptr_t)(i + 1);
+    }
+
+    // The way the map is filled today: one insert at a time, rebalancing as it goes
+    long unique = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < count; i++)
+        unique += tree_map_insert(reference, entries[i].key, entries[i].value);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sequential_ms = elapsed_ms(start, end);
+    printf("%d keys (%ld distinct) into %d buckets, %d CPU(s) online\n", count, unique, buckets,
+           (int)sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-22s %9.1f ms\n", "tree_map_insert", sequential_ms);
+
+    bool ok = check_map(reference, unique, true);
+    double one_thread_ms = 0;
+    for (int threads = 1; threads <= max_threads && ok; threads *= 2)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int inserted = tree_map_build(map, entries, count, threads);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double build_ms = elapsed_ms(start, end);
+        if (threads == 1)
+            one_thread_ms = build_ms;
+
+        char label[32];
+        snprintf(label, sizeof(label), "tree_map_build x%d", threads);
+        printf("%-22s %9.1f ms  %5.1fx insert  %5.2fx one thread\n", label, build_ms, sequential_ms / build_ms,
+               one_thread_ms / build_ms);
+
+        ok = inserted == unique && check_map(map, unique, true) && same_lookups(map, reference, entries, count);
+        clear_map(map);
+    }
+
+    // Only an empty map can be built into
+    tree_map_insert(map, 1, NULL);
+    ok = ok && tree_map_build(map, entries, count, 1) == -1 && tree_map_search(map, 1);
+
+    printf("Built maps match the inserted one: %s\n", ok ? "yes" : "NO");
+    free_tree_map(reference);
+    free_tree_map(map);
+    free(entries);
+    return ok ? 0 : 1;
+}
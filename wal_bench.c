@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/task_manager.c"
+#include "src/persistence.c"
+#include "src/wal.c"
+
+#define DEFAULT_WRITERS 8
+#define DEFAULT_MUTATIONS 20000 // Per writer
+#define REMINDER_BASE ((int64_t)1 << 32) // Fire times that need both halves of the record
+
+typedef struct Writer {
+    int index;
+    int mutations;
+    TaskManager *manager;
+    Wal *wal;
+    pthread_mutex_t *manager_lock;
+    int compact_at; // Writer 0 requests a compaction after this many mutations
+    int logged;
+    int lost;       // Mutations whose wal_sync failed
+} Writer;
+
+static uint64_t spent_sequence;      // Last reminder firing logged; under the manager lock
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// A fired reminder promoted its task: log that, as a UI's handler would
+static void log_spent(TaskManager *manager, Task *task, void *context)
+{
+    (void)manager;
+    spent_sequence = wal_log_reminder_spent((Wal *)context, task->id);
+}
+
+// One durable mutation: apply and log under the manager lock, then wait for the sync outside it
+static void *run_writer(void *arg)
+{
+    Writer *writer = (Writer *)arg;
+    int base = writer->index * writer->mutations;
+    char description[64];
+
+    for (int i = 0; i < writer->mutations; i++)
+    {
+        int id = base + i / 4 + 1;
+        uint64_t sequence = 0;
+
+        pthread_mutex_lock(writer->manager_lock);
+        switch (i % 4)
+        {
+        case 0:
+            snprintf(description, sizeof(description), "Task %d from writer %d", id, writer->index);
+            if (add_task(writer->manager, id, description, 1 + id % LOWEST_PRIORITY))
+                sequence = wal_log_add_task(writer->wal, id, description, 1 + id % LOWEST_PRIORITY);
+            if (sequence && id % 6 == 0 && add_appointment(writer->manager, id, 1, (Time){0, 9}, MARCH, false, NONE) &&
+                add_appointment_note(writer->manager, id, description))
+            {
+                wal_log_add_appointment(writer->wal, id, 1, (Time){0, 9}, MARCH, false, NONE);
+                sequence = wal_log_appointment_note(writer->wal, id, description);
+            }
+            break;
+        case 1:
+            if (update_task(writer->manager, id, NULL, 1 + (id + 2) % LOWEST_PRIORITY))
+                sequence = wal_log_update_task(writer->wal, id, NULL, 1 + (id + 2) % LOWEST_PRIORITY);
+            // Some notes are set, some set and then removed again
+            if (sequence && id % 3 == 0 && set_task_note(writer->manager, id, "Check with the vendor"))
+                sequence = wal_log_task_note(writer->wal, id, "Check with the vendor");
+            if (sequence && id % 9 == 0 && set_task_note(writer->manager, id, NULL))
+                sequence = wal_log_task_note(writer->wal, id, NULL);
+            break;
+        case 2:
+        {
+            Time time = {(char)(id % 60), (char)(id % 24)};
+            if (set_task_schedule(writer->manager, id, (MonthsInAYear)(id % 12), (char)(1 + id % 28), time))
+                sequence = wal_log_task_schedule(writer->wal, id, (MonthsInAYear)(id % 12), (char)(1 + id % 28), time);
+            if (sequence && id % 4 == 0 && set_task_reminder(writer->manager, id, id % 8 == 0, WEEKLY))
+                sequence = wal_log_task_reminder(writer->wal, id, id % 8 == 0, WEEKLY);
+            if (sequence && id % 8 == 4 && arm_task_reminder(writer->manager, id, REMINDER_BASE + id))
+                sequence = wal_log_arm_reminder(writer->wal, id, REMINDER_BASE + id);
+            break;
+        }
+        default:
+            if (id % 5 == 0 ? delete_task(writer->manager, id) : set_task_completion(writer->manager, id, true) != NULL)
+                sequence = id % 5 == 0 ? wal_log_delete_task(writer->wal, id) : wal_log_task_completion(writer->wal, id, true);
+            // Time passes: fires whatever is due, this writer's or another's
+            spent_sequence = 0;
+            if (sequence && id % 16 == 0 && advance_reminders(writer->manager, REMINDER_BASE + id - 40) > 0)
+                sequence = spent_sequence > sequence ? spent_sequence : sequence;
+            break;
+        }
+        pthread_mutex_unlock(writer->manager_lock);
+
+        if (sequence && wal_sync(writer->wal, sequence))
+            writer->logged++;
+        else
+            writer->lost++;
+
+        if (writer->index == 0 && i == writer->compact_at)
+            wal_compact(writer->wal);
+    }
+    return NULL;
+}
+
+static bool same_state(TaskManager *a, TaskManager *b)
+{
+    if (a->task_list->size != b->task_list->size)
+        return false;
+
+    for (Node *node = a->task_list->head; node; node = node->next)
+    {
+        Task *task = (Task *)node->data->value;
+        Task *other = find_task(b, task->id);
+        if (!other || other->priority != task->priority || other->is_complete != task->is_complete ||
+            other->month != task->month || other->date != task->date ||
+            other->time.hour != task->time.hour || other->time.minutes != task->time.minutes ||
+            other->have_reminder != task->have_reminder || other->recurrence_type != task->recurrence_type ||
+            (other->subtasks ? other->subtasks->size : 0) != (task->subtasks ? task->subtasks->size : 0) ||
+            !other->reminder_timer != !task->reminder_timer ||
+            (task->reminder_timer && other->reminder_timer->fire_at != task->reminder_timer->fire_at) ||
+            strcmp(other->description, task->description) != 0 || !task->note != !other->note ||
+            (task->note && strcmp(other->note->description, task->note->description) != 0))
+            return false;
+    }
+
+    if (a->appointment_list->size != b->appointment_list->size)
+        return false;
+    for (Node *node = a->appointment_list->head; node; node = node->next)
+    {
+        Appointment *appointment = (Appointment *)node->data->value;
+        Appointment *other = find_appointment(b, appointment->id);
+        if (!other || note_blob_count(other->notes) != note_blob_count(appointment->notes))
+            return false;
+        for (const char *note = note_blob_first(appointment->notes), *copy = note_blob_first(other->notes); note;
+             note = note_blob_next(appointment->notes, note), copy = note_blob_next(other->notes, copy))
+            if (strcmp(note, copy) != 0)
+                return false;
+    }
+    return true;
+}
+
+static void remove_files(const char *snapshot)
+{
+    char path[512];
+    remove(snapshot);
+    snprintf(path, sizeof(path), "%s.wal", snapshot);
+    remove(path);
+    snprintf(path, sizeof(path), "%s.wal.old", snapshot);
+    remove(path);
+}
+
+static bool run(int writers, int mutations, const char *snapshot)
+{
+    remove_files(snapshot);
+
+    TaskManager *manager = create_task_manager();
+    if (!manager || !wal_recover(manager, snapshot))
+        return false;
+
+    Wal *wal = wal_open(manager, snapshot);
+    if (!wal)
+        return false;
+    set_reminder_handler(manager, log_spent, wal);
+
+    pthread_mutex_t manager_lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * writers);
+    Writer *state = (Writer *)calloc(writers, sizeof(Writer));
+    if (!threads || !state)
+        return false;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < writers; i++)
+    {
+        state[i] = (Writer){i, mutations, manager, wal, &manager_lock, mutations / 2, 0, 0};
+        pthread_create(&threads[i], NULL, run_writer, &state[i]);
+    }
+
+    int logged = 0, lost = 0;
+    for (int i = 0; i < writers; i++)
+    {
+        pthread_join(threads[i], NULL);
+        logged += state[i].logged;
+        lost += state[i].lost;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pthread_mutex_lock(&wal->lock);
+    uint64_t syncs = wal->syncs;
+    pthread_mutex_unlock(&wal->lock);
+    bool closed = wal_close(wal);
+    bool compacted = access(snapshot, F_OK) == 0;
+    double ms = elapsed_ms(start, end);
+
+    printf("%2d writers: %7d durable mutations in %8.2f ms (%8.0f/sec), %6llu syncs, %.1f records/sync%s\n",
+           writers, logged, ms, logged / (ms / 1e3), (unsigned long long)syncs,
+           syncs ? (double)logged / syncs : 0.0, lost ? " -- SOME NOT DURABLE" : "");
+
+    // Start over from disk: compacted snapshot plus whatever the log still holds
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    TaskManager *recovered = create_task_manager();
+    bool ok = recovered && wal_recover(recovered, snapshot);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ok = ok && closed && lost == 0 && same_state(manager, recovered);
+    printf("            recovery in %.2f ms (%s), %d live tasks, state matches: %s\n",
+           elapsed_ms(start, end), compacted ? "snapshot + log" : "log only",
+           manager->task_list->size, ok ? "yes" : "NO");
+
+    free_task_manager(recovered);
+    free_task_manager(manager);
+    free(threads);
+    free(state);
+    remove_files(snapshot);
+    return ok;
+}
+
+// A snapshot saved from the live manager must not have its records replayed over
+// it, and items added outside the log (as an import adds them) must survive both
+// recovery and the next compaction
+static bool checkpoints(const char *snapshot)
+{
+    remove_files(snapshot);
+
+    TaskManager *manager = create_task_manager();
+    Wal *wal = manager ? wal_open(manager, snapshot) : NULL;
+    if (!wal)
+    {
+        free_task_manager(manager);
+        return false;
+    }
+
+    uint64_t sequence = 0;
+    bool ok = add_task(manager, 1, "Saved task", 2) && (sequence = wal_log_add_task(wal, 1, "Saved task", 2)) &&
+              add_subtask(manager, 1, "Saved subtask", 1) &&
+              (sequence = wal_log_add_subtask(wal, 1, "Saved subtask", 1)) &&
+              add_appointment(manager, 2, 14, (Time){30, 9}, MARCH, false, NONE) &&
+              (sequence = wal_log_add_appointment(wal, 2, 14, (Time){30, 9}, MARCH, false, NONE)) &&
+              add_appointment_note(manager, 2, "Saved note") &&
+              (sequence = wal_log_appointment_note(wal, 2, "Saved note")) &&
+              wal_sync(wal, sequence) && save_tasks_to_file(manager, snapshot);
+
+    ok = ok && add_task(manager, 3, "Imported task", 4) && bulk_load_finished(manager) &&
+         add_subtask(manager, 3, "Logged after the checkpoint", 1) &&
+         (sequence = wal_log_add_subtask(wal, 3, "Logged after the checkpoint", 1)) && wal_sync(wal, sequence) &&
+         wal_compact(wal);
+    ok = wal_close(wal) && ok;
+
+    TaskManager *recovered = create_task_manager();
+    ok = ok && recovered && wal_recover(recovered, snapshot) && same_state(manager, recovered);
+    printf("Saved and imported state recovers exactly: %s\n", ok ? "yes" : "NO");
+
+    free_task_manager(recovered);
+    free_task_manager(manager);
+    remove_files(snapshot);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int writers = argc > 1 ? atoi(argv[1]) : DEFAULT_WRITERS;
+    int mutations = argc > 2 ? atoi(argv[2]) : DEFAULT_MUTATIONS;
+    const char *snapshot = argc > 3 ? argv[3] : "wal_bench.snapshot";
+
+    // One writer is a sync per mutation; more writers share each sync
+    bool ok = checkpoints(snapshot);
+    ok = run(1, mutations, snapshot) && ok;
+    if (writers > 1)
+        ok = run(writers, mutations, snapshot) && ok;
+
+    return ok ? 0 : 1;
+}
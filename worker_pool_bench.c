@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "avl_api.c"
+#include "src/dynamic_array_api.c"
+#include "src/hybrid_tree_api.c"
+#include "src/tree_map_api.c"
+#include "src/doubly_linked_list_api.c"
+#include "src/task_index.c"
+#include "src/string_arena.c"
+#include "src/roaring_bitmap.c"
+#include "src/task_store.c"
+#include "src/calendar_index.c"
+#include "src/reminder_wheel.c"
+#include "src/recurrence.c"
+#include "src/task_manager.c"
+#include "src/persistence.c"
+#include "src/wal.c"
+#include "src/import_export.c"
+#include "src/archive.c"
+#include "src/worker_pool.c"
+#include "src/background_jobs.c"
+
+#define DEFAULT_TASKS 200000
+#define RECURRING_RULES 50000
+#define KEY_INTERVAL_US 2000         // A fast typist, or a held arrow key
+#define IDLE_KEYS 500
+#define MAX_KEYS 100000
+#define SCREEN_ROWS 40
+#define SCREEN_COLUMNS 100
+#define FRAME_MS 16.7
+#define SYNC_EVERY 50                // Keystrokes between background durability checks
+
+typedef struct Screen {
+    char cells[SCREEN_ROWS][SCREEN_COLUMNS];
+} Screen;
+
+typedef struct Outcome {
+    int finished;
+    int failed;
+    uint32_t occurrences;
+} Outcome;
+
+static double elapsed_ms(struct timespec start, struct timespec end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void add_us(struct timespec *time, long us)
+{
+    time->tv_nsec += us * 1000;
+    while (time->tv_nsec >= 1000000000)
+    {
+        time->tv_nsec -= 1000000000;
+        time->tv_sec++;
+    }
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// What the input loop does per key: apply and log an edit, then redraw the agenda.
+// Returns the edit's log sequence.
+static uint64_t handle_key(TaskManager *manager, Wal *wal, int task_count, Screen *screen)
+{
+    int id = 1 + rand() % task_count;
+    unsigned int priority = 1 + rand() % LOWEST_PRIORITY;
+    uint64_t sequence = update_task(manager, id, NULL, priority) ? wal_log_update_task(wal, id, NULL, priority) : 0;
+
+    Task *rows[SCREEN_ROWS];
+    int shown = get_agenda(manager, HIGHEST_PRIORITY, LOWEST_PRIORITY, rows, SCREEN_ROWS);
+    for (int row = 0; row < shown; row++)
+        snprintf(screen->cells[row], SCREEN_COLUMNS, "[%c] P%u %02d/%02d #%d %s", rows[row]->is_complete ? 'x' : ' ',
+                 rows[row]->priority, rows[row]->month + 1, rows[row]->date, rows[row]->id, rows[row]->description);
+    return sequence;
+}
+
+static void count_outcome(bool ok, void *result, void *context)
+{
+    Outcome *outcome = (Outcome *)context;
+    outcome->finished++;
+    outcome->failed += !ok;
+    if (result)
+        outcome->occurrences = ((RecurrenceExpansion *)result)->count;
+}
+
+// Keys arrive every KEY_INTERVAL_US; latency runs from arrival to finished redraw.
+// With keep_going, keys keep coming until the pool has nothing in flight.
+static int type_keys(TaskManager *manager, Wal *wal, WorkerPool *pool, int task_count, int keys, bool keep_going,
+                     double *latencies)
+{
+    Screen screen;
+    struct timespec arrival, done;
+    clock_gettime(CLOCK_MONOTONIC, &arrival);
+
+    int typed = 0;
+    uint64_t logged = 0;
+    while (typed < MAX_KEYS && (typed < keys || (keep_going && worker_pool_in_flight(pool) > 0)))
+    {
+        add_us(&arrival, KEY_INTERVAL_US);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &arrival, NULL);
+
+        struct pollfd ready = {worker_pool_fd(pool), POLLIN, 0};
+        if (poll(&ready, 1, 0) > 0)
+            worker_pool_drain(pool, 16);
+
+        uint64_t sequence = handle_key(manager, wal, task_count, &screen);
+        logged = sequence ? sequence : logged;
+        if (typed % SYNC_EVERY == SYNC_EVERY - 1 && logged)
+            background_sync(pool, wal, logged, NULL, NULL);
+
+        clock_gettime(CLOCK_MONOTONIC, &done);
+        latencies[typed++] = elapsed_ms(arrival, done);
+    }
+    return typed;
+}
+
+// Prints the percentiles and returns the slowest key
+static double report(const char *label, const double *latencies, int count)
+{
+    double *sorted = (double *)malloc(sizeof(double) * count);
+    double worst = 0;
+    for (int i = 0; i < count; i++)
+        worst = latencies[i] > worst ? latencies[i] : worst;
+    if (sorted)
+    {
+        memcpy(sorted, latencies, sizeof(double) * count);
+        qsort(sorted, count, sizeof(double), compare_doubles);
+        printf("%-22s %6d keys  p50 %6.3f ms  p99 %7.3f ms  max %8.3f ms\n", label, count, sorted[count / 2],
+               sorted[(int)(count * 0.99)], worst);
+    }
+    free(sorted);
+    return worst;
+}
+
+int main(int argc, char **argv)
+{
+    int task_count = argc > 1 ? atoi(argv[1]) : DEFAULT_TASKS;
+    const char *snapshot_path = argc > 2 ? argv[2] : "worker_pool_bench.snap";
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    char path[512];
+    struct timespec start, end;
+
+    snprintf(path, sizeof(path), "%s.wal", snapshot_path);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.wal.old", snapshot_path);
+    unlink(path);
+
+    TaskManager *manager = create_task_manager();
+    RecurrenceEngine rules;
+    recurrence_engine_init(&rules);
+    double *latencies = (double *)malloc(sizeof(double) * MAX_KEYS);
+    if (!manager || !latencies)
+        return 1;
+
+    srand(44);
+    for (int id = 1; id <= task_count; id++)
+    {
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        MonthsInAYear month = (MonthsInAYear)(rand() % 12);
+        add_task(manager, id, "Reply to the quarterly planning thread", 1 + rand() % LOWEST_PRIORITY);
+        set_task_schedule(manager, id, month, (char)(1 + rand() % 28), time);
+    }
+    for (int i = 0; i < RECURRING_RULES; i++)
+    {
+        Time time = {(char)(rand() % 60), (char)(rand() % 24)};
+        recurrence_add(&rules, RECURRING_TASK, i + 1, (RecurrenceType)(DAILY + rand() % 4), 2026,
+                       (MonthsInAYear)(rand() % 12), 1 + rand() % 28, time);
+    }
+    if (!save_tasks_to_file(manager, snapshot_path))
+        return 1;
+    Wal *wal = wal_open(manager, snapshot_path);
+    WorkerPool *pool = create_worker_pool(threads);
+    if (!wal || !pool)
+        return 1;
+
+    int typed = type_keys(manager, wal, pool, task_count, IDLE_KEYS, false, latencies);
+    report("idle", latencies, typed);
+    worker_pool_wait(pool);
+
+    // The old way: the export runs inside the input loop and every key behind it waits
+    snprintf(path, sizeof(path), "%s.csv", snapshot_path);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool inline_ok = export_to_file(manager, path, FORMAT_CSV);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-22s stalls input for %.1f ms (%.0f frames)\n", "inline export", elapsed_ms(start, end),
+           elapsed_ms(start, end) / FRAME_MS);
+
+    // On the pool: export, archive rebuild and a month of recurrences while typing goes on
+    Outcome outcome = {0};
+    int64_t month_start = recurrence_stamp(2026, MARCH, 1, (Time){0, 0});
+    int64_t month_end = recurrence_stamp(2026, APRIL, 1, (Time){0, 0});
+    char archive_path[512];
+    snprintf(archive_path, sizeof(archive_path), "%s.archive", snapshot_path);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool submitted = background_export(pool, snapshot_path, path, FORMAT_CSV, count_outcome, &outcome) &&
+                     background_archive(pool, snapshot_path, archive_path, false, count_outcome, &outcome) &&
+                     background_expand(pool, &rules, month_start, month_end, count_outcome, &outcome);
+    typed = type_keys(manager, wal, pool, task_count, 1, true, latencies);
+    worker_pool_wait(pool);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double worst = report("with background jobs", latencies, typed);
+    printf("%-22s %d jobs finished in %.1f ms on %d worker(s), %d failed\n", "", outcome.finished,
+           elapsed_ms(start, end), pool->worker_count, outcome.failed);
+
+    // The jobs saw the logged state: the archive holds every task, the expansion
+    // matches one done in place
+    TaskArchive *archive = open_archive(archive_path);
+    uint32_t expected = 0;
+    recurrence_window(&rules, month_start, month_end, &expected);
+    bool same = inline_ok && submitted && outcome.finished == 3 && !outcome.failed && archive &&
+                archive_task_count(archive) == (uint64_t)task_count && outcome.occurrences == expected &&
+                worst < FRAME_MS;
+    printf("Input stayed under a frame with jobs running: %s\n", same ? "yes" : "NO");
+
+    close_archive(archive);
+    wal_close(wal);
+    free_worker_pool(pool);
+    recurrence_engine_free(&rules);
+    free_task_manager(manager);
+    free(latencies);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "include/worker_pool.h"
+#include "src/worker_pool.c"
+
+#define ROOTS 64
+#define CHILDREN 200
+#define WIDE_CHILDREN (3 * WORKER_DEQUE_CAPACITY) // Overflows the spawning worker's deque
+#define ROUNDS 20
+
+typedef struct TestJob {
+    WorkerJob job;
+    int children;                    // Spawned from run, on the worker's own deque
+    struct TestJob *child_jobs;
+    _Atomic int runs;
+    int dones;
+    pthread_t done_thread;
+} TestJob;
+
+static WorkerPool *pool;
+static _Atomic long ran;
+static long finished;
+
+static void finish_test_job(WorkerJob *job)
+{
+    TestJob *test = (TestJob *)job->context;
+    test->dones++;
+    test->done_thread = pthread_self();
+    finished++;
+}
+
+static void run_test_job(WorkerJob *job)
+{
+    TestJob *test = (TestJob *)job->context;
+    atomic_fetch_add(&test->runs, 1);
+    atomic_fetch_add(&ran, 1);
+
+    for (int i = 0; i < test->children; i++)
+    {
+        TestJob *child = &test->child_jobs[i];
+        child->job.run = run_test_job;
+        child->job.done = finish_test_job;
+        child->job.context = child;
+        if (!worker_pool_submit(pool, &child->job))
+            printf("Child submit failed.\n");
+    }
+
+    // A little work so thieves get a chance
+    volatile unsigned spin = 0;
+    for (int i = 0; i < 2000; i++)
+        spin += i;
+}
+
+static bool check_jobs(TestJob *jobs, int count, pthread_t self)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (atomic_load(&jobs[i].runs) != 1 || jobs[i].dones != 1 || !pthread_equal(jobs[i].done_thread, self))
+        {
+            printf("Job %d ran %d times and finished %d times.\n", i, atomic_load(&jobs[i].runs), jobs[i].dones);
+            return false;
+        }
+        if (jobs[i].children && !check_jobs(jobs[i].child_jobs, jobs[i].children, self))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    pool = create_worker_pool(threads);
+    if (!pool)
+        return 1;
+
+    bool ok = true;
+    long expected = 0;
+    for (int round = 0; round < ROUNDS && ok; round++)
+    {
+        // Many roots with a fan of children each, plus one root whose children spill
+        TestJob *roots = (TestJob *)calloc(ROOTS + 1, sizeof(TestJob));
+        TestJob *children = (TestJob *)calloc(ROOTS * CHILDREN + WIDE_CHILDREN, sizeof(TestJob));
+        if (!roots || !children)
+            return 1;
+
+        for (int i = 0; i <= ROOTS; i++)
+        {
+            roots[i].children = i < ROOTS ? CHILDREN : WIDE_CHILDREN;
+            roots[i].child_jobs = children + (size_t)i * CHILDREN;
+            roots[i].job.run = run_test_job;
+            roots[i].job.done = finish_test_job;
+            roots[i].job.context = &roots[i];
+            ok = worker_pool_submit(pool, &roots[i].job) && ok;
+        }
+        expected += ROOTS + 1 + ROOTS * CHILDREN + WIDE_CHILDREN;
+
+        // Drain some on the way, the rest in wait
+        if (round % 2)
+            worker_pool_drain(pool, 100);
+        worker_pool_wait(pool);
+        ok = ok && check_jobs(roots, ROOTS + 1, pthread_self()) && atomic_load(&ran) == expected &&
+             finished == expected && worker_pool_in_flight(pool) == 0;
+
+        free(roots);
+        free(children);
+    }
+
+    uint64_t executed = 0, stolen = 0;
+    for (int i = 0; i < pool->worker_count; i++)
+    {
+        executed += atomic_load(&pool->workers[i].executed);
+        stolen += atomic_load(&pool->workers[i].stolen);
+    }
+    ok = ok && executed == (uint64_t)expected;
+    printf("%d workers: %llu jobs, %llu stolen\n", pool->worker_count, (unsigned long long)executed,
+           (unsigned long long)stolen);
+
+    // Jobs still queued at shutdown run, and their results are handed back
+    TestJob late[8];
+    memset(late, 0, sizeof(late));
+    for (int i = 0; i < 8; i++)
+    {
+        late[i].job.run = run_test_job;
+        late[i].job.done = finish_test_job;
+        late[i].job.context = &late[i];
+        worker_pool_submit(pool, &late[i].job);
+    }
+    free_worker_pool(pool);
+    ok = ok && check_jobs(late, 8, pthread_self());
+
+    printf("Worker pool test: %s\n", ok ? "passed" : "FAILED");
+    return ok ? 0 : 1;
+}